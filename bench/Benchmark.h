@@ -82,8 +82,12 @@ public:
     // Count of units (pixels, whatever) being exercised, to scale timing by.
     int getUnits() const { return fUnits; }
 
+    // Bytes of input processed by each loop of draw(), or 0.  Used to report throughput.
+    size_t getBytesPerLoop() const { return fBytesPerLoop; }
+
 protected:
     void setUnits(int units) { SkASSERT(units > 0); fUnits = units; }
+    void setBytesPerLoop(size_t bytes) { fBytesPerLoop = bytes; }
 
     virtual void setupPaint(SkPaint* paint);
 
@@ -101,7 +105,8 @@ protected:
     virtual SkIPoint onGetSize();
 
 private:
-    int fUnits = 1;
+    int    fUnits = 1;
+    size_t fBytesPerLoop = 0;
 
     typedef SkRefCnt INHERITED;
 };
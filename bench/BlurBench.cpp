@@ -6,12 +6,14 @@
  */
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkBlurMask.h"
+#include "src/core/SkMaskBlurFilter.h"
 
 #define MINI    0.01f
 #define SMALL   SkIntToScalar(2)
@@ -101,3 +103,73 @@ DEF_BENCH(return new BlurBench(REAL, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kInner_SkBlurStyle);)
 
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
+
+// Blurs a large A8 mask with SkMaskBlurFilter directly, one row at a time or eight rows at once
+// in SIMD lanes, and optionally in bands on a pool of threads.
+class MaskBlurFilterBench : public Benchmark {
+    double      fSigma;
+    bool        fLanes;
+    int         fThreads;
+    SkString    fName;
+    SkMask      fSrc;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+public:
+    MaskBlurFilterBench(double sigma, bool lanes, int threads)
+            : fSigma(sigma), fLanes(lanes), fThreads(threads) {
+        fName.printf("mask_blur_filter_%g_%s", sigma, lanes ? "lanes" : "rows");
+        if (threads) {
+            fName.appendf("_%dthreads", threads);
+        }
+        fSrc.fImage = nullptr;
+    }
+
+    ~MaskBlurFilterBench() override { SkMask::FreeImage(fSrc.fImage); }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fSrc.fBounds = SkIRect::MakeWH(kSize, kSize);
+        fSrc.fFormat = SkMask::kA8_Format;
+        fSrc.fRowBytes = kSize;
+        fSrc.fImage = SkMask::AllocImage(fSrc.computeImageSize());
+        // A rounded rect, like the shadow of a card.
+        for (int y = 0; y < kSize; y++) {
+            for (int x = 0; x < kSize; x++) {
+                int dx = std::max(0, std::abs(2 * x - kSize) - kSize / 2),
+                    dy = std::max(0, std::abs(2 * y - kSize) - kSize / 2);
+                fSrc.fImage[y * kSize + x] = dx * dx + dy * dy < kSize * kSize / 4 ? 0xFF : 0;
+            }
+        }
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkMaskBlurFilter filter(fSigma, fSigma);
+        filter.setUseLanesForTesting(fLanes);
+        for (int i = 0; i < loops; i++) {
+            SkMask dst;
+            filter.blur(fSrc, &dst, fExecutor.get());
+            SkMask::FreeImage(dst.fImage);
+        }
+    }
+
+private:
+    static constexpr int kSize = 1024;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new MaskBlurFilterBench(  5, false, 0);)
+DEF_BENCH(return new MaskBlurFilterBench(  5, true,  0);)
+DEF_BENCH(return new MaskBlurFilterBench( 25, false, 0);)
+DEF_BENCH(return new MaskBlurFilterBench( 25, true,  0);)
+DEF_BENCH(return new MaskBlurFilterBench( 25, true,  4);)
+DEF_BENCH(return new MaskBlurFilterBench(100, false, 0);)
+DEF_BENCH(return new MaskBlurFilterBench(100, true,  0);)
+DEF_BENCH(return new MaskBlurFilterBench(100, true,  4);)
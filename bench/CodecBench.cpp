@@ -9,6 +9,7 @@
 #include "bench/CodecBenchPriv.h"
 #include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "src/core/SkOSFile.h"
 #include "tools/flags/CommandLineFlags.h"
 
@@ -17,18 +18,24 @@ static DEFINE_bool(zero_init, false,
                    "Pretend our destination is zero-intialized, simulating Android?");
 
 CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType,
-        SkAlphaType alphaType)
+        SkAlphaType alphaType, int threads)
     : fColorType(colorType)
     , fAlphaType(alphaType)
     , fData(SkRef(encoded))
+    , fThreads(threads)
 {
     // Parse filename and the color type to give the benchmark a useful name
     fName.printf("Codec_%s_%s%s", baseName.c_str(), color_type_to_str(colorType),
             alpha_type_to_str(alphaType));
+    if (fThreads > 0) {
+        fName.appendf("_%dthreads", fThreads);
+    }
     // Ensure that we can create an SkCodec from this data.
     SkASSERT(SkCodec::MakeFromData(fData));
 }
 
+CodecBench::~CodecBench() = default;
+
 const char* CodecBench::onGetName() {
     return fName.c_str();
 }
@@ -45,6 +52,10 @@ void CodecBench::onDelayedSetup() {
                             .makeColorSpace(nullptr);
 
     fPixelStorage.reset(fInfo.computeMinByteSize());
+
+    if (fThreads > 0) {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
 }
 
 void CodecBench::onDraw(int n, SkCanvas* canvas) {
@@ -53,6 +64,7 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
     if (FLAGS_zero_init) {
         options.fZeroInitialized = SkCodec::kYes_ZeroInitialized;
     }
+    options.fExecutor = fExecutor.get();
     for (int i = 0; i < n; i++) {
         codec = SkCodec::MakeFromData(fData);
 #ifdef SK_DEBUG
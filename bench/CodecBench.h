@@ -15,13 +15,18 @@
 #include "include/core/SkString.h"
 #include "src/core/SkAutoMalloc.h"
 
+class SkExecutor;
+
 /**
  *  Time SkCodec.
  */
 class CodecBench : public Benchmark {
 public:
     // Calls encoded->ref()
-    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType);
+    // If threads > 0, decodes with SkCodec::Options::fExecutor set to a pool of that many threads.
+    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType,
+               int threads = 0);
+    ~CodecBench() override;
 
 protected:
     const char* onGetName() override;
@@ -36,6 +41,8 @@ private:
     sk_sp<SkData>           fData;
     SkImageInfo             fInfo;          // Set in onDelayedSetup.
     SkAutoMalloc            fPixelStorage;
+    const int               fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;  // Set in onDelayedSetup if fThreads > 0.
     typedef Benchmark INHERITED;
 };
 #endif // CodecBench_DEFINED
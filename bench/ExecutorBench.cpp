@@ -0,0 +1,73 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <atomic>
+
+// Measures the overhead of fine-grained SkTaskGroup::batch() calls, including nested ones
+// issued from inside the pool, where queue contention dominates the (tiny) work itself.
+class ExecutorBench : public Benchmark {
+public:
+    ExecutorBench(bool workStealing, int threads)
+        : fWorkStealing(workStealing), fThreads(threads) {
+        fName.printf("executor_%s_%dthreads", workStealing ? "worksteal" : "fifo", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        fExecutor = fWorkStealing ? SkExecutor::MakeWorkStealingThreadPool(fThreads)
+                                  : SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        std::atomic<int> sum{0};
+        for (int i = 0; i < loops; i++) {
+            SkTaskGroup outer(*fExecutor);
+            outer.batch(kOuter, [&](int) {
+                SkTaskGroup inner(*fExecutor);
+                inner.batch(kInner, [&](int j) {
+                    sum.fetch_add(j, std::memory_order_relaxed);
+                });
+                inner.wait();
+            });
+            outer.wait();
+        }
+    }
+
+private:
+    static constexpr int kOuter = 64,
+                         kInner = 64;
+
+    SkString                    fName;
+    bool                        fWorkStealing;
+    int                         fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ExecutorBench(false,  1); )
+DEF_BENCH( return new ExecutorBench(false,  2); )
+DEF_BENCH( return new ExecutorBench(false,  4); )
+DEF_BENCH( return new ExecutorBench(false,  8); )
+DEF_BENCH( return new ExecutorBench(false, 16); )
+DEF_BENCH( return new ExecutorBench(false, 32); )
+DEF_BENCH( return new ExecutorBench(false, 64); )
+DEF_BENCH( return new ExecutorBench(true,  1); )
+DEF_BENCH( return new ExecutorBench(true,  2); )
+DEF_BENCH( return new ExecutorBench(true,  4); )
+DEF_BENCH( return new ExecutorBench(true,  8); )
+DEF_BENCH( return new ExecutorBench(true, 16); )
+DEF_BENCH( return new ExecutorBench(true, 32); )
+DEF_BENCH( return new ExecutorBench(true, 64); )
@@ -7,7 +7,10 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkSurface.h"
+#include "include/effects/SkGradientShader.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/gpu/GrRecordingContext.h"
@@ -164,7 +167,75 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Filters a large raster image through a DAG with independent Merge, Arithmetic and Xfermode
+// branches, either serially (threads == 0) or with makeWithFilter() spreading branches and tiles
+// of the output over a pool of threads.
+class ImageMakeWithFilterThreadsBench : public Benchmark {
+public:
+    ImageMakeWithFilterThreadsBench(int size, int threads) : fSize(size), fThreads(threads) {
+        if (fThreads) {
+            fName.printf("image_make_with_filter_dag_%d_%dthreads", fSize, fThreads);
+        } else {
+            fName.printf("image_make_with_filter_dag_%d_serial", fSize);
+        }
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+
+        sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(fSize, fSize);
+        SkPoint pts[] = {{0, 0}, {SkIntToScalar(fSize), SkIntToScalar(fSize)}};
+        SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+        SkPaint paint;
+        paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 3,
+                                                     SkTileMode::kMirror));
+        surface->getCanvas()->drawPaint(paint);
+        fImage = surface->makeImageSnapshot();
+
+        auto blur   = SkImageFilters::Blur(8.0f, 8.0f, nullptr);
+        auto offset = SkImageFilters::Offset(20.0f, -20.0f, blur);
+        auto dilate = SkImageFilters::Dilate(4.0f, 4.0f, nullptr);
+        fFilter = SkImageFilters::Merge(
+                SkImageFilters::Arithmetic(0.25f, 0.5f, 0.5f, 0.0f, true, offset, dilate),
+                SkImageFilters::Xfermode(SkBlendMode::kMultiply,
+                                         SkImageFilters::Blur(3.0f, 3.0f, nullptr),
+                                         SkImageFilters::Erode(2.0f, 2.0f, nullptr)));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkIRect subset = SkIRect::MakeWH(fSize, fSize);
+        for (int j = 0; j < loops; j++) {
+            SkIRect outSubset;
+            SkIPoint offset;
+            sk_sp<SkImage> image = fImage->makeWithFilter(nullptr, fFilter.get(), subset, subset,
+                                                          &outSubset, &offset, fExecutor.get());
+            SkASSERT(image);
+        }
+    }
+
+private:
+    SkString                    fName;
+    int                         fSize;
+    int                         fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+    sk_sp<SkImage>              fImage;
+    sk_sp<SkImageFilter>        fFilter;
+
+    typedef Benchmark INHERITED;
+};
+
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
+DEF_BENCH(return new ImageMakeWithFilterThreadsBench(2048, 0);)
+DEF_BENCH(return new ImageMakeWithFilterThreadsBench(2048, 2);)
+DEF_BENCH(return new ImageMakeWithFilterThreadsBench(2048, 4);)
+DEF_BENCH(return new ImageMakeWithFilterThreadsBench(2048, 8);)
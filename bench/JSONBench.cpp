@@ -18,9 +18,23 @@ static constexpr const char* kBenchFile = "/tmp/bench.json";
 
 class JsonBench : public Benchmark {
 public:
+    enum class Mode {
+        kText,      // Parse the JSON text.
+        kSnapshot,  // Load a binary snapshot of the parsed DOM (see DOM::writeBinary).
+        kStream,    // Parse the JSON text with skjson::Parse(), without building a DOM.
+    };
+
+    explicit JsonBench(Mode mode) : fMode(mode) {}
 
 protected:
-    const char* onGetName() override { return "json_skjson"; }
+    const char* onGetName() override {
+        switch (fMode) {
+            case Mode::kText:     return "json_skjson";
+            case Mode::kSnapshot: return "json_skjson_snapshot";
+            case Mode::kStream:   return "json_skjson_stream";
+        }
+        SkUNREACHABLE;
+    }
 
     bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
 
@@ -28,6 +42,15 @@ protected:
         fData = SkData::MakeFromFileName(kBenchFile);
         if (!fData) {
             SkDebugf("!! Could not open bench file: %s\n", kBenchFile);
+            return;
+        }
+        // Throughput is always in terms of the JSON text, even when loading a snapshot of it.
+        this->setBytesPerLoop(fData->size());
+        if (fMode == Mode::kSnapshot) {
+            SkDynamicMemoryWStream stream;
+            skjson::DOM(static_cast<const char*>(fData->data()), fData->size())
+                    .writeBinary(&stream);
+            fData = stream.detachAsData();
         }
     }
 
@@ -38,9 +61,26 @@ protected:
     void onDraw(int loops, SkCanvas*) override {
         if (!fData) return;
 
+        const auto* data = static_cast<const char*>(fData->data());
+        const auto  size = fData->size();
+
         for (int i = 0; i < loops; i++) {
-            skjson::DOM dom(static_cast<const char*>(fData->data()), fData->size());
-            if (dom.root().is<skjson::NullValue>()) {
+            bool success = false;
+            switch (fMode) {
+                case Mode::kText: {
+                    skjson::DOM dom(data, size);
+                    success = !dom.root().is<skjson::NullValue>();
+                } break;
+                case Mode::kSnapshot: {
+                    const auto dom = skjson::DOM::MakeFromSnapshot(data, size);
+                    success = !dom->root().is<skjson::NullValue>();
+                } break;
+                case Mode::kStream: {
+                    skjson::Handler handler;
+                    success = skjson::Parse(data, size, &handler);
+                } break;
+            }
+            if (!success) {
                 SkDebugf("!! Parsing failed.\n");
                 return;
             }
@@ -48,12 +88,15 @@ protected:
     }
 
 private:
+    const Mode    fMode;
     sk_sp<SkData> fData;
 
     using INHERITED = Benchmark;
 };
 
-DEF_BENCH( return new JsonBench; )
+DEF_BENCH( return new JsonBench(JsonBench::Mode::kText); )
+DEF_BENCH( return new JsonBench(JsonBench::Mode::kSnapshot); )
+DEF_BENCH( return new JsonBench(JsonBench::Mode::kStream); )
 
 #if (0)
 
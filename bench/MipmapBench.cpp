@@ -7,6 +7,7 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "src/core/SkMipmap.h"
 
 class MipmapBench: public Benchmark {
@@ -14,15 +15,20 @@ class MipmapBench: public Benchmark {
     SkString fName;
     const int fW, fH;
     bool fHalfFoat;
+    int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
 
 public:
-    MipmapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    MipmapBench(int w, int h, bool halfFloat = false, int threads = 0)
+        : fW(w), fH(h), fHalfFoat(halfFloat), fThreads(threads)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
         if (halfFloat) {
             fName.append("_f16");
         }
+        if (threads) {
+            fName.appendf("_%dthreads", threads);
+        }
     }
 
 protected:
@@ -38,11 +44,14 @@ protected:
                                              SkColorSpace::MakeSRGB());
         fBitmap.allocPixels(info);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
     }
 
     void onDraw(int loops, SkCanvas*) override {
         for (int i = 0; i < loops * 4; i++) {
-            SkMipmap::Build(fBitmap, nullptr)->unref();
+            SkMipmap::Build(fBitmap.pixmap(), nullptr, true, fExecutor.get())->unref();
         }
     }
 
@@ -65,3 +74,11 @@ DEF_BENCH( return new MipmapBench(2048, 2048); )
 DEF_BENCH( return new MipmapBench(2047, 2047); )
 DEF_BENCH( return new MipmapBench(2048, 2047); )
 DEF_BENCH( return new MipmapBench(2047, 2048); )
+
+// Texture-upload sized builds, on one thread and split across a pool of threads.
+DEF_BENCH( return new MipmapBench(8192, 8192); )
+DEF_BENCH( return new MipmapBench(8192, 8192, false, 2); )
+DEF_BENCH( return new MipmapBench(8192, 8192, false, 4); )
+DEF_BENCH( return new MipmapBench(8192, 8192, false, 8); )
+DEF_BENCH( return new MipmapBench(8191, 8191, false, 4); )
+DEF_BENCH( return new MipmapBench(4096, 4096, true, 4); )
@@ -9,6 +9,7 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
@@ -97,3 +98,52 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// Measures SkPicture::playbackParallel() into a raster canvas as the thread count grows.
+class ParallelPlaybackBench : public Benchmark {
+public:
+    explicit ParallelPlaybackBench(int threads) : fThreads(threads) {
+        fName.printf("parallel_playback_rtree_%dthreads", threads);
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    SkIPoint onGetSize() override { return SkIPoint::Make(1024,1024); }
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1024, 1024, &factory);
+            SkRandom rand;
+            for (int i = 0; i < 10000; i++) {
+                SkScalar x = rand.nextRangeScalar(0, 1024),
+                         y = rand.nextRangeScalar(0, 1024),
+                         r = rand.nextRangeScalar(0, 64);
+                SkPaint paint;
+                paint.setColor(rand.nextU());
+                paint.setAntiAlias(true);
+                canvas->drawCircle(x, y, r, paint);
+            }
+        fPic = recorder.finishRecordingAsPicture();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            fPic->playbackParallel(canvas, fExecutor.get(), 4 * fThreads);
+        }
+    }
+
+private:
+    int                         fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    sk_sp<SkPicture>            fPic;
+};
+
+DEF_BENCH( return new ParallelPlaybackBench( 1); )
+DEF_BENCH( return new ParallelPlaybackBench( 2); )
+DEF_BENCH( return new ParallelPlaybackBench( 4); )
+DEF_BENCH( return new ParallelPlaybackBench( 8); )
+DEF_BENCH( return new ParallelPlaybackBench(16); )
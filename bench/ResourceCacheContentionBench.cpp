@@ -0,0 +1,109 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
+
+namespace {
+static void* gContentionNamespace;
+
+struct ContentionKey : public SkResourceCache::Key {
+    int32_t fValue;
+
+    ContentionKey(int32_t value) : fValue(value) {
+        this->init(&gContentionNamespace, 0, sizeof(fValue));
+    }
+};
+
+struct ContentionRec : public SkResourceCache::Rec {
+    ContentionKey fKey;
+
+    ContentionRec(int32_t value) : fKey(value) {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this); }
+    const char* getCategory() const override { return "resourcecachecontention-test"; }
+
+    static bool Visitor(const SkResourceCache::Rec&, void*) { return true; }
+};
+}  // namespace
+
+// Hammers the global SkResourceCache's static Find/Add from several threads at once, the way
+// concurrent rasterization does, with the cache split into one or more shards.
+class ResourceCacheContentionBench : public Benchmark {
+public:
+    ResourceCacheContentionBench(int threads, int shards) : fThreads(threads), fShards(shards) {
+        fName.printf("resourcecache_contention_%dthreads_%dshards", fThreads, fShards);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onPreDraw(SkCanvas*) override {
+        fPrevShards = SkResourceCache::SetShardCount(fShards);
+        for (int i = 0; i < kKeys; ++i) {
+            SkResourceCache::Add(new ContentionRec(i));
+        }
+    }
+
+    void onPostDraw(SkCanvas*) override {
+        SkResourceCache::PurgeAll();
+        SkResourceCache::SetShardCount(fPrevShards);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup tg(*fExecutor);
+        tg.batch(fThreads, [&](int thread) {
+            // Mostly hits, with a miss-and-add every 16th lookup.
+            uint32_t seed = thread * 7919 + 1;
+            for (int i = 0; i < loops; ++i) {
+                for (int j = 0; j < kLookupsPerLoop; ++j) {
+                    seed = seed * 1664525 + 1013904223;
+                    int32_t value = (seed >> 8) % kKeys;
+                    if ((seed & 0xF) == 0) {
+                        value += kKeys;
+                        if (!SkResourceCache::Find(ContentionKey(value),
+                                                   ContentionRec::Visitor, nullptr)) {
+                            SkResourceCache::Add(new ContentionRec(value));
+                        }
+                    } else {
+                        SkResourceCache::Find(ContentionKey(value),
+                                              ContentionRec::Visitor, nullptr);
+                    }
+                }
+            }
+        });
+    }
+
+private:
+    static constexpr int kKeys           = 4096;
+    static constexpr int kLookupsPerLoop = 100;
+
+    SkString                    fName;
+    int                         fThreads;
+    int                         fShards;
+    int                         fPrevShards = 1;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ResourceCacheContentionBench(1, 1); )
+DEF_BENCH( return new ResourceCacheContentionBench(4, 1); )
+DEF_BENCH( return new ResourceCacheContentionBench(4, 16); )
+DEF_BENCH( return new ResourceCacheContentionBench(8, 1); )
+DEF_BENCH( return new ResourceCacheContentionBench(8, 16); )
+DEF_BENCH( return new ResourceCacheContentionBench(16, 1); )
+DEF_BENCH( return new ResourceCacheContentionBench(16, 32); )
@@ -9,6 +9,7 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkGraphics.h"
 #include "include/core/SkTypeface.h"
 #include "src/core/SkRemoteGlyphCache.h"
@@ -112,10 +113,66 @@ private:
     SkString fName;
 };
 
+// Many threads looking up a handful of already-cached strikes, as when several threads shape and
+// rasterize text in the same fonts. This is dominated by SkStrikeCache::findOrCreateStrike().
+class SkGlyphCacheFindStrike : public Benchmark {
+public:
+    explicit SkGlyphCacheFindStrike(int threads) : fThreads(threads) {
+        fName.printf("SkGlyphCacheFindStrike_%dthreads", fThreads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+
+        SkFont font;
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        font.setSubpixel(true);
+        font.setTypeface(ToolUtils::create_portable_typeface("serif", SkFontStyle::Italic()));
+        SkPaint defaultPaint;
+        for (int i = 0; i < kStrikes; i++) {
+            font.setSize(10 + i);
+            fSpecs.push_back(SkStrikeSpec::MakeMask(
+                    font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                    SkScalerContextFlags::kNone, SkMatrix::I()));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup(*fExecutor).batch(fThreads, [&](int thread) {
+            for (int i = 0; i < loops; i++) {
+                for (int j = 0; j < kLookupsPerLoop; j++) {
+                    sk_sp<SkStrike> strike =
+                            fSpecs[(thread + j) % kStrikes].findOrCreateStrike();
+                }
+            }
+        });
+    }
+
+private:
+    static constexpr int kStrikes        = 8;
+    static constexpr int kLookupsPerLoop = 100;
+
+    typedef Benchmark INHERITED;
+    const int                   fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    std::vector<SkStrikeSpec>   fSpecs;
+};
+
 DEF_BENCH( return new SkGlyphCacheBasic(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheFindStrike(1); )
+DEF_BENCH( return new SkGlyphCacheFindStrike(8); )
+DEF_BENCH( return new SkGlyphCacheFindStrike(32); )
 
 namespace {
 class DiscardableManager : public SkStrikeServer::DiscardableHandleManager,
@@ -10,10 +10,15 @@
 #include "src/core/SkVM.h"
 #include "tools/SkVMBuilders.h"
 
+extern bool gSkVMAllowAVX512;
+
 namespace {
 
-    enum Mode {Opts, RP, F32, I32_Naive};
-    static const char* kMode_name[] = { "Opts", "RP","F32", "I32_Naive" };
+    // The _AVX2 modes JIT with AVX-512 disabled, to compare 8- and 16-lane code on SKX machines.
+    enum Mode {Opts, RP, F32, I32_Naive, F32_AVX2, I32_Naive_AVX2};
+    static const char* kMode_name[] = {
+        "Opts", "RP","F32", "I32_Naive", "F32_AVX2", "I32_Naive_AVX2",
+    };
 
 }  // namespace
 
@@ -34,8 +39,17 @@ private:
         fSrc.resize(fPixels, 0x7f123456);  // Arbitrary non-opaque non-transparent value.
         fDst.resize(fPixels, 0xff987654);  // Arbitrary value.
 
-        if (fMode == F32      ) { fProgram = SrcoverBuilder_F32      {}.done(); }
-        if (fMode == I32_Naive) { fProgram = SrcoverBuilder_I32_Naive{}.done(); }
+        const bool allowAVX512 = gSkVMAllowAVX512;
+        if (fMode == F32_AVX2 || fMode == I32_Naive_AVX2) {
+            gSkVMAllowAVX512 = false;
+        }
+        if (fMode == F32       || fMode == F32_AVX2      ) {
+            fProgram = SrcoverBuilder_F32      {}.done();
+        }
+        if (fMode == I32_Naive || fMode == I32_Naive_AVX2) {
+            fProgram = SrcoverBuilder_I32_Naive{}.done();
+        }
+        gSkVMAllowAVX512 = allowAVX512;
 
         if (fMode == RP) {
             fSrcCtx = { fSrc.data(), 0 };
@@ -109,6 +123,16 @@ DEF_BENCH(return (new SkVMBench{ 256, I32_Naive});)
 DEF_BENCH(return (new SkVMBench{1024, I32_Naive});)
 DEF_BENCH(return (new SkVMBench{4096, I32_Naive});)
 
+DEF_BENCH(return (new SkVMBench{  63, F32_AVX2});)
+DEF_BENCH(return (new SkVMBench{ 256, F32_AVX2});)
+DEF_BENCH(return (new SkVMBench{1024, F32_AVX2});)
+DEF_BENCH(return (new SkVMBench{4096, F32_AVX2});)
+
+DEF_BENCH(return (new SkVMBench{  63, I32_Naive_AVX2});)
+DEF_BENCH(return (new SkVMBench{ 256, I32_Naive_AVX2});)
+DEF_BENCH(return (new SkVMBench{1024, I32_Naive_AVX2});)
+DEF_BENCH(return (new SkVMBench{4096, I32_Naive_AVX2});)
+
 class SkVM_Overhead : public Benchmark {
 public:
     explicit SkVM_Overhead(bool rp) : fRP(rp) {}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkSurface.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/utils/SkRandom.h"
+
+// Draws a few thousand anti-aliased paths and gradient rects into a large raster surface,
+// either directly (threads == 0) or through SkSurface::MakeRasterTiled() on a pool of threads.
+class TiledSurfaceBench : public Benchmark {
+public:
+    TiledSurfaceBench(int size, int threads) : fSize(size), fThreads(threads) {
+        if (fThreads) {
+            fName.printf("tiled_surface_%d_%dthreads", fSize, fThreads);
+        } else {
+            fName.printf("tiled_surface_%d_direct", fSize);
+        }
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+
+        SkRandom rand;
+        for (int i = 0; i < kPaths; i++) {
+            SkPath path;
+            SkScalar x = rand.nextRangeScalar(0, fSize),
+                     y = rand.nextRangeScalar(0, fSize);
+            path.moveTo(x, y);
+            for (int j = 0; j < 4; j++) {
+                SkPoint p[3];
+                for (SkPoint& pt : p) {
+                    pt.fX = x + rand.nextRangeScalar(-200, 200);
+                    pt.fY = y + rand.nextRangeScalar(-200, 200);
+                }
+                path.cubicTo(p[0], p[1], p[2]);
+            }
+            path.close();
+            fPaths.push_back(path);
+            fColors.push_back(rand.nextU() | 0xff000000);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkImageInfo info = SkImageInfo::MakeN32Premul(fSize, fSize);
+        SkPoint pts[] = {{0, 0}, {SkIntToScalar(fSize), SkIntToScalar(fSize)}};
+        SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+        SkPaint gradient;
+        gradient.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                        SkTileMode::kClamp));
+
+        for (int loop = 0; loop < loops; loop++) {
+            sk_sp<SkSurface> surface = fThreads
+                    ? SkSurface::MakeRasterTiled(info, fExecutor.get())
+                    : SkSurface::MakeRaster(info);
+            SkCanvas* canvas = surface->getCanvas();
+            canvas->drawPaint(gradient);
+
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            for (int i = 0; i < kPaths; i++) {
+                paint.setColor(fColors[i]);
+                canvas->drawPath(fPaths[i], paint);
+            }
+
+            // Reading the pixels forces a tiled surface to rasterize what it recorded.
+            SkPixmap pm;
+            surface->peekPixels(&pm);
+        }
+    }
+
+private:
+    static constexpr int kPaths = 2000;
+
+    SkString                    fName;
+    int                         fSize;
+    int                         fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+    std::vector<SkPath>         fPaths;
+    std::vector<SkColor>        fColors;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new TiledSurfaceBench(8192, 0); )
+DEF_BENCH( return new TiledSurfaceBench(8192, 1); )
+DEF_BENCH( return new TiledSurfaceBench(8192, 2); )
+DEF_BENCH( return new TiledSurfaceBench(8192, 4); )
+DEF_BENCH( return new TiledSurfaceBench(8192, 8); )
+DEF_BENCH( return new TiledSurfaceBench(8192, 16); )
+DEF_BENCH( return new TiledSurfaceBench(8192, 32); )
@@ -152,6 +152,9 @@ static DEFINE_string(images, "",
                      " is treated as a fatal error.");
 static DEFINE_bool(simpleCodec, false,
                    "Runs of a subset of the codec tests, always N32, Premul or Opaque");
+static DEFINE_int(codecThreads, 4,
+                  "Also time N32 decodes of PNGs and JPEGs with SkCodec::Options::fExecutor "
+                  "set to a pool of this many threads. 0 disables.");
 
 static DEFINE_string2(match, m, nullptr,
                "[~][^]substring[$] [...] of name to run.\n"
@@ -953,6 +956,32 @@ public:
             fCurrentColorType = 0;
         }
 
+        // Run threaded CodecBenches, to compare against the N32 CodecBenches above.
+        for (; FLAGS_codecThreads > 0 && fCurrentThreadedCodec < fImages.count();
+               fCurrentThreadedCodec++) {
+            fSourceType = "image";
+            fBenchType = "skcodec";
+            const SkString& path = fImages[fCurrentThreadedCodec];
+            if (CommandLineFlags::ShouldSkip(FLAGS_match, path.c_str())) {
+                continue;
+            }
+            sk_sp<SkData> encoded(SkData::MakeFromFileName(path.c_str()));
+            std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(encoded));
+            if (!codec || (codec->getEncodedFormat() != SkEncodedImageFormat::kPNG &&
+                           codec->getEncodedFormat() != SkEncodedImageFormat::kJPEG)) {
+                // Only PNGs and JPEGs use the executor so far.
+                continue;
+            }
+
+            SkAlphaType alphaType = codec->getInfo().alphaType();
+            if (kUnpremul_SkAlphaType == alphaType) {
+                alphaType = kPremul_SkAlphaType;
+            }
+            fCurrentThreadedCodec++;
+            return new CodecBench(SkOSPath::Basename(path.c_str()), encoded.get(),
+                                  kN32_SkColorType, alphaType, FLAGS_codecThreads);
+        }
+
         // Run AndroidCodecBenches
         const int sampleSizes[] = { 2, 4, 8 };
         for (; fCurrentAndroidCodec < fImages.count(); fCurrentAndroidCodec++) {
@@ -1138,6 +1167,7 @@ private:
     int fCurrentTextBlobTrace = 0;
     int fCurrentUseMPD = 0;
     int fCurrentCodec = 0;
+    int fCurrentThreadedCodec = 0;
     int fCurrentAndroidCodec = 0;
 #ifdef SK_ENABLE_ANDROID_UTILS
     int fCurrentBRDImage = 0;
@@ -1374,6 +1404,11 @@ int main(int argc, char** argv) {
 
             // Metrics
             log.appendMetric("min_ms", stats.min);
+            if (size_t bytes = bench->getBytesPerLoop()) {
+                // The fastest loop's throughput.  Samples are per unit, so scale back to a loop.
+                const double loopMs = stats.min * bench->getUnits();
+                log.appendMetric("max_mb_per_s", bytes / (loopMs * 1e-3) / (1 << 20));
+            }
             log.beginArray("samples");
             for (double sample : samples) {
                 log.appendDoubleDigits(sample, 16);
@@ -52,6 +52,7 @@ static constexpr char g_type_message[] = "How to interpret --bytes, one of:\n"
                                          "image_mode\n"
                                          "image_scale\n"
                                          "json\n"
+                                         "json_snapshot\n"
                                          "path_deserialize\n"
                                          "region_deserialize\n"
                                          "region_set_path\n"
@@ -83,6 +84,7 @@ static void fuzz_image_decode(sk_sp<SkData>);
 static void fuzz_image_decode_incremental(sk_sp<SkData>);
 static void fuzz_img(sk_sp<SkData>, uint8_t, uint8_t);
 static void fuzz_json(sk_sp<SkData>);
+static void fuzz_json_snapshot(sk_sp<SkData>);
 static void fuzz_path_deserialize(sk_sp<SkData>);
 static void fuzz_region_deserialize(sk_sp<SkData>);
 static void fuzz_region_set_path(sk_sp<SkData>);
@@ -199,6 +201,10 @@ static int fuzz_file(SkString path, SkString type) {
         fuzz_json(bytes);
         return 0;
     }
+    if (type.equals("json_snapshot")) {
+        fuzz_json_snapshot(bytes);
+        return 0;
+    }
     if (type.equals("path_deserialize")) {
         fuzz_path_deserialize(bytes);
         return 0;
@@ -293,6 +299,7 @@ static std::map<std::string, std::string> cf_map = {
     {"region_set_path", "region_set_path"},
     {"skdescriptor_deserialize", "skdescriptor_deserialize"},
     {"skjson", "json"},
+    {"skjson_snapshot", "json_snapshot"},
     {"skp", "skp"},
     {"skruntimeeffect", "skruntimeeffect"},
     {"sksl2glsl", "sksl2glsl"},
@@ -344,6 +351,13 @@ static void fuzz_json(sk_sp<SkData> bytes){
     SkDebugf("[terminated] Done parsing!\n");
 }
 
+void FuzzJSONSnapshot(sk_sp<SkData> bytes);
+
+static void fuzz_json_snapshot(sk_sp<SkData> bytes){
+    FuzzJSONSnapshot(bytes);
+    SkDebugf("[terminated] Done loading!\n");
+}
+
 #if defined(SK_ENABLE_SKOTTIE)
 void FuzzSkottieJSON(sk_sp<SkData> bytes);
 
@@ -0,0 +1,25 @@
+/*
+ * Copyright 2020 Google, LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkData.h"
+#include "include/core/SkStream.h"
+#include "src/utils/SkJSON.h"
+
+void FuzzJSONSnapshot(sk_sp<SkData> bytes) {
+    const auto dom = skjson::DOM::MakeFromSnapshot(static_cast<const char*>(bytes->data()),
+                                                   bytes->size());
+    SkDynamicMemoryWStream wstream;
+    dom->write(&wstream);
+}
+
+#if defined(IS_FUZZING_WITH_LIBFUZZER)
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    auto bytes = SkData::MakeWithoutCopy(data, size);
+    FuzzJSONSnapshot(bytes);
+    return 0;
+}
+#endif
@@ -195,11 +195,21 @@ public:
     //        called SkAndroidCodec.  On the other hand, it's may be a bit confusing to call
     //        these Options when SkCodec has a slightly different set of Options.  Maybe these
     //        should be DecodeOptions or SamplingOptions?
+    /**
+     *  Filters for AndroidOptions::fResizeFilter.
+     */
+    enum class ResizeFilter {
+        kNone,      // Scale by fSampleSize only.
+        kMitchell,  // Mitchell-Netravali cubic, B = C = 1/3.
+        kLanczos3,
+    };
+
     struct AndroidOptions {
         AndroidOptions()
             : fZeroInitialized(SkCodec::kNo_ZeroInitialized)
             , fSubset(nullptr)
             , fSampleSize(1)
+            , fResizeFilter(ResizeFilter::kNone)
         {}
 
         /**
@@ -229,6 +239,20 @@ public:
          *  The default is 1, representing no downscaling.
          */
         int fSampleSize;
+
+        /**
+         *  If not kNone, the info passed to getAndroidPixels() may have any dimensions, and
+         *  fSampleSize is ignored. The image is resized to them with this filter as it is
+         *  decoded, so the full size image is never held in memory when the codec can produce
+         *  rows in order (JPEG, BMP, WBMP and non-interlaced PNG). Other codecs (GIF,
+         *  interlaced PNG) decode the full image first. WebP is resized by libwebp's own
+         *  scaler instead, which also works row by row.
+         *
+         *  Not supported together with fSubset.
+         *
+         *  The default is kNone.
+         */
+        ResizeFilter fResizeFilter;
     };
 
     /**
@@ -26,6 +26,7 @@
 
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkPngChunkReader;
 class SkSampler;
@@ -287,6 +288,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -330,6 +332,18 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, the codec may split the work of getPixels() across this executor,
+         *  and will wait for it to finish before returning. The result is identical either way.
+         *
+         *  Currently only used by full (unsampled, non-subset) decodes of
+         *    - non-interlaced PNGs, which convert rows in bands on the executor while libpng
+         *      inflates the next band.
+         *    - unscaled baseline JPEGs with restart markers (DRI) aligned to MCU rows, which
+         *      decode independent bands of MCU rows concurrently.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -861,6 +875,29 @@ protected:
         return 0;
     }
 
+    /**
+     *  Receives each row of an incremental decode as soon as it is finished, in order. See
+     *  onSupportsRowSink().
+     */
+    class RowSink {
+    public:
+        virtual ~RowSink() {}
+        virtual void onRow(const void* row) = 0;
+    };
+
+    /**
+     *  While SkSampledCodec resizes an incremental decode, it installs a RowSink here. Codecs
+     *  that return true from onSupportsRowSink() then write every row to the first row of the
+     *  destination and hand it to the sink, instead of advancing through the destination.
+     */
+    RowSink* rowSink() const { return fRowSink; }
+
+    /**
+     *  Return true if incremental decodes produce rows top-down, one at a time, and pass them
+     *  to rowSink() when it is set.
+     */
+    virtual bool onSupportsRowSink() const { return false; }
+
 private:
     const SkEncodedInfo                fEncodedInfo;
     const XformFormat                  fSrcXformFormat;
@@ -886,6 +923,8 @@ private:
 
     bool                               fStartedIncrementalDecode;
 
+    RowSink*                           fRowSink;
+
     bool initializeColorXform(const SkImageInfo& dstInfo, SkEncodedInfo::Alpha, bool srcIsOpaque);
 
     /**
@@ -22,6 +22,13 @@ public:
     static std::unique_ptr<SkExecutor> MakeLIFOThreadPool(int threads = 0,
                                                           bool allowBorrowing = true);
 
+    // Create a thread pool SkExecutor where each thread has its own queue of work, and idle
+    // threads steal from the others.  Work added from one of the pool's own threads stays on
+    // that thread's queue (LIFO), so fine-grained nested SkTaskGroup::batch() calls don't all
+    // contend on one lock.  Other work is dealt out round-robin, and stolen oldest-first.
+    static std::unique_ptr<SkExecutor> MakeWorkStealingThreadPool(int threads = 0,
+                                                                  bool allowBorrowing = true);
+
     // There is always a default SkExecutor available by calling SkExecutor::GetDefault().
     static SkExecutor& GetDefault();
     static void SetDefault(SkExecutor*);  // Does not take ownership.  Not thread safe.
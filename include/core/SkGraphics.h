@@ -131,6 +131,14 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  The resource cache can be split into shards, each with its own lock and an equal share of
+     *  the byte limit, so that threads using different entries don't contend. The default is one
+     *  shard. SetResourceCacheShardCount() returns the previous count.
+     */
+    static int GetResourceCacheShardCount();
+    static int SetResourceCacheShardCount(int newCount);
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
@@ -172,6 +180,65 @@ public:
      *  Call early in main() to allow Skia to use a JIT to accelerate CPU-bound operations.
      */
     static void AllowJIT();
+
+    /**
+     *  A cache for the programs Skia builds for CPU drawing, which a client can back with
+     *  storage that outlives the process.  Like GrContextOptions::PersistentCache, the keys and
+     *  data are opaque.  Skia calls load() before building a program, and store() after
+     *  building one it could not load.  Both may be called from any thread.
+     */
+    class SK_API PersistentCache {
+    public:
+        virtual ~PersistentCache() {}
+
+        /**
+         *  Returns the data for the key if it exists in the cache, otherwise returns null.
+         */
+        virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+        virtual void store(const SkData& key, const SkData& data) = 0;
+    };
+
+    /**
+     *  Sets the persistent cache used for CPU programs, returning the previous one (which could
+     *  be NULL).  Skia does not take ownership; the cache must outlive any drawing that uses it.
+     */
+    static PersistentCache* SetPersistentCache(PersistentCache*);
+
+    /**
+     *  Return/set the limits on the in-memory cache of programs Skia builds for CPU drawing:
+     *  the max number of programs, and the max number of bytes they use, including JIT'd code.
+     *  When either limit would be exceeded, the least recently used programs are purged.
+     *
+     *  The setters return the previous limit, and purge immediately if the new one is lower.
+     */
+    static int    GetProgramCacheCountLimit();
+    static int    SetProgramCacheCountLimit(int count);
+    static size_t GetProgramCacheByteLimit();
+    static size_t SetProgramCacheByteLimit(size_t bytes);
+
+    /**
+     *  Purge all programs from the program cache.  This does not change the limits
+     *  or reset the statistics.
+     */
+    static void PurgeProgramCache();
+
+    struct ProgramCacheStats {
+        int      fCount;   // Programs currently in the cache.
+        size_t   fBytes;   // Bytes used by those programs, including JIT'd code.
+        uint64_t fHits;
+        uint64_t fMisses;
+
+        // Time taken to build each program on a miss: fBuildTimes[i] counts builds that took
+        // less than 2^i microseconds (and at least 2^(i-1)).  The last bucket counts all slower.
+        static constexpr int kBuildTimeBuckets = 16;
+        uint64_t fBuildTimes[kBuildTimeBuckets];
+    };
+
+    /**
+     *  Return the current size of the program cache, and how well it has worked since startup.
+     */
+    static ProgramCacheStats GetProgramCacheStats();
 };
 
 class SkAutoGraphics {
@@ -25,6 +25,7 @@
 
 class SkData;
 class SkCanvas;
+class SkExecutor;
 class SkImageFilter;
 class SkImageGenerator;
 class SkMipmap;
@@ -1228,12 +1229,14 @@ public:
         @param clipBounds  expected bounds of filtered SkImage
         @param outSubset   storage for returned SkImage bounds
         @param offset      storage for returned SkImage translation
+        @param executor    if not nullptr and filtering on the CPU, independent branches of
+                           filter and tiles of a large clipBounds are filtered concurrently
         @return            filtered SkImage, or nullptr
     */
     sk_sp<SkImage> makeWithFilter(GrRecordingContext* context,
                                   const SkImageFilter* filter, const SkIRect& subset,
                                   const SkIRect& clipBounds, SkIRect* outSubset,
-                                  SkIPoint* offset) const;
+                                  SkIPoint* offset, SkExecutor* executor = nullptr) const;
 
     /** Defines a callback function, taking one parameter of type GrBackendTexture with
         no return value. Function is called when back-end texture is to be released.
@@ -21,6 +21,10 @@ public:
     SkPath snapshot();  // the builder is unchanged after returning this path
     SkPath detach();    // the builder is reset to empty after returning this path
 
+    // Returns the bounds of the points added so far, or an empty rect if any of them are not
+    // finite. Only points added since the last call are examined.
+    SkRect computeBounds() const;
+
     SkPathBuilder& setFillType(SkPathFillType ft) { fFillType = ft; return *this; }
     SkPathBuilder& setIsVolatile(bool isVolatile) { fIsVolatile = isVolatile; return *this; }
 
@@ -203,6 +207,12 @@ private:
     bool                fIsVolatile;
 
     unsigned    fSegmentMask;
+
+    // fBounds and fBoundsAreFinite cover this many leading points of fPts.
+    mutable int     fBoundsPointCount = 0;
+    mutable SkRect  fBounds = SkRect::MakeEmpty();
+    mutable bool    fBoundsAreFinite = true;
+
     SkPoint     fLastMovePoint;
     bool        fNeedsMoveVerb;
 
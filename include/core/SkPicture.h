@@ -15,6 +15,7 @@
 
 class SkCanvas;
 class SkData;
+class SkExecutor;
 struct SkDeserialProcs;
 class SkImage;
 class SkMatrix;
@@ -80,6 +81,33 @@ public:
     static sk_sp<SkPicture> MakeFromData(const void* data, size_t size,
                                          const SkDeserialProcs* procs = nullptr);
 
+    /** Recreates SkPicture that was serialized into data, referencing data in place rather
+        than copying and re-recording it. Returns constructed SkPicture if successful;
+        otherwise, returns nullptr.
+
+        Drawing commands, paints, paths, text blobs, vertices, and images are read from data
+        as the picture is played back, so data must stay unchanged for the lifetime of the
+        returned SkPicture, and procs must stay valid while it is played back. This is intended
+        for large pictures loaded with SkData::MakeFromFD() or SkData::MakeFromFileName(),
+        where it avoids most of the copying and parsing MakeFromData() does up front.
+        Pictures serialized by older versions of Skia are accepted, but some of their
+        sections may still be copied.
+
+        If resourceBudget is zero, each object is decoded the first time it is drawn and kept
+        for the lifetime of the picture. Otherwise each playback decodes what it draws into
+        its own cache, dropping least recently used objects once they take more than about
+        resourceBudget bytes, so memory stays bounded at the cost of decoding some objects
+        more than once.
+
+        @param data            memory-mapped serial data
+        @param procs           custom serial data decoders; may be nullptr
+        @param resourceBudget  bytes of decoded objects each playback may keep; 0 keeps all
+        @return                SkPicture constructed from data
+    */
+    static sk_sp<SkPicture> MakeFromMappedData(sk_sp<SkData> data,
+                                               const SkDeserialProcs* procs = nullptr,
+                                               size_t resourceBudget = 0);
+
     /** \class SkPicture::AbortCallback
         AbortCallback is an abstract class. An implementation of AbortCallback may
         passed as a parameter to SkPicture::playback, to stop it before all drawing
@@ -130,6 +158,23 @@ public:
     */
     virtual void playback(SkCanvas* canvas, AbortCallback* callback = nullptr) const = 0;
 
+    /** Replays the drawing commands on the specified raster canvas, using executor to draw
+        horizontal bands of the canvas' clip bounds in parallel. Each band draws directly into
+        the canvas' pixels, clipped to the band; if SkPicture was recorded with an
+        SkBBHFactory (e.g. SkRTreeFactory), each band replays only the commands whose bounds
+        intersect it.
+
+        Falls back to playback() if canvas is not a plain raster canvas with directly accessible
+        pixels (e.g. a wrapper like SkPaintFilterCanvas), if canvas clip is not a pixel-aligned,
+        non-anti-aliased rectangle, or if SkPicture contains backdrop filters, which read
+        pixels across band edges.
+
+        @param canvas     raster receiver of drawing commands
+        @param executor   runs the band tasks; if nullptr, SkExecutor::GetDefault()
+        @param bandCount  number of bands; if zero or less, one band per 256 rows of the clip
+    */
+    void playbackParallel(SkCanvas* canvas, SkExecutor* executor, int bandCount = 0) const;
+
     /** Returns cull SkRect for this picture, passed in when SkPicture was created.
         Returned SkRect does not specify clipping SkRect for SkPicture; cull is hint
         of SkPicture bounds.
@@ -236,13 +281,15 @@ private:
     SkPicture();
     friend class SkBigPicture;
     friend class SkEmptyPicture;
+    friend class SkMappedPicture;
     friend class SkPicturePriv;
     template <typename> friend class SkMiniPicture;
 
     void serialize(SkWStream*, const SkSerialProcs*, class SkRefCntSet* typefaces,
         bool textBlobsOnly=false) const;
     static sk_sp<SkPicture> MakeFromStream(SkStream*, const SkDeserialProcs*,
-                                           class SkTypefacePlayback*);
+                                           class SkTypefacePlayback*,
+                                           const struct SkPictureMapping* mapping = nullptr);
     friend class SkPictureData;
 
     /** Return true if the SkStream/Buffer represents a serialized picture, and
@@ -260,6 +307,10 @@ private:
     // Returns NULL if this is not an SkBigPicture.
     virtual const class SkBigPicture* asSkBigPicture() const { return nullptr; }
 
+    // Returns true if playback may read destination pixels outside the clip (backdrop filters,
+    // SaveBehind), here or in a nested picture.
+    virtual bool readsBackdrop() const { return false; }
+
     friend struct SkPathCounter;
 
     static bool IsValidPictInfo(const struct SkPictInfo& info);
@@ -25,6 +25,7 @@
 
 class SkCanvas;
 class SkDeferredDisplayList;
+class SkExecutor;
 class SkPaint;
 class SkSurfaceCharacterization;
 class GrBackendRenderTarget;
@@ -170,6 +171,30 @@ public:
     static sk_sp<SkSurface> MakeRasterN32Premul(int width, int height,
                                                 const SkSurfaceProps* surfaceProps = nullptr);
 
+    /** Allocates raster SkSurface whose draws are rasterized in parallel.
+        Allocates and zeroes pixel memory, like MakeRaster(). SkCanvas returned by SkSurface
+        records draws instead of drawing them immediately. Recorded draws are rasterized when
+        the pixels are needed: by makeImageSnapshot(), draw(), readPixels(), peekPixels(),
+        writePixels() or flush(). At that point the surface is split into tileSize by tileSize
+        tiles, and each tile replays the recorded draws, clipped to the tile, as a task on
+        executor.
+
+        Results are identical to MakeRaster(), whatever the number of threads executor uses.
+        Draws that cross a tile edge, other than drawPaint(), and layers are rasterized by a
+        single task, in order with the tiled draws around them.
+
+        @param imageInfo     width, height, SkColorType, SkAlphaType, SkColorSpace,
+                             of raster surface; width and height must be greater than zero
+        @param executor      runs the tile tasks; if nullptr, SkExecutor::GetDefault()
+        @param tileSize      width and height of each tile; must be greater than zero
+        @param surfaceProps  LCD striping orientation and setting for device independent fonts;
+                             may be nullptr
+        @return              SkSurface if all parameters are valid; otherwise, nullptr
+    */
+    static sk_sp<SkSurface> MakeRasterTiled(const SkImageInfo& imageInfo, SkExecutor* executor,
+                                            int tileSize = 512,
+                                            const SkSurfaceProps* surfaceProps = nullptr);
+
     /** Caller data passed to RenderTarget/TextureReleaseProc; may be nullptr. */
     typedef void* ReleaseContext;
 
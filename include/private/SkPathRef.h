@@ -46,22 +46,7 @@ class SkWBuffer;
 class SK_API SkPathRef final : public SkNVRefCnt<SkPathRef> {
 public:
     SkPathRef(SkTDArray<SkPoint> points, SkTDArray<uint8_t> verbs, SkTDArray<SkScalar> weights,
-              unsigned segmentMask)
-        : fPoints(std::move(points))
-        , fVerbs(std::move(verbs))
-        , fConicWeights(std::move(weights))
-    {
-        fBoundsIsDirty = true;    // this also invalidates fIsFinite
-        fGenerationID = 0;        // recompute
-        fSegmentMask = segmentMask;
-        fIsOval = false;
-        fIsRRect = false;
-        // The next two values don't matter unless fIsOval or fIsRRect are true.
-        fRRectOrOvalIsCCW = false;
-        fRRectOrOvalStartIdx = 0xAC;
-        SkDEBUGCODE(fEditorsAttached.store(0);)
-        SkDEBUGCODE(this->validate();)
-    }
+              unsigned segmentMask);
 
     class Editor {
     public:
@@ -330,6 +315,13 @@ public:
      */
     uint32_t genID() const;
 
+    /**
+     * Returns a hash of the verbs, points and conic weights. Path refs with the same contents, bit
+     * for bit, have the same hash, unlike genID(). Only verbs, points and weights appended since
+     * the last call are hashed, so this stays cheap for paths that are built up incrementally.
+     */
+    uint32_t contentHash() const;
+
     void addGenIDChangeListener(sk_sp<SkIDChangeListener>);   // Threadsafe.
     int genIDChangeListenerCount();                           // Threadsafe
 
@@ -348,28 +340,17 @@ private:
         kSegmentMask_SerializationShift = 0                 // requires 4 bits (deprecated)
     };
 
-    SkPathRef() {
-        fBoundsIsDirty = true;    // this also invalidates fIsFinite
-        fGenerationID = kEmptyGenID;
-        fSegmentMask = 0;
-        fIsOval = false;
-        fIsRRect = false;
-        // The next two values don't matter unless fIsOval or fIsRRect are true.
-        fRRectOrOvalIsCCW = false;
-        fRRectOrOvalStartIdx = 0xAC;
-        SkDEBUGCODE(fEditorsAttached.store(0);)
-        SkDEBUGCODE(this->validate();)
-    }
+    SkPathRef();
 
     void copy(const SkPathRef& ref, int additionalReserveVerbs, int additionalReservePoints);
 
     // Doesn't read fSegmentMask, but (re)computes it from the verbs array
     unsigned computeSegmentMask() const;
 
-    // Return true if the computed bounds are finite.
-    static bool ComputePtBounds(SkRect* bounds, const SkPathRef& ref) {
-        return bounds->setBoundsCheck(ref.points(), ref.countPoints());
-    }
+    // Extends 'bounds', the bounds of the first 'prefix' of 'count' points (meaningless unless
+    // 'prefixIsFinite'), to all of them. Return true if the computed bounds are finite.
+    static bool ExtendPtBounds(SkRect* bounds, bool prefixIsFinite, const SkPoint pts[],
+                               int prefix, int count);
 
     // called, if dirty, by getBounds()
     void computeBounds() const {
@@ -378,7 +359,9 @@ private:
         // using an inverted rect instead of fBoundsIsDirty and always recalculating fIsFinite.
         SkASSERT(fBoundsIsDirty);
 
-        fIsFinite = ComputePtBounds(&fBounds, *this);
+        fIsFinite = ExtendPtBounds(&fBounds, fIsFinite, this->points(), fBoundsPointCount,
+                                   this->countPoints());
+        fBoundsPointCount = this->countPoints();
         fBoundsIsDirty = false;
     }
 
@@ -387,8 +370,13 @@ private:
         fBounds = rect;
         fBoundsIsDirty = false;
         fIsFinite = fBounds.isFinite();
+        fBoundsPointCount = this->countPoints();
     }
 
+    // Forgets how far bounds, hash and convexity computations got, when existing points or verbs
+    // are about to change rather than just be appended to.
+    void resetIncrementalState();
+
     /** Makes additional room but does not change the counts or change the genID */
     void incReserve(int additionalVerbs, int additionalPoints) {
         SkDEBUGCODE(this->validate();)
@@ -403,6 +391,7 @@ private:
                      int reserveVerbs = 0, int reservePoints = 0) {
         SkDEBUGCODE(this->validate();)
         this->callGenIDChangeListeners();
+        this->resetIncrementalState();
         fBoundsIsDirty = true;      // this also invalidates fIsFinite
         fGenerationID = 0;
 
@@ -466,6 +455,7 @@ private:
     // called only by the editor. Note that this is not a const function.
     SkPoint* getWritablePoints() {
         SkDEBUGCODE(this->validate();)
+        this->resetIncrementalState();
         fIsOval = false;
         fIsRRect = false;
         return fPoints.begin();
@@ -498,6 +488,15 @@ private:
 
     mutable uint8_t  fBoundsIsDirty;
     mutable bool     fIsFinite;    // only meaningful if bounds are valid
+    // fBounds and fIsFinite cover this many leading points, so computeBounds() only needs to
+    // look at points appended since.
+    mutable int      fBoundsPointCount = 0;
+
+    // Hash and convexity state, which is extended as the path ref is appended to. Most path refs
+    // never ask for either, so it is only allocated on first use (see incrementalState()).
+    struct IncrementalState;
+    IncrementalState* incrementalState() const;
+    mutable std::atomic<IncrementalState*> fIncrementalState{nullptr};
 
     bool     fIsOval;
     bool     fIsRRect;
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkData.h"
+#include "modules/skottie/include/Skottie.h"
+#include "modules/skottie/utils/SkottieUtils.h"
+#include "tools/Resources.h"
+
+// Renders a range of frames into raster buffers with skottie_utils::RenderFrames(), on one
+// animation clone per thread.  Frames per second = kFrames / time per loop.
+class SkottieFramesBench : public Benchmark {
+public:
+    SkottieFramesBench(const char* name, int threads) : fResource(name), fThreads(threads) {
+        fName.printf("skottie_frames_%s_%dthreads", name, threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        const auto path = SkStringPrintf("skottie/%s.json", fResource);
+        if (auto data = GetResourceAsData(path.c_str())) {
+            fAnimation = skottie::Animation::Builder(skottie::Animation::Builder::kAllowClones)
+                    .make(static_cast<const char*>(data->data()), data->size());
+        }
+
+        fFrames.resize(kFrames);
+        if (fAnimation) {
+            const auto span = fAnimation->outPoint() - fAnimation->inPoint();
+            for (int i = 0; i < kFrames; ++i) {
+                fFrames[i] = span * i / kFrames;
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fAnimation) {
+            return;
+        }
+
+        const auto info = SkImageInfo::MakeN32Premul(kSize, kSize);
+        for (int loop = 0; loop < loops; ++loop) {
+            skottie_utils::RenderFrames(fAnimation, fFrames, info, SK_ColorWHITE, fThreads,
+                                        [](size_t, const SkPixmap&) {});
+        }
+    }
+
+private:
+    static constexpr int kFrames = 120;
+    static constexpr int kSize   = 512;
+
+    const char*               fResource;
+    const int                 fThreads;
+    SkString                  fName;
+    sk_sp<skottie::Animation> fAnimation;
+    std::vector<double>       fFrames;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new SkottieFramesBench("skottie_sample_2", 1); )
+DEF_BENCH( return new SkottieFramesBench("skottie_sample_2", 2); )
+DEF_BENCH( return new SkottieFramesBench("skottie_sample_2", 4); )
+DEF_BENCH( return new SkottieFramesBench("skottie_sample_2", 8); )
+DEF_BENCH( return new SkottieFramesBench("skottie-text-animator-1", 1); )
+DEF_BENCH( return new SkottieFramesBench("skottie-text-animator-1", 2); )
+DEF_BENCH( return new SkottieFramesBench("skottie-text-animator-1", 4); )
+DEF_BENCH( return new SkottieFramesBench("skottie-text-animator-1", 8); )
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkData.h"
+#include "include/core/SkStream.h"
+#include "modules/skottie/include/Skottie.h"
+#include "tools/Resources.h"
+
+// Measures the whole Animation::Builder::make() cost, from either the JSON text or a binary
+// snapshot of it.  Snapshots only skip JSON parsing; building the scene graph and animators
+// (Builder::Stats::fSceneParseTimeMS) costs the same either way.
+class SkottieLoadBench : public Benchmark {
+public:
+    SkottieLoadBench(const char* name, bool snapshot)
+        : fResource(name)
+        , fSnapshot(snapshot) {
+        fName.printf("skottie_load_%s_%s", name, snapshot ? "snapshot" : "json");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        const auto path = SkStringPrintf("skottie/%s.json", fResource);
+        fData = GetResourceAsData(path.c_str());
+        if (fData && fSnapshot) {
+            SkDynamicMemoryWStream stream;
+            skottie::Animation::Builder()
+                    .setSnapshotStream(&stream)
+                    .make(static_cast<const char*>(fData->data()), fData->size());
+            fData = stream.detachAsData();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fData) {
+            return;
+        }
+
+        for (int loop = 0; loop < loops; ++loop) {
+            auto animation = skottie::Animation::Builder(
+                                     skottie::Animation::Builder::kAcceptSnapshots)
+                    .make(static_cast<const char*>(fData->data()), fData->size());
+            SkASSERT(animation);
+        }
+    }
+
+private:
+    const char*   fResource;
+    const bool    fSnapshot;
+    SkString      fName;
+    sk_sp<SkData> fData;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new SkottieLoadBench("skottie_sample_2", false); )
+DEF_BENCH( return new SkottieLoadBench("skottie_sample_2", true ); )
+DEF_BENCH( return new SkottieLoadBench("skottie-text-animator-8", false); )
+DEF_BENCH( return new SkottieLoadBench("skottie-text-animator-8", true ); )
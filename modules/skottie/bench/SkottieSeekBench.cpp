@@ -0,0 +1,85 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkData.h"
+#include "include/private/SkTo.h"
+#include "include/utils/SkRandom.h"
+#include "modules/skottie/include/Skottie.h"
+#include "tools/Resources.h"
+
+#include <vector>
+
+// Measures animation seek cost (keyframe segment lookup, easing and scene graph sync), without
+// rendering.  Seeks either monotonically at a fixed (sub-frame) rate, like a player does, or in
+// random order.
+class SkottieSeekBench : public Benchmark {
+public:
+    SkottieSeekBench(const char* name, bool sequential)
+        : fResource(name)
+        , fSequential(sequential) {
+        fName.printf("skottie_seek_%s_%s", name, sequential ? "sequential" : "random");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        const auto path = SkStringPrintf("skottie/%s.json", fResource);
+        if (auto data = GetResourceAsData(path.c_str())) {
+            fAnimation = skottie::Animation::Make(static_cast<const char*>(data->data()),
+                                                  data->size());
+        }
+        if (!fAnimation) {
+            return;
+        }
+
+        // Four seeks per frame.  seekFrame() is relative to the in-point.
+        const auto span = fAnimation->outPoint() - fAnimation->inPoint();
+        fFrames.resize(static_cast<size_t>(span * 4));
+        for (size_t i = 0; i < fFrames.size(); ++i) {
+            fFrames[i] = i * 0.25;
+        }
+
+        if (!fSequential) {
+            SkRandom rand;
+            for (size_t i = fFrames.size(); i > 1; --i) {
+                std::swap(fFrames[i - 1], fFrames[rand.nextULessThan(SkToU32(i))]);
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fAnimation) {
+            return;
+        }
+
+        for (int loop = 0; loop < loops; ++loop) {
+            for (const auto& t : fFrames) {
+                fAnimation->seekFrame(t);
+            }
+        }
+    }
+
+private:
+    const char*               fResource;
+    const bool                fSequential;
+    SkString                  fName;
+    sk_sp<skottie::Animation> fAnimation;
+    std::vector<double>       fFrames;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new SkottieSeekBench("skottie_sample_2", true ); )
+DEF_BENCH( return new SkottieSeekBench("skottie_sample_2", false); )
+DEF_BENCH( return new SkottieSeekBench("skottie-masking-opaque", true ); )
+DEF_BENCH( return new SkottieSeekBench("skottie-masking-opaque", false); )
+DEF_BENCH( return new SkottieSeekBench("skottie-text-animator-8", true ); )
+DEF_BENCH( return new SkottieSeekBench("skottie-text-animator-8", false); )
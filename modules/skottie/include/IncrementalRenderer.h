@@ -0,0 +1,90 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkottieIncrementalRenderer_DEFINED
+#define SkottieIncrementalRenderer_DEFINED
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "modules/skottie/include/Skottie.h"
+
+#include <memory>
+#include <vector>
+
+class SkCanvas;
+
+namespace sksg { class InvalidationController; }
+
+namespace skottie {
+
+/**
+ * Renders an animation into a retained raster buffer, redrawing only the areas that changed
+ * since the previous frame.  Mostly-static animations then cost a fraction of a full frame.
+ *
+ * Damage is collected while seeking, so the renderer must be the only client seeking the
+ * animation: call invalidate() after seeking it any other way.
+ */
+class SK_API IncrementalRenderer final {
+public:
+    /**
+     * @param animation  The animation to render.  It is scaled to fit the buffer, as with
+     *                   Animation::render(canvas, &dst).
+     * @param info       Describes the retained buffer.
+     * @param flags      Animation::RenderFlags.
+     *
+     * @return nullptr if the buffer cannot be allocated.
+     */
+    static std::unique_ptr<IncrementalRenderer> Make(sk_sp<Animation> animation,
+                                                     const SkImageInfo& info,
+                                                     Animation::RenderFlags flags = 0);
+
+    ~IncrementalRenderer();
+
+    /**
+     * Seeks the animation (see Animation::seekFrame()) and redraws the damaged areas, which are
+     * cleared to transparent first.
+     */
+    void seekFrame(double t);
+
+    /**
+     * Forces the next seekFrame() to redraw the whole buffer.
+     */
+    void invalidate() { fNeedsFullRedraw = true; }
+
+    /**
+     * The current frame.
+     */
+    const SkPixmap& pixmap() const { return fBitmap.pixmap(); }
+
+    /**
+     * The rects (in buffer pixels) redrawn by the last seekFrame().  Empty if nothing changed.
+     */
+    const std::vector<SkIRect>& damage() const { return fDamage; }
+
+private:
+    IncrementalRenderer(sk_sp<Animation>, SkBitmap, Animation::RenderFlags);
+
+    // Coalescing stops at this many rects: each one makes the clip more complex.
+    static constexpr size_t kMaxDamageRects = 8;
+
+    const sk_sp<Animation>                              fAnimation;
+    const SkBitmap                                      fBitmap;
+    const std::unique_ptr<SkCanvas>                     fCanvas;
+    const SkRect                                        fDst;
+    const SkMatrix                                      fMatrix;  // Animation -> buffer.
+    const Animation::RenderFlags                        fFlags;
+    const std::unique_ptr<sksg::InvalidationController> fInvalController;
+
+    std::vector<SkIRect>                                fDamage;
+    bool                                                fNeedsFullRedraw = true;
+};
+
+} // namespace skottie
+
+#endif // SkottieIncrementalRenderer_DEFINED
@@ -23,6 +23,7 @@
 class SkCanvas;
 struct SkRect;
 class SkStream;
+class SkWStream;
 
 namespace skjson { class ObjectValue; }
 
@@ -35,7 +36,12 @@ class Scene;
 
 namespace skottie {
 
-namespace internal { class Animator; }
+namespace internal {
+
+class Animator;
+class SharedAnimationState;
+
+} // namespace internal
 
 using ImageAsset = skresources::ImageAsset;
 using ResourceProvider = skresources::ResourceProvider;
@@ -72,6 +78,10 @@ public:
                                          // frames are only resolved when needed, at seek() time.
             kPreferEmbeddedFonts = 0x02, // Attempt to use the embedded fonts (glyph paths,
                                          // normally used as fallback) over native Skia typefaces.
+            kAllowClones         = 0x04, // Retain the parsed JSON and resolved resources, so the
+                                         // animation can be cloned (see Animation::makeClone()).
+            kAcceptSnapshots     = 0x08, // Also accept binary snapshots (see setSnapshotStream())
+                                         // as input.  Without it, only JSON text is parsed.
         };
 
         explicit Builder(uint32_t flags = 0);
@@ -126,6 +136,19 @@ public:
          */
         Builder& setPrecompInterceptor(sk_sp<PrecompInterceptor>);
 
+        /**
+         * Write a binary snapshot of the parsed JSON to the given stream, on successful make().
+         * Builders created with kAcceptSnapshots can take snapshots in place of the JSON.
+         *
+         * Snapshots only replace JSON parsing (Stats::fJsonParseTimeMS): the animation scene
+         * graph and animators are still built from the loaded JSON DOM on every load
+         * (Stats::fSceneParseTimeMS), so the overall speedup depends on how the two compare.
+         *
+         * Snapshots do not embed external assets: these are still resolved via the
+         * ResourceProvider.  They are not portable across builds with a different pointer size.
+         */
+        Builder& setSnapshotStream(SkWStream*);
+
         /**
          * Animation factories.
          */
@@ -142,6 +165,7 @@ public:
         sk_sp<Logger>             fLogger;
         sk_sp<MarkerObserver  >   fMarkerObserver;
         sk_sp<PrecompInterceptor> fPrecompInterceptor;
+        SkWStream*                fSnapshotStream = nullptr;
         Stats                     fStats;
     };
 
@@ -156,6 +180,25 @@ public:
 
     ~Animation();
 
+    /**
+     * Returns a new instance of this animation, with its own animation state, for rendering
+     * frames concurrently (one instance per thread), or nullptr if the animation was not built
+     * with Builder::kAllowClones.
+     *
+     * Clones skip JSON parsing: they share the parsed JSON, the resolved typefaces, the
+     * single-frame image assets and the text shaping results of the original.  Multi-frame image
+     * assets are requested from the ResourceProvider for each clone, and the PrecompInterceptor
+     * is called for each clone.  PropertyObserver, Logger and MarkerObserver callbacks are only
+     * issued for the original animation.
+     *
+     * Multi-frame assets are stateful, so clones only decode frames in parallel if the
+     * ResourceProvider returns a new instance for each request.  If it returns the same instance
+     * (e.g. skresources::CachingResourceProvider), the clones take turns using it.
+     *
+     * The new instance must be seeked before it is rendered.
+     */
+    sk_sp<Animation> makeClone() const;
+
     enum RenderFlag : uint32_t {
         // When rendering into a known transparent buffer, clients can pass
         // this flag to avoid some unnecessary compositing overhead for
@@ -242,7 +285,8 @@ private:
     Animation(std::unique_ptr<sksg::Scene>,
               std::vector<sk_sp<internal::Animator>>&&,
               SkString ver, const SkSize& size,
-              double inPoint, double outPoint, double duration, double fps, uint32_t flags);
+              double inPoint, double outPoint, double duration, double fps, uint32_t flags,
+              sk_sp<internal::SharedAnimationState>);
 
     const std::unique_ptr<sksg::Scene>           fScene;
     const std::vector<sk_sp<internal::Animator>> fAnimators;
@@ -253,6 +297,7 @@ private:
                                                  fDuration,
                                                  fFPS;
     const uint32_t                               fFlags;
+    const sk_sp<internal::SharedAnimationState>  fShared; // Only with Builder::kAllowClones.
 
     typedef SkNVRefCnt<Animation> INHERITED;
 };
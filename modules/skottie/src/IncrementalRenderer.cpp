@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "modules/skottie/include/IncrementalRenderer.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkRegion.h"
+#include "include/private/SkTo.h"
+#include "modules/sksg/include/SkSGInvalidationController.h"
+#include "src/core/SkTraceEvent.h"
+
+namespace skottie {
+
+std::unique_ptr<IncrementalRenderer> IncrementalRenderer::Make(sk_sp<Animation> animation,
+                                                               const SkImageInfo& info,
+                                                               Animation::RenderFlags flags) {
+    SkBitmap bitmap;
+    if (!animation || !bitmap.tryAllocPixels(info)) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<IncrementalRenderer>(
+            new IncrementalRenderer(std::move(animation), std::move(bitmap), flags));
+}
+
+IncrementalRenderer::IncrementalRenderer(sk_sp<Animation> animation, SkBitmap bitmap,
+                                         Animation::RenderFlags flags)
+    : fAnimation(std::move(animation))
+    , fBitmap(std::move(bitmap))
+    , fCanvas(std::make_unique<SkCanvas>(fBitmap))
+    , fDst(SkRect::Make(fBitmap.bounds()))
+    , fMatrix(SkMatrix::MakeRectToRect(SkRect::MakeSize(fAnimation->size()), fDst,
+                                       SkMatrix::kCenter_ScaleToFit))
+    , fFlags(flags)
+    , fInvalController(std::make_unique<sksg::InvalidationController>()) {}
+
+IncrementalRenderer::~IncrementalRenderer() = default;
+
+void IncrementalRenderer::seekFrame(double t) {
+    TRACE_EVENT0("skottie", TRACE_FUNC);
+
+    fInvalController->reset();
+    fAnimation->seekFrame(t, fInvalController.get());
+
+    const auto bounds = fBitmap.bounds();
+    const auto full_area = static_cast<int64_t>(bounds.width()) * bounds.height();
+
+    if (fNeedsFullRedraw) {
+        fDamage = { bounds };
+    } else {
+        fDamage = fInvalController->coalesce(fMatrix, bounds, kMaxDamageRects);
+
+        // Past about half the frame, clipping costs more than it saves.
+        int64_t damage_area = 0;
+        for (const auto& r : fDamage) {
+            damage_area += static_cast<int64_t>(r.width()) * r.height();
+        }
+        if (damage_area * 2 > full_area) {
+            fDamage = { bounds };
+        }
+    }
+
+    if (fDamage.empty()) {
+        return;
+    }
+
+    SkAutoCanvasRestore acr(fCanvas.get(), true);
+    if (fDamage.size() > 1 || fDamage[0] != bounds) {
+        SkRegion clip;
+        clip.setRects(fDamage.data(), SkToInt(fDamage.size()));
+        fCanvas->clipRegion(clip);
+    }
+
+    fCanvas->clear(SK_ColorTRANSPARENT);
+    fAnimation->render(fCanvas.get(), &fDst, fFlags);
+
+    fNeedsFullRedraw = false;
+}
+
+} // namespace skottie
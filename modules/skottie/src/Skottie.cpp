@@ -123,8 +123,89 @@ static SkBlendMode GetBlendMode(const skjson::ObjectValue& jobject,
     return kBlendModeMap[bm_index];
 }
 
+// Resolves the frame of a single-frame asset once, so clones can share it from any thread.
+class SharedImageAsset final : public ImageAsset {
+public:
+    explicit SharedImageAsset(sk_sp<ImageAsset> asset) : fAsset(std::move(asset)) {}
+
+private:
+    bool isMultiFrame() override { return false; }
+
+    sk_sp<SkImage> getFrame(float t) override {
+        SkAutoMutexExclusive lock(fMutex);
+        if (fAsset) {
+            fFrame = fAsset->getFrame(t);
+            fAsset = nullptr;
+        }
+        return fFrame;
+    }
+
+    SkMutex           fMutex;
+    sk_sp<ImageAsset> fAsset;
+    sk_sp<SkImage>    fFrame;
+};
+
+// Serializes access to a multi-frame asset, for a ResourceProvider that returns the same
+// (stateful) instance to several animations.
+class SerializedImageAsset final : public ImageAsset {
+public:
+    explicit SerializedImageAsset(sk_sp<ImageAsset> asset) : fAsset(std::move(asset)) {}
+
+private:
+    bool isMultiFrame() override { return true; }
+
+    sk_sp<SkImage> getFrame(float t) override {
+        SkAutoMutexExclusive lock(fMutex);
+        return fAsset->getFrame(t);
+    }
+
+    SkMutex                 fMutex;
+    const sk_sp<ImageAsset> fAsset;
+};
+
 } // namespace
 
+SharedAnimationState::SharedAnimationState(std::unique_ptr<skjson::DOM> dom,
+                                           sk_sp<ResourceProvider> rp, sk_sp<SkFontMgr> fontmgr,
+                                           sk_sp<PrecompInterceptor> pi, uint32_t flags)
+    : fDOM(std::move(dom))
+    , fResourceProvider(std::move(rp))
+    , fFontMgr(std::move(fontmgr))
+    , fPrecompInterceptor(std::move(pi))
+    , fShapeCache(sk_make_sp<ShapeCache>())
+    , fFlags(flags) {}
+
+SharedAnimationState::~SharedAnimationState() = default;
+
+const skjson::ObjectValue& SharedAnimationState::root() const {
+    return fDOM->root().as<skjson::ObjectValue>();
+}
+
+sk_sp<ImageAsset> SharedAnimationState::shareImageAsset(const SkString& id,
+                                                        sk_sp<ImageAsset> asset) {
+    if (asset->isMultiFrame()) {
+        // Players are stateful, so clones normally get their own from the ResourceProvider.
+        // The original's is wrapped up front, in case the provider hands it out again.
+        if (const auto* original = fMultiFrameAssets.find(id)) {
+            return original->fAsset == asset ? original->fSerialized : asset;
+        }
+        auto serialized = sk_make_sp<SerializedImageAsset>(asset);
+        fMultiFrameAssets.set(id, { std::move(asset), serialized });
+        return std::move(serialized);
+    }
+
+    asset = sk_make_sp<SharedImageAsset>(std::move(asset));
+    fImageAssets.set(id, asset);
+
+    return asset;
+}
+
+sk_sp<ImageAsset> SharedAnimationState::findImageAsset(const SkString& id) const {
+    const auto* asset = fImageAssets.find(id);
+
+    return asset ? *asset : nullptr;
+}
+
 sk_sp<sksg::RenderNode> AnimationBuilder::attachOpacity(const skjson::ObjectValue& jobject,
                                                         sk_sp<sksg::RenderNode> child_node) const {
     if (!child_node)
@@ -162,7 +243,7 @@ AnimationBuilder::AnimationBuilder(sk_sp<ResourceProvider> rp, sk_sp<SkFontMgr>
                                    sk_sp<MarkerObserver> mobserver, sk_sp<PrecompInterceptor> pi,
                                    Animation::Builder::Stats* stats,
                                    const SkSize& comp_size, float duration, float framerate,
-                                   uint32_t flags)
+                                   uint32_t flags, SharedAnimationState* shared)
     : fResourceProvider(std::move(rp))
     , fLazyFontMgr(std::move(fontmgr))
     , fPropertyObserver(std::move(pobserver))
@@ -174,6 +255,7 @@ AnimationBuilder::AnimationBuilder(sk_sp<ResourceProvider> rp, sk_sp<SkFontMgr>
     , fDuration(duration)
     , fFrameRate(framerate)
     , fFlags(flags)
+    , fShared(shared)
     , fHasNontrivialBlending(false) {}
 
 AnimationBuilder::AnimationInfo AnimationBuilder::parse(const skjson::ObjectValue& jroot) {
@@ -333,6 +415,11 @@ Animation::Builder& Animation::Builder::setPrecompInterceptor(sk_sp<PrecompInter
     return *this;
 }
 
+Animation::Builder& Animation::Builder::setSnapshotStream(SkWStream* stream) {
+    fSnapshotStream = stream;
+    return *this;
+}
+
 sk_sp<Animation> Animation::Builder::make(SkStream* stream) {
     if (!stream->hasLength()) {
         // TODO: handle explicit buffering?
@@ -368,15 +455,17 @@ sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
     fStats.fJsonSize = data_len;
     const auto t0 = std::chrono::steady_clock::now();
 
-    const skjson::DOM dom(data, data_len);
-    if (!dom.root().is<skjson::ObjectValue>()) {
+    auto dom = (fFlags & kAcceptSnapshots) && skjson::DOM::IsSnapshot(data, data_len)
+            ? skjson::DOM::MakeFromSnapshot(data, data_len)
+            : std::make_unique<skjson::DOM>(data, data_len);
+    if (!dom->root().is<skjson::ObjectValue>()) {
         // TODO: more error info.
         if (fLogger) {
             fLogger->log(Logger::Level::kError, "Failed to parse JSON input.\n");
         }
         return nullptr;
     }
-    const auto& json = dom.root().as<skjson::ObjectValue>();
+    const auto& json = dom->root().as<skjson::ObjectValue>();
 
     const auto t1 = std::chrono::steady_clock::now();
     fStats.fJsonParseTimeMS = std::chrono::duration<float, std::milli>{t1-t0}.count();
@@ -401,17 +490,31 @@ sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
         return nullptr;
     }
 
+    if (fSnapshotStream) {
+        dom->writeBinary(fSnapshotStream);
+    }
+    // Writing the snapshot doesn't count as scene construction.
+    const auto t1_scene = std::chrono::steady_clock::now();
+
     SkASSERT(resolvedProvider);
+    sk_sp<internal::SharedAnimationState> shared;
+    if (fFlags & kAllowClones) {
+        shared = sk_make_sp<internal::SharedAnimationState>(std::move(dom), resolvedProvider,
+                                                            fFontMgr, fPrecompInterceptor,
+                                                            fFlags);
+    }
+
     internal::AnimationBuilder builder(std::move(resolvedProvider), fFontMgr,
                                        std::move(fPropertyObserver),
                                        std::move(fLogger),
                                        std::move(fMarkerObserver),
                                        std::move(fPrecompInterceptor),
-                                       &fStats, size, duration, fps, fFlags);
+                                       &fStats, size, duration, fps, fFlags, shared.get());
+    // No need to lock the shared state: no clones can exist yet.
     auto ainfo = builder.parse(json);
 
     const auto t2 = std::chrono::steady_clock::now();
-    fStats.fSceneParseTimeMS = std::chrono::duration<float, std::milli>{t2-t1}.count();
+    fStats.fSceneParseTimeMS = std::chrono::duration<float, std::milli>{t2-t1_scene}.count();
     fStats.fTotalLoadTimeMS  = std::chrono::duration<float, std::milli>{t2-t0}.count();
 
     if (!ainfo.fScene && fLogger) {
@@ -431,7 +534,8 @@ sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
                                           outPoint,
                                           duration,
                                           fps,
-                                          flags));
+                                          flags,
+                                          std::move(shared)));
 }
 
 sk_sp<Animation> Animation::Builder::makeFromFile(const char path[]) {
@@ -444,7 +548,8 @@ sk_sp<Animation> Animation::Builder::makeFromFile(const char path[]) {
 Animation::Animation(std::unique_ptr<sksg::Scene> scene,
                      std::vector<sk_sp<internal::Animator>>&& animators,
                      SkString version, const SkSize& size,
-                     double inPoint, double outPoint, double duration, double fps, uint32_t flags)
+                     double inPoint, double outPoint, double duration, double fps, uint32_t flags,
+                     sk_sp<internal::SharedAnimationState> shared)
     : fScene(std::move(scene))
     , fAnimators(std::move(animators))
     , fVersion(std::move(version))
@@ -453,10 +558,43 @@ Animation::Animation(std::unique_ptr<sksg::Scene> scene,
     , fOutPoint(outPoint)
     , fDuration(duration)
     , fFPS(fps)
-    , fFlags(flags) {}
+    , fFlags(flags)
+    , fShared(std::move(shared)) {}
 
 Animation::~Animation() = default;
 
+sk_sp<Animation> Animation::makeClone() const {
+    TRACE_EVENT0("skottie", TRACE_FUNC);
+
+    if (!fShared) {
+        return nullptr;
+    }
+
+    // Observers and loggers only see the original animation.
+    Builder::Stats stats;
+    internal::AnimationBuilder builder(fShared->fResourceProvider, fShared->fFontMgr,
+                                       nullptr, nullptr, nullptr,
+                                       fShared->fPrecompInterceptor,
+                                       &stats, fSize, fDuration, fFPS, fShared->fFlags,
+                                       fShared.get());
+    internal::AnimationBuilder::AnimationInfo ainfo;
+    {
+        SkAutoMutexExclusive lock(fShared->fBuildMutex);
+        ainfo = builder.parse(fShared->root());
+    }
+
+    return sk_sp<Animation>(new Animation(std::move(ainfo.fScene),
+                                          std::move(ainfo.fAnimators),
+                                          fVersion,
+                                          fSize,
+                                          fInPoint,
+                                          fOutPoint,
+                                          fDuration,
+                                          fFPS,
+                                          fFlags,
+                                          fShared));
+}
+
 void Animation::render(SkCanvas* canvas, const SkRect* dstR) const {
     this->render(canvas, dstR, 0);
 }
@@ -13,6 +13,7 @@
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypeface.h"
+#include "include/private/SkMutex.h"
 #include "include/private/SkTHash.h"
 #include "include/utils/SkCustomTypeface.h"
 #include "modules/skottie/include/SkottieProperty.h"
@@ -20,12 +21,14 @@
 #include "modules/sksg/include/SkSGScene.h"
 #include "src/utils/SkUTF.h"
 
+#include <memory>
 #include <vector>
 
 class SkFontMgr;
 
 namespace skjson {
 class ArrayValue;
+class DOM;
 class ObjectValue;
 class Value;
 } // namespace skjson
@@ -43,18 +46,59 @@ namespace internal {
 // Close-enough to AE.
 static constexpr float kBlurSizeToSigma = 0.3f;
 
+class ShapeCache;
 class TextAdapter;
 class TransformAdapter2D;
 class TransformAdapter3D;
 
 using AnimatorScope = std::vector<sk_sp<Animator>>;
 
+// State shared by an animation built with Animation::Builder::kAllowClones and all of its clones:
+// the parsed JSON, the builder configuration, and whatever resources can safely be used from
+// several animations at once.
+class SharedAnimationState final : public SkRefCnt {
+public:
+    SharedAnimationState(std::unique_ptr<skjson::DOM>, sk_sp<ResourceProvider>, sk_sp<SkFontMgr>,
+                         sk_sp<PrecompInterceptor>, uint32_t flags);
+    ~SharedAnimationState() override;
+
+    const skjson::ObjectValue& root() const;
+
+    // Returns the asset to use for |id|, replacing |asset| with a shared, thread-safe wrapper
+    // if it has a single frame.  Multi-frame assets are stateful, so each animation should have
+    // its own: if the ResourceProvider hands a clone the same instance it gave the original
+    // (e.g. a CachingResourceProvider), they share a wrapper that serializes getFrame().
+    sk_sp<ImageAsset> shareImageAsset(const SkString& id, sk_sp<ImageAsset> asset);
+    sk_sp<ImageAsset> findImageAsset(const SkString& id) const;
+
+    const std::unique_ptr<skjson::DOM>      fDOM;
+    const sk_sp<ResourceProvider>           fResourceProvider;
+    const sk_sp<SkFontMgr>                  fFontMgr;
+    const sk_sp<PrecompInterceptor>         fPrecompInterceptor;
+    const sk_sp<ShapeCache>                 fShapeCache;
+    const uint32_t                          fFlags;
+
+    // Serializes clone builds, which read and update the caches below.
+    SkMutex                                 fBuildMutex;
+
+    bool                                    fHasTypefaces = false;
+    SkTHashMap<SkString, sk_sp<SkTypeface>> fTypefaces;   // By font name.
+    SkTHashMap<SkString, sk_sp<ImageAsset>> fImageAssets; // By asset id.
+
+    struct MultiFrameAsset {
+        sk_sp<ImageAsset> fAsset;       // As loaded for the original animation.
+        sk_sp<ImageAsset> fSerialized;  // What the original (and clones given fAsset) use.
+    };
+    SkTHashMap<SkString, MultiFrameAsset>   fMultiFrameAssets; // By asset id.
+};
+
 class AnimationBuilder final : public SkNoncopyable {
 public:
     AnimationBuilder(sk_sp<ResourceProvider>, sk_sp<SkFontMgr>, sk_sp<PropertyObserver>,
                      sk_sp<Logger>, sk_sp<MarkerObserver>, sk_sp<PrecompInterceptor>,
                      Animation::Builder::Stats*, const SkSize& comp_size,
-                     float duration, float framerate, uint32_t flags);
+                     float duration, float framerate, uint32_t flags,
+                     SharedAnimationState* = nullptr);
 
     struct AnimationInfo {
         std::unique_ptr<sksg::Scene> fScene;
@@ -187,6 +231,8 @@ private:
     void parseFonts (const skjson::ObjectValue* jfonts,
                      const skjson::ArrayValue* jchars);
 
+    void resolveTypefaces(const skjson::ArrayValue* jchars);
+
     // Return true iff all fonts were resolved.
     bool resolveNativeTypefaces();
     bool resolveEmbeddedTypefaces(const skjson::ArrayValue& jchars);
@@ -241,6 +287,7 @@ private:
     const float                fDuration,
                                fFrameRate;
     const uint32_t             fFlags;
+    SharedAnimationState*      fShared;   // Optional.
     mutable AnimatorScope*     fCurrentAnimatorScope;
     mutable const char*        fPropertyObserverContext;
     mutable bool               fHasNontrivialBlending : 1;
@@ -5,21 +5,30 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTextBlob.h"
 #include "include/core/SkTypeface.h"
+#include "modules/skottie/include/IncrementalRenderer.h"
 #include "modules/skottie/include/Skottie.h"
 #include "modules/skottie/include/SkottieProperty.h"
 #include "modules/skottie/src/text/SkottieShaper.h"
 #include "src/core/SkFontDescriptor.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTextBlobPriv.h"
 #include "tests/Test.h"
+#include "tools/Resources.h"
 #include "tools/ToolUtils.h"
 
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -846,3 +855,374 @@ DEF_TEST(Skottie_Image_Loading, reporter) {
         REPORTER_ASSERT(reporter, SkScalarNearlyEqual(multi_asset->requestedFrames()[1], 2));
     }
 }
+
+DEF_TEST(Skottie_Clone, reporter) {
+    static constexpr char json[] = R"({
+                                     "v": "5.2.1",
+                                     "w": 100,
+                                     "h": 100,
+                                     "fr": 10,
+                                     "ip": 0,
+                                     "op": 100,
+                                     "assets": [
+                                       { "id": "single_frame", "p": "a.png", "u": "",
+                                         "w": 50, "h": 50 },
+                                       { "id": "multi_frame" , "p": "b.png", "u": "",
+                                         "w": 50, "h": 50 }
+                                     ],
+                                     "layers": [
+                                       {
+                                         "ty": 2, "refId": "single_frame", "ind": 0,
+                                         "ip": 0, "op": 100, "ks": {}
+                                       },
+                                       {
+                                         "ty": 2, "refId": "multi_frame", "ind": 1,
+                                         "ip": 0, "op": 100,
+                                         "ks": {
+                                           "p": { "a": 1, "k": [
+                                             { "t":  0, "s": [ 0,  0], "e": [50, 50] },
+                                             { "t": 99, "s": [50, 50] }
+                                           ]}
+                                         }
+                                       },
+                                       {
+                                         "ty": 1, "sc": "#00ff00", "sw": 20, "sh": 20, "ind": 2,
+                                         "ip": 0, "op": 100,
+                                         "ks": {
+                                           "r": { "a": 1, "k": [
+                                             { "t":  0, "s": [  0], "e": [360] },
+                                             { "t": 99, "s": [360] }
+                                           ]}
+                                         }
+                                       }
+                                     ]
+                                   })";
+
+    class TestAsset final : public skresources::ImageAsset {
+    public:
+        TestAsset(bool multi_frame, std::atomic<int>* loads, std::atomic<int>* overlaps)
+            : fMultiFrame(multi_frame)
+            , fOverlaps(overlaps) {
+            loads->fetch_add(1);
+        }
+
+    private:
+        bool isMultiFrame() override { return fMultiFrame; }
+
+        sk_sp<SkImage> getFrame(float t) override {
+            // Players are stateful, so count any calls that overlap on the same instance.
+            if (fBusy.exchange(true)) {
+                fOverlaps->fetch_add(1);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            auto surface = SkSurface::MakeRasterN32Premul(50, 50);
+            surface->getCanvas()->clear(fMultiFrame ? SkColorSetRGB(0, 0, (U8CPU)(t * 20))
+                                                    : SK_ColorRED);
+            fBusy = false;
+            return surface->makeImageSnapshot();
+        }
+
+        const bool        fMultiFrame;
+        std::atomic<int>* fOverlaps;
+        std::atomic<bool> fBusy{false};
+    };
+
+    class TestResourceProvider final : public skresources::ResourceProvider {
+    public:
+        std::atomic<int> fSingleFrameLoads{0},
+                         fMultiFrameLoads{0},
+                         fOverlappingFrames{0};
+
+    private:
+        sk_sp<ImageAsset> loadImageAsset(const char[], const char[],
+                                         const char id[]) const override {
+            auto* self = const_cast<TestResourceProvider*>(this);
+            return strcmp(id, "single_frame")
+                    ? sk_make_sp<TestAsset>(true , &self->fMultiFrameLoads,
+                                            &self->fOverlappingFrames)
+                    : sk_make_sp<TestAsset>(false, &self->fSingleFrameLoads,
+                                            &self->fOverlappingFrames);
+        }
+    };
+
+    // Clones are opt-in.
+    REPORTER_ASSERT(reporter, !Animation::Make(json, strlen(json))->makeClone());
+
+    auto rp = sk_make_sp<TestResourceProvider>();
+    auto animation = Animation::Builder(Animation::Builder::kAllowClones)
+                         .setResourceProvider(rp)
+                         .make(json, strlen(json));
+    REPORTER_ASSERT(reporter, animation);
+
+    static constexpr int kClones = 4;
+    std::vector<sk_sp<Animation>> clones;
+    for (int i = 0; i < kClones; ++i) {
+        clones.push_back(animation->makeClone());
+        REPORTER_ASSERT(reporter, clones.back());
+        REPORTER_ASSERT(reporter, clones.back()->duration() == animation->duration());
+        REPORTER_ASSERT(reporter, clones.back()->size() == animation->size());
+    }
+
+    // The single-frame asset is shared, the multi-frame asset is loaded for each clone.
+    REPORTER_ASSERT(reporter, rp->fSingleFrameLoads == 1);
+    REPORTER_ASSERT(reporter, rp->fMultiFrameLoads == 1 + kClones);
+
+    const auto info = SkImageInfo::MakeN32Premul(100, 100);
+    auto render = [&](Animation* anim, double frame, SkBitmap* bm) {
+        bm->allocPixels(info);
+        SkCanvas canvas(*bm);
+        canvas.clear(SK_ColorWHITE);
+        anim->seekFrame(frame);
+        anim->render(&canvas);
+    };
+
+    // Clones seeked concurrently to different frames render the same pixels as the original.
+    static constexpr int kFrames = 16;
+    SkBitmap expected[kFrames], actual[kFrames];
+    for (int i = 0; i < kFrames; ++i) {
+        render(animation.get(), i * 6.5, &expected[i]);
+    }
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(kClones);
+    SkTaskGroup tg(*executor);
+    tg.batch(kClones, [&](int c) {
+        for (int i = c; i < kFrames; i += kClones) {
+            render(clones[c].get(), i * 6.5, &actual[i]);
+        }
+    });
+    tg.wait();
+
+    for (int i = 0; i < kFrames; ++i) {
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected[i], actual[i]), "frame %d", i);
+    }
+    REPORTER_ASSERT(reporter, rp->fOverlappingFrames == 0);
+
+    // A caching provider hands every clone the original's multi-frame asset.  They still render
+    // the same frames, but must take turns with it.
+    {
+        auto cached_rp = sk_make_sp<TestResourceProvider>();
+        auto cached_animation = Animation::Builder(Animation::Builder::kAllowClones)
+                                    .setResourceProvider(
+                                        skresources::CachingResourceProvider::Make(cached_rp))
+                                    .make(json, strlen(json));
+        REPORTER_ASSERT(reporter, cached_animation);
+
+        std::vector<sk_sp<Animation>> cached_clones;
+        for (int i = 0; i < kClones; ++i) {
+            cached_clones.push_back(cached_animation->makeClone());
+        }
+        REPORTER_ASSERT(reporter, cached_rp->fMultiFrameLoads == 1);
+
+        tg.batch(kClones, [&](int c) {
+            for (int i = c; i < kFrames; i += kClones) {
+                render(cached_clones[c].get(), i * 6.5, &actual[i]);
+            }
+        });
+        tg.wait();
+
+        for (int i = 0; i < kFrames; ++i) {
+            REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected[i], actual[i]),
+                            "cached frame %d", i);
+        }
+        REPORTER_ASSERT(reporter, cached_rp->fOverlappingFrames == 0);
+    }
+
+    // Text layers reuse the original's typefaces and shaping results.
+    if (auto data = GetResourceAsData("skottie/skottie-text-animator-1.json")) {
+        auto text_animation = Animation::Builder(Animation::Builder::kAllowClones)
+                                  .make(static_cast<const char*>(data->data()), data->size());
+        REPORTER_ASSERT(reporter, text_animation);
+        auto text_clone = text_animation->makeClone();
+        REPORTER_ASSERT(reporter, text_clone);
+
+        const auto frames = text_animation->outPoint() - text_animation->inPoint();
+        for (int i = 0; i < kFrames; ++i) {
+            SkBitmap a, b;
+            render(text_animation.get(), frames * i / kFrames, &a);
+            render(text_clone.get()    , frames * i / kFrames, &b);
+            REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(a, b), "text frame %d", i);
+        }
+    }
+}
+
+DEF_TEST(Skottie_IncrementalRenderer, reporter) {
+    // Mostly static: a large background, a moving square and a blinking one.
+    static constexpr char json[] = R"({
+                                     "v": "5.2.1",
+                                     "w": 200,
+                                     "h": 100,
+                                     "fr": 10,
+                                     "ip": 0,
+                                     "op": 100,
+                                     "layers": [
+                                       {
+                                         "ty": 1, "sc": "#ff0000", "sw": 10, "sh": 10, "ind": 0,
+                                         "ip": 0, "op": 100,
+                                         "ks": {
+                                           "p": { "a": 1, "k": [
+                                             { "t":  0, "s": [10.5, 10], "e": [90.5, 60] },
+                                             { "t": 99, "s": [90.5, 60] }
+                                           ]},
+                                           "r": { "a": 1, "k": [
+                                             { "t":  0, "s": [0], "e": [90] },
+                                             { "t": 99, "s": [90] }
+                                           ]}
+                                         }
+                                       },
+                                       {
+                                         "ty": 1, "sc": "#0000ff", "sw": 20, "sh": 20, "ind": 1,
+                                         "ip": 0, "op": 100,
+                                         "ks": {
+                                           "p": { "a": 0, "k": [170, 20] },
+                                           "o": { "a": 1, "k": [
+                                             { "t":  0, "s": [100], "e": [0], "h": 1 },
+                                             { "t": 50, "s": [  0] }
+                                           ]}
+                                         }
+                                       },
+                                       {
+                                         "ty": 1, "sc": "#00ff00", "sw": 200, "sh": 100, "ind": 2,
+                                         "ip": 0, "op": 100, "ks": {}
+                                       }
+                                     ]
+                                   })";
+
+    // Scan conversion may take a different (equivalent) path under a clip, so anti-aliased
+    // edges can be off by a bit -- and mattes amplify that.  Hence the optional tolerance.
+    auto matches = [](const SkPixmap& a, const SkPixmap& b, int tolerance) {
+        for (int y = 0; y < a.height(); ++y) {
+            for (int x = 0; x < a.width(); ++x) {
+                const auto ca = *a.addr32(x, y),
+                           cb = *b.addr32(x, y);
+                for (int shift = 0; shift < 32; shift += 8) {
+                    if (std::abs(int((ca >> shift) & 0xff) -
+                                 int((cb >> shift) & 0xff)) > tolerance) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    };
+
+    auto check = [&](const sk_sp<Animation>& animation, const SkImageInfo& info,
+                     const char* name, int tolerance) {
+        auto renderer = IncrementalRenderer::Make(animation, info);
+        REPORTER_ASSERT(reporter, renderer);
+
+        const auto dst = SkRect::Make(info.bounds());
+        const auto frames = animation->outPoint() - animation->inPoint();
+        size_t partial_frames = 0;
+        for (int i = 0; i <= 20; ++i) {
+            const auto t = frames * i / 20;
+            renderer->seekFrame(t);
+
+            const auto& damage = renderer->damage();
+            partial_frames += !damage.empty() && damage[0] != info.bounds();
+
+            SkBitmap expected;
+            expected.allocPixels(info);
+            SkCanvas canvas(expected);
+            canvas.clear(SK_ColorTRANSPARENT);
+            animation->seekFrame(t);
+            animation->render(&canvas, &dst);
+
+            REPORTER_ASSERT(reporter, matches(expected.pixmap(), renderer->pixmap(), tolerance),
+                            "%s frame %d", name, i);
+        }
+
+        return partial_frames;
+    };
+
+    auto animation = Animation::Make(json, strlen(json));
+    const auto info = SkImageInfo::MakeN32Premul(300, 150);
+    REPORTER_ASSERT(reporter, check(animation, info, "inline", 0) == 20);
+
+    // Damage is small, and nothing is redrawn when nothing changes.
+    auto renderer = IncrementalRenderer::Make(animation, info);
+    renderer->seekFrame(0);
+    REPORTER_ASSERT(reporter, renderer->damage().size() == 1 &&
+                              renderer->damage()[0] == info.bounds());
+    renderer->seekFrame(10);
+    for (const auto& r : renderer->damage()) {
+        REPORTER_ASSERT(reporter, r.width() < 60 && r.height() < 60);
+    }
+    renderer->seekFrame(60);
+    renderer->seekFrame(70);
+    REPORTER_ASSERT(reporter, renderer->damage().size() == 1);
+    renderer->seekFrame(99);
+    renderer->seekFrame(99);
+    REPORTER_ASSERT(reporter, renderer->damage().empty());
+
+    // After invalidate(), everything is redrawn.
+    renderer->invalidate();
+    renderer->seekFrame(99);
+    REPORTER_ASSERT(reporter, renderer->damage().size() == 1 &&
+                              renderer->damage()[0] == info.bounds());
+
+    for (const char* res : { "skottie/skottie_sample_2.json",
+                             "skottie/skottie-text-animator-1.json",
+                             "skottie/skottie-luma-matte.json" }) {
+        if (auto data = GetResourceAsData(res)) {
+            check(Animation::Make(static_cast<const char*>(data->data()), data->size()),
+                  SkImageInfo::MakeN32Premul(250, 250), res, 16);
+        }
+    }
+}
+
+DEF_TEST(Skottie_Snapshot, reporter) {
+    auto render = [](const sk_sp<Animation>& animation, double t) {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::MakeN32Premul(200, 200));
+        SkCanvas canvas(bm);
+        canvas.clear(SK_ColorTRANSPARENT);
+        const auto dst = SkRect::MakeIWH(200, 200);
+        animation->seekFrame(t);
+        animation->render(&canvas, &dst);
+        return bm;
+    };
+
+    for (const char* res : { "skottie/skottie_sample_2.json",
+                             "skottie/skottie-text-animator-1.json",
+                             "skottie/skottie-luma-matte.json" }) {
+        auto data = GetResourceAsData(res);
+        if (!data) {
+            continue;
+        }
+
+        SkDynamicMemoryWStream wstream;
+        auto builder = Animation::Builder();
+        auto animation = builder.setSnapshotStream(&wstream)
+                                .make(static_cast<const char*>(data->data()), data->size());
+        REPORTER_ASSERT(reporter, animation, "%s", res);
+        const auto snapshot = wstream.detachAsData();
+        REPORTER_ASSERT(reporter, snapshot->size() > 0, "%s", res);
+
+        // Snapshots are only accepted by opted-in builders, and yield identical animations.
+        REPORTER_ASSERT(reporter, !Animation::Make(static_cast<const char*>(snapshot->data()),
+                                                   snapshot->size()), "%s", res);
+        auto snapshot_animation = Animation::Builder(Animation::Builder::kAcceptSnapshots)
+                                      .make(static_cast<const char*>(snapshot->data()),
+                                            snapshot->size());
+        REPORTER_ASSERT(reporter, snapshot_animation, "%s", res);
+        if (!animation || !snapshot_animation) {
+            continue;
+        }
+        REPORTER_ASSERT(reporter, snapshot_animation->size()     == animation->size());
+        REPORTER_ASSERT(reporter, snapshot_animation->duration() == animation->duration());
+
+        const auto frames = animation->outPoint() - animation->inPoint();
+        for (int i = 0; i <= 4; ++i) {
+            const auto t = frames * i / 4;
+            REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(render(animation, t).pixmap(),
+                                                              render(snapshot_animation,
+                                                                     t).pixmap()),
+                            "%s frame %d", res, i);
+        }
+
+        // Truncated snapshots are rejected.
+        REPORTER_ASSERT(reporter, !Animation::Builder(Animation::Builder::kAcceptSnapshots)
+                                       .make(static_cast<const char*>(snapshot->data()),
+                                             snapshot->size() / 2));
+    }
+}
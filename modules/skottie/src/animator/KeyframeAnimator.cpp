@@ -7,12 +7,85 @@
 
 #include "modules/skottie/src/animator/KeyframeAnimator.h"
 
+#include "include/core/SkCubicMap.h"
 #include "modules/skottie/src/SkottieJson.h"
 
+#include <algorithm>
+#include <cmath>
+
 #define DUMP_KF_RECORDS 0
 
 namespace skottie::internal {
 
+namespace {
+
+float eval_poly(const float coeff[3], float t) {
+    return ((coeff[0] * t + coeff[1]) * t + coeff[2]) * t;
+}
+
+} // namespace
+
+CubicEasing::CubicEasing(SkPoint c0, SkPoint c1) {
+    // Clamp X values only (we allow Ys outside [0..1]), as SkCubicMap does.
+    // This keeps x(t) monotonic.
+    c0.fX = SkTPin(c0.fX, 0.0f, 1.0f);
+    c1.fX = SkTPin(c1.fX, 0.0f, 1.0f);
+
+    fXCoeff[0] = 1 + 3 * c0.fX - 3 * c1.fX;
+    fXCoeff[1] = 3 * c1.fX - 6 * c0.fX;
+    fXCoeff[2] = 3 * c0.fX;
+    fYCoeff[0] = 1 + 3 * c0.fY - 3 * c1.fY;
+    fYCoeff[1] = 3 * c1.fY - 6 * c0.fY;
+    fYCoeff[2] = 3 * c0.fY;
+
+    fT[0] = 0;
+    for (int i = 1; i < kLUTSize; ++i) {
+        const auto x = static_cast<float>(i) / kLUTSize;
+        fT[i] = this->solveT(x, fT[i - 1], 1, std::max(fT[i - 1], x));
+    }
+    fT[kLUTSize] = 1;
+}
+
+float CubicEasing::solveT(float x, float t0, float t1, float t) const {
+    // Same tolerance as SkCubicMap.
+    static constexpr float kTolerance     = 0.00005f;
+    static constexpr int   kMaxIterations = 24;
+
+    for (int i = 0; i < kMaxIterations; ++i) {
+        const auto f = eval_poly(fXCoeff, t) - x;
+        if (std::abs(f) <= kTolerance) {
+            break;
+        }
+
+        // x(t) is monotonic, so f tells us which side of the root we're on.
+        if (f < 0) {
+            t0 = t;
+        } else {
+            t1 = t;
+        }
+
+        // Newton step, falling back to bisection when it leaves the bracket
+        // (or when the derivative vanishes, at the ends of some curves).
+        const auto fp = (3 * fXCoeff[0] * t + 2 * fXCoeff[1]) * t + fXCoeff[2];
+        const auto tn = t - f / fp;
+        t = (tn > t0 && tn < t1) ? tn : (t0 + t1) * 0.5f;
+    }
+
+    return t;
+}
+
+float CubicEasing::computeYFromX(float x) const {
+    x = SkTPin(x, 0.0f, 1.0f);
+
+    // Seed the solver with the t interpolated from the two closest table entries.
+    const auto fi = x * kLUTSize;
+    const auto i  = std::min(static_cast<int>(fi), kLUTSize - 1);
+    const auto t0 = fT[i],
+               t1 = fT[i + 1];
+
+    return eval_poly(fYCoeff, this->solveT(x, t0, t1, t0 + (t1 - t0) * (fi - i)));
+}
+
 KeyframeAnimator::~KeyframeAnimator() = default;
 
 KeyframeAnimator::LERPInfo KeyframeAnimator::getLERPInfo(float t) const {
@@ -29,7 +102,12 @@ KeyframeAnimator::LERPInfo KeyframeAnimator::getLERPInfo(float t) const {
 
     // Cache the current segment (most queries have good locality).
     if (!fCurrentSegment.contains(t)) {
-        fCurrentSegment = this->find_segment(t);
+        // Players typically seek forward at a fixed rate, so try the next segment before
+        // searching.
+        const auto* kf1 = fCurrentSegment.kf1;
+        const KFSegment next = kf1 && kf1 < &fKFs.back() ? KFSegment{ kf1, kf1 + 1 }
+                                                         : KFSegment{ nullptr, nullptr };
+        fCurrentSegment = next.contains(t) ? next : this->find_segment(t);
     }
     SkASSERT(fCurrentSegment.contains(t));
 
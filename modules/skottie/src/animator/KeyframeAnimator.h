@@ -8,7 +8,6 @@
 #ifndef SkottieKeyframeAnimator_DEFINED
 #define SkottieKeyframeAnimator_DEFINED
 
-#include "include/core/SkCubicMap.h"
 #include "include/core/SkPoint.h"
 #include "include/private/SkNoncopyable.h"
 #include "modules/skottie/src/animator/Animator.h"
@@ -53,6 +52,29 @@ struct Keyframe {
     static constexpr uint32_t kCubicIndexOffset = 2;
 };
 
+// Cubic Bezier easing (maps a linear segment weight to an eased weight).
+//
+// Like SkCubicMap, but the x -> t inversion starts from a precomputed table of t values at
+// evenly spaced xs: most lookups land within tolerance straight from the table, and the rest
+// typically take a single safeguarded Newton step (instead of several Halley iterations from a
+// linear guess).
+class CubicEasing {
+public:
+    CubicEasing(SkPoint c0, SkPoint c1);
+
+    float computeYFromX(float x) const;
+
+private:
+    static constexpr int kLUTSize = 64;
+
+    // Returns the t in [t0..t1] for which x(t) == x, starting from |t|.
+    float solveT(float x, float t0, float t1, float t) const;
+
+    float fXCoeff[3],            // x(t) = ((a*t + b)*t + c)*t
+          fYCoeff[3],            // y(t) = ((a*t + b)*t + c)*t
+          fT[kLUTSize + 1];      // t values for x = i / kLUTSize
+};
+
 class KeyframeAnimator : public Animator {
 public:
     ~KeyframeAnimator() override;
@@ -65,7 +87,7 @@ public:
     }
 
 protected:
-    KeyframeAnimator(std::vector<Keyframe> kfs, std::vector<SkCubicMap> cms)
+    KeyframeAnimator(std::vector<Keyframe> kfs, std::vector<CubicEasing> cms)
         : fKFs(std::move(kfs))
         , fCMs(std::move(cms)) {}
 
@@ -99,9 +121,9 @@ private:
     // Given a |t| and a containing KFSegment, compute the local interpolation weight.
     float compute_weight(const KFSegment& seg, float t) const;
 
-    const std::vector<Keyframe>   fKFs; // Keyframe records, one per AE/Lottie keyframe.
-    const std::vector<SkCubicMap> fCMs; // Optional cubic mappers (Bezier interpolation).
-    mutable KFSegment             fCurrentSegment = { nullptr, nullptr }; // Cached segment.
+    const std::vector<Keyframe>    fKFs; // Keyframe records, one per AE/Lottie keyframe.
+    const std::vector<CubicEasing> fCMs; // Optional cubic mappers (Bezier interpolation).
+    mutable KFSegment              fCurrentSegment = { nullptr, nullptr }; // Cached segment.
 };
 
 class KeyframeAnimatorBuilder : public SkNoncopyable {
@@ -120,8 +142,8 @@ protected:
 
     bool parseKeyframes(const AnimationBuilder&, const skjson::ArrayValue&);
 
-    std::vector<Keyframe>   fKFs; // Keyframe records, one per AE/Lottie keyframe.
-    std::vector<SkCubicMap> fCMs; // Optional cubic mappers (Bezier interpolation).
+    std::vector<Keyframe>    fKFs; // Keyframe records, one per AE/Lottie keyframe.
+    std::vector<CubicEasing> fCMs; // Optional cubic mappers (Bezier interpolation).
 
 private:
     uint32_t parseMapping(const skjson::ObjectValue&);
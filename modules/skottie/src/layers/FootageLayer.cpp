@@ -81,11 +81,18 @@ AnimationBuilder::loadFootageAsset(const skjson::ObjectValue& jimage) const {
         return cached_info;
     }
 
-    auto asset = fResourceProvider->loadImageAsset(path->begin(), name->begin(), id->begin());
+    auto asset = fShared ? fShared->findImageAsset(res_id) : nullptr;
     if (!asset) {
-        this->log(Logger::Level::kError, nullptr, "Could not load image asset: %s/%s (id: '%s').",
-                  path->begin(), name->begin(), id->begin());
-        return nullptr;
+        asset = fResourceProvider->loadImageAsset(path->begin(), name->begin(), id->begin());
+        if (!asset) {
+            this->log(Logger::Level::kError, nullptr,
+                      "Could not load image asset: %s/%s (id: '%s').",
+                      path->begin(), name->begin(), id->begin());
+            return nullptr;
+        }
+        if (fShared) {
+            asset = fShared->shareImageAsset(res_id, std::move(asset));
+        }
     }
 
     const auto size = SkISize::Make(ParseDefault<int>(jimage["w"], 0),
@@ -228,6 +228,27 @@ void AnimationBuilder::parseFonts(const skjson::ObjectValue* jfonts,
                   });
     }
 
+    // Clones reuse the typefaces resolved for the original animation.
+    if (fShared && fShared->fHasTypefaces) {
+        fFonts.foreach([this](const SkString& name, FontInfo* finfo) {
+            if (const auto* typeface = fShared->fTypefaces.find(name)) {
+                finfo->fTypeface = *typeface;
+            }
+        });
+        return;
+    }
+
+    this->resolveTypefaces(jchars);
+
+    if (fShared) {
+        fFonts.foreach([this](const SkString& name, FontInfo* finfo) {
+            fShared->fTypefaces.set(name, finfo->fTypeface);
+        });
+        fShared->fHasTypefaces = true;
+    }
+}
+
+void AnimationBuilder::resolveTypefaces(const skjson::ArrayValue* jchars) {
     // Optional pass.
     if (jchars && (fFlags & Animation::Builder::kPreferEmbeddedFonts) &&
         this->resolveEmbeddedTypefaces(*jchars)) {
@@ -397,7 +418,8 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachTextLayer(const skjson::ObjectVa
     return this->attachDiscardableAdapter<TextAdapter>(jlayer,
                                                        this,
                                                        fLazyFontMgr.getMaybeNull(),
-                                                       fLogger);
+                                                       fLogger,
+                                                       fShared ? fShared->fShapeCache : nullptr);
 }
 #endif
 
@@ -9,6 +9,7 @@
 
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkTypeface.h"
 #include "modules/skottie/src/SkottieJson.h"
 #include "modules/skottie/src/text/RangeSelector.h"
 #include "modules/skottie/src/text/TextAnimator.h"
@@ -20,12 +21,62 @@
 #include "modules/sksg/include/SkSGText.h"
 #include "modules/sksg/include/SkSGTransform.h"
 
+#include <string.h>
+
 namespace skottie {
 namespace internal {
 
+Shaper::Result ShapeCache::shape(const SkString& text, const Shaper::TextDesc& desc,
+                                 const SkRect& box, const sk_sp<SkFontMgr>& fontmgr) {
+    // The key is the text followed by the remaining shaping inputs, as raw bytes.
+    struct {
+        SkRect               fBox;
+        SkScalar             fTextSize,
+                             fLineHeight,
+                             fAscent;
+        uint32_t             fTypefaceID,
+                             fFlags;
+        SkTextUtils::Align   fHAlign;
+        Shaper::VAlign       fVAlign;
+        Shaper::ResizePolicy fResize;
+    } params;
+    memset(&params, 0, sizeof(params));
+    params.fBox        = box;
+    params.fTextSize   = desc.fTextSize;
+    params.fLineHeight = desc.fLineHeight;
+    params.fAscent     = desc.fAscent;
+    params.fTypefaceID = desc.fTypeface ? desc.fTypeface->uniqueID() : 0;
+    params.fFlags      = desc.fFlags;
+    params.fHAlign     = desc.fHAlign;
+    params.fVAlign     = desc.fVAlign;
+    params.fResize     = desc.fResize;
+
+    SkString key(text);
+    key.append(reinterpret_cast<const char*>(&params), sizeof(params));
+
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        if (const auto* result = fResults.find(key)) {
+            return *result;
+        }
+    }
+
+    // Shape outside the lock: clones racing on the same text just do redundant work.
+    auto result = Shaper::Shape(text, desc, box, fontmgr);
+
+    SkAutoMutexExclusive lock(fMutex);
+    if (fResults.count() >= kMaxEntries) {
+        fResults.reset();
+    }
+    fResults.set(std::move(key), result);
+
+    return result;
+}
+
 sk_sp<TextAdapter> TextAdapter::Make(const skjson::ObjectValue& jlayer,
                                      const AnimationBuilder* abuilder,
-                                     sk_sp<SkFontMgr> fontmgr, sk_sp<Logger> logger) {
+                                     sk_sp<SkFontMgr> fontmgr, sk_sp<Logger> logger,
+                                     sk_sp<ShapeCache> shape_cache) {
     // General text node format:
     // "t": {
     //    "a": [], // animators (see TextAnimator)
@@ -79,6 +130,7 @@ sk_sp<TextAdapter> TextAdapter::Make(const skjson::ObjectValue& jlayer,
 
     auto adapter = sk_sp<TextAdapter>(new TextAdapter(std::move(fontmgr),
                                                       std::move(logger),
+                                                      std::move(shape_cache),
                                                       gGroupingMap[SkToSizeT(apg - 1)]));
 
     adapter->bind(*abuilder, jd, adapter->fText.fCurrentValue);
@@ -105,10 +157,12 @@ sk_sp<TextAdapter> TextAdapter::Make(const skjson::ObjectValue& jlayer,
     return adapter;
 }
 
-TextAdapter::TextAdapter(sk_sp<SkFontMgr> fontmgr, sk_sp<Logger> logger, AnchorPointGrouping apg)
+TextAdapter::TextAdapter(sk_sp<SkFontMgr> fontmgr, sk_sp<Logger> logger,
+                         sk_sp<ShapeCache> shape_cache, AnchorPointGrouping apg)
     : fRoot(sksg::Group::Make())
     , fFontMgr(std::move(fontmgr))
     , fLogger(std::move(logger))
+    , fShapeCache(std::move(shape_cache))
     , fAnchorPointGrouping(apg)
     , fHasBlurAnimator(false)
     , fRequiresAnchorPoint(false) {}
@@ -275,7 +329,9 @@ void TextAdapter::reshape() {
         fText->fResize,
         this->shaperFlags(),
     };
-    const auto shape_result = Shaper::Shape(fText->fText, text_desc, fText->fBox, fFontMgr);
+    const auto shape_result = fShapeCache
+            ? fShapeCache->shape(fText->fText, text_desc, fText->fBox, fFontMgr)
+            : Shaper::Shape(fText->fText, text_desc, fText->fBox, fFontMgr);
 
     if (fLogger && shape_result.fMissingGlyphCount > 0) {
         const auto msg = SkStringPrintf("Missing %zu glyphs for '%s'.",
@@ -8,6 +8,9 @@
 #ifndef SkottieTextAdapter_DEFINED
 #define SkottieTextAdapter_DEFINED
 
+#include "include/core/SkTextBlob.h"
+#include "include/private/SkMutex.h"
+#include "include/private/SkTHash.h"
 #include "modules/skottie/src/animator/Animator.h"
 #include "modules/skottie/src/text/SkottieShaper.h"
 #include "modules/skottie/src/text/TextAnimator.h"
@@ -27,10 +30,25 @@ class Matrix;
 namespace skottie {
 namespace internal {
 
+// Thread-safe cache of shaping results, shared by the clones of an animation (see
+// Animation::makeClone()) so that each distinct text value is only shaped once.
+class ShapeCache final : public SkRefCnt {
+public:
+    Shaper::Result shape(const SkString& text, const Shaper::TextDesc&, const SkRect& box,
+                         const sk_sp<SkFontMgr>&);
+
+private:
+    // Entries are dropped wholesale when the cache fills up.
+    static constexpr int kMaxEntries = 256;
+
+    SkMutex                              fMutex;
+    SkTHashMap<SkString, Shaper::Result> fResults;
+};
+
 class TextAdapter final : public AnimatablePropertyContainer {
 public:
     static sk_sp<TextAdapter> Make(const skjson::ObjectValue&, const AnimationBuilder*,
-                                   sk_sp<SkFontMgr>, sk_sp<Logger>);
+                                   sk_sp<SkFontMgr>, sk_sp<Logger>, sk_sp<ShapeCache>);
 
     ~TextAdapter() override;
 
@@ -50,7 +68,7 @@ private:
         kAll,
     };
 
-    TextAdapter(sk_sp<SkFontMgr>, sk_sp<Logger>, AnchorPointGrouping);
+    TextAdapter(sk_sp<SkFontMgr>, sk_sp<Logger>, sk_sp<ShapeCache>, AnchorPointGrouping);
 
     struct FragmentRec {
         SkPoint                      fOrigin; // fragment position
@@ -83,6 +101,7 @@ private:
     const sk_sp<sksg::Group>         fRoot;
     const sk_sp<SkFontMgr>           fFontMgr;
     sk_sp<Logger>                    fLogger;
+    const sk_sp<ShapeCache>          fShapeCache; // Optional.
     const AnchorPointGrouping        fAnchorPointGrouping;
 
     std::vector<sk_sp<TextAnimator>> fAnimators;
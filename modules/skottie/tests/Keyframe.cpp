@@ -5,10 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkCubicMap.h"
+#include "include/utils/SkRandom.h"
 #include "modules/skottie/include/ExternalLayer.h"
 #include "modules/skottie/src/SkottiePriv.h"
 #include "modules/skottie/src/SkottieValue.h"
 #include "modules/skottie/src/animator/Animator.h"
+#include "modules/skottie/src/animator/KeyframeAnimator.h"
 #include "src/utils/SkJSON.h"
 #include "tests/Test.h"
 
@@ -134,4 +137,56 @@ DEF_TEST(Skottie_Keyframe, reporter) {
         REPORTER_ASSERT(reporter, SkScalarNearlyEqual(prop(3  ), 4));
         REPORTER_ASSERT(reporter, SkScalarNearlyEqual(prop(4  ), 4));
     }
+    {
+        // Cubic easing, seeked in various orders (exercising the segment cursor).
+        MockProperty<ScalarValue> prop(R"({
+                                         "a": 1,
+                                         "k": [
+                                           { "t": 0, "s": 0,
+                                             "o": { "x": 0.9, "y": 0 }, "i": { "x": 1, "y": 1 } },
+                                           { "t": 1, "s": 1,
+                                             "o": { "x": 0.4, "y": 0 }, "i": { "x": 0.2, "y": 1 } },
+                                           { "t": 2, "s": 2,
+                                             "o": { "x": 0, "y": 0.5 }, "i": { "x": 1, "y": 0.5 } },
+                                           { "t": 3, "s": 4,
+                                             "o": { "x": 0, "y": -1 }, "i": { "x": 1, "y": 2 } },
+                                           { "t": 4, "s": 8,
+                                             "o": { "x": 0, "y": 0 }, "i": { "x": 0, "y": 1 } },
+                                           { "t": 5, "s": 6 }
+                                         ]
+                                       })");
+        REPORTER_ASSERT(reporter, prop);
+
+        const SkCubicMap cms[] = {
+            SkCubicMap({0.9f,    0}, {   1,    1}),
+            SkCubicMap({0.4f,    0}, {0.2f,    1}),
+            SkCubicMap({   0, 0.5f}, {   1, 0.5f}),
+            SkCubicMap({   0,   -1}, {   1,    2}),
+            SkCubicMap({   0,    0}, {   0,    1}),
+        };
+        const float vs[] = { 0, 1, 2, 4, 8, 6 };
+
+        auto expected = [&](float t) {
+            if (t <= 0) { return vs[0]; }
+            if (t >= 5) { return vs[5]; }
+            const auto i = static_cast<int>(t);
+            return Lerp(vs[i], vs[i + 1], cms[i].computeYFromX(t - i));
+        };
+        auto check = [&](float t) {
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(prop(t), expected(t), 0.001f),
+                            "t: %g, got %g expected %g", t, prop(t), expected(t));
+        };
+
+        static constexpr int kSteps = 300;
+        for (int i = -10; i <= kSteps + 10; ++i) {
+            check(5.0f * i / kSteps);
+        }
+        for (int i = kSteps; i >= 0; --i) {
+            check(5.0f * i / kSteps);
+        }
+        SkRandom rand;
+        for (int i = 0; i < kSteps; ++i) {
+            check(rand.nextRangeF(0, 5));
+        }
+    }
 }
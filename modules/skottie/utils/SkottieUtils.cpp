@@ -7,6 +7,14 @@
 
 #include "modules/skottie/utils/SkottieUtils.h"
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/private/SkTo.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+
 namespace skottie_utils {
 
 class CustomPropertyManager::PropertyInterceptor final : public skottie::PropertyObserver {
@@ -228,4 +236,75 @@ sk_sp<skottie::ExternalLayer> ExternalAnimationPrecompInterceptor::onLoadPrecomp
                 : nullptr;
 }
 
+bool RenderFrames(const sk_sp<skottie::Animation>& animation, const std::vector<double>& frames,
+                  const SkImageInfo& info, SkColor background, int threads,
+                  const FrameProc& proc) {
+    threads = std::max(threads, 1);
+
+    std::vector<sk_sp<skottie::Animation>> clones = { animation };
+    for (int i = 1; i < threads; ++i) {
+        auto clone = animation->makeClone();
+        if (!clone) {
+            return false;
+        }
+        clones.push_back(std::move(clone));
+    }
+
+    const auto dst = SkRect::Make(info.bounds());
+    const auto render = [&](skottie::Animation* anim, double frame, SkBitmap* bitmap) {
+        SkCanvas canvas(*bitmap);
+        canvas.clear(background);
+        anim->seekFrame(frame);
+        anim->render(&canvas, &dst);
+    };
+
+    if (threads == 1) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        for (size_t i = 0; i < frames.size(); ++i) {
+            render(animation.get(), frames[i], &bitmap);
+            proc(i, bitmap.pixmap());
+        }
+        return true;
+    }
+
+    // Frames are rendered in batches of one frame per clone, into two sets of buffers: batch
+    // n + 1 renders while batch n is handed to |proc|.
+    std::vector<SkBitmap> bitmaps(2 * threads);
+    for (auto& bitmap : bitmaps) {
+        bitmap.allocPixels(info);
+    }
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(threads);
+    SkTaskGroup tg(*executor);
+
+    const auto render_batch = [&](size_t first) {
+        const auto count = std::min(frames.size() - first, static_cast<size_t>(threads));
+        tg.batch(SkToInt(count), [&, first](int i) {
+            const auto index = first + i;
+            render(clones[i].get(), frames[index], &bitmaps[index % bitmaps.size()]);
+        });
+    };
+
+    if (!frames.empty()) {
+        render_batch(0);
+    }
+    for (size_t first = 0; first < frames.size(); first += threads) {
+        tg.wait();
+
+        const auto next = first + threads;
+        if (next < frames.size()) {
+            render_batch(next);
+        }
+
+        const auto last = std::min(next, frames.size());
+        for (size_t i = first; i < last; ++i) {
+            proc(i, bitmaps[i % bitmaps.size()].pixmap());
+        }
+    }
+    tg.wait();
+
+    return true;
+}
+
 } // namespace skottie_utils
@@ -8,15 +8,20 @@
 #ifndef SkottieUtils_DEFINED
 #define SkottieUtils_DEFINED
 
+#include "include/core/SkColor.h"
+#include "include/core/SkImageInfo.h"
 #include "modules/skottie/include/ExternalLayer.h"
 #include "modules/skottie/include/Skottie.h"
 #include "modules/skottie/include/SkottieProperty.h"
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+class SkPixmap;
+
 namespace skottie_utils {
 
 /**
@@ -122,6 +127,21 @@ private:
     const SkString                             fPrefix;
 };
 
+/**
+ * Renders the given frames (in Animation::seekFrame() units) of an animation into raster buffers
+ * described by |info|, on |threads| threads: each thread renders every |threads|-th frame on its
+ * own clone of the animation.  Frames are cleared to |background|, and the animation is scaled to
+ * fit the buffer.
+ *
+ * |proc| receives each frame, in order, on the calling thread; while it runs, the next few frames
+ * are being rendered.
+ *
+ * Returns false if |threads| > 1 and the animation could not be cloned (see
+ * Animation::Builder::kAllowClones).
+ */
+using FrameProc = std::function<void(size_t index, const SkPixmap&)>;
+bool RenderFrames(const sk_sp<skottie::Animation>&, const std::vector<double>& frames,
+                  const SkImageInfo& info, SkColor background, int threads, const FrameProc&);
 
 } // namespace skottie_utils
 
@@ -9,12 +9,11 @@
 #define SkSGInvalidationController_DEFINED
 
 #include "include/core/SkMatrix.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkTypes.h"
 
 #include <vector>
 
-struct SkRect;
-
 namespace sksg {
 
 /**
@@ -35,6 +34,16 @@ public:
     auto begin() const { return fRects.cbegin(); }
     auto   end() const { return fRects.cend();   }
 
+    /**
+     * Returns the damaged device pixels: the invalidated rects mapped by |ctm|, rounded out with
+     * an extra pixel for antialiasing, and clipped to |clip|.
+     *
+     * Rects are coalesced whenever their bounding rect is no larger than their combined areas,
+     * and then pairwise (cheapest first) until there are no more than |maxRects|.
+     */
+    std::vector<SkIRect> coalesce(const SkMatrix& ctm, const SkIRect& clip,
+                                  size_t maxRects) const;
+
     void reset();
 
 private:
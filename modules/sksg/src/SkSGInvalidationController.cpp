@@ -10,8 +10,29 @@
 #include "include/core/SkRect.h"
 #include "src/core/SkTLazy.h"
 
+#include <algorithm>
+
 namespace sksg {
 
+namespace {
+
+int64_t area(const SkIRect& r) {
+    return static_cast<int64_t>(r.width()) * r.height();
+}
+
+SkIRect join(const SkIRect& a, const SkIRect& b) {
+    auto r = a;
+    r.join(b);
+    return r;
+}
+
+// Extra pixels covered by the bounding rect of a and b, over covering them separately.
+int64_t merge_cost(const SkIRect& a, const SkIRect& b) {
+    return area(join(a, b)) - area(a) - area(b);
+}
+
+} // namespace
+
 InvalidationController::InvalidationController() : fBounds(SkRect::MakeEmpty()) {}
 
 void InvalidationController::inval(const SkRect& r, const SkMatrix& ctm) {
@@ -29,6 +50,61 @@ void InvalidationController::inval(const SkRect& r, const SkMatrix& ctm) {
     fBounds.join(*rect);
 }
 
+std::vector<SkIRect> InvalidationController::coalesce(const SkMatrix& ctm, const SkIRect& clip,
+                                                      size_t maxRects) const {
+    std::vector<SkIRect> rects;
+    rects.reserve(fRects.size());
+    for (const auto& r : fRects) {
+        auto ir = ctm.mapRect(r).roundOut().makeOutset(1, 1);
+        if (ir.intersect(clip)) {
+            rects.push_back(ir);
+        }
+    }
+
+    // Largest first, so smaller rects mostly fold into the ones they are nested in.
+    std::sort(rects.begin(), rects.end(), [](const SkIRect& a, const SkIRect& b) {
+        return area(a) > area(b);
+    });
+
+    std::vector<SkIRect> result;
+    for (auto r : rects) {
+        // Growing a rect may make it worth merging with rects already in the result.
+        for (size_t i = 0; i < result.size();) {
+            if (merge_cost(result[i], r) <= 0) {
+                r.join(result[i]);
+                result[i] = result.back();
+                result.pop_back();
+                i = 0;
+            } else {
+                ++i;
+            }
+        }
+        result.push_back(r);
+    }
+
+    maxRects = std::max<size_t>(maxRects, 1);
+    while (result.size() > maxRects) {
+        size_t best_i = 0,
+               best_j = 1;
+        auto best_cost = merge_cost(result[0], result[1]);
+        for (size_t i = 0; i < result.size(); ++i) {
+            for (size_t j = i + 1; j < result.size(); ++j) {
+                const auto cost = merge_cost(result[i], result[j]);
+                if (cost < best_cost) {
+                    best_i = i;
+                    best_j = j;
+                    best_cost = cost;
+                }
+            }
+        }
+        result[best_i].join(result[best_j]);
+        result[best_j] = result.back();
+        result.pop_back();
+    }
+
+    return result;
+}
+
 void InvalidationController::reset() {
     fRects.clear();
     fBounds.setEmpty();
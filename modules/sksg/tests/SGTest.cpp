@@ -22,6 +22,7 @@
 
 #include "tests/Test.h"
 
+#include <algorithm>
 #include <vector>
 
 static void check_inval(skiatest::Reporter* reporter, const sk_sp<sksg::Node>& root,
@@ -355,4 +356,60 @@ DEF_TEST(SGInvalidation, reporter) {
     inval_group_remove(reporter);
 }
 
+DEF_TEST(SGInvalidation_Coalesce, reporter) {
+    const auto clip = SkIRect::MakeWH(1000, 1000);
+
+    auto check = [&](const std::vector<SkRect>& inval, const SkMatrix& ctm, size_t max_rects,
+                     const std::vector<SkIRect>& expected) {
+        sksg::InvalidationController ic;
+        for (const auto& r : inval) {
+            ic.inval(r);
+        }
+
+        auto rects = ic.coalesce(ctm, clip, max_rects);
+        std::sort(rects.begin(), rects.end(), [](const SkIRect& a, const SkIRect& b) {
+            return a.fLeft < b.fLeft || (a.fLeft == b.fLeft && a.fTop < b.fTop);
+        });
+
+        REPORTER_ASSERT(reporter, rects == expected);
+        if (rects != expected) {
+            for (const auto& r : rects) {
+                SkDebugf("*** [%d %d %d %d]\n", r.fLeft, r.fTop, r.fRight, r.fBottom);
+            }
+        }
+    };
+
+    // Nothing to do.
+    check({}, SkMatrix::I(), 8, {});
+
+    // Rects are rounded out, with a pixel of AA slop, and clipped.
+    check({ SkRect::MakeLTRB(10.5f, 10.5f, 20.5f, 20.5f), SkRect::MakeLTRB(990, 990, 1100, 1100) },
+          SkMatrix::I(), 8,
+          { SkIRect::MakeLTRB(9, 9, 22, 22), SkIRect::MakeLTRB(989, 989, 1000, 1000) });
+
+    // Nested and overlapping rects merge; distant ones don't.
+    check({ SkRect::MakeLTRB(100, 100, 200, 200),
+            SkRect::MakeLTRB(120, 120, 140, 140),
+            SkRect::MakeLTRB(150, 110, 250, 190),
+            SkRect::MakeLTRB(600, 600, 610, 610) },
+          SkMatrix::I(), 8,
+          { SkIRect::MakeLTRB( 99,  99, 251, 201), SkIRect::MakeLTRB(599, 599, 611, 611) });
+
+    // Rects are mapped to device space.
+    check({ SkRect::MakeLTRB(10, 10, 20, 20) }, SkMatrix::Scale(2, 3), 8,
+          { SkIRect::MakeLTRB(19, 29, 41, 61) });
+
+    // Past |max_rects|, the closest rects merge first.
+    check({ SkRect::MakeLTRB(  0, 0,  10, 10),
+            SkRect::MakeLTRB( 20, 0,  30, 10),
+            SkRect::MakeLTRB(500, 0, 510, 10) },
+          SkMatrix::I(), 2,
+          { SkIRect::MakeLTRB(0, 0, 31, 11), SkIRect::MakeLTRB(499, 0, 511, 11) });
+    check({ SkRect::MakeLTRB(  0, 0,  10, 10),
+            SkRect::MakeLTRB( 20, 0,  30, 10),
+            SkRect::MakeLTRB(500, 0, 510, 10) },
+          SkMatrix::I(), 1,
+          { SkIRect::MakeLTRB(0, 0, 511, 11) });
+}
+
 #endif // !defined(SK_BUILD_FOR_GOOGLE3)
@@ -163,6 +163,7 @@ SkCodec::SkCodec(SkEncodedInfo&& info, XformFormat srcFormat, std::unique_ptr<Sk
     , fOptions()
     , fCurrScanline(-1)
     , fStartedIncrementalDecode(false)
+    , fRowSink(nullptr)
 {}
 
 SkCodec::~SkCodec() {}
@@ -8,6 +8,8 @@
 #include "src/codec/SkJpegCodec.h"
 
 #include "include/codec/SkCodec.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
@@ -16,8 +18,12 @@
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkJpegDecoderMgr.h"
 #include "src/codec/SkParseEncodedOrigin.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/pdf/SkJpegInfo.h"
 
+#include <atomic>
+#include <vector>
+
 // stdio is needed for libjpeg-turbo
 #include <stdio.h>
 #include "src/codec/SkJpegUtility.h"
@@ -519,6 +525,242 @@ static inline bool needs_swizzler_to_convert_from_cmyk(J_COLOR_SPACE jpegColorTy
     return !hasCMYKColorSpace || !hasColorSpaceXform;
 }
 
+namespace {
+
+// Where the pieces of a baseline JPEG with restart markers live in its encoded data.
+struct RestartLayout {
+    size_t              fSOFOffset;     // The SOF marker, which holds the image height.
+    size_t              fScanOffset;    // The first entropy-coded byte, just after SOS.
+    size_t              fEOIOffset;     // The EOI marker ending the scan.
+    std::vector<size_t> fRSTOffsets;    // Each RSTn marker, in order.
+};
+
+constexpr uint8_t kSOF0Marker = 0xC0;   // Baseline, Huffman.
+constexpr uint8_t kSOF1Marker = 0xC1;   // Extended sequential, Huffman.
+constexpr uint8_t kSOF9Marker = 0xC9;   // Extended sequential, arithmetic.
+constexpr uint8_t kSOSMarker  = 0xDA;
+
+}  // namespace
+
+/*
+ * Walks the markers of a complete, single scan JPEG and finds its restart markers.
+ * Returns false if the data is truncated, or if the first scan is not followed by EOI.
+ */
+static bool find_restart_markers(const uint8_t* data, size_t length, RestartLayout* layout) {
+    size_t offset = 2;
+    layout->fSOFOffset = 0;
+    while (true) {
+        // Markers may be preceded by any number of 0xFF fill bytes.
+        while (offset + 1 < length && 0xFF == data[offset] && 0xFF == data[offset + 1]) {
+            offset++;
+        }
+        if (offset + 4 > length || 0xFF != data[offset]) {
+            return false;
+        }
+        const uint8_t marker = data[offset + 1];
+        const size_t segmentLength = (data[offset + 2] << 8) | data[offset + 3];
+        if (segmentLength < 2 || offset + 2 + segmentLength > length) {
+            return false;
+        }
+        if (kSOF0Marker == marker || kSOF1Marker == marker || kSOF9Marker == marker) {
+            layout->fSOFOffset = offset;
+        }
+        offset += 2 + segmentLength;
+        if (kSOSMarker == marker) {
+            break;
+        }
+    }
+    if (!layout->fSOFOffset) {
+        return false;
+    }
+
+    layout->fScanOffset = offset;
+    layout->fRSTOffsets.clear();
+    for (; offset + 1 < length; offset++) {
+        if (0xFF != data[offset]) {
+            continue;
+        }
+        const uint8_t marker = data[offset + 1];
+        if (0x00 == marker) {
+            // A stuffed 0xFF data byte.
+            offset++;
+        } else if (0xFF == marker) {
+            // Fill byte.
+        } else if (marker >= JPEG_RST0 && marker <= JPEG_RST0 + 7) {
+            layout->fRSTOffsets.push_back(offset);
+            offset++;
+        } else if (JPEG_EOI == marker) {
+            layout->fEOIOffset = offset;
+            return true;
+        } else {
+            // Another scan, DNL, ...
+            return false;
+        }
+    }
+    return false;
+}
+
+static int greatest_common_divisor(int a, int b) {
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+bool SkJpegCodec::decodeRestartIntervals(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                         const Options& options) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (!options.fExecutor || options.fSubset || dinfo->progressive_mode ||
+            0 == dinfo->restart_interval || dinfo->comps_in_scan != dinfo->num_components ||
+            dstInfo.dimensions() != this->dimensions()) {
+        return false;
+    }
+    if (needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+                                            this->getEncodedInfo().profile(), this->colorXform())) {
+        // Leave CMYK->RGB conversion to the sequential path.
+        return false;
+    }
+
+    SkStream* stream = this->stream();
+    const uint8_t* data = static_cast<const uint8_t*>(stream->getMemoryBase());
+    if (!data || !stream->hasLength() || !IsJpeg(data, stream->getLength())) {
+        return false;
+    }
+    RestartLayout layout;
+    if (!find_restart_markers(data, stream->getLength(), &layout)) {
+        return false;
+    }
+
+    // An interleaved scan codes one MCU per max_h_samp_factor x max_v_samp_factor blocks.
+    const int width  = SkTo<int>(dinfo->image_width);
+    const int height = SkTo<int>(dinfo->image_height);
+    const int mcuWidth  = (1 == dinfo->comps_in_scan) ? DCTSIZE
+                                                      : dinfo->max_h_samp_factor * DCTSIZE;
+    const int mcuHeight = (1 == dinfo->comps_in_scan) ? DCTSIZE
+                                                      : dinfo->max_v_samp_factor * DCTSIZE;
+    const int mcusPerRow = (width  + mcuWidth  - 1) / mcuWidth;
+    const int mcuRows    = (height + mcuHeight - 1) / mcuHeight;
+    const int interval   = dinfo->restart_interval;
+    if (((int64_t) mcusPerRow * mcuRows - 1) / interval != (int64_t) layout.fRSTOffsets.size()) {
+        return false;
+    }
+
+    // Bands start and end on MCU rows that also start a restart interval, i.e. on multiples of
+    // alignedRows. Keep them tall enough that setting up each decoder stays cheap.
+    constexpr int kMinBandHeight = 64;
+    const int alignedRows = interval / greatest_common_divisor(interval, mcusPerRow);
+    const int bandRows = alignedRows * std::max(1, kMinBandHeight / (alignedRows * mcuHeight));
+    const int bandCount = (mcuRows + bandRows - 1) / bandRows;
+    if (bandCount < 2) {
+        return false;
+    }
+
+    // Fancy upsampling of vertically subsampled chroma reads the neighboring rows, which live in
+    // the neighboring bands. Decode an extra aligned step on either side of each band so the rows
+    // we keep match the sequential decode exactly.
+    bool needsContext = false;
+    for (int i = 0; i < dinfo->num_components; i++) {
+        needsContext |= dinfo->comp_info[i].v_samp_factor != dinfo->max_v_samp_factor;
+    }
+    const int contextRows = (needsContext && dinfo->do_fancy_upsampling) ? alignedRows : 0;
+
+    auto restartIndex = [=](int mcuRow) {
+        return SkTo<int>((int64_t) mcuRow * mcusPerRow / interval);
+    };
+    auto scanStart = [&](int mcuRow) {
+        const int index = restartIndex(mcuRow);
+        return 0 == index ? layout.fScanOffset : layout.fRSTOffsets[index - 1] + 2;
+    };
+    auto scanEnd = [&](int mcuRow) {
+        return mcuRows == mcuRow ? layout.fEOIOffset : layout.fRSTOffsets[restartIndex(mcuRow) - 1];
+    };
+
+    const J_COLOR_SPACE outColorSpace = dinfo->out_color_space;
+    const J_DITHER_MODE ditherMode = dinfo->dither_mode;
+    const J_DCT_METHOD dctMethod = dinfo->dct_method;
+    const bool xformFromScratch = this->colorXform() &&
+                                  sizeof(uint32_t) != dstInfo.bytesPerPixel();
+    const size_t scratchBytes = std::max(SkToSizeT(width) * sizeof(uint32_t),
+                                         dstInfo.minRowBytes());
+
+    std::atomic<bool> failed{false};
+    SkTaskGroup tasks(*options.fExecutor);
+    for (int band = 0; band < bandCount; band++) {
+        tasks.add([=, &layout, &failed] {
+            const int top    = band * bandRows,
+                      bottom = std::min(mcuRows, top + bandRows),
+                      first  = std::max(0, top - contextRows),
+                      last   = std::min(mcuRows, bottom + contextRows);
+
+            // Stitch the headers and this band's restart intervals into a standalone JPEG,
+            // with the height patched to match and the RSTn markers renumbered from RST0.
+            const size_t start = scanStart(first),
+                         end   = scanEnd(last);
+            const int bandHeight = std::min(last * mcuHeight, height) - first * mcuHeight;
+            sk_sp<SkData> bandData =
+                    SkData::MakeUninitialized(layout.fScanOffset + end - start + 2);
+            uint8_t* bytes = static_cast<uint8_t*>(bandData->writable_data());
+            memcpy(bytes, data, layout.fScanOffset);
+            bytes[layout.fSOFOffset + 5] = (uint8_t) (bandHeight >> 8);
+            bytes[layout.fSOFOffset + 6] = (uint8_t) (bandHeight & 0xFF);
+            memcpy(bytes + layout.fScanOffset, data + start, end - start);
+            for (int i = restartIndex(first), n = 0;
+                    i < SkToInt(layout.fRSTOffsets.size()) && layout.fRSTOffsets[i] < end;
+                    i++, n++) {
+                bytes[layout.fScanOffset + layout.fRSTOffsets[i] - start + 1] = JPEG_RST0 + (n & 7);
+            }
+            bytes[bandData->size() - 2] = 0xFF;
+            bytes[bandData->size() - 1] = JPEG_EOI;
+
+            SkMemoryStream bandStream(bandData);
+            JpegDecoderMgr decoderMgr(&bandStream);
+            skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr.errorMgr());
+            if (setjmp(jmp)) {
+                failed = true;
+                return;
+            }
+            decoderMgr.init();
+            jpeg_decompress_struct* bandInfo = decoderMgr.dinfo();
+            if (JPEG_HEADER_OK != jpeg_read_header(bandInfo, true)) {
+                failed = true;
+                return;
+            }
+            bandInfo->out_color_space = outColorSpace;
+            bandInfo->dither_mode = ditherMode;
+            bandInfo->dct_method = dctMethod;
+            if (!jpeg_start_decompress(bandInfo)) {
+                failed = true;
+                return;
+            }
+
+            SkAutoTMalloc<uint8_t> scratch(scratchBytes);
+            const int skipRows = (top - first) * mcuHeight;
+            const int keepRows = std::min(bottom * mcuHeight, height) - top * mcuHeight;
+            for (int y = 0; y < skipRows + keepRows && !failed; y++) {
+                void* dstRow = nullptr;
+                JSAMPLE* decodeRow = scratch.get();
+                if (y >= skipRows) {
+                    dstRow = SkTAddOffset<void>(dst, (top * mcuHeight + y - skipRows) * rowBytes);
+                    if (!xformFromScratch) {
+                        decodeRow = (JSAMPLE*) dstRow;
+                    }
+                }
+                if (1 != jpeg_read_scanlines(bandInfo, &decodeRow, 1)) {
+                    failed = true;
+                    return;
+                }
+                if (dstRow && this->colorXform()) {
+                    this->applyColorXform(dstRow, decodeRow, width);
+                }
+            }
+        });
+    }
+    tasks.wait();
+    return !failed;
+}
+
 /*
  * Performs the jpeg decode
  */
@@ -540,6 +782,10 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
     }
 
+    if (this->decodeRestartIntervals(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     if (!jpeg_start_decompress(dinfo)) {
         return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
     }
@@ -109,6 +109,16 @@ private:
     bool SK_WARN_UNUSED_RESULT allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
 
+    /*
+     * Decodes the whole image on options.fExecutor by splitting it into bands at restart
+     * markers, each decoded by its own libjpeg-turbo instance.
+     * Returns false, having written nothing useful, if the image cannot be decoded this way
+     * (no restart markers, progressive, scaled, incomplete data, ...).  The caller should
+     * then fall back to the sequential path.
+     */
+    bool decodeRestartIntervals(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                const Options&);
+
     /*
      * Scanline decoding.
      */
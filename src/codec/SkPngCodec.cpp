@@ -7,12 +7,14 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkMath.h"
 #include "include/core/SkPoint3.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkMacros.h"
+#include "include/private/SkSemaphore.h"
 #include "include/private/SkTemplates.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkColorTable.h"
@@ -20,6 +22,7 @@
 #include "src/codec/SkPngPriv.h"
 #include "src/codec/SkSwizzler.h"
 #include "src/core/SkOpts.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkUtils.h"
 
 #include "png.h"
@@ -429,10 +432,10 @@ std::unique_ptr<SkEncodedInfo::ICCProfile> read_color_profile(png_structp png_pt
 #endif // LIBPNG >= 1.6
 }
 
-void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
+size_t SkPngCodec::colorXformSrcRowBytes(const SkImageInfo& dstInfo) const {
     switch (fXformMode) {
         case kSwizzleOnly_XformMode:
-            break;
+            return 0;
         case kColorOnly_XformMode:
             // Intentional fall through.  A swizzler hasn't been created yet, but one will
             // be created later if we are sampling.  We'll go ahead and allocate
@@ -443,12 +446,17 @@ void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
             // If we have more than 8-bits (per component) of precision, we will keep that
             // extra precision.  Otherwise, we will swizzle to RGBA_8888 before transforming.
             const size_t bytesPerPixel = (bitsPerPixel > 32) ? bitsPerPixel / 8 : 4;
-            const size_t colorXformBytes = dstInfo.width() * bytesPerPixel;
-            fStorage.reset(colorXformBytes);
-            fColorXformSrcRow = fStorage.get();
-            break;
+            return dstInfo.width() * bytesPerPixel;
         }
     }
+    SkUNREACHABLE;
+}
+
+void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
+    if (size_t colorXformBytes = this->colorXformSrcRowBytes(dstInfo)) {
+        fStorage.reset(colorXformBytes);
+        fColorXformSrcRow = fStorage.get();
+    }
 }
 
 static skcms_PixelFormat png_select_xform_format(const SkEncodedInfo& info) {
@@ -467,6 +475,10 @@ static skcms_PixelFormat png_select_xform_format(const SkEncodedInfo& info) {
 }
 
 void SkPngCodec::applyXformRow(void* dst, const void* src) {
+    this->applyXformRow(dst, src, fColorXformSrcRow);
+}
+
+void SkPngCodec::applyXformRow(void* dst, const void* src, void* colorXformSrcRow) const {
     switch (fXformMode) {
         case kSwizzleOnly_XformMode:
             fSwizzler->swizzle(dst, (const uint8_t*) src);
@@ -475,8 +487,8 @@ void SkPngCodec::applyXformRow(void* dst, const void* src) {
             this->applyColorXform(dst, src, fXformWidth);
             break;
         case kSwizzleColor_XformMode:
-            fSwizzler->swizzle(fColorXformSrcRow, (const uint8_t*) src);
-            this->applyColorXform(dst, fColorXformSrcRow, fXformWidth);
+            fSwizzler->swizzle(colorXformSrcRow, (const uint8_t*) src);
+            this->applyColorXform(dst, colorXformSrcRow, fXformWidth);
             break;
     }
 }
@@ -519,6 +531,29 @@ private:
     int                         fLastRow;
     int                         fRowsNeeded;
 
+    // Used by decodeAllRows() when Options::fExecutor is set. libpng has to inflate and unfilter
+    // rows in order, but converting them (swizzle and color xform) is independent per row, so
+    // we copy rows into bands and convert each full band on the executor while libpng carries
+    // on with the next.
+    static constexpr int    kBandsInFlight = 16;
+    static constexpr size_t kBandBytes     = 128 * 1024;
+
+    struct Band {
+        SkAutoTMalloc<png_byte> fSrc;
+        void*                   fDst  = nullptr;
+        int                     fRows = 0;
+        SkSemaphore             fFree{1};
+    };
+
+    SkExecutor*                 fExecutor = nullptr;
+    std::unique_ptr<SkTaskGroup> fBandTasks;
+    SkAutoTArray<Band>          fBands;
+    int                         fBandRows = 0;
+    int                         fRowsInBand = 0;
+    int                         fCurrentBand = 0;
+    size_t                      fSrcRowBytes = 0;
+    size_t                      fScratchBytes = 0;
+
     typedef SkPngCodec INHERITED;
 
     static SkPngNormalDecoder* GetDecoder(png_structp png_ptr) {
@@ -535,7 +570,9 @@ private:
         fFirstRow = 0;
         fLastRow = height - 1;
 
+        this->startBands(this->options().fExecutor);
         const bool success = this->processData();
+        this->finishBands();
         if (success && fRowsWrittenToOutput == height) {
             return kSuccess;
         }
@@ -550,10 +587,89 @@ private:
     void allRowsCallback(png_bytep row, int rowNum) {
         SkASSERT(rowNum == fRowsWrittenToOutput);
         fRowsWrittenToOutput++;
-        this->applyXformRow(fDst, row);
+        if (fBandTasks) {
+            this->bandRow(row);
+        } else {
+            this->applyXformRow(fDst, row);
+        }
         fDst = SkTAddOffset<void>(fDst, fRowBytes);
     }
 
+    void startBands(SkExecutor* executor) {
+        fBandTasks.reset();
+        if (!executor) {
+            return;
+        }
+        fSrcRowBytes = png_get_rowbytes(this->png_ptr(), this->info_ptr());
+        const size_t height = this->dimensions().height();
+        fBandRows = (int)SkTPin<size_t>(kBandBytes / std::max<size_t>(fSrcRowBytes, 1),
+                                        1, height);
+        if ((size_t)fBandRows == height) {
+            // Just one band; nothing to overlap with.
+            return;
+        }
+
+        fExecutor = executor;
+        fBandTasks = std::make_unique<SkTaskGroup>(*executor);
+        fBands.reset(kBandsInFlight);
+        for (int i = 0; i < kBandsInFlight; i++) {
+            fBands[i].fSrc.reset(fBandRows * fSrcRowBytes);
+        }
+        fScratchBytes = this->colorXformSrcRowBytes(this->dstInfo());
+        fRowsInBand = 0;
+        fCurrentBand = 0;
+    }
+
+    void bandRow(png_bytep row) {
+        Band& band = fBands[fCurrentBand];
+        if (fRowsInBand == 0) {
+            // Wait for the last task using this band, helping out instead of blocking, in case
+            // we are running on one of the executor's own threads.
+            while (!band.fFree.try_wait()) {
+                fExecutor->borrow();
+            }
+            band.fDst = fDst;
+        }
+        memcpy(band.fSrc.get() + fRowsInBand * fSrcRowBytes, row, fSrcRowBytes);
+        if (++fRowsInBand == fBandRows) {
+            this->flushBand();
+        }
+    }
+
+    void flushBand() {
+        if (fRowsInBand == 0) {
+            return;
+        }
+        Band* band = &fBands[fCurrentBand];
+        band->fRows = fRowsInBand;
+        fBandTasks->add([this, band] {
+            SkAutoTMalloc<uint8_t> scratch(fScratchBytes);
+            const png_byte* src = band->fSrc.get();
+            void* dst = band->fDst;
+            for (int i = 0; i < band->fRows; i++) {
+                this->applyXformRow(dst, src, scratch.get());
+                src += fSrcRowBytes;
+                dst = SkTAddOffset<void>(dst, fRowBytes);
+            }
+            band->fFree.signal();
+        });
+        fRowsInBand = 0;
+        fCurrentBand = (fCurrentBand + 1) % kBandsInFlight;
+    }
+
+    void finishBands() {
+        if (fBandTasks) {
+            // Rows libpng gave us before an error or incomplete input still get converted.
+            this->flushBand();
+            fBandTasks->wait();
+            fBandTasks.reset();
+            fBands.reset(0);
+            fExecutor = nullptr;
+        }
+    }
+
+    bool onSupportsRowSink() const override { return true; }
+
     void setRange(int firstRow, int lastRow, void* dst, size_t rowBytes) override {
         png_set_progressive_read_fn(this->png_ptr(), this, nullptr, RowCallback, nullptr);
         fFirstRow = firstRow;
@@ -594,7 +710,11 @@ private:
         // If there is no swizzler, all rows are needed.
         if (!this->swizzler() || this->swizzler()->rowNeeded(rowNum - fFirstRow)) {
             this->applyXformRow(fDst, row);
-            fDst = SkTAddOffset<void>(fDst, fRowBytes);
+            if (RowSink* sink = this->rowSink()) {
+                sink->onRow(fDst);
+            } else {
+                fDst = SkTAddOffset<void>(fDst, fRowBytes);
+            }
             fRowsWrittenToOutput++;
         }
 
@@ -54,6 +54,10 @@ protected:
 
     SkSampler* getSampler(bool createIfNecessary) override;
     void applyXformRow(void* dst, const void* src);
+    // Thread-safe version, for converting rows in parallel: uses colorXformSrcRow (at least
+    // colorXformSrcRowBytes() long) as scratch instead of fColorXformSrcRow.
+    void applyXformRow(void* dst, const void* src, void* colorXformSrcRow) const;
+    size_t colorXformSrcRowBytes(const SkImageInfo& dstInfo) const;
 
     voidp png_ptr() { return fPng_ptr; }
     voidp info_ptr() { return fInfo_ptr; }
@@ -11,6 +11,8 @@
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkSampledCodec.h"
 #include "src/codec/SkSampler.h"
+#include "src/codec/SkScanlineResizer.h"
+#include "src/core/SkAutoMalloc.h"
 #include "src/core/SkMathPriv.h"
 
 SkSampledCodec::SkSampledCodec(SkCodec* codec, ExifOrientationBehavior behavior)
@@ -77,6 +79,11 @@ SkCodec::Result SkSampledCodec::onGetAndroidPixels(const SkImageInfo& info, void
     SkCodec::Options codecOptions;
     codecOptions.fZeroInitialized = options.fZeroInitialized;
 
+    if (options.fResizeFilter != ResizeFilter::kNone &&
+            info.dimensions() != this->codec()->dimensions()) {
+        return this->resizedDecode(info, pixels, rowBytes, options);
+    }
+
     SkIRect* subset = options.fSubset;
     if (!subset || subset->size() == this->codec()->dimensions()) {
         if (this->codec()->dimensionsSupported(info.dimensions())) {
@@ -350,3 +357,111 @@ SkCodec::Result SkSampledCodec::sampledDecode(const SkImageInfo& info, void* pix
             return SkCodec::kUnimplemented;
     }
 }
+
+SkCodec::Result SkSampledCodec::resizedDecode(const SkImageInfo& info, void* pixels,
+        size_t rowBytes, const AndroidOptions& options) {
+    SkASSERT(options.fResizeFilter != ResizeFilter::kNone);
+    if (options.fSubset) {
+        return SkCodec::kUnimplemented;
+    }
+    if (info.isEmpty()) {
+        return SkCodec::kInvalidScale;
+    }
+
+    // Let libjpeg-turbo scale first, as long as that leaves at least as many pixels as we need.
+    SkISize nativeSize = this->codec()->dimensions();
+    if (this->codec()->getEncodedFormat() == SkEncodedImageFormat::kJPEG) {
+        for (int sampleSize : { 8, 4, 2 }) {
+            SkISize size = this->codec()->getScaledDimensions(
+                    get_scale_from_sample_size(sampleSize));
+            if (size.width() >= info.width() && size.height() >= info.height()) {
+                nativeSize = size;
+                break;
+            }
+        }
+    }
+
+    // Decode rows in the destination's color space, premultiplied so the filter does not bleed
+    // color out of transparent pixels. 565 goes through 8888 so the codec does not dither.
+    SkImageInfo srcInfo = info.makeDimensions(nativeSize);
+    if (kRGB_565_SkColorType == info.colorType()) {
+        srcInfo = srcInfo.makeColorType(kRGBA_8888_SkColorType);
+    }
+    if (kUnpremul_SkAlphaType == info.alphaType()) {
+        srcInfo = srcInfo.makeAlphaType(kPremul_SkAlphaType);
+    }
+    const size_t srcRowBytes = srcInfo.minRowBytes();
+    const SkPixmap dst(info, pixels, rowBytes);
+    const SkImageInfo fillInfo = srcInfo.makeWH(srcInfo.width(), 1);
+
+    SkCodec::Options codecOptions;
+    SkCodec::Result result;
+
+    // Feeds the resizer the rows the codec never produced.
+    auto finish = [&](SkScanlineResizer* resizer, void* row) {
+        SkSampler::Fill(fillInfo, row, srcRowBytes, SkCodec::kNo_ZeroInitialized);
+        while (resizer->rowsAdded() < srcInfo.height()) {
+            resizer->addRow(row);
+        }
+    };
+
+    // Codecs that hand each row of an incremental decode to a RowSink only need one row.
+    if (this->codec()->onSupportsRowSink()) {
+        SkAutoMalloc row(srcRowBytes);
+        SkScanlineResizer resizer(srcInfo, dst, options.fResizeFilter, false);
+        struct Sink : public SkCodec::RowSink {
+            SkScanlineResizer* fResizer;
+            void onRow(const void* row) override { fResizer->addRow(row); }
+        } sink;
+        sink.fResizer = &resizer;
+
+        result = this->codec()->startIncrementalDecode(srcInfo, row.get(), srcRowBytes,
+                                                       &codecOptions);
+        if (SkCodec::kSuccess == result) {
+            this->codec()->fRowSink = &sink;
+            result = this->codec()->incrementalDecode();
+            this->codec()->fRowSink = nullptr;
+            if (SkCodec::kSuccess != result && SkCodec::kIncompleteInput != result &&
+                    SkCodec::kErrorInInput != result) {
+                return result;
+            }
+            finish(&resizer, row.get());
+            return result;
+        } else if (SkCodec::kUnimplemented != result) {
+            return result;
+        }
+    }
+
+    // Otherwise stream scanlines, if the codec supports them.
+    result = this->codec()->startScanlineDecode(srcInfo, &codecOptions);
+    if (SkCodec::kSuccess == result) {
+        SkAutoMalloc row(srcRowBytes);
+        const bool bottomUp =
+                SkCodec::kBottomUp_SkScanlineOrder == this->codec()->getScanlineOrder();
+        SkScanlineResizer resizer(srcInfo, dst, options.fResizeFilter, bottomUp);
+        for (int y = 0; y < srcInfo.height(); y++) {
+            if (1 != this->codec()->getScanlines(row.get(), 1, srcRowBytes)) {
+                finish(&resizer, row.get());
+                return SkCodec::kIncompleteInput;
+            }
+            resizer.addRow(row.get());
+        }
+        return SkCodec::kSuccess;
+    } else if (SkCodec::kUnimplemented != result) {
+        return result;
+    }
+
+    // Codecs that write rows out of order (interlaced PNG, GIF) need the whole image.
+    SkAutoMalloc full(srcInfo.computeByteSize(srcRowBytes));
+    result = this->codec()->getPixels(srcInfo, full.get(), srcRowBytes, &codecOptions);
+    if (SkCodec::kSuccess != result && SkCodec::kIncompleteInput != result &&
+            SkCodec::kErrorInInput != result) {
+        return result;
+    }
+    // getPixels() has already filled in anything it could not decode.
+    SkScanlineResizer resizer(srcInfo, dst, options.fResizeFilter, false);
+    for (int y = 0; y < srcInfo.height(); y++) {
+        resizer.addRow(SkTAddOffset<const void>(full.get(), y * srcRowBytes));
+    }
+    return result;
+}
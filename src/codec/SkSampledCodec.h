@@ -54,6 +54,16 @@ private:
     SkCodec::Result sampledDecode(const SkImageInfo& info, void* pixels, size_t rowBytes,
             const AndroidOptions& options);
 
+    /**
+     *  This fulfills the same contract as onGetAndroidPixels().
+     *
+     *  We call this function from onGetAndroidPixels() if options.fResizeFilter is set and
+     *  the info does not match the size of the image. Rows are passed through an
+     *  SkScanlineResizer as fCodec decodes them.
+     */
+    SkCodec::Result resizedDecode(const SkImageInfo& info, void* pixels, size_t rowBytes,
+            const AndroidOptions& options);
+
     typedef SkAndroidCodec INHERITED;
 };
 #endif // SkSampledCodec_DEFINED
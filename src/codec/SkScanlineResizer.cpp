@@ -0,0 +1,166 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkScanlineResizer.h"
+
+#include "include/private/SkFloatingPoint.h"
+#include "include/private/SkNx.h"
+#include "src/core/SkConvertPixels.h"
+
+#include <algorithm>
+#include <cmath>
+
+static float mitchell(float x) {
+    // Mitchell-Netravali with B = C = 1/3.
+    x = std::abs(x);
+    if (x < 1) {
+        return (7 * x * x * x - 12 * x * x + 16.0f / 3) / 6;
+    }
+    if (x < 2) {
+        return (-7.0f / 3 * x * x * x + 12 * x * x - 20 * x + 32.0f / 3) / 6;
+    }
+    return 0;
+}
+
+static float sinc(float x) {
+    if (x == 0) {
+        return 1;
+    }
+    x *= SK_FloatPI;
+    return std::sin(x) / x;
+}
+
+static float lanczos3(float x) {
+    return std::abs(x) < 3 ? sinc(x) * sinc(x / 3) : 0;
+}
+
+void SkScanlineResizer::ComputeAxis(int srcSize, int dstSize, Filter filter, Axis* axis) {
+    SkASSERT(filter != Filter::kNone);
+    float (*kernel)(float) = filter == Filter::kMitchell ? mitchell : lanczos3;
+    const float radius = filter == Filter::kMitchell ? 2 : 3;
+
+    // When downscaling, stretch the kernel over the source pixels each destination pixel covers.
+    const float scale = (float)srcSize / dstSize;
+    const float kernelScale = std::max(scale, 1.0f);
+
+    axis->fContributions.resize(dstSize);
+    axis->fWeights.clear();
+    for (int i = 0; i < dstSize; i++) {
+        const float center = (i + 0.5f) * scale;
+        // Source pixel j is centered at j + 0.5.
+        const int first = std::max(0, (int)std::ceil(center - radius * kernelScale - 0.5f));
+        const int last  = std::min(srcSize - 1,
+                                   (int)std::floor(center + radius * kernelScale - 0.5f));
+
+        Contribution& c = axis->fContributions[i];
+        c.fFirst = first;
+        c.fWeights = (int)axis->fWeights.size();
+
+        // Pixels past the edges are dropped and the rest renormalized.
+        float sum = 0;
+        for (int j = first; j <= last; j++) {
+            float w = kernel((j + 0.5f - center) / kernelScale);
+            axis->fWeights.push_back(w);
+            sum += w;
+        }
+        c.fCount = last - first + 1;
+        if (c.fCount <= 0 || sum == 0) {
+            // Only possible for tiny, extreme upscales; take the nearest pixel.
+            c.fFirst = SkTPin((int)center, 0, srcSize - 1);
+            c.fCount = 1;
+            axis->fWeights.resize(c.fWeights);
+            axis->fWeights.push_back(1);
+            continue;
+        }
+        for (int k = 0; k < c.fCount; k++) {
+            axis->fWeights[c.fWeights + k] /= sum;
+        }
+    }
+}
+
+SkScanlineResizer::SkScanlineResizer(const SkImageInfo& srcInfo, const SkPixmap& dst,
+                                     Filter filter, bool bottomUp)
+    : fSrcInfo(srcInfo)
+    , fDst(dst)
+    , fBottomUp(bottomUp)
+    , fPremul(!srcInfo.isOpaque())
+{
+    ComputeAxis(srcInfo.width(),  dst.width(),  filter, &fX);
+    ComputeAxis(srcInfo.height(), dst.height(), filter, &fY);
+
+    fRingRows = 1;
+    for (const Contribution& c : fY.fContributions) {
+        fRingRows = std::max(fRingRows, c.fCount);
+    }
+    fRing.reset(4 * fRingRows * dst.width());
+    fSrcRow.reset(4 * srcInfo.width());
+    fDstRow.reset(4 * dst.width());
+}
+
+void SkScanlineResizer::addRow(const void* row) {
+    SkASSERT(fRowsAdded < fSrcInfo.height());
+
+    const SkAlphaType at = fPremul ? kPremul_SkAlphaType : kOpaque_SkAlphaType;
+    const SkImageInfo srcRowInfo = fSrcInfo.makeWH(fSrcInfo.width(), 1);
+    const SkImageInfo floatRowInfo = srcRowInfo.makeColorType(kRGBA_F32_SkColorType)
+                                               .makeAlphaType(at);
+    SkConvertPixels(floatRowInfo, fSrcRow.get(), floatRowInfo.minRowBytes(),
+                    srcRowInfo, row, srcRowInfo.minRowBytes());
+
+    float* filtered = fRing.get() + 4 * fDst.width() * (fRowsAdded % fRingRows);
+    for (int x = 0; x < fDst.width(); x++) {
+        const Contribution& c = fX.fContributions[x];
+        const float* src = fSrcRow.get() + 4 * c.fFirst;
+        const float* weights = fX.fWeights.data() + c.fWeights;
+        Sk4f sum = 0;
+        for (int k = 0; k < c.fCount; k++) {
+            sum += Sk4f::Load(src + 4 * k) * weights[k];
+        }
+        sum.store(filtered + 4 * x);
+    }
+    fRowsAdded++;
+
+    while (fRowsWritten < fDst.height()) {
+        const Contribution& c = fY.fContributions[fRowsWritten];
+        if (c.fFirst + c.fCount > fRowsAdded) {
+            break;
+        }
+        this->writeRow(fRowsWritten++);
+    }
+}
+
+void SkScanlineResizer::writeRow(int y) {
+    const Contribution& c = fY.fContributions[y];
+    const float* weights = fY.fWeights.data() + c.fWeights;
+    const int width = fDst.width();
+
+    float* dst = fDstRow.get();
+    for (int x = 0; x < width; x++) {
+        Sk4f sum = 0;
+        for (int k = 0; k < c.fCount; k++) {
+            const float* src = fRing.get() + 4 * (width * ((c.fFirst + k) % fRingRows) + x);
+            sum += Sk4f::Load(src) * weights[k];
+        }
+
+        // Mitchell and Lanczos ring, so clamp to a valid color.
+        float a = fPremul ? SkTPin(sum[3], 0.0f, 1.0f) : 1.0f;
+        Sk4f clamped = Sk4f::Min(Sk4f::Max(sum, 0), a);
+        clamped.store(dst + 4 * x);
+        dst[4 * x + 3] = a;
+    }
+
+    // Filters are symmetric, so when rows arrive bottom-up we resize the upside-down image
+    // and write its rows upside-down, without changing the weights.
+    const int dstY = fBottomUp ? fDst.height() - 1 - y : y;
+    const SkAlphaType at = fPremul ? kPremul_SkAlphaType : kOpaque_SkAlphaType;
+    const SkImageInfo dstRowInfo = fDst.info().makeWH(width, 1);
+    const SkImageInfo floatRowInfo = dstRowInfo.makeColorType(kRGBA_F32_SkColorType)
+                                               .makeAlphaType(at)
+                                               .makeColorSpace(fSrcInfo.refColorSpace());
+    SkConvertPixels(dstRowInfo, fDst.writable_addr(0, dstY), fDst.rowBytes(),
+                    floatRowInfo, fDstRow.get(), floatRowInfo.minRowBytes());
+}
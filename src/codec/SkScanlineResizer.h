@@ -0,0 +1,83 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkScanlineResizer_DEFINED
+#define SkScanlineResizer_DEFINED
+
+#include "include/codec/SkAndroidCodec.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/private/SkTemplates.h"
+
+#include <vector>
+
+/**
+ *  Resizes an image that arrives one row at a time, as a codec decodes it, with a separable
+ *  Mitchell or Lanczos3 filter.
+ *
+ *  Each source row is filtered horizontally as soon as it arrives and kept in a ring buffer,
+ *  and each destination row is filtered vertically as soon as the last source row under its
+ *  filter has arrived, so only as many rows as the vertical filter spans are ever resident.
+ */
+class SkScanlineResizer : SkNoncopyable {
+public:
+    using Filter = SkAndroidCodec::ResizeFilter;
+
+    /**
+     *  @param srcInfo  Describes the rows that will be passed to addRow(): their color type,
+     *                  alpha type and color space, the width of each row and the number of rows.
+     *  @param dst      Receives the resized image, converted to its color type and alpha type.
+     *  @param filter   Must not be kNone.
+     *  @param bottomUp If true, rows arrive from the bottom of the image to the top.
+     */
+    SkScanlineResizer(const SkImageInfo& srcInfo, const SkPixmap& dst, Filter filter,
+                      bool bottomUp);
+
+    /**
+     *  Add the next source row. Writes any destination rows that are now complete.
+     */
+    void addRow(const void* row);
+
+    int rowsAdded() const { return fRowsAdded; }
+
+private:
+    // The source pixels that contribute to one destination pixel, along one axis.
+    struct Contribution {
+        int fFirst;     // First source pixel.
+        int fCount;     // Number of source pixels.
+        int fWeights;   // Index of the first weight in fWeights.
+    };
+
+    struct Axis {
+        std::vector<Contribution> fContributions;  // One per destination pixel.
+        std::vector<float>        fWeights;
+    };
+
+    static void ComputeAxis(int srcSize, int dstSize, Filter, Axis*);
+
+    void writeRow(int dstY);
+
+    const SkImageInfo     fSrcInfo;
+    const SkPixmap        fDst;
+    const bool            fBottomUp;
+    const bool            fPremul;      // Clamp color to alpha before writing.
+
+    Axis                  fX, fY;
+
+    int                   fRowsAdded = 0;
+    int                   fRowsWritten = 0;
+
+    // Horizontally filtered rows, as 4 floats per destination pixel, indexed by source row
+    // modulo fRingRows.
+    int                   fRingRows;
+    SkAutoTMalloc<float>  fRing;
+
+    SkAutoTMalloc<float>  fSrcRow;      // The current source row, as 4 floats per pixel.
+    SkAutoTMalloc<float>  fDstRow;      // The current destination row, as 4 floats per pixel.
+};
+
+#endif  // SkScanlineResizer_DEFINED
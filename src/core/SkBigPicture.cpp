@@ -8,6 +8,7 @@
 #include "include/core/SkBBHFactory.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkPictureCommon.h"
+#include "src/core/SkPicturePriv.h"
 #include "src/core/SkRecord.h"
 #include "src/core/SkRecordDraw.h"
 #include "src/core/SkTraceEvent.h"
@@ -64,6 +65,33 @@ struct NestedApproxOpCounter {
     }
 };
 
+struct BackdropReadFinder {
+    SkPicture const* const* fDrawablePicts;
+    int                     fDrawableCount;
+
+    template <typename T> bool operator()(const T&) { return false; }
+    bool operator()(const SkRecords::SaveLayer& op) { return op.backdrop != nullptr; }
+    bool operator()(const SkRecords::SaveBehind&)   { return true; }
+    bool operator()(const SkRecords::DrawPicture& op) {
+        return SkPicturePriv::ReadsBackdrop(op.picture.get());
+    }
+    bool operator()(const SkRecords::DrawDrawable& op) {
+        // We can't see into a drawable that wasn't snapshotted, so assume the worst.
+        return op.index < 0 || op.index >= fDrawableCount ||
+               SkPicturePriv::ReadsBackdrop(fDrawablePicts[op.index]);
+    }
+};
+
+bool SkBigPicture::readsBackdrop() const {
+    BackdropReadFinder finder = {this->drawablePicts(), this->drawableCount()};
+    for (int i = 0; i < fRecord->count(); i++) {
+        if (fRecord->visit(i, finder)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 SkRect SkBigPicture::cullRect()            const { return fCullRect; }
 int SkBigPicture::approximateOpCount(bool nested) const {
     if (nested) {
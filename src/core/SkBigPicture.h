@@ -47,6 +47,7 @@ public:
     int approximateOpCount(bool nested) const override;
     size_t approximateBytesUsed() const override;
     const SkBigPicture* asSkBigPicture() const override { return this; }
+    bool readsBackdrop() const override;
 
 // Used by GrLayerHoister
     void partialPlayback(SkCanvas*,
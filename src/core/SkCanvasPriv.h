@@ -48,6 +48,14 @@ public:
         canvas->drawClippedToSaveBehind(paint);
     }
 
+    static SkBaseDevice* TopDevice(const SkCanvas* canvas) {
+        return canvas->getTopDevice();
+    }
+
+    static bool IsClipAA(const SkCanvas* canvas) {
+        return canvas->androidFramework_isClipAA();
+    }
+
     // Exposed for testing on non-Android framework builds
     static void ReplaceClip(SkCanvas* canvas, const SkIRect& rect) {
         canvas->androidFramework_replaceClip(rect);
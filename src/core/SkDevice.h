@@ -385,6 +385,7 @@ private:
     friend class SkDraw;
     friend class SkDrawIter;
     friend class SkSurface_Raster;
+    friend class SkSurface_RasterTiled;
     friend class DeviceTestingAccess;
 
     // Temporarily friend the SkGlyphRunBuilder until drawPosText is gone.
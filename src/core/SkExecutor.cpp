@@ -10,6 +10,7 @@
 #include "include/private/SkSemaphore.h"
 #include "include/private/SkSpinlock.h"
 #include "include/private/SkTArray.h"
+#include <atomic>
 #include <deque>
 #include <thread>
 
@@ -141,6 +142,137 @@ private:
     bool                  fAllowBorrowing;
 };
 
+// An SkWorkStealingThreadPool gives each of its threads its own deque of work.  Threads push
+// and pop work at the back of their own deque, and when that runs dry, steal from the front of a
+// randomly chosen other deque.  Work added from outside the pool is dealt out round-robin.
+// Each deque has its own lock, so unlike SkThreadPool there's no single lock every add() and
+// every worker contends on; fWorkAvailable still counts the work pending across all deques.
+class SkWorkStealingThreadPool final : public SkExecutor {
+public:
+    explicit SkWorkStealingThreadPool(int threads, bool allowBorrowing)
+        : fQueues(new Queue[threads])
+        , fQueueCount(threads)
+        , fAllowBorrowing(allowBorrowing) {
+        for (int i = 0; i < threads; i++) {
+            fThreads.emplace_back(&Loop, this, i);
+        }
+    }
+
+    ~SkWorkStealingThreadPool() override {
+        // Each thread finishes whatever work it can find, then shuts down once it finds none.
+        fShuttingDown.store(true, std::memory_order_relaxed);
+        fWorkAvailable.signal(fThreads.count());
+        for (int i = 0; i < fThreads.count(); i++) {
+            fThreads[i].join();
+        }
+    }
+
+    void add(std::function<void(void)> work) override {
+        // Our own threads keep the work they create; anyone else's goes round-robin.
+        int index = (gCurrentWorker.fPool == this)
+                  ? gCurrentWorker.fIndex
+                  : (int)(fNextQueue.fetch_add(1, std::memory_order_relaxed) % fQueueCount);
+        {
+            SkAutoSpinlock lock(fQueues[index].fLock);
+            fQueues[index].fWork.emplace_back(std::move(work));
+        }
+        fWorkAvailable.signal(1);
+    }
+
+    void borrow() override {
+        // If there is work waiting and we're allowed to borrow work, do it.
+        if (fAllowBorrowing && fWorkAvailable.try_wait()) {
+            std::function<void(void)> work;
+            while (!this->find_work(&work)) {}
+            work();
+        }
+    }
+
+private:
+    struct Queue {
+        SkSpinlock                            fLock;
+        std::deque<std::function<void(void)>> fWork;
+    };
+
+    // Set on each of our threads so add() and find_work() can tell which deque is theirs.
+    struct Worker {
+        const SkWorkStealingThreadPool* fPool;
+        int                             fIndex;
+    };
+    static thread_local Worker gCurrentWorker;
+
+    // Pops from our own deque if we're one of the pool's threads, otherwise steals.
+    // This should be called only when fWorkAvailable indicates there's work to do,
+    // but may still return false if another thread got to that work first.
+    bool find_work(std::function<void(void)>* work) {
+        const bool isWorker = (gCurrentWorker.fPool == this);
+        if (isWorker) {
+            Queue& own = fQueues[gCurrentWorker.fIndex];
+            SkAutoSpinlock lock(own.fLock);
+            if (!own.fWork.empty()) {
+                *work = std::move(own.fWork.back());
+                own.fWork.pop_back();
+                return true;
+            }
+        }
+
+        // Visit every other deque once, starting at a random victim to spread out contention.
+        const uint32_t offset = random();
+        for (int i = 0; i < fQueueCount; i++) {
+            int victim = (int)((offset + i) % fQueueCount);
+            if (isWorker && victim == gCurrentWorker.fIndex) {
+                continue;
+            }
+            Queue& q = fQueues[victim];
+            SkAutoSpinlock lock(q.fLock);
+            if (!q.fWork.empty()) {
+                *work = std::move(q.fWork.front());
+                q.fWork.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // A per-thread xorshift generator is plenty to pick steal victims.
+    static uint32_t random() {
+        static thread_local uint32_t state = 0;
+        if (state == 0) {
+            state = (uint32_t)(uintptr_t)&state | 1;
+        }
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    static void Loop(SkWorkStealingThreadPool* pool, int index) {
+        gCurrentWorker = {pool, index};
+        for (;;) {
+            pool->fWorkAvailable.wait();
+            std::function<void(void)> work;
+            while (!pool->find_work(&work)) {
+                if (pool->fShuttingDown.load(std::memory_order_relaxed)) {
+                    // All the work has been claimed, and this signal was ours to shut down.
+                    return;
+                }
+            }
+            work();
+        }
+    }
+
+    std::unique_ptr<Queue[]> fQueues;
+    const int                fQueueCount;
+    SkTArray<std::thread>    fThreads;
+    SkSemaphore              fWorkAvailable;
+    std::atomic<uint32_t>    fNextQueue{0};
+    std::atomic<bool>        fShuttingDown{false};
+    bool                     fAllowBorrowing;
+};
+
+thread_local SkWorkStealingThreadPool::Worker SkWorkStealingThreadPool::gCurrentWorker = {
+    nullptr, 0};
+
 std::unique_ptr<SkExecutor> SkExecutor::MakeFIFOThreadPool(int threads, bool allowBorrowing) {
     using WorkList = std::deque<std::function<void(void)>>;
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
@@ -151,3 +283,8 @@ std::unique_ptr<SkExecutor> SkExecutor::MakeLIFOThreadPool(int threads, bool all
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
                                                     allowBorrowing);
 }
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingThreadPool(int threads,
+                                                                  bool allowBorrowing) {
+    return std::make_unique<SkWorkStealingThreadPool>(threads > 0 ? threads : num_cores(),
+                                                      allowBorrowing);
+}
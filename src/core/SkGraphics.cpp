@@ -19,6 +19,7 @@
 #include "src/core/SkBlitter.h"
 #include "src/core/SkCpu.h"
 #include "src/core/SkGeometry.h"
+#include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkResourceCache.h"
@@ -27,6 +28,7 @@
 #include "src/core/SkTSearch.h"
 #include "src/core/SkTypefaceCache.h"
 
+#include <atomic>
 #include <stdlib.h>
 
 void SkGraphics::Init() {
@@ -40,12 +42,14 @@ void SkGraphics::Init() {
 void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkResourceCache::DumpMemoryStatistics(dump);
   SkStrikeCache::DumpMemoryStatistics(dump);
+  SkImageFilterCache::Get()->dumpMemoryStatistics(dump);
 }
 
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter_Base::PurgeCache();
+    SkGraphics::PurgeProgramCache();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -138,3 +142,9 @@ extern bool gSkVMAllowJIT;
 void SkGraphics::AllowJIT() {
     gSkVMAllowJIT = true;
 }
+
+extern std::atomic<SkGraphics::PersistentCache*> gSkVMPersistentCache;
+
+SkGraphics::PersistentCache* SkGraphics::SetPersistentCache(PersistentCache* cache) {
+    return gSkVMPersistentCache.exchange(cache);
+}
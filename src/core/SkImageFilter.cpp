@@ -8,7 +8,9 @@
 #include "include/core/SkImageFilter.h"
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkTime.h"
 #include "include/effects/SkComposeImageFilter.h"
 #include "include/private/SkSafe32.h"
 #include "src/core/SkFuzzLogging.h"
@@ -19,6 +21,7 @@
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkSpecialSurface.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkValidationUtils.h"
 #include "src/core/SkWriteBuffer.h"
 #if SK_SUPPORT_GPU
@@ -31,6 +34,7 @@
 #include "src/gpu/SkGr.h"
 #endif
 #include <atomic>
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // SkImageFilter - A number of the public APIs on SkImageFilter downcast to SkImageFilter_Base
@@ -227,6 +231,9 @@ skif::FilterResult<For::kOutput> SkImageFilter_Base::filterImage(const skif::Con
         return result;
     }
 
+    // Only timed for the cache. Includes the time spent on inputs that weren't cached either,
+    // since a hit saves that too.
+    const double start = context.cache() ? SkTime::GetNSecs() : 0;
     result = this->onFilterImage(context);
 
     if (context.gpuBacked()) {
@@ -234,12 +241,87 @@ skif::FilterResult<For::kOutput> SkImageFilter_Base::filterImage(const skif::Con
     }
 
     if (context.cache()) {
-        context.cache()->set(key, this, result);
+        const double computeMs = (SkTime::GetNSecs() - start) * 1e-6;
+        context.cache()->set(key, this, result, computeMs);
     }
 
     return result;
 }
 
+skif::FilterResult<For::kOutput> SkImageFilter_Base::filterImageTiled(
+        const skif::Context& context) const {
+    // Tiles must be big enough that the margins pixel-moving filters add to each of them stay
+    // small next to the tile itself.
+    static constexpr int kTileSize = 512;
+
+    const SkIRect output = context.clipBounds();
+    if (!context.executor() || !context.isValid() || context.gpuBacked() ||
+        (output.width() <= kTileSize && output.height() <= kTileSize) ||
+        !this->canFilterImageTiled()) {
+        return this->filterImage(context);
+    }
+
+    const int cols = (output.width()  + kTileSize - 1) / kTileSize,
+              rows = (output.height() + kTileSize - 1) / kTileSize;
+    auto tileBounds = [&](int i) {
+        SkIRect tile = SkIRect::MakeXYWH(output.fLeft + (i % cols) * kTileSize,
+                                         output.fTop  + (i / cols) * kTileSize,
+                                         kTileSize, kTileSize);
+        SkAssertResult(tile.intersect(output));
+        return tile;
+    };
+
+    std::vector<skif::FilterResult<For::kOutput>> tiles(cols * rows);
+    SkTaskGroup tg(*context.executor());
+    tg.batch(cols * rows, [&](int i) {
+        tiles[i] = this->filterImage(
+                context.withNewDesiredOutput(skif::LayerSpace<SkIRect>(tileBounds(i))));
+    });
+    tg.wait();
+
+    // A tile's result may extend past its desired output; only its own tile is valid. The
+    // combined result only covers what the tiles actually produced, like filterImage() would.
+    std::vector<SkIRect> valid(cols * rows, SkIRect::MakeEmpty());
+    SkIRect bounds = SkIRect::MakeEmpty();
+    for (int i = 0; i < cols * rows; ++i) {
+        if (const SkSpecialImage* image = tiles[i].image()) {
+            const SkIPoint origin(tiles[i].layerOrigin());
+            SkIRect tile = SkIRect::MakeXYWH(origin.fX, origin.fY, image->width(), image->height());
+            if (tile.intersect(tileBounds(i))) {
+                valid[i] = tile;
+                bounds.join(tile);
+            }
+        }
+    }
+    if (bounds.isEmpty()) {
+        return {};
+    }
+
+    sk_sp<SkSpecialSurface> surf = context.makeSurface(bounds.size());
+    if (!surf) {
+        return {};
+    }
+    SkCanvas* canvas = surf->getCanvas();
+    SkASSERT(canvas);
+    canvas->clear(SK_ColorTRANSPARENT);
+    canvas->translate(-SkIntToScalar(bounds.fLeft), -SkIntToScalar(bounds.fTop));
+
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    for (int i = 0; i < cols * rows; ++i) {
+        if (valid[i].isEmpty()) {
+            continue;
+        }
+        SkAutoCanvasRestore acr(canvas, true);
+        canvas->clipRect(SkRect::Make(valid[i]));
+        const SkIPoint origin(tiles[i].layerOrigin());
+        tiles[i].image()->draw(canvas, SkIntToScalar(origin.fX), SkIntToScalar(origin.fY), &paint);
+    }
+
+    return skif::FilterResult<For::kOutput>(surf->makeImageSnapshot(),
+                                            skif::LayerSpace<SkIPoint>(bounds.topLeft()));
+}
+
 skif::LayerSpace<SkIRect> SkImageFilter_Base::getInputBounds(
         const skif::Mapping& mapping, const skif::DeviceSpace<SkRect>& desiredOutput,
         const skif::ParameterSpace<SkRect>* knownContentBounds) const {
@@ -308,6 +390,20 @@ bool SkImageFilter_Base::canHandleComplexCTM() const {
     return true;
 }
 
+bool SkImageFilter_Base::canFilterImageTiled() const {
+    if (!this->onCanFilterImageTiled()) {
+        return false;
+    }
+    const int count = this->countInputs();
+    for (int i = 0; i < count; ++i) {
+        const SkImageFilter_Base* input = as_IFB(this->getInput(i));
+        if (input && !input->canFilterImageTiled()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void SkImageFilter::CropRect::applyTo(const SkIRect& imageBounds, const SkMatrix& ctm,
                                       bool embiggen, SkIRect* cropped) const {
     *cropped = imageBounds;
@@ -547,6 +643,32 @@ template skif::FilterResult<For::kInput> SkImageFilter_Base::filterInput(int, co
 template skif::FilterResult<For::kInput0> SkImageFilter_Base::filterInput(int, const skif::Context&) const;
 template skif::FilterResult<For::kInput1> SkImageFilter_Base::filterInput(int, const skif::Context&) const;
 
+void SkImageFilter_Base::filterInputs(const Context& ctx, sk_sp<SkSpecialImage> images[],
+                                      SkIPoint offsets[]) const {
+    auto filter = [&](int i) {
+        offsets[i] = SkIPoint::Make(0, 0);
+        images[i] = this->filterInput(i, ctx, &offsets[i]);
+    };
+
+    // Null inputs just return the context's source, so only real input filters are worth a task.
+    int branches = 0;
+    for (int i = 0; i < this->countInputs(); ++i) {
+        branches += this->getInput(i) ? 1 : 0;
+    }
+
+    if (!ctx.executor() || ctx.gpuBacked() || branches < 2) {
+        for (int i = 0; i < this->countInputs(); ++i) {
+            filter(i);
+        }
+        return;
+    }
+
+    // Branches that share a sub-DAG may both compute it if neither finds it in the cache first.
+    SkTaskGroup tg(*ctx.executor());
+    tg.batch(this->countInputs(), filter);
+    tg.wait();
+}
+
 SkImageFilter_Base::Context SkImageFilter_Base::mapContext(const Context& ctx) const {
     // We don't recurse through the child input filters because that happens automatically
     // as part of the filterImage() evaluation. In this case, we want the bounds for the
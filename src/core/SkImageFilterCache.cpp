@@ -11,13 +11,15 @@
 
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/private/SkMutex.h"
 #include "include/private/SkOnce.h"
 #include "include/private/SkTHash.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTDPQueue.h"
 #include "src/core/SkTDynamicHash.h"
-#include "src/core/SkTInternalLList.h"
 
 #ifdef SK_BUILD_FOR_IOS
   enum { kDefaultCacheSize = 2 * 1024 * 1024 };
@@ -36,19 +38,36 @@ public:
     }
     struct Value {
         Value(const Key& key, const skif::FilterResult<For::kOutput>& image,
-              const SkImageFilter* filter)
-            : fKey(key), fImage(image), fFilter(filter) {}
+              const SkImageFilter* filter, double computeMs)
+            : fKey(key), fImage(image), fFilter(filter), fTypeName(filter->getTypeName())
+            , fComputeMs(computeMs) {}
 
         Key fKey;
         skif::FilterResult<For::kOutput> fImage;
         const SkImageFilter* fFilter;
+        // Kept separately from fFilter so it's still valid while the filter is being destroyed.
+        const char* fTypeName;
+        double fComputeMs;
+
+        // The eviction priority: the cache's inflation when the entry was last used, plus the
+        // compute time it saves per byte. The lowest goes first, the least recently used on ties.
+        double fPriority = 0;
+        uint64_t fLastUse = 0;
+        int fIndex = -1;
+
+        size_t bytes() const { return fImage.image() ? fImage.image()->getSize() : 0; }
+
         static const Key& GetKey(const Value& v) {
             return v.fKey;
         }
         static uint32_t Hash(const Key& key) {
             return SkOpts::hash(reinterpret_cast<const uint32_t*>(&key), sizeof(Key));
         }
-        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Value);
+        static bool Less(Value* const& a, Value* const& b) {
+            return a->fPriority < b->fPriority ||
+                   (a->fPriority == b->fPriority && a->fLastUse < b->fLastUse);
+        }
+        static int* Index(Value* const& v) { return &v->fIndex; }
     };
 
     bool get(const Key& key, skif::FilterResult<For::kOutput>* result) const override {
@@ -56,10 +75,12 @@ public:
 
         SkAutoMutexExclusive mutex(fMutex);
         if (Value* v = fLookup.find(key)) {
-            if (v != fLRU.head()) {
-                fLRU.remove(v);
-                fLRU.addToHead(v);
-            }
+            this->touch(v);
+            fQueue.priorityDidChange(v);
+
+            Stats& stats = this->stats(v->fTypeName);
+            stats.fHits++;
+            stats.fSavedMs += v->fComputeMs;
 
             *result = v->fImage;
             return true;
@@ -67,39 +88,43 @@ public:
         return false;
     }
 
+    using SkImageFilterCache::set;
     void set(const Key& key, const SkImageFilter* filter,
-             const skif::FilterResult<For::kOutput>& result) override {
+             const skif::FilterResult<For::kOutput>& result, double computeMs) override {
         SkAutoMutexExclusive mutex(fMutex);
         if (Value* v = fLookup.find(key)) {
             this->removeInternal(v);
         }
-        Value* v = new Value(key, result, filter);
+        Value* v = new Value(key, result, filter, computeMs);
         fLookup.add(v);
-        fLRU.addToHead(v);
-        fCurrentBytes += result.image() ? result.image()->getSize() : 0;
+        fCurrentBytes += v->bytes();
         if (auto* values = fImageFilterValues.find(filter)) {
             values->push_back(v);
         } else {
             fImageFilterValues.set(filter, {v});
         }
 
-        while (fCurrentBytes > fMaxBytes) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            if (tail == v) {
-                break;
-            }
-            this->removeInternal(tail);
+        Stats& stats = this->stats(v->fTypeName);
+        stats.fMisses++;
+        stats.fComputeMs += computeMs;
+
+        // The new entry is never evicted to make room for itself.
+        while (fCurrentBytes > fMaxBytes && fQueue.count() > 0) {
+            Value* victim = fQueue.peek();
+            fInflation = victim->fPriority;
+            this->removeInternal(victim);
         }
+        this->touch(v);
+        fQueue.insert(v);
     }
 
     void purge() override {
         SkAutoMutexExclusive mutex(fMutex);
-        while (fCurrentBytes > 0) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            this->removeInternal(tail);
+        while (fQueue.count() > 0) {
+            this->removeInternal(fQueue.peek());
         }
+        SkASSERT(fCurrentBytes == 0);
+        fInflation = 0;
     }
 
     void purgeByImageFilter(const SkImageFilter* filter) override {
@@ -118,7 +143,52 @@ public:
     }
 
     SkDEBUGCODE(int count() const override { return fLookup.count(); })
+
+    void dumpMemoryStatistics(SkTraceMemoryDump* dump) const override {
+        static const char kDumpName[] = "skia/sk_image_filter_cache";
+
+        SkAutoMutexExclusive mutex(fMutex);
+        dump->dumpNumericValue(kDumpName, "size", "bytes", fCurrentBytes);
+        dump->dumpNumericValue(kDumpName, "budget_size", "bytes", fMaxBytes);
+        dump->dumpNumericValue(kDumpName, "entry_count", "objects", fLookup.count());
+
+        if (dump->getRequestedDetails() == SkTraceMemoryDump::kLight_LevelOfDetail) {
+            return;
+        }
+
+        const auto& allStats = fStats;
+        allStats.foreach([&](const char* typeName, const Stats& stats) {
+            SkString dumpName = SkStringPrintf("%s/%s", kDumpName, typeName);
+            dump->dumpNumericValue(dumpName.c_str(), "hits", "objects", stats.fHits);
+            dump->dumpNumericValue(dumpName.c_str(), "misses", "objects", stats.fMisses);
+            dump->dumpNumericValue(dumpName.c_str(), "compute_time", "microseconds",
+                                   (uint64_t)(stats.fComputeMs * 1000));
+            dump->dumpNumericValue(dumpName.c_str(), "saved_time", "microseconds",
+                                   (uint64_t)(stats.fSavedMs * 1000));
+        });
+    }
+
 private:
+    struct Stats {
+        uint64_t fHits = 0;
+        uint64_t fMisses = 0;
+        double   fComputeMs = 0;    // Spent computing results that were then cached.
+        double   fSavedMs = 0;      // Not spent, thanks to hits.
+    };
+
+    Stats& stats(const char* typeName) const {
+        if (Stats* stats = fStats.find(typeName)) {
+            return *stats;
+        }
+        return *fStats.set(typeName, Stats());
+    }
+
+    void touch(Value* v) const {
+        // Cheap results that are large are the first to go; the 1 keeps empty results finite.
+        v->fPriority = fInflation + v->fComputeMs / (v->bytes() + 1);
+        v->fLastUse = ++fUseCount;
+    }
+
     void removeInternal(Value* v) {
         if (v->fFilter) {
             if (auto* values = fImageFilterValues.find(v->fFilter)) {
@@ -134,18 +204,23 @@ private:
                 }
             }
         }
-        fCurrentBytes -= v->fImage.image() ? v->fImage.image()->getSize() : 0;
-        fLRU.remove(v);
+        fCurrentBytes -= v->bytes();
+        fQueue.remove(v);
         fLookup.remove(v->fKey);
         delete v;
     }
 private:
     SkTDynamicHash<Value, Key>                            fLookup;
-    mutable SkTInternalLList<Value>                       fLRU;
+    mutable SkTDPQueue<Value*, Value::Less, Value::Index> fQueue;
     // Value* always points to an item in fLookup.
     SkTHashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
+    // Keyed by the address of the type name: getTypeName() returns one literal per filter type.
+    mutable SkTHashMap<const char*, Stats>                fStats;
     size_t                                                fMaxBytes;
     size_t                                                fCurrentBytes;
+    // The priority of the last entry evicted, which ages every entry not used since.
+    double                                                fInflation = 0;
+    mutable uint64_t                                      fUseCount = 0;
     mutable SkMutex                                       fMutex;
 };
 
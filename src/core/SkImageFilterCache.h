@@ -14,6 +14,7 @@
 
 struct SkIPoint;
 class SkImageFilter;
+class SkTraceMemoryDump;
 
 struct SkImageFilterCacheKey {
     SkImageFilterCacheKey(const uint32_t uniqueID, const SkMatrix& matrix,
@@ -49,6 +50,10 @@ struct SkImageFilterCacheKey {
 // This cache maps from (filter's unique ID + CTM + clipBounds + src bitmap generation ID) to result
 // NOTE: this is the _specific_ unique ID of the image filter, so refiltering the same image with a
 // copy of the image filter (with exactly the same parameters) will not yield a cache hit.
+//
+// When over budget, the cache evicts the entry that saves the least compute time per byte, aged so
+// that entries which are not reused eventually go regardless of their cost (GreedyDual-Size).
+// Results whose costs are equal (or unknown) are evicted least recently used first.
 class SkImageFilterCache : public SkRefCnt {
 public:
     SK_USE_FLUENT_IMAGE_FILTER_TYPES_IN_CLASS
@@ -64,12 +69,22 @@ public:
     virtual bool get(const SkImageFilterCacheKey& key,
                      skif::FilterResult<For::kOutput>* result) const = 0;
     // 'filter' is included in the caching to allow the purging of all of an image filter's cached
-    // results when it is destroyed.
+    // results when it is destroyed. 'computeMs' is how long 'result' took to compute, which is
+    // what a later hit saves.
     virtual void set(const SkImageFilterCacheKey& key, const SkImageFilter* filter,
-                     const skif::FilterResult<For::kOutput>& result) = 0;
+                     const skif::FilterResult<For::kOutput>& result, double computeMs) = 0;
+    // Caches a result whose compute time is unknown.
+    void set(const SkImageFilterCacheKey& key, const SkImageFilter* filter,
+             const skif::FilterResult<For::kOutput>& result) {
+        this->set(key, filter, result, 0);
+    }
     virtual void purge() = 0;
     virtual void purgeByImageFilter(const SkImageFilter*) = 0;
     SkDEBUGCODE(virtual int count() const = 0;)
+
+    // Dumps the cache's size and budget and, at the detailed level, hit and miss counts and the
+    // total compute time spent and saved, per image filter type.
+    virtual void dumpMemoryStatistics(SkTraceMemoryDump*) const = 0;
 };
 
 #endif
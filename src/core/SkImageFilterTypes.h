@@ -13,6 +13,7 @@
 #include "src/core/SkSpecialSurface.h"
 
 class GrRecordingContext;
+class SkExecutor;
 class SkImageFilter;
 class SkImageFilterCache;
 class SkSpecialSurface;
@@ -632,6 +633,9 @@ public:
     // The cache to use when recursing through the filter DAG, in order to avoid repeated
     // calculations of the same image.
     SkImageFilterCache* cache() const { return fCache; }
+    // If not null, CPU filtering may evaluate independent inputs of a node concurrently on this
+    // executor. The cache must be safe to share between threads, which SkImageFilterCache is.
+    SkExecutor* executor() const { return fExecutor; }
     // The output device's color type, which can be used for intermediate images to be
     // compatible with the eventual target of the filtered result.
     SkColorType colorType() const { return fColorType; }
@@ -680,17 +684,28 @@ public:
 
     // Create a new context that matches this context, but with an overridden layer space.
     Context withNewMapping(const Mapping& mapping) const {
-        return Context(mapping, fDesiredOutput, fCache, fColorType, fColorSpace, fSource);
+        Context ctx = *this;
+        ctx.fMapping = mapping;
+        return ctx;
     }
     // Create a new context that matches this context, but with an overridden desired output rect.
     Context withNewDesiredOutput(const LayerSpace<SkIRect>& desiredOutput) const {
-        return Context(fMapping, desiredOutput, fCache, fColorType, fColorSpace, fSource);
+        Context ctx = *this;
+        ctx.fDesiredOutput = desiredOutput;
+        return ctx;
+    }
+    // Create a new context that matches this context, but filters on 'executor' (may be null).
+    Context withExecutor(SkExecutor* executor) const {
+        Context ctx = *this;
+        ctx.fExecutor = executor;
+        return ctx;
     }
 
 private:
     Mapping                   fMapping;
     LayerSpace<SkIRect>       fDesiredOutput;
     SkImageFilterCache*       fCache;
+    SkExecutor*               fExecutor = nullptr;
     SkColorType               fColorType;
     // The pointed-to object is owned by the device controlling the filter process, and our lifetime
     // is bounded by the device, so this can be a bare pointer.
@@ -41,6 +41,18 @@ public:
      */
     skif::FilterResult<For::kOutput> filterImage(const skif::Context& context) const;
 
+    /**
+     *  Like filterImage(), but if the context has an executor and is not GPU backed, a large
+     *  desired output is split into tiles that are filtered concurrently on the executor and then
+     *  stitched back into a single image covering the desired output. Each tile's evaluation of
+     *  the DAG requests only the input its tile needs (plus any margin pixel-moving filters read),
+     *  and its intermediate results are cached per tile in the context's cache.
+     *
+     *  Tiling only happens when canFilterImageTiled() is true; otherwise, and for small outputs,
+     *  this is the same as filterImage().
+     */
+    skif::FilterResult<For::kOutput> filterImageTiled(const skif::Context& context) const;
+
     /**
      *  Calculate the smallest-possible required layer bounds that would provide sufficient
      *  information to correctly compute the image filter for every pixel in the desired output
@@ -130,6 +142,13 @@ public:
      */
     bool canHandleComplexCTM() const;
 
+    /**
+     *  Returns true iff the filter and all of its (non-null) inputs compute every output pixel the
+     *  same way regardless of the desired output bounds, so that filterImageTiled() can evaluate
+     *  the DAG on tiles of the output and get the same pixels as a single evaluation.
+     */
+    bool canFilterImageTiled() const;
+
     /**
      * Return an image filter representing this filter applied with the given ctm. This will modify
      * the DAG as needed if this filter does not support complex CTMs and 'ctm' is not simple. The
@@ -204,6 +223,11 @@ protected:
         return this->getInputFilteredImage(index, ctx).imageAndOffset(offset);
     }
 
+    // Calls filterInput(i, ctx, &offsets[i]) for each of this filter's inputs. If the context has
+    // an executor and is not GPU backed, independent input branches are evaluated concurrently.
+    void filterInputs(const Context& ctx, sk_sp<SkSpecialImage> images[],
+                      SkIPoint offsets[]) const;
+
     // Helper function to visit each of this filter's child filters and call their
     // onGetInputLayerBounds with the provided 'desiredOutput' and 'contentBounds'. Automatically
     // handles null input filters. Returns the union of all of the children's input bounds.
@@ -335,6 +359,14 @@ private:
      */
     virtual bool onCanHandleComplexCTM() const { return false; }
 
+    /**
+     *  Return true if this filter's output pixels only depend on the input pixels around them
+     *  (within the margin reported by onFilterNodeBounds()), and not on where the edges of the
+     *  desired output or of the input image are. Filters that treat those edges specially, like
+     *  lighting (edge normals) or magnifier (inset from the bounds), must return false.
+     */
+    virtual bool onCanFilterImageTiled() const { return false; }
+
     /**
      *  Return true if this filter would transform transparent black pixels to a color other than
      *  transparent black. When false, optimizations can be taken to discard regions known to be
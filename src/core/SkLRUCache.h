@@ -69,6 +69,30 @@ public:
         return fMap.count();
     }
 
+    void remove(const K& key) {
+        Entry** value = fMap.find(key);
+        SkASSERT(value);
+        Entry* entry = *value;
+        SkASSERT(key == entry->fKey);
+        fMap.remove(key);
+        fLRU.remove(entry);
+        delete entry;
+    }
+
+    // Removes the least recently used entry, moving its value into *evicted if non-null.
+    // Returns false if the cache was already empty.
+    bool removeLRU(V* evicted = nullptr) {
+        Entry* entry = fLRU.tail();
+        if (!entry) {
+            return false;
+        }
+        if (evicted) {
+            *evicted = std::move(entry->fValue);
+        }
+        this->remove(entry->fKey);
+        return true;
+    }
+
     template <typename Fn>  // f(K*, V*)
     void foreach(Fn&& fn) {
         typename SkTInternalLList<Entry>::Iter iter;
@@ -97,16 +121,6 @@ private:
         }
     };
 
-    void remove(const K& key) {
-        Entry** value = fMap.find(key);
-        SkASSERT(value);
-        Entry* entry = *value;
-        SkASSERT(key == entry->fKey);
-        fMap.remove(key);
-        fLRU.remove(entry);
-        delete entry;
-    }
-
     int                             fMaxCount;
     SkTHashTable<Entry*, K, Traits> fMap;
     SkTInternalLList<Entry>         fLRU;
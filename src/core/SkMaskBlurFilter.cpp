@@ -8,12 +8,15 @@
 #include "src/core/SkMaskBlurFilter.h"
 
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkExecutor.h"
 #include "include/private/SkMalloc.h"
 #include "include/private/SkNx.h"
 #include "include/private/SkTemplates.h"
 #include "include/private/SkTo.h"
+#include "include/private/SkVx.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkGaussFilter.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <cmath>
 #include <climits>
@@ -226,6 +229,88 @@ public:
             buffer2, buffer2End);
     }
 
+    // The number of rows blurLanes() blurs at once, one per SIMD lane.
+    static constexpr int kLanes = 8;
+    using Lanes = skvx::Vec<kLanes, uint32_t>;
+
+    // A window of one needs no buffers, which Scan handles by aliasing them all to one slot.
+    // blurLanes() doesn't reproduce that, so leave those rare filters to Scan.
+    bool canBlurLanes() const { return fPass0Size > 0; }
+
+    // Runs Scan::blur() on kLanes rows at once. The rows' width alphas are interleaved in src,
+    // one lane per row, and each blurred column of kLanes alphas is stored to consecutive bytes,
+    // with dstStride between columns. The result is identical to blurring each row with Scan.
+    void blurLanes(const Lanes* src, int width, uint8_t* dst, size_t dstStride,
+                   Lanes* buffer) const {
+        SkASSERT(this->canBlurLanes());
+        Lanes* buffer0    = buffer;
+        Lanes* buffer0End = buffer0 + fPass0Size;
+        Lanes* buffer1    = buffer0End;
+        Lanes* buffer1End = buffer1 + fPass1Size;
+        Lanes* buffer2    = buffer1End;
+        Lanes* buffer2End = buffer2 + fPass2Size;
+
+        Lanes sum0, sum1, sum2;
+        Lanes* buffer0Cursor, *buffer1Cursor, *buffer2Cursor;
+        auto reset = [&] {
+            std::fill(buffer0, buffer2End, Lanes(0));
+            sum0 = sum1 = sum2 = 0;
+            buffer0Cursor = buffer0;
+            buffer1Cursor = buffer1;
+            buffer2Cursor = buffer2;
+        };
+
+        auto step = [&](const Lanes& leadingEdge, uint8_t* d) {
+            sum0 += leadingEdge;
+            sum1 += sum0;
+            sum2 += sum1;
+
+            this->finalScale(sum2, d);
+
+            sum2 -= *buffer2Cursor;
+            *buffer2Cursor = sum1;
+            buffer2Cursor = (buffer2Cursor + 1) < buffer2End ? buffer2Cursor + 1 : buffer2;
+
+            sum1 -= *buffer1Cursor;
+            *buffer1Cursor = sum0;
+            buffer1Cursor = (buffer1Cursor + 1) < buffer1End ? buffer1Cursor + 1 : buffer1;
+
+            sum0 -= *buffer0Cursor;
+            *buffer0Cursor = leadingEdge;
+            buffer0Cursor = (buffer0Cursor + 1) < buffer0End ? buffer0Cursor + 1 : buffer0;
+        };
+
+        const int noChangeCount = fSlidingWindow > width ? fSlidingWindow - width : 0;
+        const int dstCount = width + fSlidingWindow - 1;
+
+        // Consume the source, then let the leading edge run off the right side of the mask.
+        reset();
+        int x = 0;
+        for (; x < width; x++) {
+            step(src[x], dst + x * dstStride);
+        }
+        for (int i = 0; i < noChangeCount; i++, x++) {
+            step(Lanes(0), dst + x * dstStride);
+        }
+
+        // Starting from the right, fill in the rest.
+        reset();
+        for (int d = dstCount - 1, s = width - 1; d >= x; d--, s--) {
+            step(src[s], dst + d * dstStride);
+        }
+    }
+
+    // Scan::finalScale() for each lane, storing kLanes bytes to dst.
+    void finalScale(const Lanes& sum, uint8_t* dst) const {
+        constexpr uint64_t kRound = static_cast<uint64_t>(1) << 31;
+        // Scale the even and odd lanes separately in 64 bits, then interleave them back.
+        auto pairs = skvx::bit_pun<skvx::Vec<kLanes/2, uint64_t>>(sum);
+        auto even  = ((pairs & 0xffffffff) * fWeight + kRound) >> 32,
+             odd   = ((pairs >> 32)        * fWeight + kRound) >> 32;
+        auto packed = skvx::cast<uint16_t>(even | (odd << 8));
+        packed.store(dst);
+    }
+
     uint64_t fWeight;
     int      fBorder;
     int      fSlidingWindow;
@@ -951,9 +1036,75 @@ static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMa
     return {radiusX, radiusY};
 }
 
+// Blurs rows [top, bottom) of a mask that is width alphas wide, and writes each blurred row
+// transposed, as a column of dstCount alphas: row y goes to dst[y], dst[y + dstStride], ...
+// Whole groups of PlanGauss::kLanes rows are blurred together if useLanes; leftover rows one at a
+// time.
+template <typename AlphaIter>
+static void blur_and_transpose(const PlanGauss& plan, bool useLanes,
+                               AlphaIter rowStart, AlphaIter rowEnd,
+                               uint32_t srcRB, int width, int top, int bottom,
+                               uint8_t* dst, int dstStride, int dstCount) {
+    constexpr int kLanes = PlanGauss::kLanes;
+    rowStart >>= srcRB * top;
+    rowEnd   >>= srcRB * top;
+
+    int y = top;
+    if (useLanes && plan.canBlurLanes() && bottom - y >= kLanes) {
+        SkAutoTMalloc<PlanGauss::Lanes> columns(width);
+        SkAutoTMalloc<PlanGauss::Lanes> buffer(plan.bufferSize());
+        for (; bottom - y >= kLanes; y += kLanes) {
+            for (int lane = 0; lane < kLanes; lane++, rowStart >>= srcRB, rowEnd >>= srcRB) {
+                AlphaIter src = rowStart;
+                for (int x = 0; x < width; x++, ++src) {
+                    columns[x][lane] = *src;
+                }
+            }
+            plan.blurLanes(columns.get(), width, dst + y, dstStride, buffer.get());
+        }
+    }
+
+    SkAutoTMalloc<uint32_t> buffer(std::max<size_t>(plan.bufferSize(), 1));
+    const PlanGauss::Scan& scan = plan.makeBlurScan(width, buffer.get());
+    for (; y < bottom; y++, rowStart >>= srcRB, rowEnd >>= srcRB) {
+        auto dstStart = dst + y;
+        scan.blur(rowStart, rowEnd, dstStart, dstStride, dstStart + dstStride * dstCount);
+    }
+}
+
+// Runs blur_and_transpose() over rows [0, height) in bands on executor, if there is enough work
+// to be worth it.
+template <typename AlphaIter>
+static void blur_and_transpose_rows(SkExecutor* executor, const PlanGauss& plan, bool useLanes,
+                                    AlphaIter rowStart, AlphaIter rowEnd, uint32_t srcRB,
+                                    int width, int height,
+                                    uint8_t* dst, int dstStride, int dstCount) {
+    // Bands are whole groups of lanes, and at least this many source alphas.
+    constexpr int kMinBandAlphas = 64 * 1024;
+    const int bands = (int)std::min<int64_t>(height / PlanGauss::kLanes,
+                                             (int64_t)width * height / kMinBandAlphas);
+    if (bands <= 1) {
+        blur_and_transpose(plan, useLanes, rowStart, rowEnd, srcRB, width, 0, height,
+                           dst, dstStride, dstCount);
+        return;
+    }
+
+    const int groups = height / PlanGauss::kLanes;
+    SkTaskGroup tg(*executor);
+    for (int b = 0; b < bands; b++) {
+        int top    = PlanGauss::kLanes * (groups *  b      / bands),
+            bottom = b == bands - 1 ? height : PlanGauss::kLanes * (groups * (b + 1) / bands);
+        tg.add([=] {
+            blur_and_transpose(plan, useLanes, rowStart, rowEnd, srcRB, width, top, bottom,
+                               dst, dstStride, dstCount);
+        });
+    }
+    tg.wait();
+}
+
 // TODO: assuming sigmaW = sigmaH. Allow different sigmas. Right now the
 // API forces the sigmas to be the same.
-SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
+SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst, SkExecutor* executor) const {
 
     if (fSigmaW < 2.0 && fSigmaH < 2.0) {
         return small_blur(fSigmaW, fSigmaH, src, dst);
@@ -984,8 +1135,9 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
         dstH = dst->fBounds.height();
     SkASSERT(srcW >= 0 && srcH >= 0 && dstW >= 0 && dstH >= 0);
 
-    auto bufferSize = std::max(planW.bufferSize(), planH.bufferSize());
-    auto buffer = alloc.makeArrayDefault<uint32_t>(bufferSize);
+    if (!executor) {
+        executor = &SkExecutor::GetDefault();
+    }
 
     // Blur both directions.
     int tmpW = srcH,
@@ -994,43 +1146,34 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
     auto tmp = alloc.makeArrayDefault<uint8_t>(tmpW * tmpH);
 
     // Blur horizontally, and transpose.
-    const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffer);
     switch (src.fFormat) {
         case SkMask::kBW_Format: {
             const uint8_t* bwStart = src.fImage;
             auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
             auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
+            blur_and_transpose_rows(executor, planW, fUseLanes, start, end, src.fRowBytes,
+                                    srcW, srcH, tmp, tmpW, tmpH);
         } break;
         case SkMask::kA8_Format: {
             const uint8_t* a8Start = src.fImage;
             auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
             auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
+            blur_and_transpose_rows(executor, planW, fUseLanes, start, end, src.fRowBytes,
+                                    srcW, srcH, tmp, tmpW, tmpH);
         } break;
         case SkMask::kARGB32_Format: {
             const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(src.fImage);
             auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
             auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
+            blur_and_transpose_rows(executor, planW, fUseLanes, start, end, src.fRowBytes,
+                                    srcW, srcH, tmp, tmpW, tmpH);
         } break;
         case SkMask::kLCD16_Format: {
             const uint16_t* lcdStart = reinterpret_cast<const uint16_t*>(src.fImage);
             auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
             auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
+            blur_and_transpose_rows(executor, planW, fUseLanes, start, end, src.fRowBytes,
+                                    srcW, srcH, tmp, tmpW, tmpH);
         } break;
         default:
             SK_ABORT("Unhandled format.");
@@ -1038,14 +1181,10 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
 
     // Blur vertically (scan in memory order because of the transposition),
     // and transpose back to the original orientation.
-    const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
-    for (int y = 0; y < tmpH; y++) {
-        auto tmpStart = &tmp[y * tmpW];
-        auto dstStart = &dst->fImage[y];
-
-        scanH.blur(tmpStart, tmpStart + tmpW,
-                   dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
-    }
+    auto start = SkMask::AlphaIter<SkMask::kA8_Format>(tmp);
+    auto end = SkMask::AlphaIter<SkMask::kA8_Format>(tmp + tmpW);
+    blur_and_transpose_rows(executor, planH, fUseLanes, start, end, tmpW, tmpW, tmpH,
+                            dst->fImage, dst->fRowBytes, dstH);
 
     return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
 }
@@ -15,6 +15,8 @@
 #include "include/core/SkTypes.h"
 #include "src/core/SkMask.h"
 
+class SkExecutor;
+
 // Implement a single channel Gaussian blur. The specifics for implementation are taken from:
 // https://drafts.fxtf.org/filters/#feGaussianBlurElement
 class SkMaskBlurFilter {
@@ -27,11 +29,18 @@ public:
     bool hasNoBlur() const;
 
     // Given a src SkMask, generate dst SkMask returning the border width and height.
-    SkIPoint blur(const SkMask& src, SkMask* dst) const;
+    // Large masks are blurred in bands of rows on executor, or SkExecutor::GetDefault() if it
+    // is nullptr.
+    SkIPoint blur(const SkMask& src, SkMask* dst, SkExecutor* executor = nullptr) const;
+
+    // Blurring eight rows at once in SIMD lanes is on by default. Tests and benches turn it off
+    // to compare against blurring one row at a time.
+    void setUseLanesForTesting(bool useLanes) { fUseLanes = useLanes; }
 
 private:
     const double fSigmaW;
     const double fSigmaH;
+    bool         fUseLanes = true;
 };
 
 #endif  // SkBlurMaskFilter_DEFINED
@@ -15,6 +15,8 @@
 #include "include/private/SkVx.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkMipmap.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkTaskGroup.h"
 #include <new>
 
 //
@@ -395,7 +397,7 @@ size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
 }
 
 SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
-                          bool computeContents) {
+                          bool computeContents, SkExecutor* executor) {
     typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
 
     FilterProc* proc_1_2 = nullptr;
@@ -416,7 +418,7 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
+            proc_2_2 = SkOpts::downsample_2_2_8888;
             proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
@@ -633,14 +635,36 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
 
         const SkPixmap& dstPM = levels[i].fPixmap;
         if (computeContents) {
-            const void* srcBasePtr = srcPM.addr();
-            void* dstBasePtr = dstPM.writable_addr();
-
-            const size_t srcRB = srcPM.rowBytes();
-            for (int y = 0; y < height; y++) {
-                proc(dstBasePtr, srcBasePtr, srcRB, width);
-                srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-                dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
+            // Dst row y reads src rows 2y and 2y+1 (and 2y+2 when the src height is odd), so
+            // any band of dst rows can be filtered independently of the others: neighboring
+            // bands may read the same src row, but only ever write their own dst rows.
+            auto downsample = [proc, srcPM, dstPM](int top, int bottom) {
+                const size_t srcRB = srcPM.rowBytes();
+                const char* srcBasePtr = (const char*)srcPM.addr() + srcRB * 2 * top;
+                char* dstBasePtr = (char*)dstPM.writable_addr() + dstPM.rowBytes() * top;
+                for (int y = top; y < bottom; y++) {
+                    proc(dstBasePtr, srcBasePtr, srcRB, dstPM.width());
+                    srcBasePtr += srcRB * 2; // jump two rows
+                    dstBasePtr += dstPM.rowBytes();
+                }
+            };
+
+            // Don't bother spreading small levels across threads.
+            constexpr int kMinBandPixels = 64 * 1024;
+            const int bands = executor ? (int)std::min<int64_t>(height, (int64_t)width * height
+                                                                         / kMinBandPixels)
+                                       : 1;
+            if (bands > 1) {
+                SkTaskGroup tg(*executor);
+                for (int b = 0; b < bands; b++) {
+                    tg.add([=] {
+                        downsample((int)((int64_t)height *  b      / bands),
+                                   (int)((int64_t)height * (b + 1) / bands));
+                    });
+                }
+                tg.wait();
+            } else {
+                downsample(0, height);
             }
         }
         srcPM = dstPM;
@@ -18,6 +18,7 @@
 class SkBitmap;
 class SkData;
 class SkDiscardableMemory;
+class SkExecutor;
 class SkMipmapBuilder;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
@@ -33,8 +34,10 @@ class SkMipmap : public SkCachedData {
 public:
     // Allocate and fill-in a mipmap. If computeContents is false, we just allocated
     // and compute the sizes/rowbytes, but leave the pixel-data uninitialized.
+    // If executor is non-null, large levels are split into bands of rows that are downsampled
+    // on it concurrently. Each level still waits for the level above it to be finished.
     static SkMipmap* Build(const SkPixmap& src, SkDiscardableFactoryProc,
-                           bool computeContents = true);
+                           bool computeContents = true, SkExecutor* executor = nullptr);
 
     static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
 
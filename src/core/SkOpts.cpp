@@ -43,6 +43,7 @@
 #include "src/opts/SkBlitMask_opts.h"
 #include "src/opts/SkBlitRow_opts.h"
 #include "src/opts/SkChecksum_opts.h"
+#include "src/opts/SkMipmap_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
 #include "src/opts/SkUtils_opts.h"
@@ -88,6 +89,8 @@ namespace SkOpts {
     DEFINE_DEFAULT(S32_alpha_D32_filter_DX);
     DEFINE_DEFAULT(S32_alpha_D32_filter_DXDY);
 
+    DEFINE_DEFAULT(downsample_2_2_8888);
+
     DEFINE_DEFAULT(interpret_skvm);
 #undef DEFINE_DEFAULT
 
@@ -66,6 +66,9 @@ namespace SkOpts {
     extern void (*S32_alpha_D32_filter_DXDY)(const SkBitmapProcState&,
                                              const uint32_t* xy, int count, SkPMColor*);
 
+    // SkMipmap's 2x2 box filter for 8888 pixels, the common case for even-sized levels.
+    extern void (*downsample_2_2_8888)(void* dst, const void* src, size_t srcRB, int count);
+
 #define M(st) +1
     // We can't necessarily express the type of SkJumper stage functions here,
     // so we just use this void(*)(void) as a stand-in.
@@ -18,6 +18,7 @@
 #include "src/core/SkCubicClipper.h"
 #include "src/core/SkGeometry.h"
 #include "src/core/SkMatrixPriv.h"
+#include "src/core/SkPathConvexity.h"
 #include "src/core/SkPathMakers.h"
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkPointPriv.h"
@@ -2023,271 +2024,248 @@ bool SkPath::isValidImpl() const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static int sign(SkScalar x) { return x < 0; }
-#define kValueNeverReturnedBySign   2
-
-enum DirChange {
-    kUnknown_DirChange,
-    kLeft_DirChange,
-    kRight_DirChange,
-    kStraight_DirChange,
-    kBackwards_DirChange, // if double back, allow simple lines to be convex
-    kInvalid_DirChange
-};
-
-
-static bool almost_equal(SkScalar compA, SkScalar compB) {
-    // The error epsilon was empirically derived; worse case round rects
-    // with a mid point outset by 2x float epsilon in tests had an error
-    // of 12.
-    const int epsilon = 16;
-    if (!SkScalarIsFinite(compA) || !SkScalarIsFinite(compB)) {
-        return false;
+SkPath::Verb SkPathConvexityWalker::autoClose(SkPoint pts[2]) {
+    if (fLastPt != fMoveTo) {
+        // See SkPath::Iter::autoClose(): NaN points are treated as the same.
+        if (SkScalarIsNaN(fLastPt.fX) || SkScalarIsNaN(fLastPt.fY) ||
+            SkScalarIsNaN(fMoveTo.fX) || SkScalarIsNaN(fMoveTo.fY)) {
+            return SkPath::kClose_Verb;
+        }
+        pts[0] = fLastPt;
+        pts[1] = fMoveTo;
+        fLastPt = fMoveTo;
+        return SkPath::kLine_Verb;
     }
-    // no need to check for small numbers because SkPath::Iter has removed degenerate values
-    int aBits = SkFloatAs2sCompliment(compA);
-    int bBits = SkFloatAs2sCompliment(compB);
-    return aBits < bBits + epsilon && bBits < aBits + epsilon;
+    pts[0] = fMoveTo;
+    return SkPath::kClose_Verb;
 }
 
-// only valid for a single contour
-struct Convexicator {
-
-    /** The direction returned is only valid if the path is determined convex */
-    SkPathPriv::FirstDirection getFirstDirection() const { return fFirstDirection; }
-
-    void setMovePt(const SkPoint& pt) {
-        fPriorPt = fLastPt = fCurrPt = pt;
-    }
-
-    bool addPt(const SkPoint& pt) {
-        if (fCurrPt == pt) {
-            return true;
-        }
-        fCurrPt = pt;
-        if (fPriorPt == fLastPt) {  // should only be true for first non-zero vector
-            fLastVec = fCurrPt - fLastPt;
-            fFirstPt = pt;
-        } else if (!this->addVec(fCurrPt - fLastPt)) {
-            return false;
+SkPath::Verb SkPathConvexityWalker::next(const SkPathRef& ref, SkPoint pts[4]) {
+    if (fVerbIndex == ref.countVerbs()) {
+        if (fNeedClose && fAfterPrimitive) {
+            if (SkPath::kLine_Verb == this->autoClose(pts)) {
+                return SkPath::kLine_Verb;
+            }
+            fNeedClose = false;
+            return SkPath::kClose_Verb;
         }
-        fPriorPt = fLastPt;
-        fLastPt = fCurrPt;
-        return true;
+        return SkPath::kDone_Verb;
     }
 
-    static SkPathConvexityType BySign(const SkPoint points[], int count) {
-        const SkPoint* last = points + count;
-        SkPoint currPt = *points++;
-        SkPoint firstPt = currPt;
-        int dxes = 0;
-        int dyes = 0;
-        int lastSx = kValueNeverReturnedBySign;
-        int lastSy = kValueNeverReturnedBySign;
-        for (int outerLoop = 0; outerLoop < 2; ++outerLoop ) {
-            while (points != last) {
-                SkVector vec = *points - currPt;
-                if (!vec.isZero()) {
-                    // give up if vector construction failed
-                    if (!vec.isFinite()) {
-                        return SkPathConvexityType::kUnknown;
-                    }
-                    int sx = sign(vec.fX);
-                    int sy = sign(vec.fY);
-                    dxes += (sx != lastSx);
-                    dyes += (sy != lastSy);
-                    if (dxes > 3 || dyes > 3) {
-                        return SkPathConvexityType::kConcave;
-                    }
-                    lastSx = sx;
-                    lastSy = sy;
-                }
-                currPt = *points++;
-                if (outerLoop) {
-                    break;
+    const SkPoint* srcPts = ref.points() + fPointIndex;
+    SkPath::Verb verb = (SkPath::Verb)ref.atVerb(fVerbIndex++);
+    int ptCount = 0;
+    switch (verb) {
+        case SkPath::kMove_Verb:
+            if (fNeedClose) {
+                fVerbIndex--;
+                verb = this->autoClose(pts);
+                if (verb == SkPath::kClose_Verb) {
+                    fNeedClose = false;
                 }
+                return verb;
+            }
+            if (fVerbIndex == ref.countVerbs()) {    // a trailing moveTo
+                return SkPath::kDone_Verb;
+            }
+            fMoveTo = pts[0] = srcPts[0];
+            fLastPt = fMoveTo;
+            fAfterPrimitive = false;
+            fNeedClose = true;
+            fPointIndex += 1;
+            return verb;
+        case SkPath::kLine_Verb:
+            ptCount = 1;
+            break;
+        case SkPath::kQuad_Verb:
+        case SkPath::kConic_Verb:
+            ptCount = 2;
+            break;
+        case SkPath::kCubic_Verb:
+            ptCount = 3;
+            break;
+        case SkPath::kClose_Verb:
+            verb = this->autoClose(pts);
+            if (verb == SkPath::kLine_Verb) {
+                fVerbIndex--;
+            } else {
+                fNeedClose = false;
+                fAfterPrimitive = false;
             }
-            points = &firstPt;
+            fLastPt = fMoveTo;
+            return verb;
+        default:
+            return verb;
+    }
+    // Convexicator never looks at pts[0], the start of the segment.
+    memcpy(&pts[1], srcPts, ptCount * sizeof(SkPoint));
+    fLastPt = srcPts[ptCount - 1];
+    fAfterPrimitive = true;
+    fPointIndex += ptCount;
+    return verb;
+}
+
+bool SkPathConvexityWalker::add(SkPath::Verb verb, const SkPoint pts[4]) {
+    // This has always treated every failure as concave, even when fState gave up because a
+    // vector wasn't finite.
+    auto fail = [this]() {
+        fConvexity = SkPathConvexityType::kConcave;
+        return false;
+    };
+
+    int count;
+    switch (verb) {
+        case SkPath::kMove_Verb:
+            if (++fContourCount > 1) {
+                fConvexity = SkPathConvexityType::kConcave;
+                return false;
+            }
+            fState.setMovePt(pts[0]);
+            count = 0;
+            break;
+        case SkPath::kLine_Verb:
+            count = 1;
+            break;
+        case SkPath::kQuad_Verb:
+            // fall through
+        case SkPath::kConic_Verb:
+            count = 2;
+            break;
+        case SkPath::kCubic_Verb:
+            count = 3;
+            break;
+        case SkPath::kClose_Verb:
+            if (!fState.close()) {
+                return fail();
+            }
+            count = 0;
+            break;
+        default:
+            SkDEBUGFAIL("bad verb");
+            fConvexity = SkPathConvexityType::kConcave;
+            return false;
+    }
+    for (int i = 1; i <= count; i++) {
+        if (!fState.addPt(pts[i])) {
+            return fail();
         }
-        return SkPathConvexityType::kConvex;  // that is, it may be convex, don't know yet
     }
+    return true;
+}
 
-    bool close() {
-        return this->addPt(fFirstPt);
-    }
+SkPathConvexityWalker::Result SkPathConvexityWalker::walk(const SkPathRef& ref, int signCount) {
+    constexpr auto kNoDirection = SkPathPriv::kUnknown_FirstDirection;
+    const Result kConcave = { SkPathConvexityType::kConcave, kNoDirection, 0 },
+                 kUnknown = { SkPathConvexityType::kUnknown, kNoDirection, 0 };
 
-    bool isFinite() const {
-        return fIsFinite;
+    // Check to see if path changes direction more than three times as quick concave test.
+    // Like SkPath::Iter, this only considers the last of the initial move tos, which is always
+    // the first point: SkPath::Iter turns a second move to into a close.
+    if (signCount > 3) {
+        if (signCount < fSignCount) {
+            // Another SkPath sharing this path ref ends its test earlier.
+            fSigns = SkPathConvexity::SignChanges();
+            fSignCount = 0;
+            fSignConvexity = SkPathConvexityType::kConvex;
+        }
+        const SkPoint* points = ref.points();
+        if (fSignCount == 0) {
+            fSigns = SkPathConvexity::SignChanges(points[0]);
+            fSignCount = 1;
+        }
+        while (SkPathConvexityType::kConvex == fSignConvexity && fSignCount < signCount) {
+            fSignConvexity = fSigns.addPt(points[fSignCount++]);
+        }
+        if (SkPathConvexityType::kConvex != fSignConvexity) {
+            return SkPathConvexityType::kConcave == fSignConvexity ? kConcave : kUnknown;
+        }
+        // Closing back to the first point isn't part of the test for a longer path.
+        SkPathConvexity::SignChanges closed = fSigns;
+        switch (closed.addPt(points[0])) {
+            case SkPathConvexityType::kConcave: return kConcave;
+            case SkPathConvexityType::kUnknown: return kUnknown;
+            default: break;
+        }
+    } else if (!ref.isFinite()) {
+        return kUnknown;
     }
 
-    int reversals() const {
-        return fReversals;
+    // What SkPath::Iter does at a trailing move to, and at the end of the path, depends on what
+    // follows, so stop short of those and finish the walk on a copy.
+    SkPoint pts[4];
+    const int verbCount = ref.countVerbs();
+    while (SkPathConvexityType::kConvex == fConvexity &&
+           (fVerbIndex < verbCount - 1 ||
+            (fVerbIndex == verbCount - 1 && SkPath::kMove_Verb != ref.atVerb(fVerbIndex)))) {
+        this->add(this->next(ref, pts), pts);
+    }
+    if (SkPathConvexityType::kConvex != fConvexity) {
+        return SkPathConvexityType::kConcave == fConvexity ? kConcave : kUnknown;
     }
 
-private:
-    DirChange directionChange(const SkVector& curVec) {
-        SkScalar cross = SkPoint::CrossProduct(fLastVec, curVec);
-        if (!SkScalarIsFinite(cross)) {
-                return kUnknown_DirChange;
-        }
-        SkScalar smallest = std::min(fCurrPt.fX, std::min(fCurrPt.fY, std::min(fLastPt.fX, fLastPt.fY)));
-        SkScalar largest = std::max(fCurrPt.fX, std::max(fCurrPt.fY, std::max(fLastPt.fX, fLastPt.fY)));
-        largest = std::max(largest, -smallest);
-
-        if (almost_equal(largest, largest + cross)) {
-            constexpr SkScalar nearlyZeroSqd = SK_ScalarNearlyZero * SK_ScalarNearlyZero;
-            if (SkScalarNearlyZero(SkPointPriv::LengthSqd(fLastVec), nearlyZeroSqd) ||
-                SkScalarNearlyZero(SkPointPriv::LengthSqd(curVec), nearlyZeroSqd)) {
-                return kUnknown_DirChange;
-            }
-            return fLastVec.dot(curVec) < 0 ? kBackwards_DirChange : kStraight_DirChange;
-        }
-        return 1 == SkScalarSignAsInt(cross) ? kRight_DirChange : kLeft_DirChange;
-    }
-
-    bool addVec(const SkVector& curVec) {
-        DirChange dir = this->directionChange(curVec);
-        switch (dir) {
-            case kLeft_DirChange:       // fall through
-            case kRight_DirChange:
-                if (kInvalid_DirChange == fExpectedDir) {
-                    fExpectedDir = dir;
-                    fFirstDirection = (kRight_DirChange == dir) ? SkPathPriv::kCW_FirstDirection
-                                                                : SkPathPriv::kCCW_FirstDirection;
-                } else if (dir != fExpectedDir) {
-                    fFirstDirection = SkPathPriv::kUnknown_FirstDirection;
-                    return false;
-                }
-                fLastVec = curVec;
-                break;
-            case kStraight_DirChange:
-                break;
-            case kBackwards_DirChange:
-                //  allow path to reverse direction twice
-                //    Given path.moveTo(0, 0); path.lineTo(1, 1);
-                //    - 1st reversal: direction change formed by line (0,0 1,1), line (1,1 0,0)
-                //    - 2nd reversal: direction change formed by line (1,1 0,0), line (0,0 1,1)
-                fLastVec = curVec;
-                return ++fReversals < 3;
-            case kUnknown_DirChange:
-                return (fIsFinite = false);
-            case kInvalid_DirChange:
-                SK_ABORT("Use of invalid direction change flag");
-                break;
+    SkPathConvexityWalker end = *this;
+    SkPath::Verb verb;
+    while ((verb = end.next(ref, pts)) != SkPath::kDone_Verb) {
+        if (!end.add(verb, pts)) {
+            return SkPathConvexityType::kConcave == end.fConvexity ? kConcave : kUnknown;
         }
-        return true;
     }
-
-    SkPoint             fFirstPt {0, 0};
-    SkPoint             fPriorPt {0, 0};
-    SkPoint             fLastPt {0, 0};
-    SkPoint             fCurrPt {0, 0};
-    SkVector            fLastVec {0, 0};
-    DirChange           fExpectedDir { kInvalid_DirChange };
-    SkPathPriv::FirstDirection   fFirstDirection { SkPathPriv::kUnknown_FirstDirection };
-    int                 fReversals { 0 };
-    bool                fIsFinite { true };
-};
+    return { SkPathConvexityType::kConvex, end.fState.getFirstDirection(),
+             end.fState.reversals() };
+}
 
 SkPathConvexityType SkPath::internalGetConvexity() const {
-    SkPoint         pts[4];
-    SkPath::Verb    verb;
-    SkPath::Iter    iter(*this, true);
     auto setComputedConvexity = [=](SkPathConvexityType convexity){
         SkASSERT(SkPathConvexityType::kUnknown != convexity);
         this->setConvexityType(convexity);
         return convexity;
     };
 
-    // Check to see if path changes direction more than three times as quick concave test
     int pointCount = this->countPoints();
     // last moveTo index may exceed point count if data comes from fuzzer (via SkImageFilter)
     if (0 < fLastMoveToIndex && fLastMoveToIndex < pointCount) {
         pointCount = fLastMoveToIndex;
     }
-    if (pointCount > 3) {
-        const SkPoint* points = fPathRef->points();
-        const SkPoint* last = &points[pointCount];
-        // only consider the last of the initial move tos
-        while (SkPath::kMove_Verb == iter.next(pts)) {
-            ++points;
-        }
-        --points;
-        SkPathConvexityType convexity = Convexicator::BySign(points, (int) (last - points));
-        if (SkPathConvexityType::kConcave == convexity) {
-            return setComputedConvexity(SkPathConvexityType::kConcave);
-        } else if (SkPathConvexityType::kUnknown == convexity) {
-            return SkPathConvexityType::kUnknown;
-        }
-        iter.setPath(*this, true);
-    } else if (!this->isFinite()) {
-        return SkPathConvexityType::kUnknown;
-    }
 
-    int             contourCount = 0;
-    int             count;
-    Convexicator    state;
-    auto setFail = [=](){
-        if (!state.isFinite()) {
-            return SkPathConvexityType::kUnknown;
+    SkPathConvexityWalker::Result result;
+    {
+        SkPathRef::IncrementalState* state = fPathRef->incrementalState();
+        SkAutoMutexExclusive lock(state->fMutex);
+        // Only keep the walk around once a path ref's convexity is asked for a second time,
+        // which is what paths that grow between draws look like.
+        if (!state->fConvexityWalker && state->fConvexityWalked) {
+            state->fConvexityWalker = std::make_unique<SkPathConvexityWalker>();
         }
-        return setComputedConvexity(SkPathConvexityType::kConcave);
-    };
+        state->fConvexityWalked = true;
+        result = state->fConvexityWalker
+                ? state->fConvexityWalker->walk(*fPathRef, pointCount)
+                : SkPathConvexityWalker().walk(*fPathRef, pointCount);
+    }
 
-    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
-        switch (verb) {
-            case kMove_Verb:
-                if (++contourCount > 1) {
-                    return setComputedConvexity(SkPathConvexityType::kConcave);
-                }
-                state.setMovePt(pts[0]);
-                count = 0;
-                break;
-            case kLine_Verb:
-                count = 1;
-                break;
-            case kQuad_Verb:
-                // fall through
-            case kConic_Verb:
-                count = 2;
-                break;
-            case kCubic_Verb:
-                count = 3;
-                break;
-            case kClose_Verb:
-                if (!state.close()) {
-                    return setFail();
-                }
-                count = 0;
-                break;
-            default:
-                SkDEBUGFAIL("bad verb");
-                return setComputedConvexity(SkPathConvexityType::kConcave);
-        }
-        for (int i = 1; i <= count; i++) {
-            if (!state.addPt(pts[i])) {
-                return setFail();
-            }
-        }
+    if (SkPathConvexityType::kUnknown == result.fConvexity) {
+        return SkPathConvexityType::kUnknown;
+    }
+    if (SkPathConvexityType::kConcave == result.fConvexity) {
+        return setComputedConvexity(SkPathConvexityType::kConcave);
     }
 
     if (this->getFirstDirection() == SkPathPriv::kUnknown_FirstDirection) {
-        if (state.getFirstDirection() == SkPathPriv::kUnknown_FirstDirection
+        if (result.fFirstDirection == SkPathPriv::kUnknown_FirstDirection
                 && !this->getBounds().isEmpty()) {
-            return setComputedConvexity(state.reversals() < 3 ?
+            return setComputedConvexity(result.fReversals < 3 ?
                     SkPathConvexityType::kConvex : SkPathConvexityType::kConcave);
         }
-        this->setFirstDirection(state.getFirstDirection());
+        this->setFirstDirection(result.fFirstDirection);
     }
     return setComputedConvexity(SkPathConvexityType::kConvex);
 }
 
 bool SkPathPriv::IsConvex(const SkPoint points[], int count) {
-    SkPathConvexityType convexity = Convexicator::BySign(points, count);
+    SkPathConvexityType convexity = SkPathConvexity::Convexicator::BySign(points, count);
     if (SkPathConvexityType::kConvex != convexity) {
         return false;
     }
-    Convexicator state;
+    SkPathConvexity::Convexicator state;
     state.setMovePt(points[0]);
     for (int i = 1; i < count; i++) {
         if (!state.addPt(points[i])) {
@@ -30,6 +30,7 @@ SkPathBuilder& SkPathBuilder::reset() {
     // these are internal state
 
     fSegmentMask = 0;
+    fBoundsPointCount = 0;
     fLastMovePoint = {0, 0};
     fNeedsMoveVerb = true;
     fConvexity = SkPathConvexityType::kUnknown;
@@ -144,12 +145,23 @@ SkPathBuilder& SkPathBuilder::rCubicTo(SkPoint p1, SkPoint p2, SkPoint p3) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 
+SkRect SkPathBuilder::computeBounds() const {
+    fBoundsAreFinite = SkPathRef::ExtendPtBounds(&fBounds, fBoundsAreFinite, fPts.begin(),
+                                                 fBoundsPointCount, fPts.count());
+    fBoundsPointCount = fPts.count();
+    return fBoundsAreFinite ? fBounds : SkRect::MakeEmpty();
+}
+
 SkPath SkPathBuilder::make(sk_sp<SkPathRef> pr) const {
     switch (fIsA) {
         case kIsA_Oval:  pr->setIsOval( true, fIsACCW, fIsAStart); break;
         case kIsA_RRect: pr->setIsRRect(true, fIsACCW, fIsAStart); break;
         default: break;
     }
+    // Hand over bounds we've already computed; non-finite points are left to SkPathRef.
+    if (fBoundsPointCount > 0 && fBoundsPointCount == pr->countPoints() && fBoundsAreFinite) {
+        pr->setBounds(fBounds);
+    }
     return SkPath(std::move(pr), fFillType, fIsVolatile, fConvexity);
 }
 
@@ -505,6 +517,9 @@ SkPathBuilder& SkPathBuilder::arcTo(SkPoint rad, SkScalar angle, SkPathBuilder::
     // The final point should match the input point (by definition); replace it to
     // ensure that rounding errors in the above math don't cause any problems.
     fPts.back() = endPt;
+    if (fBoundsPointCount == fPts.count()) {
+        fBoundsPointCount = 0;
+    }
 #endif
     return *this;
 }
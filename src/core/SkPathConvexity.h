@@ -0,0 +1,270 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPathConvexity_DEFINED
+#define SkPathConvexity_DEFINED
+
+#include "include/core/SkPath.h"
+#include "include/private/SkFloatBits.h"
+#include "include/private/SkMutex.h"
+#include "include/private/SkPathRef.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkPointPriv.h"
+
+#include <memory>
+
+// Helpers shared by SkPathPriv::IsConvex() and SkPathConvexityWalker.
+namespace SkPathConvexity {
+
+inline int sign(SkScalar x) { return x < 0; }
+constexpr int kValueNeverReturnedBySign = 2;
+
+enum DirChange {
+    kUnknown_DirChange,
+    kLeft_DirChange,
+    kRight_DirChange,
+    kStraight_DirChange,
+    kBackwards_DirChange, // if double back, allow simple lines to be convex
+    kInvalid_DirChange
+};
+
+
+inline bool almost_equal(SkScalar compA, SkScalar compB) {
+    // The error epsilon was empirically derived; worse case round rects
+    // with a mid point outset by 2x float epsilon in tests had an error
+    // of 12.
+    const int epsilon = 16;
+    if (!SkScalarIsFinite(compA) || !SkScalarIsFinite(compB)) {
+        return false;
+    }
+    // no need to check for small numbers because SkPath::Iter has removed degenerate values
+    int aBits = SkFloatAs2sCompliment(compA);
+    int bBits = SkFloatAs2sCompliment(compB);
+    return aBits < bBits + epsilon && bBits < aBits + epsilon;
+}
+
+// Counts how often the x and y directions flip along a polyline. More than three flips in either
+// means the polyline can't be convex, which is a quick test to run before Convexicator.
+struct SignChanges {
+    SignChanges() = default;
+    explicit SignChanges(const SkPoint& start) : fCurrPt(start) {}
+
+    // Returns kConcave if the polyline now flips too often, kUnknown if a vector to the new point
+    // isn't finite, and kConvex (that is, it may be convex, don't know yet) otherwise.
+    SkPathConvexityType addPt(const SkPoint& pt) {
+        SkVector vec = pt - fCurrPt;
+        if (!vec.isZero()) {
+            // give up if vector construction failed
+            if (!vec.isFinite()) {
+                return SkPathConvexityType::kUnknown;
+            }
+            int sx = sign(vec.fX);
+            int sy = sign(vec.fY);
+            fDxes += (sx != fLastSx);
+            fDyes += (sy != fLastSy);
+            if (fDxes > 3 || fDyes > 3) {
+                return SkPathConvexityType::kConcave;
+            }
+            fLastSx = sx;
+            fLastSy = sy;
+        }
+        fCurrPt = pt;
+        return SkPathConvexityType::kConvex;
+    }
+
+private:
+    SkPoint fCurrPt {0, 0};
+    int     fDxes = 0;
+    int     fDyes = 0;
+    int     fLastSx = kValueNeverReturnedBySign;
+    int     fLastSy = kValueNeverReturnedBySign;
+};
+
+// only valid for a single contour
+struct Convexicator {
+
+    /** The direction returned is only valid if the path is determined convex */
+    SkPathPriv::FirstDirection getFirstDirection() const { return fFirstDirection; }
+
+    void setMovePt(const SkPoint& pt) {
+        fPriorPt = fLastPt = fCurrPt = pt;
+    }
+
+    bool addPt(const SkPoint& pt) {
+        if (fCurrPt == pt) {
+            return true;
+        }
+        fCurrPt = pt;
+        if (fPriorPt == fLastPt) {  // should only be true for first non-zero vector
+            fLastVec = fCurrPt - fLastPt;
+            fFirstPt = pt;
+        } else if (!this->addVec(fCurrPt - fLastPt)) {
+            return false;
+        }
+        fPriorPt = fLastPt;
+        fLastPt = fCurrPt;
+        return true;
+    }
+
+    static SkPathConvexityType BySign(const SkPoint points[], int count) {
+        SignChanges signs(points[0]);
+        for (int i = 1; i < count; ++i) {
+            SkPathConvexityType convexity = signs.addPt(points[i]);
+            if (SkPathConvexityType::kConvex != convexity) {
+                return convexity;
+            }
+        }
+        return signs.addPt(points[0]);
+    }
+
+    bool close() {
+        return this->addPt(fFirstPt);
+    }
+
+    bool isFinite() const {
+        return fIsFinite;
+    }
+
+    int reversals() const {
+        return fReversals;
+    }
+
+private:
+    DirChange directionChange(const SkVector& curVec) {
+        SkScalar cross = SkPoint::CrossProduct(fLastVec, curVec);
+        if (!SkScalarIsFinite(cross)) {
+                return kUnknown_DirChange;
+        }
+        SkScalar smallest = std::min(fCurrPt.fX, std::min(fCurrPt.fY, std::min(fLastPt.fX, fLastPt.fY)));
+        SkScalar largest = std::max(fCurrPt.fX, std::max(fCurrPt.fY, std::max(fLastPt.fX, fLastPt.fY)));
+        largest = std::max(largest, -smallest);
+
+        if (almost_equal(largest, largest + cross)) {
+            constexpr SkScalar nearlyZeroSqd = SK_ScalarNearlyZero * SK_ScalarNearlyZero;
+            if (SkScalarNearlyZero(SkPointPriv::LengthSqd(fLastVec), nearlyZeroSqd) ||
+                SkScalarNearlyZero(SkPointPriv::LengthSqd(curVec), nearlyZeroSqd)) {
+                return kUnknown_DirChange;
+            }
+            return fLastVec.dot(curVec) < 0 ? kBackwards_DirChange : kStraight_DirChange;
+        }
+        return 1 == SkScalarSignAsInt(cross) ? kRight_DirChange : kLeft_DirChange;
+    }
+
+    bool addVec(const SkVector& curVec) {
+        DirChange dir = this->directionChange(curVec);
+        switch (dir) {
+            case kLeft_DirChange:       // fall through
+            case kRight_DirChange:
+                if (kInvalid_DirChange == fExpectedDir) {
+                    fExpectedDir = dir;
+                    fFirstDirection = (kRight_DirChange == dir) ? SkPathPriv::kCW_FirstDirection
+                                                                : SkPathPriv::kCCW_FirstDirection;
+                } else if (dir != fExpectedDir) {
+                    fFirstDirection = SkPathPriv::kUnknown_FirstDirection;
+                    return false;
+                }
+                fLastVec = curVec;
+                break;
+            case kStraight_DirChange:
+                break;
+            case kBackwards_DirChange:
+                //  allow path to reverse direction twice
+                //    Given path.moveTo(0, 0); path.lineTo(1, 1);
+                //    - 1st reversal: direction change formed by line (0,0 1,1), line (1,1 0,0)
+                //    - 2nd reversal: direction change formed by line (1,1 0,0), line (0,0 1,1)
+                fLastVec = curVec;
+                return ++fReversals < 3;
+            case kUnknown_DirChange:
+                return (fIsFinite = false);
+            case kInvalid_DirChange:
+                SK_ABORT("Use of invalid direction change flag");
+                break;
+        }
+        return true;
+    }
+
+    SkPoint             fFirstPt {0, 0};
+    SkPoint             fPriorPt {0, 0};
+    SkPoint             fLastPt {0, 0};
+    SkPoint             fCurrPt {0, 0};
+    SkVector            fLastVec {0, 0};
+    DirChange           fExpectedDir { kInvalid_DirChange };
+    SkPathPriv::FirstDirection   fFirstDirection { SkPathPriv::kUnknown_FirstDirection };
+    int                 fReversals { 0 };
+    bool                fIsFinite { true };
+};
+
+}  // namespace SkPathConvexity
+
+/**
+ *  Computes the convexity of an SkPathRef the same way SkPath::getConvexityType() always has,
+ *  but remembers how far through the verbs and points it got. When more verbs are appended to the
+ *  path ref, walk() picks up where it left off, so a path that is grown a segment at a time and
+ *  asked for its convexity along the way is only walked once in total.
+ *
+ *  Anything that changes existing points or verbs (rather than appending) must start a new walker.
+ */
+class SkPathConvexityWalker {
+public:
+    struct Result {
+        // kConcave or kUnknown if that was decided along the way. kConvex otherwise, in which case
+        // the path is convex unless fFirstDirection is unknown and there are 3 or more reversals.
+        SkPathConvexityType         fConvexity;
+        SkPathPriv::FirstDirection  fFirstDirection;
+        int                         fReversals;
+    };
+
+    /**
+     *  'signCount' is the number of leading points the quick sign change test looks at; the test
+     *  is skipped when it is 3 or less.
+     */
+    Result walk(const SkPathRef&, int signCount);
+
+private:
+    // Mirrors SkPath::Iter::next(), iterating with forceClose.
+    SkPath::Verb next(const SkPathRef&, SkPoint pts[4]);
+    SkPath::Verb autoClose(SkPoint pts[2]);
+
+    // Feeds a verb from next() to fState. Returns false once the convexity is decided.
+    bool add(SkPath::Verb, const SkPoint pts[4]);
+
+    // The sign change test over points [0, fSignCount), which resumes if the path grows.
+    SkPathConvexity::SignChanges fSigns;
+    int                 fSignCount = 0;
+    SkPathConvexityType fSignConvexity = SkPathConvexityType::kConvex;
+
+    // SkPath::Iter's state, just before the verb at fVerbIndex.
+    int                 fVerbIndex = 0;
+    int                 fPointIndex = 0;
+    SkPoint             fMoveTo {0, 0};
+    SkPoint             fLastPt {0, 0};
+    bool                fNeedClose = false;
+    bool                fAfterPrimitive = false;
+
+    int                 fContourCount = 0;
+    SkPathConvexity::Convexicator fState;
+    SkPathConvexityType fConvexity = SkPathConvexityType::kConvex;
+};
+
+struct SkPathRef::IncrementalState {
+    // A hash of the first fCount elements of an array, extended as elements are appended.
+    struct RollingHash {
+        int      fCount = 0;
+        uint32_t fHash = 0;
+    };
+
+    // Guards the rest, which may be updated by several threads at once.
+    SkMutex     fMutex;
+    RollingHash fPointsHash;
+    RollingHash fVerbsHash;
+    RollingHash fWeightsHash;
+    // Only kept once convexity has been computed more than once (fConvexityWalked).
+    std::unique_ptr<SkPathConvexityWalker> fConvexityWalker;
+    bool        fConvexityWalked = false;
+};
+
+#endif
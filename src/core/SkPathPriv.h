@@ -99,6 +99,15 @@ public:
         path.fPathRef->addGenIDChangeListener(std::move(listener));
     }
 
+    /**
+     * Returns a hash of the path's verbs, points, conic weights and fill type, suitable for keying
+     * caches by what a path contains rather than by its generation ID. It is cheap to call again
+     * after appending to the path; see SkPathRef::contentHash().
+     */
+    static uint32_t ContentHash(const SkPath& path) {
+        return path.fPathRef->contentHash() ^ (static_cast<uint32_t>(path.getFillType()) << 30);
+    }
+
     /**
      * This returns true for a rect that begins and ends at the same corner and has either a move
      * followed by four lines or a move followed by 3 lines and a close. None of the parameters are
@@ -386,6 +395,13 @@ public:
      */
     static int GenIDChangeListenersCount(const SkPath&);
 
+    /**
+     *  Returns the number of bytes SkPath::readFromMemory() would consume from storage, judging
+     *  only by the serialized header (the verbs and points themselves are not validated), or 0
+     *  if storage does not start with a path this version can read.
+     */
+    static size_t SerializedSize(const void* storage, size_t length);
+
     static void UpdatePathPoint(SkPath* path, int index, const SkPoint& pt) {
         SkASSERT(index < path->countPoints());
         SkPathRef::Editor ed(&path->fPathRef);
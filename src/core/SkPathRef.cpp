@@ -8,10 +8,12 @@
 #include "include/private/SkPathRef.h"
 
 #include "include/core/SkPath.h"
+#include "include/private/SkChecksum.h"
 #include "include/private/SkNx.h"
 #include "include/private/SkOnce.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkBuffer.h"
+#include "src/core/SkPathConvexity.h"
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkPathView.h"
 #include "src/core/SkSafeMath.h"
@@ -50,11 +52,43 @@ void SkPath::shrinkToFit() {
 
 //////////////////////////////////////////////////////////////////////////////
 
+SkPathRef::SkPathRef(SkTDArray<SkPoint> points, SkTDArray<uint8_t> verbs,
+                     SkTDArray<SkScalar> weights, unsigned segmentMask)
+    : fPoints(std::move(points))
+    , fVerbs(std::move(verbs))
+    , fConicWeights(std::move(weights))
+{
+    fBoundsIsDirty = true;    // this also invalidates fIsFinite
+    fGenerationID = 0;        // recompute
+    fSegmentMask = segmentMask;
+    fIsOval = false;
+    fIsRRect = false;
+    // The next two values don't matter unless fIsOval or fIsRRect are true.
+    fRRectOrOvalIsCCW = false;
+    fRRectOrOvalStartIdx = 0xAC;
+    SkDEBUGCODE(fEditorsAttached.store(0);)
+    SkDEBUGCODE(this->validate();)
+}
+
+SkPathRef::SkPathRef() {
+    fBoundsIsDirty = true;    // this also invalidates fIsFinite
+    fGenerationID = kEmptyGenID;
+    fSegmentMask = 0;
+    fIsOval = false;
+    fIsRRect = false;
+    // The next two values don't matter unless fIsOval or fIsRRect are true.
+    fRRectOrOvalIsCCW = false;
+    fRRectOrOvalStartIdx = 0xAC;
+    SkDEBUGCODE(fEditorsAttached.store(0);)
+    SkDEBUGCODE(this->validate();)
+}
+
 SkPathRef::~SkPathRef() {
     // Deliberately don't validate() this path ref, otherwise there's no way
     // to read one that's not valid and then free its memory without asserting.
     SkDEBUGCODE(fGenerationID = 0xEEEEEEEE;)
     SkDEBUGCODE(fEditorsAttached.store(0x7777777);)
+    delete fIncrementalState.load(std::memory_order_relaxed);
 }
 
 static SkPathRef* gEmpty = nullptr;
@@ -147,6 +181,7 @@ void SkPathRef::CreateTransformedCopy(sk_sp<SkPathRef>* dst,
         dst->reset(new SkPathRef);
     }
 
+    (*dst)->resetIncrementalState();
     if (dst->get() != &src) {
         (*dst)->fPoints = src.fPoints;
         (*dst)->fVerbs = src.fVerbs;
@@ -172,6 +207,7 @@ void SkPathRef::CreateTransformedCopy(sk_sp<SkPathRef>* dst,
      */
     if (canXformBounds) {
         (*dst)->fBoundsIsDirty = false;
+        (*dst)->fBoundsPointCount = (*dst)->countPoints();
         if (src.fIsFinite) {
             matrix.mapRect(&(*dst)->fBounds, src.fBounds);
             if (!((*dst)->fIsFinite = (*dst)->fBounds.isFinite())) {
@@ -211,6 +247,7 @@ void SkPathRef::Rewind(sk_sp<SkPathRef>* pathRef) {
     if ((*pathRef)->unique()) {
         SkDEBUGCODE((*pathRef)->validate();)
         (*pathRef)->callGenIDChangeListeners();
+        (*pathRef)->resetIncrementalState();
         (*pathRef)->fBoundsIsDirty = true;  // this also invalidates fIsFinite
         (*pathRef)->fGenerationID = 0;
         (*pathRef)->fPoints.rewind();
@@ -299,10 +336,23 @@ void SkPathRef::copy(const SkPathRef& ref,
     fPoints = ref.fPoints;
     fConicWeights = ref.fConicWeights;
     fBoundsIsDirty = ref.fBoundsIsDirty;
-    if (!fBoundsIsDirty) {
+    fBoundsPointCount = ref.fBoundsPointCount;
+    if (!fBoundsIsDirty || fBoundsPointCount > 0) {
         fBounds = ref.fBounds;
         fIsFinite = ref.fIsFinite;
     }
+    if (IncrementalState* src = ref.fIncrementalState.load(std::memory_order_acquire)) {
+        // The copy has the same contents, so it can carry on from where 'ref' got to.
+        IncrementalState* dst = this->incrementalState();
+        SkAutoMutexExclusive lock(src->fMutex);
+        dst->fPointsHash = src->fPointsHash;
+        dst->fVerbsHash = src->fVerbsHash;
+        dst->fWeightsHash = src->fWeightsHash;
+        if (src->fConvexityWalker) {
+            dst->fConvexityWalker = std::make_unique<SkPathConvexityWalker>(*src->fConvexityWalker);
+        }
+        dst->fConvexityWalked = src->fConvexityWalked;
+    }
     fSegmentMask = ref.fSegmentMask;
     fIsOval = ref.fIsOval;
     fIsRRect = ref.fIsRRect;
@@ -326,6 +376,88 @@ unsigned SkPathRef::computeSegmentMask() const {
     return mask;
 }
 
+bool SkPathRef::ExtendPtBounds(SkRect* bounds, bool prefixIsFinite, const SkPoint pts[],
+                               int prefix, int count) {
+    if (prefix <= 0 || prefix > count) {
+        return bounds->setBoundsCheck(pts, count);
+    }
+    SkRect appended;
+    if (!prefixIsFinite || !appended.setBoundsCheck(pts + prefix, count - prefix)) {
+        bounds->setEmpty();
+        return false;
+    }
+    // Not join(), which would skip the bounds of a lone point for being empty.
+    if (prefix < count) {
+        bounds->setLTRB(std::min(bounds->fLeft,   appended.fLeft),
+                        std::min(bounds->fTop,    appended.fTop),
+                        std::max(bounds->fRight,  appended.fRight),
+                        std::max(bounds->fBottom, appended.fBottom));
+    }
+    return true;
+}
+
+void SkPathRef::resetIncrementalState() {
+    fBoundsPointCount = 0;
+    // Only called while editing, when no other thread can be using this path ref.
+    delete fIncrementalState.exchange(nullptr, std::memory_order_relaxed);
+}
+
+SkPathRef::IncrementalState* SkPathRef::incrementalState() const {
+    IncrementalState* state = fIncrementalState.load(std::memory_order_acquire);
+    if (!state) {
+        // Several threads may get here at once; the first one to publish its state wins.
+        auto fresh = std::make_unique<IncrementalState>();
+        if (fIncrementalState.compare_exchange_strong(state, fresh.get(),
+                                                      std::memory_order_acq_rel,
+                                                      std::memory_order_acquire)) {
+            state = fresh.release();
+        }
+    }
+    return state;
+}
+
+// One round of MurmurHash3_x86_32, so hashing a word at a time gives the same result however the
+// words were split up between calls.
+static uint32_t hash_word(uint32_t hash, uint32_t k) {
+    k *= 0xcc9e2d51;
+    k = (k << 15) | (k >> 17);
+    k *= 0x1b873593;
+    hash ^= k;
+    hash = (hash << 13) | (hash >> 19);
+    return hash * 5 + 0xe6546b64;
+}
+
+template <typename T>
+static void extend_hash(uint32_t* hash, int* hashed, const SkTDArray<T>& array) {
+    static_assert(sizeof(T) == 1 || sizeof(T) % 4 == 0, "");
+    for (int i = *hashed; i < array.count(); ++i) {
+        if constexpr (sizeof(T) == 1) {
+            *hash = hash_word(*hash, *reinterpret_cast<const uint8_t*>(&array[i]));
+        } else {
+            uint32_t words[sizeof(T) / 4];
+            memcpy(words, &array[i], sizeof(T));
+            for (uint32_t word : words) {
+                *hash = hash_word(*hash, word);
+            }
+        }
+    }
+    *hashed = array.count();
+}
+
+uint32_t SkPathRef::contentHash() const {
+    IncrementalState* state = this->incrementalState();
+    SkAutoMutexExclusive lock(state->fMutex);
+    IncrementalState::RollingHash& points  = state->fPointsHash;
+    IncrementalState::RollingHash& verbs   = state->fVerbsHash;
+    IncrementalState::RollingHash& weights = state->fWeightsHash;
+    extend_hash(&points.fHash,  &points.fCount,  fPoints);
+    extend_hash(&verbs.fHash,   &verbs.fCount,   fVerbs);
+    extend_hash(&weights.fHash, &weights.fCount, fConicWeights);
+
+    uint32_t hash = hash_word(hash_word(hash_word(0, points.fHash), verbs.fHash), weights.fHash);
+    return SkChecksum::Mix(hash ^ (fPoints.count() + fVerbs.count() + fConicWeights.count()));
+}
+
 void SkPathRef::interpolate(const SkPathRef& ending, SkScalar weight, SkPathRef* out) const {
     const SkScalar* inValues = &ending.getPoints()->fX;
     SkScalar* outValues = &out->getWritablePoints()->fX;
@@ -157,6 +157,37 @@ size_t SkPath::readFromMemory(const void* storage, size_t length) {
     return 0;
 }
 
+size_t SkPathPriv::SerializedSize(const void* storage, size_t length) {
+    SkRBuffer buffer(storage, length);
+    uint32_t packed;
+    if (!buffer.readU32(&packed)) {
+        return 0;
+    }
+    unsigned version = extract_version(packed);
+    if (version < kMin_Version || version > kCurrent_Version) {
+        return 0;
+    }
+
+    switch (extract_serializationtype(packed)) {
+        case SerializationType::kRRect:
+            buffer.skip(SkRRect::kSizeInMemory + sizeof(int32_t));  // rrect + start
+            break;
+        case SerializationType::kGeneral: {
+            int32_t pts, cnx, vbs;
+            if (!buffer.readS32(&pts) || !buffer.readS32(&cnx) || !buffer.readS32(&vbs)) {
+                return 0;
+            }
+            buffer.skipCount<SkPoint>(pts);
+            buffer.skipCount<SkScalar>(cnx);
+            buffer.skipCount<uint8_t>(vbs);
+        } break;
+        default:
+            return 0;
+    }
+    buffer.skipToAlign4();
+    return buffer.isValid() ? buffer.pos() : 0;
+}
+
 size_t SkPath::readAsRRect(const void* storage, size_t length) {
     SkRBuffer buffer(storage, length);
     uint32_t packed;
@@ -7,17 +7,22 @@
 
 #include "include/core/SkPicture.h"
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkSerialProcs.h"
+#include "include/core/SkSurface.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkDevice.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkPictureCommon.h"
 #include "src/core/SkPictureData.h"
 #include "src/core/SkPicturePlayback.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkPictureRecord.h"
+#include "src/core/SkTaskGroup.h"
 #include <atomic>
 
 // When we read/write the SkPictInfo via a stream, we have a sentinel byte right after the info.
@@ -127,10 +132,89 @@ sk_sp<SkPicture> SkPicture::Forwardport(const SkPictInfo& info,
     return r.finishRecordingAsPicture();
 }
 
+// A picture loaded by MakeFromMappedData(), played back straight from its SkPictureData
+// (whose ops and objects still live in the mapping) instead of being re-recorded into an SkRecord.
+class SkMappedPicture final : public SkPicture {
+public:
+    SkMappedPicture(std::unique_ptr<SkPictureData> data, size_t resourceBudget)
+        : fData(std::move(data))
+        , fResourceBudget(resourceBudget) {}
+
+    void playback(SkCanvas* canvas, AbortCallback* callback) const override {
+        if (fResourceBudget) {
+            SkPictureResourceCache cache(fResourceBudget);
+            SkPicturePlayback(fData.get(), &cache).draw(canvas, callback, nullptr);
+        } else {
+            SkPicturePlayback(fData.get()).draw(canvas, callback, nullptr);
+        }
+    }
+
+    // We don't walk the ops to count them (that would touch every page of the mapping), so
+    // guess from their size; the smallest ops are a single 4-byte word, most are 16+ bytes.
+    int approximateOpCount(bool nested) const override {
+        int count = SkToInt(fData->opData()->size() / 16);
+        if (nested) {
+            for (const auto& pic : fData->pictures()) {
+                count += pic->approximateOpCount(true);
+            }
+        }
+        return count;
+    }
+    size_t approximateBytesUsed() const override {
+        return sizeof(*this) + sizeof(SkPictureData) + fData->opData()->size();
+    }
+    SkRect cullRect() const override { return fData->info().fCullRect; }
+
+    // Walks the op headers (and the flags of layer ops) without decoding anything.
+    bool readsBackdrop() const override {
+        const SkData* ops = fData->opData().get();
+        SkReadBuffer reader(ops->data(), ops->size());
+        while (!reader.eof()) {
+            const size_t start = reader.offset();
+            uint32_t bits = reader.readInt();
+            uint32_t op   = bits >> 24,
+                     size = bits & 0xffffff;
+            if (size == 0xffffff) {
+                size = reader.readInt();
+            }
+            if (!reader.validate(size > 0 && size <= ops->size() - start)) {
+                return true;  // Malformed, so we can't tell.
+            }
+            if (op == SAVE_BEHIND) {
+                return true;
+            }
+            if (op == SAVE_LAYER_SAVELAYERREC && (reader.readInt() & SAVELAYERREC_HAS_BACKDROP)) {
+                return true;
+            }
+            reader.skip(start + size - reader.offset());
+        }
+        for (const auto& pic : fData->pictures()) {
+            if (SkPicturePriv::ReadsBackdrop(pic.get())) {
+                return true;
+            }
+        }
+        return !reader.isValid();
+    }
+
+private:
+    std::unique_ptr<SkPictureData> fData;
+    size_t                         fResourceBudget;
+};
+
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialProcs* procs) {
     return MakeFromStream(stream, procs, nullptr);
 }
 
+sk_sp<SkPicture> SkPicture::MakeFromMappedData(sk_sp<SkData> data, const SkDeserialProcs* procs,
+                                               size_t resourceBudget) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data);
+    SkPictureMapping mapping = {data.get(), resourceBudget};
+    return MakeFromStream(&stream, procs, nullptr, &mapping);
+}
+
 sk_sp<SkPicture> SkPicture::MakeFromData(const void* data, size_t size,
                                          const SkDeserialProcs* procs) {
     if (!data) {
@@ -149,7 +233,8 @@ sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, const SkDeserialPro
 }
 
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialProcs* procsPtr,
-                                           SkTypefacePlayback* typefaces) {
+                                           SkTypefacePlayback* typefaces,
+                                           const SkPictureMapping* mapping) {
     SkPictInfo info;
     if (!StreamIsSKP(stream, &info)) {
         return nullptr;
@@ -165,7 +250,14 @@ sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialPro
     switch (trailingStreamByteAfterPictInfo) {
         case kPictureData_TrailingStreamByteAfterPictInfo: {
             std::unique_ptr<SkPictureData> data(
-                    SkPictureData::CreateFromStream(stream, info, procs, typefaces));
+                    SkPictureData::CreateFromStream(stream, info, procs, typefaces, mapping));
+            if (mapping) {
+                if (!data || !data->opData()) {
+                    return nullptr;
+                }
+                return sk_sp<SkPicture>(new SkMappedPicture(std::move(data),
+                                                            mapping->fResourceBudget));
+            }
             return Forwardport(info, data.get(), nullptr);
         }
         case kCustom_TrailingStreamByteAfterPictInfo: {
@@ -218,6 +310,61 @@ SkPictureData* SkPicture::backport() const {
     return new SkPictureData(rec, info);
 }
 
+void SkPicture::playbackParallel(SkCanvas* canvas, SkExecutor* executor, int bandCount) const {
+    // Bands split the clip exactly along pixel rows, so it must be a non-AA rect.  Backdrop
+    // filters (and SaveBehind) read pixels outside the clip, which neighbouring bands write.
+    // Bands draw straight into the pixels of the canvas' own top device: wrapper canvases
+    // (SkPaintFilterCanvas, SkNWayCanvas, ...) forward pixel access to another canvas, but their
+    // own device has no pixels, so they play back normally and keep their behavior.
+    SkBaseDevice* device = SkCanvasPriv::TopDevice(canvas);
+    if (!canvas->isClipRect() || SkCanvasPriv::IsClipAA(canvas) || this->readsBackdrop() ||
+        !device || !device->isPixelAlignedToGlobal()) {
+        this->playback(canvas);
+        return;
+    }
+
+    // We're about to draw behind the canvas' back, so let any surface copy-on-write first.
+    if (SkSurface* surface = canvas->getSurface()) {
+        surface->notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+    }
+
+    SkPixmap pixels;
+    SkBitmap dst;
+    if (!device->accessPixels(&pixels) || !dst.installPixels(pixels)) {
+        this->playback(canvas);
+        return;
+    }
+    const SkIPoint origin = device->getOrigin();
+
+    // Work in the coordinate space of the top layer's pixels.
+    SkIRect clip = canvas->getDeviceClipBounds().makeOffset(-origin.x(), -origin.y());
+    if (!clip.intersect(dst.bounds())) {
+        return;
+    }
+    SkMatrix ctm = canvas->getTotalMatrix();
+    ctm.postTranslate(-origin.x(), -origin.y());
+
+    SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+    canvas->getProps(&props);
+
+    if (bandCount <= 0) {
+        bandCount = (clip.height() + 255) / 256;
+    }
+    bandCount = std::min(bandCount, clip.height());
+
+    SkTaskGroup tg(executor ? *executor : SkExecutor::GetDefault());
+    tg.batch(bandCount, [&](int i) {
+        int top    = clip.fTop + clip.height() *  i      / bandCount,
+            bottom = clip.fTop + clip.height() * (i + 1) / bandCount;
+        SkCanvas bandCanvas(dst, props);
+        bandCanvas.clipRect(SkRect::Make(SkIRect::MakeLTRB(clip.fLeft, top, clip.fRight, bottom)));
+        bandCanvas.setMatrix(ctm);
+        // SkBigPicture queries its BBH with this clip, so we'll only visit ops touching the band.
+        this->playback(&bandCanvas);
+    });
+    tg.wait();
+}
+
 void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procs) const {
     this->serialize(stream, procs, nullptr);
 }
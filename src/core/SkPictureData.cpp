@@ -11,6 +11,7 @@
 #include "include/core/SkTypeface.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkAutoMalloc.h"
+#include "src/core/SkPathPriv.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkPictureRecord.h"
 #include "src/core/SkReadBuffer.h"
@@ -89,6 +90,17 @@ static void write_tag_size(SkWStream* stream, uint32_t tag, size_t size) {
     stream->write32(SkToU32(size));
 }
 
+// Writes a pad section if needed so that the payload of the next tag/size pair starts at a
+// 4-byte aligned stream offset, letting SkPicture::MakeFromMappedData() read it in place.
+static void write_pad_for_next_tag(SkWStream* stream) {
+    size_t pad = (0 - stream->bytesWritten()) & 3;
+    if (pad) {
+        write_tag_size(stream, SK_PICT_PAD_TAG, pad);
+        uint32_t zero = 0;
+        stream->write(&zero, pad);
+    }
+}
+
 void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     int count = rec.count();
 
@@ -204,6 +216,7 @@ static SkSerialProcs skip_typeface_proc(const SkSerialProcs& procs) {
 void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
                               SkRefCntSet* topLevelTypeFaceSet, bool textBlobsOnly) const {
     // This can happen at pretty much any time, so might as well do it first.
+    write_pad_for_next_tag(stream);
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
 
@@ -242,6 +255,7 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
     WriteTypefaces(stream, *typefaceSet, procs);
 
     // Write the buffer.
+    write_pad_for_next_tag(stream);
     write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
     buffer.writeToStream(stream);
 
@@ -281,15 +295,43 @@ void SkPictureData::flatten(SkWriteBuffer& buffer) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Returns the next size bytes of stream as a subset of mapping if they are 4-byte aligned (as
+// SkReadBuffer requires), skipping over them, or nullptr if they need to be copied instead.
+static sk_sp<SkData> map_from_stream(SkStream* stream, const SkPictureMapping* mapping,
+                                     size_t size) {
+    if (!mapping) {
+        return nullptr;
+    }
+    const SkData* data = mapping->fData;
+    SkASSERT(stream->getMemoryBase() == data->data());
+    size_t offset = stream->getPosition();
+    if (!SkIsAlign4((uintptr_t)data->bytes() + offset) || size > data->size() - offset) {
+        return nullptr;
+    }
+    if (stream->skip(size) != size) {
+        return nullptr;
+    }
+    return SkData::MakeSubset(data, offset, size);
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
                                    const SkDeserialProcs& procs,
-                                   SkTypefacePlayback* topLevelTFPlayback) {
+                                   SkTypefacePlayback* topLevelTFPlayback,
+                                   const SkPictureMapping* mapping) {
     switch (tag) {
+        case SK_PICT_PAD_TAG:
+            if (stream->skip(size) != size) {
+                return false;
+            }
+            break;
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            fOpData = map_from_stream(stream, mapping, size);
+            if (!fOpData) {
+                fOpData = SkData::MakeFromStream(stream, size);
+            }
             if (!fOpData) {
                 return false;
             }
@@ -330,7 +372,7 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             fPictures.reserve(SkToInt(size));
 
             for (uint32_t i = 0; i < size; i++) {
-                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback);
+                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback, mapping);
                 if (!pic) {
                     return false;
                 }
@@ -338,12 +380,28 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
-                return false;
+            SkAutoMalloc storage;
+            const void* bytes;
+            if (mapping) {
+                // Objects are decoded lazily from this data, so it must outlive the parse.
+                SkASSERT(!fArrayData);
+                fArrayData = map_from_stream(stream, mapping, size);
+                if (!fArrayData) {
+                    fArrayData = SkData::MakeFromStream(stream, size);
+                }
+                if (!fArrayData) {
+                    return false;
+                }
+                bytes = fArrayData->data();
+            } else {
+                storage.reset(size);
+                if (stream->read(storage.get(), size) != size) {
+                    return false;
+                }
+                bytes = storage.get();
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(bytes, size);
             buffer.setVersion(fInfo.getVersion());
 
             if (!fFactoryPlayback) {
@@ -358,6 +416,16 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             } else {
                 // Newer .skp files serialize all typefaces with the top picture.
                 topLevelTFPlayback->setupBuffer(buffer);
+                if (fArrayData && topLevelTFPlayback != &fTFPlayback) {
+                    // We'll still need them after the top picture's data is gone.
+                    fTFPlayback.setCount(topLevelTFPlayback->count());
+                    for (size_t i = 0; i < topLevelTFPlayback->count(); i++) {
+                        fTFPlayback[i] = (*topLevelTFPlayback)[i];
+                    }
+                }
+            }
+            if (fArrayData) {
+                fProcs = procs;
             }
 
             while (!buffer.eof() && buffer.isValid()) {
@@ -406,7 +474,90 @@ bool new_array_from_buffer(SkReadBuffer& buffer, uint32_t inCount,
     return true;
 }
 
+// Skips over an image written by SkWriteBuffer::writeImage() without decoding it.
+static void skip_image(SkReadBuffer& buffer) {
+    auto skip_byte_array = [&buffer] { buffer.skip(buffer.readUInt()); };
+
+    if (buffer.isVersionLT(SkPicturePriv::kSerializeMipmaps_Version)) {
+        SkIRect bounds;
+        buffer.readIRect(&bounds);
+        buffer.skip(SkAbs32(buffer.read32()));
+        return;
+    }
+    uint32_t flags = buffer.read32();
+    skip_byte_array();
+    if (flags & SkWriteBufferImageFlags::kHasSubsetRect) {
+        SkIRect subset;
+        buffer.readIRect(&subset);
+    }
+    if (flags & SkWriteBufferImageFlags::kHasMipmap) {
+        skip_byte_array();
+    }
+}
+
+template <typename T, typename SkipFn>
+void SkPictureData::locateLazyObjects(SkReadBuffer& buffer, LazyKind kind, int count,
+                                      SkTArray<T>* decoded, SkipFn&& skip) {
+    // Every object takes at least 4 bytes, so this keeps a bad count from allocating too much.
+    if (!buffer.validate(!fLazy[kind] && count >= 0 && (size_t)count <= buffer.available() / 4)) {
+        return;
+    }
+    fLazy[kind].reset(new LazyObject[count]);
+    for (int i = 0; i < count && buffer.isValid(); i++) {
+        fLazy[kind][i].fOffset = buffer.offset();
+        skip();
+        fLazy[kind][i].fSize = buffer.offset() - fLazy[kind][i].fOffset;
+    }
+    if (buffer.isValid()) {
+        decoded->push_back_n(count);
+    }
+}
+
 void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t size) {
+    if (fArrayData) {
+        // Loading from a mapping: just note where each object is, and size the arrays they'll
+        // be decoded into. We only have a cheap way to skip paths and images, so the others are
+        // decoded once here and dropped right away.
+        const int count = SkTFitsIn<int>(size) ? SkToInt(size) : -1;
+        switch (tag) {
+            case SK_PICT_PAINT_BUFFER_TAG:
+                this->locateLazyObjects(buffer, kPaint_LazyKind, count, &fPaints, [&] {
+                    SkPaint paint;
+                    buffer.readPaint(&paint, nullptr);
+                });
+                return;
+            case SK_PICT_PATH_BUFFER_TAG:
+                if (size > 0) {
+                    const int pathCount = buffer.readInt();
+                    this->locateLazyObjects(buffer, kPath_LazyKind, pathCount, &fPaths, [&] {
+                        size_t pathSize = SkPathPriv::SerializedSize(
+                                fArrayData->bytes() + buffer.offset(), buffer.available());
+                        if (buffer.validate(pathSize > 0 && SkIsAlign4(pathSize))) {
+                            buffer.skip(pathSize);
+                        }
+                    });
+                }
+                return;
+            case SK_PICT_TEXTBLOB_BUFFER_TAG:
+                this->locateLazyObjects(buffer, kTextBlob_LazyKind, count, &fTextBlobs, [&] {
+                    buffer.validate(SkTextBlobPriv::MakeFromBuffer(buffer) != nullptr);
+                });
+                return;
+            case SK_PICT_VERTICES_BUFFER_TAG:
+                this->locateLazyObjects(buffer, kVertices_LazyKind, count, &fVertices, [&] {
+                    buffer.validate(SkVerticesPriv::Decode(buffer) != nullptr);
+                });
+                return;
+            case SK_PICT_IMAGE_BUFFER_TAG:
+                this->locateLazyObjects(buffer, kImage_LazyKind, count, &fImages, [&] {
+                    skip_image(buffer);
+                });
+                return;
+            default:
+                break;  // Everything else is read as usual.
+        }
+    }
+
     switch (tag) {
         case SK_PICT_PAINT_BUFFER_TAG: {
             if (!buffer.validate(SkTFitsIn<int>(size))) {
@@ -472,13 +623,14 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                const SkDeserialProcs& procs,
-                                               SkTypefacePlayback* topLevelTFPlayback) {
+                                               SkTypefacePlayback* topLevelTFPlayback,
+                                               const SkPictureMapping* mapping) {
     std::unique_ptr<SkPictureData> data(new SkPictureData(info));
     if (!topLevelTFPlayback) {
         topLevelTFPlayback = &data->fTFPlayback;
     }
 
-    if (!data->parseStream(stream, procs, topLevelTFPlayback)) {
+    if (!data->parseStream(stream, procs, topLevelTFPlayback, mapping)) {
         return nullptr;
     }
     return data.release();
@@ -497,7 +649,8 @@ SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
 
 bool SkPictureData::parseStream(SkStream* stream,
                                 const SkDeserialProcs& procs,
-                                SkTypefacePlayback* topLevelTFPlayback) {
+                                SkTypefacePlayback* topLevelTFPlayback,
+                                const SkPictureMapping* mapping) {
     for (;;) {
         uint32_t tag;
         if (!stream->readU32(&tag)) { return false; }
@@ -507,7 +660,7 @@ bool SkPictureData::parseStream(SkStream* stream,
 
         uint32_t size;
         if (!stream->readU32(&size)) { return false; }
-        if (!this->parseStreamTag(stream, tag, size, procs, topLevelTFPlayback)) {
+        if (!this->parseStreamTag(stream, tag, size, procs, topLevelTFPlayback, mapping)) {
             return false; // we're invalid
         }
     }
@@ -532,20 +685,140 @@ bool SkPictureData::parseBuffer(SkReadBuffer& buffer) {
     return true;
 }
 
-const SkPaint* SkPictureData::optionalPaint(SkReadBuffer* reader) const {
+const SkPaint* SkPictureData::optionalPaint(SkReadBuffer* reader,
+                                            SkPictureResourceCache* cache) const {
     int index = reader->readInt();
     if (index == 0) {
         return nullptr; // recorder wrote a zero for no paint (likely drawimage)
     }
-    return reader->validate(index > 0 && index <= fPaints.count()) ?
-        &fPaints[index - 1] : nullptr;
+    if (!reader->validate(index > 0 && index <= fPaints.count())) {
+        return nullptr;
+    }
+    return fLazy[kPaint_LazyKind] ? &this->lazyPaint(index - 1, cache) : &fPaints[index - 1];
 }
 
-const SkPaint& SkPictureData::requiredPaint(SkReadBuffer* reader) const {
-    const SkPaint* paint = this->optionalPaint(reader);
+const SkPaint& SkPictureData::requiredPaint(SkReadBuffer* reader,
+                                            SkPictureResourceCache* cache) const {
+    const SkPaint* paint = this->optionalPaint(reader, cache);
     if (reader->validate(paint != nullptr)) {
         return *paint;
     }
     static const SkPaint& stub = *(new SkPaint);
     return stub;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkPictureResourceCache::purge() {
+    Entry evicted;
+    while (fBytesUsed > fBudget && fLRU.removeLRU(&evicted)) {
+        fBytesUsed -= evicted.fBytes;
+    }
+}
+
+void SkPictureData::decodeLazyObject(LazyKind kind, int index,
+                                     SkPictureResourceCache::Entry* entry) const {
+    const LazyObject& obj = fLazy[kind][index];
+    SkReadBuffer buffer(fArrayData->bytes() + obj.fOffset, obj.fSize);
+    buffer.setVersion(fInfo.getVersion());
+    fFactoryPlayback->setupBuffer(buffer);
+    fTFPlayback.setupBuffer(buffer);
+    buffer.setDeserialProcs(fProcs);
+
+    switch (kind) {
+        case kPaint_LazyKind:    buffer.readPaint(&entry->fPaint, nullptr);               break;
+        case kPath_LazyKind:     buffer.readPath(&entry->fPath);
+                                 entry->fPath.updateBoundsCache();                         break;
+        case kTextBlob_LazyKind: entry->fTextBlob = SkTextBlobPriv::MakeFromBuffer(buffer); break;
+        case kVertices_LazyKind: entry->fVertices = SkVerticesPriv::Decode(buffer);        break;
+        case kImage_LazyKind:    entry->fImage    = buffer.readImage();                    break;
+        case kLazyKindCount:     SkUNREACHABLE;
+    }
+    // We approximate what the decoded object costs by its serialized size.
+    entry->fBytes = sizeof(*entry) + obj.fSize;
+}
+
+const SkPictureResourceCache::Entry& SkPictureData::cachedLazyObject(
+        LazyKind kind, int index, SkPictureResourceCache* cache) const {
+    const uint64_t key = (uint64_t)kind << 32 | (uint32_t)index;
+    if (const SkPictureResourceCache::Entry* entry = cache->fLRU.find(key)) {
+        return *entry;
+    }
+    SkPictureResourceCache::Entry entry;
+    this->decodeLazyObject(kind, index, &entry);
+    cache->fBytesUsed += entry.fBytes;
+    return *cache->fLRU.insert(key, std::move(entry));
+}
+
+const SkPaint& SkPictureData::lazyPaint(int index, SkPictureResourceCache* cache) const {
+    if (cache) {
+        return this->cachedLazyObject(kPaint_LazyKind, index, cache).fPaint;
+    }
+    fLazy[kPaint_LazyKind][index].fOnce([&] {
+        SkPictureResourceCache::Entry entry;
+        this->decodeLazyObject(kPaint_LazyKind, index, &entry);
+        fPaints[index] = std::move(entry.fPaint);
+    });
+    return fPaints[index];
+}
+
+const SkPath& SkPictureData::lazyPath(int index, SkPictureResourceCache* cache) const {
+    if (cache) {
+        return this->cachedLazyObject(kPath_LazyKind, index, cache).fPath;
+    }
+    fLazy[kPath_LazyKind][index].fOnce([&] {
+        SkPictureResourceCache::Entry entry;
+        this->decodeLazyObject(kPath_LazyKind, index, &entry);
+        fPaths[index] = std::move(entry.fPath);
+    });
+    return fPaths[index];
+}
+
+// Text blobs, vertices and images can fail to decode; that invalidates the reader just as a bad
+// index would, so playback skips the op rather than drawing a null object.
+template <typename T>
+static const T* validate_decoded(SkReadBuffer* reader, const sk_sp<const T>& obj) {
+    return reader->validate(obj != nullptr) ? obj.get() : nullptr;
+}
+
+const SkTextBlob* SkPictureData::lazyTextBlob(SkReadBuffer* reader, int index,
+                                              SkPictureResourceCache* cache) const {
+    if (cache) {
+        return validate_decoded(reader,
+                                this->cachedLazyObject(kTextBlob_LazyKind, index, cache).fTextBlob);
+    }
+    fLazy[kTextBlob_LazyKind][index].fOnce([&] {
+        SkPictureResourceCache::Entry entry;
+        this->decodeLazyObject(kTextBlob_LazyKind, index, &entry);
+        fTextBlobs[index] = std::move(entry.fTextBlob);
+    });
+    return validate_decoded(reader, fTextBlobs[index]);
+}
+
+const SkVertices* SkPictureData::lazyVertices(SkReadBuffer* reader, int index,
+                                              SkPictureResourceCache* cache) const {
+    if (cache) {
+        return validate_decoded(reader,
+                                this->cachedLazyObject(kVertices_LazyKind, index, cache).fVertices);
+    }
+    fLazy[kVertices_LazyKind][index].fOnce([&] {
+        SkPictureResourceCache::Entry entry;
+        this->decodeLazyObject(kVertices_LazyKind, index, &entry);
+        fVertices[index] = std::move(entry.fVertices);
+    });
+    return validate_decoded(reader, fVertices[index]);
+}
+
+const SkImage* SkPictureData::lazyImage(SkReadBuffer* reader, int index,
+                                        SkPictureResourceCache* cache) const {
+    if (cache) {
+        return validate_decoded(reader,
+                                this->cachedLazyObject(kImage_LazyKind, index, cache).fImage);
+    }
+    fLazy[kImage_LazyKind][index].fOnce([&] {
+        SkPictureResourceCache::Entry entry;
+        this->decodeLazyObject(kImage_LazyKind, index, &entry);
+        fImages[index] = std::move(entry.fImage);
+    });
+    return validate_decoded(reader, fImages[index]);
+}
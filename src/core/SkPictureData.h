@@ -10,8 +10,13 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkDrawable.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
 #include "include/core/SkPicture.h"
+#include "include/core/SkSerialProcs.h"
+#include "include/private/SkOnce.h"
 #include "include/private/SkTArray.h"
+#include "src/core/SkLRUCache.h"
 #include "src/core/SkPictureFlat.h"
 
 #include <memory>
@@ -54,6 +59,8 @@ public:
 #define SK_PICT_TYPEFACE_TAG   SkSetFourByteTag('t', 'p', 'f', 'c')
 #define SK_PICT_PICTURE_TAG    SkSetFourByteTag('p', 'c', 't', 'r')
 #define SK_PICT_DRAWABLE_TAG   SkSetFourByteTag('d', 'r', 'a', 'w')
+// Zero padding so the next section's payload starts 4-byte aligned in the stream (V80+).
+#define SK_PICT_PAD_TAG        SkSetFourByteTag('p', 'a', 'd', ' ')
 
 // This tag specifies the size of the ReadBuffer, needed for the following tags
 #define SK_PICT_BUFFER_SIZE_TAG     SkSetFourByteTag('a', 'r', 'a', 'y')
@@ -67,6 +74,43 @@ public:
 // Always write this last (with no length field afterwards)
 #define SK_PICT_EOF_TAG     SkSetFourByteTag('e', 'o', 'f', ' ')
 
+// How SkPicture::MakeFromMappedData() was asked to load a picture and its sub-pictures.
+struct SkPictureMapping {
+    const SkData* fData;            // the SkStream being parsed reads from this
+    size_t        fResourceBudget;  // 0 to keep decoded objects for the picture's lifetime
+};
+
+// Paints, paths, text blobs, vertices and images decoded during one playback of a picture loaded
+// with a resource budget. It's local to that playback, so needs no locking. Objects are only
+// dropped by purge(), which SkPicturePlayback calls between ops, so anything handed out for the
+// op being played back stays valid until the next one starts.
+class SkPictureResourceCache : SkNoncopyable {
+public:
+    explicit SkPictureResourceCache(size_t budget) : fBudget(budget), fLRU(SK_MaxS32) {}
+
+    // Drops least recently used objects until no more than the budget is in use.
+    void purge();
+
+    size_t bytesUsed() const { return fBytesUsed; }
+
+private:
+    friend class SkPictureData;
+
+    // Only the field matching the object's kind is set.
+    struct Entry {
+        SkPaint                  fPaint;
+        SkPath                   fPath;
+        sk_sp<const SkTextBlob>  fTextBlob;
+        sk_sp<const SkVertices>  fVertices;
+        sk_sp<const SkImage>     fImage;
+        size_t                   fBytes = 0;
+    };
+
+    size_t                       fBudget;
+    size_t                       fBytesUsed = 0;
+    SkLRUCache<uint64_t, Entry>  fLRU;  // keyed by kind << 32 | index
+};
+
 template <typename T>
 T* read_index_base_1_or_null(SkReadBuffer* reader, const SkTArray<sk_sp<T>>& array) {
     int index = reader->readInt();
@@ -77,35 +121,52 @@ class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&);
     // Does not affect ownership of SkStream.
+    // If mapping is non-null the stream must be reading from it; aligned sections are then
+    // referenced in place rather than copied, and paints, paths, text blobs, vertices and images
+    // are only located at load and decoded as playback uses them.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            const SkDeserialProcs&,
-                                           SkTypefacePlayback*);
+                                           SkTypefacePlayback*,
+                                           const SkPictureMapping* mapping = nullptr);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
     void serialize(SkWStream*, const SkSerialProcs&, SkRefCntSet*, bool textBlobsOnly=false) const;
     void flatten(SkWriteBuffer&) const;
 
     const sk_sp<SkData>& opData() const { return fOpData; }
+    const SkPictInfo& info() const { return fInfo; }
+
+    const SkTArray<sk_sp<const SkPicture>>& pictures() const { return fPictures; }
 
 protected:
     explicit SkPictureData(const SkPictInfo& info);
 
     // Does not affect ownership of SkStream.
-    bool parseStream(SkStream*, const SkDeserialProcs&, SkTypefacePlayback*);
+    bool parseStream(SkStream*, const SkDeserialProcs&, SkTypefacePlayback*,
+                     const SkPictureMapping*);
     bool parseBuffer(SkReadBuffer& buffer);
 
 public:
-    const SkImage* getImage(SkReadBuffer* reader) const {
+    // For pictures loaded from a mapping, the getters below decode objects as they're first asked
+    // for. With a cache they go there and may later be purged, otherwise they're kept for good.
+
+    const SkImage* getImage(SkReadBuffer* reader, SkPictureResourceCache* cache = nullptr) const {
         // images are written base-0, unlike paths, pictures, drawables, etc.
         const int index = reader->readInt();
-        return reader->validateIndex(index, fImages.count()) ? fImages[index].get() : nullptr;
+        if (!reader->validateIndex(index, fImages.count())) {
+            return nullptr;
+        }
+        return fLazy[kImage_LazyKind] ? this->lazyImage(reader, index, cache)
+                                      : fImages[index].get();
     }
 
-    const SkPath& getPath(SkReadBuffer* reader) const {
+    const SkPath& getPath(SkReadBuffer* reader, SkPictureResourceCache* cache = nullptr) const {
         int index = reader->readInt();
-        return reader->validate(index > 0 && index <= fPaths.count()) ?
-                fPaths[index - 1] : fEmptyPath;
+        if (!reader->validate(index > 0 && index <= fPaths.count())) {
+            return fEmptyPath;
+        }
+        return fLazy[kPath_LazyKind] ? this->lazyPath(index - 1, cache) : fPaths[index - 1];
     }
 
     const SkPicture* getPicture(SkReadBuffer* reader) const {
@@ -117,17 +178,31 @@ public:
     }
 
     // Return a paint if one was used for this op, or nullptr if none was used.
-    const SkPaint* optionalPaint(SkReadBuffer* reader) const;
+    const SkPaint* optionalPaint(SkReadBuffer* reader,
+                                 SkPictureResourceCache* cache = nullptr) const;
 
     // Return the paint used for this op, invalidating the SkReadBuffer if there appears to be none.
     // The returned paint is always safe to use.
-    const SkPaint& requiredPaint(SkReadBuffer* reader) const;
-
-    const SkTextBlob* getTextBlob(SkReadBuffer* reader) const {
+    const SkPaint& requiredPaint(SkReadBuffer* reader,
+                                 SkPictureResourceCache* cache = nullptr) const;
+
+    const SkTextBlob* getTextBlob(SkReadBuffer* reader,
+                                  SkPictureResourceCache* cache = nullptr) const {
+        if (fLazy[kTextBlob_LazyKind]) {
+            int index = reader->readInt();
+            return reader->validate(index > 0 && index <= fTextBlobs.count())
+                   ? this->lazyTextBlob(reader, index - 1, cache) : nullptr;
+        }
         return read_index_base_1_or_null(reader, fTextBlobs);
     }
 
-    const SkVertices* getVertices(SkReadBuffer* reader) const {
+    const SkVertices* getVertices(SkReadBuffer* reader,
+                                  SkPictureResourceCache* cache = nullptr) const {
+        if (fLazy[kVertices_LazyKind]) {
+            int index = reader->readInt();
+            return reader->validate(index > 0 && index <= fVertices.count())
+                   ? this->lazyVertices(reader, index - 1, cache) : nullptr;
+        }
         return read_index_base_1_or_null(reader, fVertices);
     }
 
@@ -135,23 +210,60 @@ private:
     // these help us with reading/writing
     // Does not affect ownership of SkStream.
     bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size,
-                        const SkDeserialProcs&, SkTypefacePlayback*);
+                        const SkDeserialProcs&, SkTypefacePlayback*, const SkPictureMapping*);
     void parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&, bool textBlobsOnly) const;
 
-    SkTArray<SkPaint>  fPaints;
-    SkTArray<SkPath>   fPaths;
+    enum LazyKind {
+        kPaint_LazyKind,
+        kPath_LazyKind,
+        kTextBlob_LazyKind,
+        kVertices_LazyKind,
+        kImage_LazyKind,
+
+        kLazyKindCount
+    };
+
+    // Where one object lives in fArrayData. Without a cache it is decoded into the matching
+    // array below, possibly from several playback threads at once, hence the SkOnce.
+    struct LazyObject {
+        size_t fOffset = 0;
+        size_t fSize   = 0;
+        SkOnce fOnce;
+    };
+
+    template <typename T, typename SkipFn>
+    void locateLazyObjects(SkReadBuffer&, LazyKind, int count, SkTArray<T>* decoded, SkipFn&&);
+    void decodeLazyObject(LazyKind, int index, SkPictureResourceCache::Entry*) const;
+    const SkPictureResourceCache::Entry& cachedLazyObject(LazyKind, int index,
+                                                          SkPictureResourceCache*) const;
+
+    const SkPaint&    lazyPaint(int index, SkPictureResourceCache*) const;
+    const SkPath&     lazyPath(int index, SkPictureResourceCache*) const;
+    const SkTextBlob* lazyTextBlob(SkReadBuffer*, int index, SkPictureResourceCache*) const;
+    const SkVertices* lazyVertices(SkReadBuffer*, int index, SkPictureResourceCache*) const;
+    const SkImage*    lazyImage(SkReadBuffer*, int index, SkPictureResourceCache*) const;
+
+    // When loaded from a mapping, these arrays start out sized but empty.
+    mutable SkTArray<SkPaint>  fPaints;
+    mutable SkTArray<SkPath>   fPaths;
+
+    // Only set when loaded from a mapping, along with the arrays section holding the objects
+    // and what's needed to decode them later.
+    std::unique_ptr<LazyObject[]> fLazy[kLazyKindCount];
+    sk_sp<SkData>                 fArrayData;
+    SkDeserialProcs               fProcs;
 
     sk_sp<SkData>   fOpData;    // opcodes and parameters
 
     const SkPath    fEmptyPath;
     const SkBitmap  fEmptyBitmap;
 
-    SkTArray<sk_sp<const SkPicture>>   fPictures;
-    SkTArray<sk_sp<SkDrawable>>        fDrawables;
-    SkTArray<sk_sp<const SkTextBlob>>  fTextBlobs;
-    SkTArray<sk_sp<const SkVertices>>  fVertices;
-    SkTArray<sk_sp<const SkImage>>     fImages;
+    SkTArray<sk_sp<const SkPicture>>           fPictures;
+    SkTArray<sk_sp<SkDrawable>>                fDrawables;
+    mutable SkTArray<sk_sp<const SkTextBlob>>  fTextBlobs;
+    mutable SkTArray<sk_sp<const SkVertices>>  fVertices;
+    mutable SkTArray<sk_sp<const SkImage>>     fImages;
 
     SkTypefacePlayback                 fTFPlayback;
     std::unique_ptr<SkFactoryPlayback> fFactoryPlayback;
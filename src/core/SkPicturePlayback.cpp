@@ -64,6 +64,10 @@ void SkPicturePlayback::draw(SkCanvas* canvas,
             return;
         }
 
+        if (fCache) {
+            fCache->purge();
+        }
+
         fCurOffset = reader.offset();
 
         uint32_t bits = reader.readInt();
@@ -108,7 +112,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->flush();
             break;
         case CLIP_PATH: {
-            const SkPath& path = fPictureData->getPath(reader);
+            const SkPath& path = fPictureData->getPath(reader, fCache);
             uint32_t packed = reader->readInt();
             SkClipOp clipOp = ClipParams_unpackRegionOp(reader, packed);
             bool doAA = ClipParams_unpackDoAA(packed);
@@ -166,7 +170,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             }
         } break;
         case CLIP_SHADER_IN_PAINT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
             SkClipOp clipOp = reader->checkRange(SkClipOp::kDifference, SkClipOp::kIntersect);
             BREAK_ON_READ_ERROR(reader);
 
@@ -200,7 +204,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawAnnotation(rect, key.c_str(), data.get());
         } break;
         case DRAW_ARC: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
             SkRect rect;
             reader->readRect(&rect);
             SkScalar startAngle = reader->readScalar();
@@ -211,8 +215,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawArc(rect, startAngle, sweepAngle, SkToBool(useCenter), paint);
         } break;
         case DRAW_ATLAS: {
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
-            const SkImage* atlas = fPictureData->getImage(reader);
+            const SkPaint* paint = fPictureData->optionalPaint(reader, fCache);
+            const SkImage* atlas = fPictureData->getImage(reader, fCache);
             const uint32_t flags = reader->readUInt();
             const int count = reader->readUInt();
             const SkRSXform* xform = (const SkRSXform*)reader->skip(count, sizeof(SkRSXform));
@@ -258,7 +262,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawDrawable(drawable, &matrix);
         } break;
         case DRAW_DRRECT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
             SkRRect outer, inner;
             reader->readRRect(&outer);
             reader->readRRect(&inner);
@@ -290,7 +294,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             if (!reader->validate(cnt >= 0)) {
                 break;
             }
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
+            const SkPaint* paint = fPictureData->optionalPaint(reader, fCache);
 
             SkCanvas::SrcRectConstraint constraint =
                     reader->checkRange(SkCanvas::kStrict_SrcRectConstraint,
@@ -306,7 +310,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             int maxMatrixIndex = -1;
             SkAutoTArray<SkCanvas::ImageSetEntry> set(cnt);
             for (int i = 0; i < cnt && reader->isValid(); ++i) {
-                set[i].fImage = sk_ref_sp(fPictureData->getImage(reader));
+                set[i].fImage = sk_ref_sp(fPictureData->getImage(reader, fCache));
                 reader->readRect(&set[i].fSrcRect);
                 reader->readRect(&set[i].fDstRect);
                 set[i].fMatrixIndex = reader->readInt();
@@ -350,8 +354,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
                                                     paint, constraint);
         } break;
         case DRAW_IMAGE: {
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
-            const SkImage* image = fPictureData->getImage(reader);
+            const SkPaint* paint = fPictureData->optionalPaint(reader, fCache);
+            const SkImage* image = fPictureData->getImage(reader, fCache);
             SkPoint loc;
             reader->readPoint(&loc);
             BREAK_ON_READ_ERROR(reader);
@@ -359,8 +363,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawImage(image, loc.fX, loc.fY, paint);
         } break;
         case DRAW_IMAGE_LATTICE: {
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
-            const SkImage* image = fPictureData->getImage(reader);
+            const SkPaint* paint = fPictureData->optionalPaint(reader, fCache);
+            const SkImage* image = fPictureData->getImage(reader, fCache);
             SkCanvas::Lattice lattice;
             (void)SkCanvasPriv::ReadLattice(*reader, &lattice);
             const SkRect* dst = reader->skipT<SkRect>();
@@ -369,8 +373,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawImageLattice(image, lattice, *dst, paint);
         } break;
         case DRAW_IMAGE_NINE: {
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
-            const SkImage* image = fPictureData->getImage(reader);
+            const SkPaint* paint = fPictureData->optionalPaint(reader, fCache);
+            const SkImage* image = fPictureData->getImage(reader, fCache);
             SkIRect center;
             reader->readIRect(&center);
             SkRect dst;
@@ -380,8 +384,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawImageNine(image, center, dst, paint);
         } break;
         case DRAW_IMAGE_RECT: {
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
-            const SkImage* image = fPictureData->getImage(reader);
+            const SkPaint* paint = fPictureData->optionalPaint(reader, fCache);
+            const SkImage* image = fPictureData->getImage(reader, fCache);
             SkRect storage;
             const SkRect* src = get_rect_ptr(reader, &storage);   // may be null
             SkRect dst;
@@ -398,7 +402,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->legacy_drawImageRect(image, src, dst, paint, constraint);
         } break;
         case DRAW_OVAL: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
             SkRect rect;
             reader->readRect(&rect);
             BREAK_ON_READ_ERROR(reader);
@@ -406,19 +410,19 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawOval(rect, paint);
         } break;
         case DRAW_PAINT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
             BREAK_ON_READ_ERROR(reader);
 
             canvas->drawPaint(paint);
         } break;
         case DRAW_BEHIND_PAINT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
             BREAK_ON_READ_ERROR(reader);
 
             SkCanvasPriv::DrawBehind(canvas, paint);
         } break;
         case DRAW_PATCH: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
 
             const SkPoint* cubics = (const SkPoint*)reader->skip(SkPatchUtils::kNumCtrlPts,
                                                                  sizeof(SkPoint));
@@ -444,8 +448,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawPatch(cubics, colors, texCoords, bmode, paint);
         } break;
         case DRAW_PATH: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
-            const auto& path = fPictureData->getPath(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
+            const auto& path = fPictureData->getPath(reader, fCache);
             BREAK_ON_READ_ERROR(reader);
 
             canvas->drawPath(path, paint);
@@ -457,7 +461,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawPicture(pic);
         } break;
         case DRAW_PICTURE_MATRIX_PAINT: {
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
+            const SkPaint* paint = fPictureData->optionalPaint(reader, fCache);
             SkMatrix matrix;
             reader->readMatrix(&matrix);
             const SkPicture* pic = fPictureData->getPicture(reader);
@@ -466,7 +470,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawPicture(pic, &matrix, paint);
         } break;
         case DRAW_POINTS: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
             SkCanvas::PointMode mode = (SkCanvas::PointMode)reader->readInt();
             size_t count = reader->readInt();
             const SkPoint* pts = (const SkPoint*)reader->skip(count, sizeof(SkPoint));
@@ -475,7 +479,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawPoints(mode, count, pts, paint);
         } break;
         case DRAW_RECT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
             SkRect rect;
             reader->readRect(&rect);
             BREAK_ON_READ_ERROR(reader);
@@ -483,7 +487,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawRect(rect, paint);
         } break;
         case DRAW_REGION: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
             SkRegion region;
             reader->readRegion(&region);
             BREAK_ON_READ_ERROR(reader);
@@ -491,7 +495,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawRegion(region, paint);
         } break;
         case DRAW_RRECT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
             SkRRect rrect;
             reader->readRRect(&rrect);
             BREAK_ON_READ_ERROR(reader);
@@ -499,7 +503,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawRRect(rrect, paint);
         } break;
         case DRAW_SHADOW_REC: {
-            const auto& path = fPictureData->getPath(reader);
+            const auto& path = fPictureData->getPath(reader, fCache);
             SkDrawShadowRec rec;
             reader->readPoint3(&rec.fZPlaneParams);
             reader->readPoint3(&rec.fLightPos);
@@ -512,8 +516,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->private_draw_shadow_rec(path, rec);
         } break;
         case DRAW_TEXT_BLOB: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
-            const SkTextBlob* blob = fPictureData->getTextBlob(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
+            const SkTextBlob* blob = fPictureData->getTextBlob(reader, fCache);
             SkScalar x = reader->readScalar();
             SkScalar y = reader->readScalar();
             BREAK_ON_READ_ERROR(reader);
@@ -521,8 +525,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawTextBlob(blob, x, y, paint);
         } break;
         case DRAW_VERTICES_OBJECT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
-            const SkVertices* vertices = fPictureData->getVertices(reader);
+            const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
+            const SkVertices* vertices = fPictureData->getVertices(reader, fCache);
             const int boneCount = reader->readInt();
             (void)reader->skip(boneCount, sizeof(SkVertices_DeprecatedBone));
             SkBlendMode bmode = reader->read32LE(SkBlendMode::kLastMode);
@@ -561,7 +565,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
         case SAVE_LAYER_SAVEFLAGS_DEPRECATED: {
             SkRect storage;
             const SkRect* boundsPtr = get_rect_ptr(reader, &storage);
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
+            const SkPaint* paint = fPictureData->optionalPaint(reader, fCache);
             auto flags = SkCanvasPriv::LegacySaveFlagsToSaveLayerFlags(reader->readInt());
             BREAK_ON_READ_ERROR(reader);
 
@@ -576,17 +580,17 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
                 rec.fBounds = &bounds;
             }
             if (flatFlags & SAVELAYERREC_HAS_PAINT) {
-                rec.fPaint = &fPictureData->requiredPaint(reader);
+                rec.fPaint = &fPictureData->requiredPaint(reader, fCache);
             }
             if (flatFlags & SAVELAYERREC_HAS_BACKDROP) {
-                const SkPaint& paint = fPictureData->requiredPaint(reader);
+                const SkPaint& paint = fPictureData->requiredPaint(reader, fCache);
                 rec.fBackdrop = paint.getImageFilter();
             }
             if (flatFlags & SAVELAYERREC_HAS_FLAGS) {
                 rec.fSaveLayerFlags = reader->readInt();
             }
             if (flatFlags & SAVELAYERREC_HAS_CLIPMASK_OBSOLETE) {
-                (void)fPictureData->getImage(reader);
+                (void)fPictureData->getImage(reader, fCache);
             }
             if (flatFlags & SAVELAYERREC_HAS_CLIPMATRIX_OBSOLETE) {
                 SkMatrix clipMatrix_ignored;
@@ -14,12 +14,16 @@ class SkBitmap;
 class SkCanvas;
 class SkPaint;
 class SkPictureData;
+class SkPictureResourceCache;
 
 // The basic picture playback class replays the provided picture into a canvas.
 class SkPicturePlayback final : SkNoncopyable {
 public:
-    SkPicturePlayback(const SkPictureData* data)
+    // If cache is non-null, objects of a picture loaded from a mapping are decoded into it and
+    // purged between ops to keep it within budget.
+    SkPicturePlayback(const SkPictureData* data, SkPictureResourceCache* cache = nullptr)
         : fPictureData(data)
+        , fCache(cache)
         , fCurOffset(0) {
     }
 
@@ -32,7 +36,8 @@ public:
     void resetOpID() { fCurOffset = 0; }
 
 protected:
-    const SkPictureData* fPictureData;
+    const SkPictureData*    fPictureData;
+    SkPictureResourceCache* fCache;
 
     // The offset of the current operation when within the draw method
     size_t fCurOffset;
@@ -35,6 +35,10 @@ public:
         return picture->asSkBigPicture();
     }
 
+    static bool ReadsBackdrop(const SkPicture* picture) {
+        return picture->readsBackdrop();
+    }
+
     // V35: Store SkRect (rather then width & height) in header
     // V36: Remove (obsolete) alphatype from SkColorTable
     // V37: Added shadow only option to SkDropShadowImageFilter (last version to record CLEAR)
@@ -80,6 +84,7 @@ public:
     // V77: Explicit filtering options on imageshaders
     // V78: Serialize skmipmap data for images that have it
     // V79: Cubic Resampler option on imageshader
+    // V80: Stream-serialized picture data pads its op and array sections to 4-byte offsets
 
     enum Version {
         kMorphologyTakesScalar_Version      = 74,
@@ -88,10 +93,11 @@ public:
         kFilterOptionsInImageShader_Version = 77,
         kSerializeMipmaps_Version           = 78,
         kCubicResamplerImageShader_Version  = 79,
+        kAlignedStreamSections_Version      = 80,
 
         // Only SKPs within the min/current picture version range (inclusive) can be read.
         kMin_Version     = kMorphologyTakesScalar_Version,
-        kCurrent_Version = kCubicResamplerImageShader_Version
+        kCurrent_Version = kAlignedStreamSections_Version
     };
 
     static_assert(SkPicturePriv::kMin_Version <= SkPicturePriv::kCubicResamplerImageShader_Version,
@@ -16,6 +16,7 @@
 #include "src/core/SkMipmap.h"
 #include "src/core/SkOpts.h"
 
+#include <atomic>
 #include <stddef.h>
 #include <stdlib.h>
 
@@ -269,6 +270,24 @@ void SkResourceCache::purgeSharedID(uint64_t sharedID) {
 #endif
 }
 
+void SkResourceCache::detachAll(SkTDArray<Rec*>* recs) {
+    // Oldest first, so adopting them in order rebuilds the same relative LRU order.
+    while (Rec* rec = fTail) {
+        this->release(rec);
+        fHash->remove(rec->getKey());
+        fTotalBytesUsed -= rec->bytesUsed();
+        fCount -= 1;
+        recs->push_back(rec);
+    }
+    SkASSERT(0 == fTotalBytesUsed && 0 == fCount);
+}
+
+void SkResourceCache::adopt(Rec* rec) {
+    SkASSERT(!fHash->find(rec->getKey()));
+    this->addToHead(rec);
+    fHash->set(rec);
+}
+
 void SkResourceCache::visitAll(Visitor visitor, void* context) {
     // go backwards, just like purgeAsNeeded, just to make the code similar.
     // could iterate either direction and still be correct.
@@ -450,89 +469,234 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static SkResourceCache* gResourceCache = nullptr;
-static SkMutex& resource_cache_mutex() {
-    static SkMutex& mutex = *(new SkMutex);
-    return mutex;
+// The global cache is split into shards: independent SkResourceCaches, each with its own mutex,
+// LRU list and an equal share of the total byte limit. A Key's hash picks its shard, so threads
+// working on unrelated keys don't serialize on one lock. Each shard purges its own LRU list when
+// it goes over its share of the budget, which approximates a single global LRU. One shard (the
+// default) is exactly the old single-mutex cache.
+
+#ifndef SK_DEFAULT_RESOURCE_CACHE_SHARD_COUNT
+    #define SK_DEFAULT_RESOURCE_CACHE_SHARD_COUNT   1
+#endif
+
+namespace {
+struct Shard {
+    SkMutex          fMutex;
+    SkResourceCache* fCache = nullptr;
+};
+}  // namespace
+
+static constexpr int kMaxShardCount = 64;
+static_assert(SK_DEFAULT_RESOURCE_CACHE_SHARD_COUNT >= 1 &&
+              SK_DEFAULT_RESOURCE_CACHE_SHARD_COUNT <= kMaxShardCount, "bad_default_shard_count");
+
+static Shard* get_shards() {
+    static Shard* shards = new Shard[kMaxShardCount];
+    return shards;
 }
 
-/** Must hold resource_cache_mutex() when calling. */
-static SkResourceCache* get_cache() {
-    // resource_cache_mutex() is always held when this is called, so we don't need to be fancy in here.
-    resource_cache_mutex().assertHeld();
-    if (nullptr == gResourceCache) {
+// These only change while every shard's mutex is held, so holding any one of them is enough to
+// read them.
+static std::atomic<int> gShardCount{SK_DEFAULT_RESOURCE_CACHE_SHARD_COUNT};
+static size_t gTotalByteLimit = SK_DEFAULT_IMAGE_CACHE_LIMIT;
+static size_t gSingleAllocationByteLimit = 0;
+
+// Use the high bits of the hash: each shard's SkTHashTable indexes its slots with the low bits.
+static int shard_index(uint32_t hash, int shardCount) {
+    return (int)(((uint64_t)hash * shardCount) >> 32);
+}
+
+// Spreads the total limit over the shards so that their limits add up to exactly totalLimit.
+static size_t shard_byte_limit(size_t totalLimit, int index, int shardCount) {
+    return totalLimit / shardCount + (index < (int)(totalLimit % shardCount) ? 1 : 0);
+}
+
+/** Must hold the shard's mutex when calling. */
+static SkResourceCache* get_cache(int index, int shardCount) {
+    Shard& shard = get_shards()[index];
+    shard.fMutex.assertHeld();
+    if (nullptr == shard.fCache) {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+        // Discardable shards have no byte budget; each applies the count limit on its own.
+        shard.fCache = new SkResourceCache(SkDiscardableMemory::Create);
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+        shard.fCache = new SkResourceCache(shard_byte_limit(gTotalByteLimit, index, shardCount));
 #endif
+        shard.fCache->setSingleAllocationByteLimit(gSingleAllocationByteLimit);
+    }
+    return shard.fCache;
+}
+
+// Calls fn with the cache for hash, holding that shard's mutex. If the shard count changed while
+// we waited for the mutex, hash may belong to a different shard now, so we try again.
+template <typename Fn>
+static auto with_shard(uint32_t hash, Fn&& fn) -> decltype(fn(nullptr)) {
+    for (;;) {
+        int count = gShardCount.load(std::memory_order_acquire);
+        int index = shard_index(hash, count);
+        SkAutoMutexExclusive am(get_shards()[index].fMutex);
+        if (count == gShardCount.load(std::memory_order_relaxed)) {
+            return fn(get_cache(index, count));
+        }
     }
-    return gResourceCache;
+}
+
+// Holds the mutex of every shard in use. The shard count only changes while all of them are
+// held, so once we hold shard 0 the count is stable. Resharding locks all kMaxShardCount, since
+// it may bring new ones into use. Mutexes are always taken in index order.
+class AutoLockAllShards {
+public:
+    explicit AutoLockAllShards(bool forResharding = false) {
+        get_shards()[0].fMutex.acquire();
+        fCount = gShardCount.load(std::memory_order_relaxed);
+        fLocked = forResharding ? kMaxShardCount : fCount;
+        for (int i = 1; i < fLocked; ++i) {
+            get_shards()[i].fMutex.acquire();
+        }
+    }
+    ~AutoLockAllShards() {
+        for (int i = fLocked - 1; i >= 0; --i) {
+            get_shards()[i].fMutex.release();
+        }
+    }
+
+    int count() const { return fCount; }
+    SkResourceCache* cache(int index) const { return get_cache(index, fCount); }
+
+private:
+    int fCount;
+    int fLocked;
+};
+
+int SkResourceCache::GetShardCount() {
+    return gShardCount.load(std::memory_order_relaxed);
+}
+
+int SkResourceCache::SetShardCount(int newCount) {
+    newCount = SkTPin(newCount, 1, kMaxShardCount);
+
+    AutoLockAllShards lock(true);
+    int prevCount = lock.count();
+    if (newCount == prevCount) {
+        return prevCount;
+    }
+
+    // Pull every Rec out of the old shards (oldest first), then hand each to its new shard.
+    // Recs may still be in use, so they move rather than being purged.
+    SkTDArray<Rec*> recs;
+    for (int i = 0; i < prevCount; ++i) {
+        Shard& shard = get_shards()[i];
+        if (shard.fCache) {
+            shard.fCache->detachAll(&recs);
+            delete shard.fCache;
+            shard.fCache = nullptr;
+        }
+    }
+
+    gShardCount.store(newCount, std::memory_order_release);
+    for (Rec* rec : recs) {
+        get_cache(shard_index(rec->getHash(), newCount), newCount)->adopt(rec);
+    }
+    for (int i = 0; i < newCount; ++i) {
+        get_cache(i, newCount)->purgeAsNeeded();
+    }
+    return prevCount;
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getTotalBytesUsed();
+    AutoLockAllShards lock;
+    size_t used = 0;
+    for (int i = 0; i < lock.count(); ++i) {
+        used += lock.cache(i)->getTotalBytesUsed();
+    }
+    return used;
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getTotalByteLimit();
+    AutoLockAllShards lock;
+    size_t limit = 0;
+    for (int i = 0; i < lock.count(); ++i) {
+        limit += lock.cache(i)->getTotalByteLimit();
+    }
+    return limit;
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->setTotalByteLimit(newLimit);
+    AutoLockAllShards lock;
+    size_t prevLimit = 0;
+    gTotalByteLimit = newLimit;
+    for (int i = 0; i < lock.count(); ++i) {
+        prevLimit += lock.cache(i)->setTotalByteLimit(
+                shard_byte_limit(newLimit, i, lock.count()));
+    }
+    return prevLimit;
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->discardableFactory();
+    return with_shard(0, [](SkResourceCache* cache) { return cache->discardableFactory(); });
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->newCachedData(bytes);
+    // Any shard can allocate; rotate through them so concurrent allocations don't all contend.
+    static std::atomic<uint32_t> gNextHash{0};
+    uint32_t hash = gNextHash.fetch_add(0x9E3779B9u, std::memory_order_relaxed);
+    return with_shard(hash, [=](SkResourceCache* cache) { return cache->newCachedData(bytes); });
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    get_cache()->dump();
+    AutoLockAllShards lock;
+    for (int i = 0; i < lock.count(); ++i) {
+        lock.cache(i)->dump();
+    }
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->setSingleAllocationByteLimit(size);
+    AutoLockAllShards lock;
+    size_t prevLimit = gSingleAllocationByteLimit;
+    gSingleAllocationByteLimit = size;
+    for (int i = 0; i < lock.count(); ++i) {
+        lock.cache(i)->setSingleAllocationByteLimit(size);
+    }
+    return prevLimit;
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getSingleAllocationByteLimit();
+    AutoLockAllShards lock;
+    return gSingleAllocationByteLimit;
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    // A Rec lives in a single shard, so it has to fit that shard's share of the budget.
+    AutoLockAllShards lock;
+    size_t limit = lock.cache(0)->getEffectiveSingleAllocationByteLimit();
+    for (int i = 1; i < lock.count(); ++i) {
+        limit = std::min(limit, lock.cache(i)->getEffectiveSingleAllocationByteLimit());
+    }
+    return limit;
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->purgeAll();
+    AutoLockAllShards lock;
+    for (int i = 0; i < lock.count(); ++i) {
+        lock.cache(i)->purgeAll();
+    }
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->find(key, visitor, context);
+    return with_shard(key.hash(), [&](SkResourceCache* cache) {
+        return cache->find(key, visitor, context);
+    });
 }
 
 void SkResourceCache::Add(Rec* rec, void* payload) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    get_cache()->add(rec, payload);
+    with_shard(rec->getHash(), [&](SkResourceCache* cache) { cache->add(rec, payload); });
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    get_cache()->visitAll(visitor, context);
+    AutoLockAllShards lock;
+    for (int i = 0; i < lock.count(); ++i) {
+        lock.cache(i)->visitAll(visitor, context);
+    }
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
@@ -566,6 +730,14 @@ size_t SkGraphics::SetResourceCacheSingleAllocationByteLimit(size_t newLimit) {
     return SkResourceCache::SetSingleAllocationByteLimit(newLimit);
 }
 
+int SkGraphics::GetResourceCacheShardCount() {
+    return SkResourceCache::GetShardCount();
+}
+
+int SkGraphics::SetResourceCacheShardCount(int newCount) {
+    return SkResourceCache::SetShardCount(newCount);
+}
+
 void SkGraphics::PurgeResourceCache() {
     SkImageFilter_Base::PurgeCache();
     return SkResourceCache::PurgeAll();
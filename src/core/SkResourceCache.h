@@ -166,6 +166,16 @@ public:
 
     static void PurgeAll();
 
+    /**
+     *  The global cache can be split into shards, each with its own lock, LRU list and an equal
+     *  share of the total byte limit. A Key's hash decides which shard holds it, so Find/Add on
+     *  different keys from different threads rarely contend. Changing the count moves every Rec
+     *  into its new shard (purging any shard that ends up over its share). The count is pinned
+     *  to [1, 64]; 1 is a single global LRU. SetShardCount() returns the previous count.
+     */
+    static int GetShardCount();
+    static int SetShardCount(int);
+
     static void TestDumpMemoryStatistics();
 
     /** Dump memory usage statistics of every Rec in the cache using the
@@ -275,6 +285,11 @@ private:
     void checkMessages();
     void purgeAsNeeded(bool forcePurge = false);
 
+    // Used when resharding the global cache: moves Recs between instances without purging them
+    // or calling postAddInstall() again.
+    void detachAll(SkTDArray<Rec*>*);
+    void adopt(Rec*);
+
     // linklist management
     void moveToHead(Rec*);
     void addToHead(Rec*);
@@ -13,8 +13,10 @@
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkTraceMemoryDump.h"
 #include "include/core/SkTypeface.h"
+#include "include/private/SkChecksum.h"
 #include "include/private/SkMutex.h"
 #include "include/private/SkTemplates.h"
+#include "include/private/SkThreadID.h"
 #include "src/core/SkGlyphRunPainter.h"
 #include "src/core/SkScalerCache.h"
 
@@ -31,9 +33,30 @@ SkStrikeCache* SkStrikeCache::GlobalStrikeCache() {
     return cache;
 }
 
+struct SkStrikeCache::LookupTable {
+    struct Slot {
+        uint32_t fHash{0};
+        Strike*  fStrike{nullptr};
+    };
+
+    explicit LookupTable(int capacity) : fMask{capacity - 1}, fSlots{capacity} {}
+
+    const int          fMask;
+    SkAutoTArray<Slot> fSlots;
+};
+
+SkStrikeCache::~SkStrikeCache() {
+    delete fLookupTable.load(std::memory_order_relaxed);
+}
+
 auto SkStrikeCache::findOrCreateStrike(const SkDescriptor& desc,
                                        const SkScalerContextEffects& effects,
                                        const SkTypeface& typeface) -> sk_sp<Strike> {
+    if (sk_sp<Strike> strike = this->internalFindStrikeLockFree(desc)) {
+        this->internalPurgeIfNeeded();
+        return strike;
+    }
+
     SkAutoSpinlock ac(fLock);
     sk_sp<Strike> strike = this->internalFindStrikeOrNull(desc);
     if (strike == nullptr) {
@@ -41,6 +64,7 @@ auto SkStrikeCache::findOrCreateStrike(const SkDescriptor& desc,
         strike = this->internalCreateStrike(desc, std::move(scaler));
     }
     this->internalPurge();
+    this->internalPublishLookup();
     return strike;
 }
 
@@ -120,12 +144,71 @@ void SkStrikeCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
 }
 
 sk_sp<SkStrike> SkStrikeCache::findStrike(const SkDescriptor& desc) {
+    if (sk_sp<SkStrike> result = this->internalFindStrikeLockFree(desc)) {
+        this->internalPurgeIfNeeded();
+        return result;
+    }
+
     SkAutoSpinlock ac(fLock);
     sk_sp<SkStrike> result = this->internalFindStrikeOrNull(desc);
     this->internalPurge();
+    this->internalPublishLookup();
+    return result;
+}
+
+auto SkStrikeCache::internalFindStrikeLockFree(const SkDescriptor& desc) -> sk_sp<Strike> {
+    // Announce ourselves so that nothing we can see in the table is freed until we are done.
+    // If the epoch flips between reading it and counting ourselves in, the writer may not have
+    // seen us, so count ourselves in again under the new parity.
+    ReaderStripe& stripe =
+            fReaders[SkChecksum::Mix((uint32_t)SkGetThreadID()) & (kReaderStripes - 1)];
+    uint32_t parity;
+    for (;;) {
+        parity = fReaderEpoch.load(std::memory_order_acquire) & 1;
+        stripe.fCount[parity].fetch_add(1, std::memory_order_seq_cst);
+        if ((fReaderEpoch.load(std::memory_order_seq_cst) & 1) == parity) {
+            break;
+        }
+        stripe.fCount[parity].fetch_sub(1, std::memory_order_release);
+    }
+
+    Strike* found = nullptr;
+    if (const LookupTable* table = fLookupTable.load(std::memory_order_acquire)) {
+        const uint32_t hash = desc.getChecksum();
+        for (int index = hash & table->fMask;
+             table->fSlots[index].fStrike != nullptr;
+             index = (index + 1) & table->fMask) {
+            const LookupTable::Slot& slot = table->fSlots[index];
+            if (slot.fHash == hash && slot.fStrike->getDescriptor() == desc) {
+                found = slot.fStrike;
+                break;
+            }
+        }
+    }
+
+    // The table still holds a ref on anything in it, so it is safe to take ours.
+    sk_sp<Strike> result = sk_ref_sp(found);
+    stripe.fCount[parity].fetch_sub(1, std::memory_order_release);
+
+    if (result) {
+        // Defer the LRU update to the next purge. Skip the store if nothing has been linked since
+        // the last use, so threads sharing a strike don't all write its cache line.
+        uint32_t now = fUseClock.load(std::memory_order_relaxed);
+        if (result->fLastUse.load(std::memory_order_relaxed) != now) {
+            result->fLastUse.store(now, std::memory_order_relaxed);
+        }
+    }
     return result;
 }
 
+void SkStrikeCache::internalPurgeIfNeeded() {
+    if (fPurgeNeeded.load(std::memory_order_relaxed)) {
+        SkAutoSpinlock ac(fLock);
+        this->internalPurge();
+        this->internalPublishLookup();
+    }
+}
+
 auto SkStrikeCache::internalFindStrikeOrNull(const SkDescriptor& desc) -> sk_sp<Strike> {
 
     // Check head because it is likely the strike we are looking for.
@@ -138,16 +221,7 @@ auto SkStrikeCache::internalFindStrikeOrNull(const SkDescriptor& desc) -> sk_sp<
     SkASSERT(strikePtr != nullptr);
     if (fHead != strikePtr) {
         // Make most recently used
-        strikePtr->fPrev->fNext = strikePtr->fNext;
-        if (strikePtr->fNext != nullptr) {
-            strikePtr->fNext->fPrev = strikePtr->fPrev;
-        } else {
-            fTail = strikePtr->fPrev;
-        }
-        fHead->fPrev = strikePtr;
-        strikePtr->fNext = fHead;
-        strikePtr->fPrev = nullptr;
-        fHead = strikePtr;
+        this->internalMoveToHead(strikePtr);
     }
     return sk_ref_sp(strikePtr);
 }
@@ -158,7 +232,10 @@ sk_sp<SkStrike> SkStrikeCache::createStrike(
         SkFontMetrics* maybeMetrics,
         std::unique_ptr<SkStrikePinner> pinner) {
     SkAutoSpinlock ac(fLock);
-    return this->internalCreateStrike(desc, std::move(scaler), maybeMetrics, std::move(pinner));
+    sk_sp<Strike> strike =
+            this->internalCreateStrike(desc, std::move(scaler), maybeMetrics, std::move(pinner));
+    this->internalPublishLookup();
+    return strike;
 }
 
 auto SkStrikeCache::internalCreateStrike(
@@ -175,6 +252,7 @@ auto SkStrikeCache::internalCreateStrike(
 void SkStrikeCache::purgeAll() {
     SkAutoSpinlock ac(fLock);
     this->internalPurge(fTotalMemoryUsed);
+    this->internalPublishLookup();
 }
 
 size_t SkStrikeCache::getTotalMemoryUsed() const {
@@ -198,6 +276,7 @@ size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
     size_t prevLimit = fCacheSizeLimit;
     fCacheSizeLimit = newLimit;
     this->internalPurge();
+    this->internalPublishLookup();
     return prevLimit;
 }
 
@@ -216,6 +295,7 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
     int prevCount = fCacheCountLimit;
     fCacheCountLimit = newCount;
     this->internalPurge();
+    this->internalPublishLookup();
     return prevCount;
 }
 
@@ -266,6 +346,7 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
 
     // early exit
     if (!countNeeded && !bytesNeeded) {
+        fPurgeNeeded.store(false, std::memory_order_relaxed);
         return 0;
     }
 
@@ -278,8 +359,13 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
     while (strike != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
         Strike* prev = strike->fPrev;
 
-        // Only delete if the strike is not pinned.
-        if (strike->fPinner == nullptr || strike->fPinner->canDelete()) {
+        // A lock-free find used this strike since it was last linked; catch up on that deferred
+        // LRU update rather than evicting it. Its new fLinkStamp is at least as new as any
+        // fLastUse, so it will not be moved again during this purge.
+        if ((int32_t)(strike->fLastUse.load(std::memory_order_relaxed) - strike->fLinkStamp) > 0) {
+            this->internalMoveToHead(strike);
+        } else if (strike->fPinner == nullptr || strike->fPinner->canDelete()) {
+            // Only delete if the strike is not pinned.
             bytesFreed += strike->fMemoryUsed;
             countFreed += 1;
             this->internalRemoveStrike(strike);
@@ -288,6 +374,8 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
     }
 
     this->validate();
+    fPurgeNeeded.store(fTotalMemoryUsed > fCacheSizeLimit || fCacheCount > fCacheCountLimit,
+                       std::memory_order_relaxed);
 
 #ifdef SPEW_PURGE_STATUS
     if (countFreed) {
@@ -318,6 +406,29 @@ void SkStrikeCache::internalAttachToHead(sk_sp<Strike> strike) {
     }
 
     fHead = strikePtr; // Transfer ownership of strike to the cache list.
+
+    strikePtr->fLinkStamp = fUseClock.fetch_add(1, std::memory_order_relaxed) + 1;
+    strikePtr->fLastUse.store(strikePtr->fLinkStamp, std::memory_order_relaxed);
+    fLookupTableDirty = true;
+    if (fTotalMemoryUsed > fCacheSizeLimit || fCacheCount > fCacheCountLimit) {
+        fPurgeNeeded.store(true, std::memory_order_relaxed);
+    }
+}
+
+void SkStrikeCache::internalMoveToHead(Strike* strike) {
+    if (fHead != strike) {
+        strike->fPrev->fNext = strike->fNext;
+        if (strike->fNext != nullptr) {
+            strike->fNext->fPrev = strike->fPrev;
+        } else {
+            fTail = strike->fPrev;
+        }
+        fHead->fPrev = strike;
+        strike->fNext = fHead;
+        strike->fPrev = nullptr;
+        fHead = strike;
+    }
+    strike->fLinkStamp = fUseClock.fetch_add(1, std::memory_order_relaxed) + 1;
 }
 
 void SkStrikeCache::internalRemoveStrike(Strike* strike) {
@@ -338,9 +449,52 @@ void SkStrikeCache::internalRemoveStrike(Strike* strike) {
 
     strike->fPrev = strike->fNext = nullptr;
     strike->fRemoved = true;
+
+    // Lock-free readers may still find the strike in the published table, so keep it alive until
+    // internalPublishLookup() has replaced the table and waited them out.
+    fRetiredStrikes.push_back(sk_ref_sp(strike));
+    fLookupTableDirty = true;
     fStrikeLookup.remove(strike->getDescriptor());
 }
 
+void SkStrikeCache::internalPublishLookup() {
+    if (!fLookupTableDirty) {
+        return;
+    }
+    fLookupTableDirty = false;
+
+    // Keep the table at most half full so probe sequences stay short.
+    int capacity = 16;
+    while (capacity < 2 * fCacheCount) {
+        capacity *= 2;
+    }
+    auto table = new LookupTable{capacity};
+    for (Strike* strike = fHead; strike != nullptr; strike = strike->fNext) {
+        uint32_t hash = strike->getDescriptor().getChecksum();
+        int index = hash & table->fMask;
+        while (table->fSlots[index].fStrike != nullptr) {
+            index = (index + 1) & table->fMask;
+        }
+        table->fSlots[index] = {hash, strike};
+    }
+
+    LookupTable* oldTable = fLookupTable.exchange(table, std::memory_order_acq_rel);
+    if (oldTable != nullptr || !fRetiredStrikes.empty()) {
+        this->internalWaitForReaders();
+        delete oldTable;
+        fRetiredStrikes.clear();
+    }
+}
+
+void SkStrikeCache::internalWaitForReaders() {
+    // New readers count themselves under the new parity and can only see the new table; wait
+    // for everyone who started under the old parity to leave.
+    uint32_t oldParity = fReaderEpoch.fetch_add(1, std::memory_order_seq_cst) & 1;
+    for (ReaderStripe& stripe : fReaders) {
+        while (stripe.fCount[oldParity].load(std::memory_order_acquire) != 0) {}
+    }
+}
+
 void SkStrikeCache::validate() const {
 #ifdef SK_DEBUG
     size_t computedBytes = 0;
@@ -371,6 +525,9 @@ void SkStrikeCache::Strike::updateDelta(size_t increase) {
         fMemoryUsed += increase;
         if (!fRemoved) {
             fStrikeCache->fTotalMemoryUsed += increase;
+            if (fStrikeCache->fTotalMemoryUsed > fStrikeCache->fCacheSizeLimit) {
+                fStrikeCache->fPurgeNeeded.store(true, std::memory_order_relaxed);
+            }
         }
     }
 }
@@ -8,8 +8,10 @@
 #ifndef SkStrikeCache_DEFINED
 #define SkStrikeCache_DEFINED
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "include/private/SkSpinlock.h"
 #include "include/private/SkTemplates.h"
@@ -41,6 +43,7 @@ public:
 class SkStrikeCache final : public SkStrikeForGPUCacheInterface {
 public:
     SkStrikeCache() = default;
+    ~SkStrikeCache() override;
 
     class Strike final : public SkRefCnt, public SkStrikeForGPU {
     public:
@@ -143,6 +146,12 @@ public:
         std::unique_ptr<SkStrikePinner> fPinner;
         size_t                          fMemoryUsed{sizeof(SkScalerCache)};
         bool                            fRemoved{false};
+
+        // Ticks of fStrikeCache->fUseClock: when this strike was last moved to the head of the
+        // LRU list, and when a lock-free lookup last found it. Purging gives strikes that were
+        // used after they were linked a second chance instead of evicting them.
+        uint32_t                        fLinkStamp{0};
+        std::atomic<uint32_t>           fLastUse{0};
     };  // Strike
 
     static SkStrikeCache* GlobalStrikeCache();
@@ -186,6 +195,11 @@ public:
     int  setCachePointSizeLimit(int limit) SK_EXCLUDES(fLock);
 
 private:
+    // Finds a strike without taking fLock, using the table published by internalPublishLookup().
+    // Returns nullptr if the strike is not there; the caller then falls back to the locked path.
+    sk_sp<Strike> internalFindStrikeLockFree(const SkDescriptor& desc) SK_EXCLUDES(fLock);
+    void internalPurgeIfNeeded() SK_EXCLUDES(fLock);
+
     sk_sp<Strike> internalFindStrikeOrNull(const SkDescriptor& desc) SK_REQUIRES(fLock);
     sk_sp<Strike> internalCreateStrike(
             const SkDescriptor& desc,
@@ -196,6 +210,12 @@ private:
     // The following methods can only be called when mutex is already held.
     void internalRemoveStrike(Strike* strike) SK_REQUIRES(fLock);
     void internalAttachToHead(sk_sp<Strike> strike) SK_REQUIRES(fLock);
+    void internalMoveToHead(Strike* strike) SK_REQUIRES(fLock);
+
+    // If strikes were added or removed, publishes a new lock-free lookup table, waits for the
+    // readers of the old one to finish, and then frees it along with the removed strikes.
+    void internalPublishLookup() SK_REQUIRES(fLock);
+    void internalWaitForReaders() SK_REQUIRES(fLock);
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
     // and attempt to purge caches to match.
@@ -220,6 +240,28 @@ private:
     };
     SkTHashTable<sk_sp<Strike>, SkDescriptor, StrikeTraits> fStrikeLookup SK_GUARDED_BY(fLock);
 
+    // A snapshot of fStrikeLookup that is read without fLock. It is replaced, never modified, and
+    // old snapshots and removed strikes are only freed once no reader can still be using them.
+    struct LookupTable;
+    std::atomic<LookupTable*> fLookupTable{nullptr};
+    bool fLookupTableDirty SK_GUARDED_BY(fLock) {false};
+    std::vector<sk_sp<Strike>> fRetiredStrikes SK_GUARDED_BY(fLock);
+
+    // Lock-free readers announce themselves in one of kReaderStripes counters (picked by thread),
+    // under the parity of fReaderEpoch at the time they started. internalWaitForReaders() flips
+    // the parity and waits for the old parity's counts to drain.
+    static constexpr int kReaderStripes = 16;
+    struct alignas(64) ReaderStripe {
+        std::atomic<int32_t> fCount[2] = {{0}, {0}};
+    };
+    ReaderStripe fReaders[kReaderStripes];
+    std::atomic<uint32_t> fReaderEpoch{0};
+
+    // Only advanced under fLock; lock-free readers copy it into Strike::fLastUse.
+    std::atomic<uint32_t> fUseClock{0};
+    // Set when the cache may be over budget, so lock-free finds know to take fLock and purge.
+    std::atomic<bool> fPurgeNeeded{false};
+
     size_t  fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
     size_t  fTotalMemoryUsed SK_GUARDED_BY(fLock) {0};
     int32_t fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
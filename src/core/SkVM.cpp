@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkData.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/private/SkChecksum.h"
@@ -38,6 +39,7 @@
 
 bool gSkVMAllowJIT{false};
 bool gSkVMJITViaDylib{false};
+bool gSkVMAllowAVX512{true};
 
 #if defined(SKVM_JIT)
     #if defined(SK_BUILD_FOR_WIN)
@@ -617,13 +619,89 @@ namespace skvm {
     }
 
     Program Builder::done(const char* debug_name) const {
+        return this->done(debug_name, nullptr);
+    }
+
+    // A serialized Program is a SerializedHeader, then its strides, then its instructions.
+    // The format is tied to this build's Ops, so we fold their names into the header and
+    // refuse to load data written by a build with different ones.
+    namespace {
+        static const uint32_t kSerializedMagic   = SkSetFourByteTag('s','k','v','m'),
+                              kSerializedVersion = 1;
+
+        struct SerializedHeader {
+            uint32_t magic,
+                     version,
+                     ops,        // Hash of the names of all SKVM_OPS.
+                     strides,    // Count of int32_t strides that follow the header.
+                     instructions,
+                     checksum;   // Hash of everything after the header.
+        };
+
+        // OptimizedInstruction with fixed-size fields and no padding.
+        struct SerializedInstruction {
+            int32_t op,
+                    x,y,z,
+                    immy,immz,
+                    death,
+                    can_hoist;
+        };
+
+        static uint32_t ops_hash() {
+            static const char names[] =
+            #define M(op) #op " "
+                SKVM_OPS(M)
+            #undef M
+            ;
+            return SkOpts::hash(names, sizeof(names));
+        }
+
+        static const int kOpCount = 0
+        #define M(op) +1
+            SKVM_OPS(M)
+        #undef M
+        ;
+    }
+
+    Program Builder::done(const char* debug_name, sk_sp<SkData>* serialized) const {
         char buf[64] = "skvm-jit-";
         if (!debug_name) {
             *SkStrAppendU32(buf+9, this->hash()) = '\0';
             debug_name = buf;
         }
 
-        return {this->optimize(), fStrides, debug_name};
+        std::vector<OptimizedInstruction> optimized = this->optimize();
+
+        if (serialized) {
+            size_t size = sizeof(SerializedHeader)
+                        + sizeof(int32_t)               * fStrides.size()
+                        + sizeof(SerializedInstruction) * optimized.size();
+            sk_sp<SkData> data = SkData::MakeUninitialized(size);
+            auto header  = (SerializedHeader*)data->writable_data();
+            auto strides = (int32_t*)(header + 1);
+            auto insts   = (SerializedInstruction*)(strides + fStrides.size());
+
+            for (size_t i = 0; i < fStrides.size(); i++) {
+                strides[i] = fStrides[i];
+            }
+            for (size_t i = 0; i < optimized.size(); i++) {
+                const OptimizedInstruction& inst = optimized[i];
+                insts[i] = {(int32_t)inst.op,
+                            inst.x, inst.y, inst.z,
+                            inst.immy, inst.immz,
+                            inst.death,
+                            inst.can_hoist ? 1 : 0};
+            }
+            *header = {kSerializedMagic,
+                       kSerializedVersion,
+                       ops_hash(),
+                       (uint32_t)fStrides.size(),
+                       (uint32_t)optimized.size(),
+                       SkOpts::hash(strides, size - sizeof(SerializedHeader))};
+            *serialized = std::move(data);
+        }
+
+        return {optimized, fStrides, debug_name};
     }
 
     uint64_t Builder::hash() const {
@@ -1916,8 +1994,50 @@ namespace skvm {
         return vex;
     }
 
+    // The EVEX prefix extends AVX to AVX-512, adding 512-bit zmm operations and opmasks.
+    // We only use zmm0-15, so the extra register bits R', V', and the second use of X are all 0.
+    static void evex(uint8_t bytes[4],
+                     bool   W,   // Same as VEX WE.
+                     bool   R,   // Same as VEX R.
+                     bool   X,   // Same as VEX X.
+                     bool   B,   // Same as VEX B.
+                     int  map,   // SSE opcode map selector: 0x0f, 0x380f, 0x3a0f.
+                     int vvvv,   // 4-bit second operand register, as in VEX.
+                     int   pp,   // SSE mandatory prefix: 0x66, 0xf3, 0xf2, else none.
+                     int  aaa) { // Opmask register, or 0 for none.
+        int mm = 0;
+        switch (map) {
+            case   0x0f: mm = 0b01; break;
+            case 0x380f: mm = 0b10; break;
+            case 0x3a0f: mm = 0b11; break;
+            default: SkUNREACHABLE;
+        }
+        switch (pp) {
+            case 0x66: pp = 0b01; break;
+            case 0xf3: pp = 0b10; break;
+            case 0xf2: pp = 0b11; break;
+            default:   pp = 0b00; break;
+        }
+
+        bytes[0] = 0x62;
+        bytes[1] = (~(int)R & 1) << 7    // R, R', X, and B are all stored inverted.
+                 | (~(int)X & 1) << 6
+                 | (~(int)B & 1) << 5
+                 |            1  << 4    // R' = 0, inverted.
+                 |           mm  << 0;
+        bytes[2] = (W       &  1) << 7
+                 | (~vvvv   & 15) << 3
+                 |             1  << 2   // Fixed 1.
+                 |            pp  << 0;
+        bytes[3] =          0b10  << 5   // L'L = 512-bit.  We never use zeroing (z) or broadcast (b).
+                 |             1  << 3   // V' = 0, inverted.
+                 | (aaa     &  7) << 0;
+    }
+
     Assembler::Assembler(void* buf) : fCode((uint8_t*)buf), fCurr(fCode), fSize(0) {}
 
+    void Assembler::use_zmm(bool zmm) { fZmm = zmm; }
+
     size_t Assembler::size() const { return fSize; }
 
     void Assembler::bytes(const void* p, int n) {
@@ -2049,8 +2169,50 @@ namespace skvm {
     void Assembler::vpunpckldq(Ymm dst, Ymm x, Operand y) { this->op(0x66,0x0f,0x62, dst,x,y); }
     void Assembler::vpunpckhdq(Ymm dst, Ymm x, Operand y) { this->op(0x66,0x0f,0x6a, dst,x,y); }
 
-    void Assembler::vpcmpeqd(Ymm dst, Ymm x, Operand y) { this->op(0x66,0x0f,0x76, dst,x,y); }
-    void Assembler::vpcmpgtd(Ymm dst, Ymm x, Operand y) { this->op(0x66,0x0f,0x66, dst,x,y); }
+    void Assembler::vpcmpeqd(Ymm dst, Ymm x, Operand y) {
+        SkASSERT(!fZmm);  // AVX-512 compares write to an Opmask.
+        this->op(0x66,0x0f,0x76, dst,x,y);
+    }
+    void Assembler::vpcmpgtd(Ymm dst, Ymm x, Operand y) {
+        SkASSERT(!fZmm);
+        this->op(0x66,0x0f,0x66, dst,x,y);
+    }
+
+    void Assembler::vpcmpeqd(Opmask dst, Ymm x, Operand y) {
+        this->op(0x66,0x0f,0x76, dst,x,y,W0,L512);
+    }
+    void Assembler::vpcmpgtd(Opmask dst, Ymm x, Operand y) {
+        this->op(0x66,0x0f,0x66, dst,x,y,W0,L512);
+    }
+    void Assembler::vcmpps(Opmask dst, Ymm x, Operand y, int imm) {
+        this->op(0,0x0f,0xc2, dst,x,y,W0,L512);
+        this->imm_byte_after_operand(y, imm);
+    }
+
+    void Assembler::vpmovm2d(Ymm dst, Opmask src) {
+        this->op(0xf3,0x380f,0x38, dst,0,Operand{(Ymm)src},W0,L512);
+    }
+
+    void Assembler::kxnorw(Opmask dst, Opmask x, Opmask y) {
+        // Opmask instructions are VEX-encoded, with L1 meaning a 16-bit operation here.
+        this->op(0,0x0f,0x46, dst,x,Operand{(Ymm)y},W0,L256);
+    }
+    void Assembler::kortestw(Opmask x, Opmask y) {
+        this->op(0,0x0f,0x98, x,0,Operand{(Ymm)y},W0,L128);
+    }
+
+    void Assembler::vpternlogd(Ymm dst, Ymm x, Operand y, int imm) {
+        this->op(0x66,0x3a0f,0x25, dst,x,y,W0,L512);
+        this->imm_byte_after_operand(y, imm);
+    }
+
+    // Like vcvtps2ph, these down-converting moves encode their source as dst and dst as y.
+    void Assembler::vpmovdw(Operand dst, Ymm src) {
+        this->op(0xf3,0x380f,0x33, src,0,dst,W0,L512);
+    }
+    void Assembler::vpmovdb(Operand dst, Ymm src) {
+        this->op(0xf3,0x380f,0x31, src,0,dst,W0,L512);
+    }
 
 
     void Assembler::imm_byte_after_operand(const Operand& operand, int imm) {
@@ -2067,11 +2229,13 @@ namespace skvm {
     }
 
     void Assembler::vcmpps(Ymm dst, Ymm x, Operand y, int imm) {
+        SkASSERT(!fZmm);  // AVX-512 compares write to an Opmask.
         this->op(0,0x0f,0xc2, dst,x,y);
         this->imm_byte_after_operand(y, imm);
     }
 
     void Assembler::vpblendvb(Ymm dst, Ymm x, Operand y, Ymm z) {
+        SkASSERT(!fZmm);
         this->op(0x66,0x3a0f,0x4c, dst,x,y);
         this->imm_byte_after_operand(y, z << 4);
     }
@@ -2095,12 +2259,14 @@ namespace skvm {
     }
 
     void Assembler::vpermq(Ymm dst, Operand x, int imm) {
+        SkASSERT(!fZmm);  // The EVEX form of vpermq permutes within each 256-bit half.
         // A bit unusual among the instructions we use, this is 64-bit operation, so we set W.
         this->op(0x66,0x3a0f,0x00, dst,x,W1);
         this->imm_byte_after_operand(x, imm);
     }
 
     void Assembler::vperm2f128(Ymm dst, Ymm x, Operand y, int imm) {
+        SkASSERT(!fZmm);
         this->op(0x66,0x3a0f,0x06, dst,x,y);
         this->imm_byte_after_operand(y, imm);
     }
@@ -2153,12 +2319,24 @@ namespace skvm {
         return l->offset - (here + 4);
     }
 
-    void Assembler::op(int prefix, int map, int opcode, int dst, int x, Operand y, W w, L l) {
+    void Assembler::op(int prefix, int map, int opcode, int dst, int x, Operand y, W w, L l,
+                       Opmask k) {
+        // Write either a 4-byte EVEX prefix for zmm operations, or a 2- or 3-byte VEX prefix.
+        auto prefix_bytes = [&](bool R, bool X, bool B) {
+            if (l == L512) {
+                uint8_t p[4];
+                evex(p, w, R,X,B, map, x, prefix, k);
+                this->bytes(p, 4);
+            } else {
+                SkASSERT(k == k0);
+                VEX v = vex(w, R,X,B, map, x, l == L256, prefix);
+                this->bytes(v.bytes, v.len);
+            }
+        };
+
         switch (y.kind) {
             case Operand::REG: {
-                VEX v = vex(w, dst>>3, 0, y.reg>>3,
-                            map, x, l, prefix);
-                this->bytes(v.bytes, v.len);
+                prefix_bytes(dst>>3, 0, y.reg>>3);
                 this->byte(opcode);
                 this->byte(mod_rm(Mod::Direct, dst&7, y.reg&7));
             } return;
@@ -2171,24 +2349,27 @@ namespace skvm {
                 const bool need_SIB = m.base  == rsp
                                    || m.index != rsp;
 
-                VEX v = vex(w, dst>>3, m.index>>3, m.base>>3,
-                            map, x, l, prefix);
-                this->bytes(v.bytes, v.len);
+                // EVEX scales one-byte displacements by the operand size, so we always use
+                // four-byte displacements there rather than worry about that compression.
+                Mod md = mod(m.disp);
+                if (l == L512 && md == Mod::OneByteImm) {
+                    md = Mod::FourByteImm;
+                }
+
+                prefix_bytes(dst>>3, m.index>>3, m.base>>3);
                 this->byte(opcode);
-                this->byte(mod_rm(mod(m.disp), dst&7, (need_SIB ? rsp : m.base)&7));
+                this->byte(mod_rm(md, dst&7, (need_SIB ? rsp : m.base)&7));
                 if (need_SIB) {
                     this->byte(sib(m.scale, m.index&7, m.base&7));
                 }
-                this->bytes(&m.disp, imm_bytes(mod(m.disp)));
+                this->bytes(&m.disp, imm_bytes(md));
             } return;
 
             case Operand::LABEL: {
                 // IP-relative addressing uses Mod::Indirect with the R/M encoded as-if rbp or r13.
                 const int rip = rbp;
 
-                VEX v = vex(w, dst>>3, 0, rip>>3,
-                            map, x, l, prefix);
-                this->bytes(v.bytes, v.len);
+                prefix_bytes(dst>>3, 0, rip>>3);
                 this->byte(opcode);
                 this->byte(mod_rm(Mod::Indirect, dst&7, rip&7));
                 this->word(this->disp32(y.label));
@@ -2198,7 +2379,10 @@ namespace skvm {
 
     void Assembler::vpshufb(Ymm dst, Ymm x, Operand y) { this->op(0x66,0x380f,0x00, dst,x,y); }
 
-    void Assembler::vptest(Ymm x, Operand y) { this->op(0x66, 0x380f, 0x17, x,y); }
+    void Assembler::vptest(Ymm x, Operand y) {
+        SkASSERT(!fZmm);
+        this->op(0x66, 0x380f, 0x17, x,y);
+    }
 
     void Assembler::vbroadcastss(Ymm dst, Operand y) { this->op(0x66,0x380f,0x18, dst,y); }
 
@@ -2244,6 +2428,7 @@ namespace skvm {
     }
 
     void Assembler::vextracti128(Operand dst, Ymm src, int imm) {
+        SkASSERT(!fZmm);
         this->op(0x66,0x3a0f,0x39, src,dst);
         SkASSERT(dst.kind != Operand::LABEL);
         this->byte(imm);
@@ -2265,6 +2450,7 @@ namespace skvm {
     }
 
     void Assembler::vgatherdps(Ymm dst, Scale scale, Ymm ix, GP64 base, Ymm mask) {
+        SkASSERT(!fZmm);
         // Unlike most instructions, no aliasing is permitted here.
         SkASSERT(dst != ix);
         SkASSERT(dst != mask);
@@ -2281,6 +2467,19 @@ namespace skvm {
         this->byte(sib(scale, ix&7, base&7));
     }
 
+    void Assembler::vpgatherdd(Ymm dst, Scale scale, Ymm ix, GP64 base, Opmask mask) {
+        // As with vgatherdps, no aliasing is permitted, and k0 can't be used as a gather mask.
+        SkASSERT(dst != ix);
+        SkASSERT(mask != k0);
+
+        uint8_t p[4];
+        evex(p, 0, dst>>3, ix>>3, base>>3, 0x380f, /*vvvv unused*/0, 0x66, mask);
+        this->bytes(p, 4);
+        this->byte(0x90);
+        this->byte(mod_rm(Mod::Indirect, dst&7, rsp/*use SIB*/));
+        this->byte(sib(scale, ix&7, base&7));
+    }
+
     // https://static.docs.arm.com/ddi0596/a/DDI_0596_ARM_a64_instruction_set_architecture.pdf
 
     static int operator"" _mask(unsigned long long bits) { return (1<<(int)bits)-1; }
@@ -2980,12 +3179,80 @@ namespace skvm {
         this->setupInterpreter(instructions);
     }
 
+    Program Program::MakeFromData(const void* data, size_t length, const char* debug_name) {
+        SerializedHeader header;
+        if (!data || length < sizeof(header)) {
+            return {};
+        }
+        memcpy(&header, data, sizeof(header));
+
+        const size_t payload = length - sizeof(header);
+        if (header.magic   != kSerializedMagic   ||
+            header.version != kSerializedVersion ||
+            header.ops     != ops_hash()         ||
+            header.strides      > payload / sizeof(int32_t) ||
+            header.instructions > payload / sizeof(SerializedInstruction) ||
+            payload != sizeof(int32_t)               * header.strides
+                     + sizeof(SerializedInstruction) * header.instructions) {
+            return {};
+        }
+        const char* ptr = (const char*)data + sizeof(header);
+        if (header.checksum != SkOpts::hash(ptr, payload)) {
+            return {};
+        }
+
+        std::vector<int> strides(header.strides);
+        memcpy(strides.data(), ptr, sizeof(int32_t) * header.strides);
+        ptr += sizeof(int32_t) * header.strides;
+
+        const Val n = (Val)header.instructions;
+        std::vector<OptimizedInstruction> instructions(n);
+        for (Val id = 0; id < n; id++) {
+            SerializedInstruction inst;
+            memcpy(&inst, ptr + sizeof(inst) * id, sizeof(inst));
+
+            // Each argument must refer to an earlier instruction, each value must die
+            // no earlier than it's born, and any argument index must name a real argument.
+            auto valid_arg = [&](Val arg) { return arg == NA || (0 <= arg && arg < id); };
+            if (inst.op < 0 || inst.op >= kOpCount ||
+                !valid_arg(inst.x) || !valid_arg(inst.y) || !valid_arg(inst.z) ||
+                inst.death < id || inst.death > n) {
+                return {};
+            }
+            const Op op = (Op)inst.op;
+            if (Op::store8 <= op && op <= Op::uniform32 && op != Op::index &&
+                (inst.immy < 0 || inst.immy >= (int)header.strides)) {
+                return {};
+            }
+
+            instructions[id] = {op,
+                                inst.x, inst.y, inst.z,
+                                inst.immy, inst.immz,
+                                inst.death,
+                                inst.can_hoist != 0};
+        }
+
+        char buf[64] = "skvm-jit-";
+        if (!debug_name) {
+            *SkStrAppendU32(buf+9, header.checksum) = '\0';
+            debug_name = buf;
+        }
+        return {instructions, strides, debug_name};
+    }
+
     std::vector<InterpreterInstruction> Program::instructions() const { return fImpl->instructions; }
     int  Program::nargs() const { return (int)fImpl->strides.size(); }
     int  Program::nregs() const { return fImpl->regs; }
     int  Program::loop () const { return fImpl->loop; }
     bool Program::empty() const { return fImpl->instructions.empty(); }
 
+    size_t Program::approxBytesUsed() const {
+        return sizeof(Impl)
+             + sizeof(InterpreterInstruction) * fImpl->instructions.capacity()
+             + sizeof(int)                    * fImpl->strides.capacity()
+             + fImpl->jit_size;
+    }
+
     // Translate OptimizedInstructions to InterpreterInstructions.
     void Program::setupInterpreter(const std::vector<OptimizedInstruction>& instructions) {
         // Register each instruction is assigned to.
@@ -3113,7 +3380,12 @@ namespace skvm {
         if (!SkCpu::Supports(SkCpu::HSW)) {
             return false;
         }
-        const int K = 8;
+        // With a->using_zmm(), each Reg is a 16-lane zmm register, otherwise an 8-lane ymm.
+        const bool zmm = a->using_zmm();
+        if (zmm && !SkCpu::Supports(SkCpu::SKX)) {
+            return false;
+        }
+        const int K = zmm ? 16 : 8;
         using Reg = A::Ymm;
         #if defined(_M_X64)  // Important to check this first; clang-cl defines both.
             const A::GP64 N = A::rcx,
@@ -3412,6 +3684,14 @@ namespace skvm {
             };
 
         #if defined(__x86_64__) || defined(_M_X64)
+            // These ops shuffle 128-bit halves of ymm registers around and have no zmm
+            // implementations.  setupJIT() assembles programs that use them with ymm instead.
+            if (zmm && (op == Op::store64 || op == Op::store128 ||
+                        op == Op::load64  || op == Op::load128  ||
+                        op == Op::gather8 || op == Op::gather16)) {
+                return false;
+            }
+
             // On x86 we can work with many values directly from the stack or program constant pool.
             auto any = [&](Val v) -> A::Operand {
                 SkASSERT(v >= 0);
@@ -3441,7 +3721,12 @@ namespace skvm {
 
             #if defined(__x86_64__) || defined(_M_X64)
                 case Op::assert_true: {
-                    a->vptest (r(x), &constants[0xffffffff]);
+                    if (zmm) {
+                        a->vpcmpeqd(A::k1, r(x), &constants[0xffffffff]);
+                        a->kortestw(A::k1, A::k1);
+                    } else {
+                        a->vptest  (r(x), &constants[0xffffffff]);
+                    }
                     A::Label all_true;
                     a->jc(&all_true);
                     a->int3();
@@ -3451,6 +3736,8 @@ namespace skvm {
                 case Op::store8:
                     if (scalar) {
                         a->vpextrb(A::Mem{arg[immy]}, (A::Xmm)r(x), 0);
+                    } else if (zmm) {
+                        a->vpmovdb(A::Mem{arg[immy]}, r(x));
                     } else {
                         a->vpackusdw(dst(x), r(x), r(x));
                         a->vpermq   (dst(), dst(), 0xd8);
@@ -3461,6 +3748,8 @@ namespace skvm {
                 case Op::store16:
                     if (scalar) {
                         a->vpextrw(A::Mem{arg[immy]}, (A::Xmm)r(x), 0);
+                    } else if (zmm) {
+                        a->vpmovdw(A::Mem{arg[immy]}, r(x));
                     } else {
                         a->vpackusdw(dst(x), r(x), r(x));
                         a->vpermq   (dst(), dst(), 0xd8);
@@ -3621,11 +3910,16 @@ namespace skvm {
                 } else {
                     a->mov(GP0, A::Mem{arg[immy], immz});
 
-                    A::Ymm mask = alloc_tmp();
-                    a->vpcmpeqd(mask, mask, mask);   // (All lanes enabled.)
+                    if (zmm) {
+                        a->kxnorw(A::k1, A::k1, A::k1);  // (All lanes enabled.)
+                        a->vpgatherdd(dst(), A::FOUR, r(x), GP0, A::k1);
+                    } else {
+                        A::Ymm mask = alloc_tmp();
+                        a->vpcmpeqd(mask, mask, mask);   // (All lanes enabled.)
 
-                    a->vgatherdps(dst(), A::FOUR, r(x), GP0, mask);
-                    free_tmp(mask);
+                        a->vgatherdps(dst(), A::FOUR, r(x), GP0, mask);
+                        free_tmp(mask);
+                    }
                 }
                 break;
 
@@ -3722,32 +4016,62 @@ namespace skvm {
                 case Op::bit_clear: a->vpandn(dst(y), r(y), any(x)); break;  // Notice, y then x.
 
                 case Op::select:
-                    if (try_alias(z)) { a->vpblendvb(dst(z), r(z), any(y), r(x)); }
-                    else              { a->vpblendvb(dst(x), r(z), any(y), r(x)); }
-                                        break;
+                    if (zmm) {
+                        // 0xca is the truth table for dst = dst ? y : z, with x in dst.
+                        if (!try_alias(x)) { a->vmovups(dst(), any(x)); }
+                        a->vpternlogd(dst(), r(y), any(z), 0xca);
+                    } else {
+                        if (try_alias(z)) { a->vpblendvb(dst(z), r(z), any(y), r(x)); }
+                        else              { a->vpblendvb(dst(x), r(z), any(y), r(x)); }
+                    } break;
 
                 case Op::shl_i32: a->vpslld(dst(x), r(x), immy); break;
                 case Op::shr_i32: a->vpsrld(dst(x), r(x), immy); break;
                 case Op::sra_i32: a->vpsrad(dst(x), r(x), immy); break;
 
+                // With zmm, comparisons write to opmask k1, which vpmovm2d expands back to a mask.
                 case Op::eq_i32:
-                    if (in_reg(x)) { a->vpcmpeqd(dst(x), r(x), any(y)); }
-                    else           { a->vpcmpeqd(dst(y), r(y), any(x)); }
-                                     break;
+                    if (zmm) {
+                        if (in_reg(x)) { a->vpcmpeqd(A::k1, r(x), any(y)); }
+                        else           { a->vpcmpeqd(A::k1, r(y), any(x)); }
+                        a->vpmovm2d(dst(), A::k1);
+                    } else {
+                        if (in_reg(x)) { a->vpcmpeqd(dst(x), r(x), any(y)); }
+                        else           { a->vpcmpeqd(dst(y), r(y), any(x)); }
+                    } break;
 
-                case Op::gt_i32: a->vpcmpgtd(dst(), r(x), any(y)); break;
+                case Op::gt_i32:
+                    if (zmm) { a->vpcmpgtd(A::k1, r(x), any(y)); a->vpmovm2d(dst(), A::k1); }
+                    else     { a->vpcmpgtd(dst(), r(x), any(y)); }
+                               break;
 
                 case Op::eq_f32:
-                    if (in_reg(x)) { a->vcmpeqps(dst(x), r(x), any(y)); }
-                    else           { a->vcmpeqps(dst(y), r(y), any(x)); }
-                                     break;
+                    if (zmm) {
+                        if (in_reg(x)) { a->vcmpeqps(A::k1, r(x), any(y)); }
+                        else           { a->vcmpeqps(A::k1, r(y), any(x)); }
+                        a->vpmovm2d(dst(), A::k1);
+                    } else {
+                        if (in_reg(x)) { a->vcmpeqps(dst(x), r(x), any(y)); }
+                        else           { a->vcmpeqps(dst(y), r(y), any(x)); }
+                    } break;
                 case Op::neq_f32:
-                    if (in_reg(x)) { a->vcmpneqps(dst(x), r(x), any(y)); }
-                    else           { a->vcmpneqps(dst(y), r(y), any(x)); }
-                                     break;
+                    if (zmm) {
+                        if (in_reg(x)) { a->vcmpneqps(A::k1, r(x), any(y)); }
+                        else           { a->vcmpneqps(A::k1, r(y), any(x)); }
+                        a->vpmovm2d(dst(), A::k1);
+                    } else {
+                        if (in_reg(x)) { a->vcmpneqps(dst(x), r(x), any(y)); }
+                        else           { a->vcmpneqps(dst(y), r(y), any(x)); }
+                    } break;
 
-                case Op:: gt_f32: a->vcmpltps (dst(y), r(y), any(x)); break;
-                case Op::gte_f32: a->vcmpleps (dst(y), r(y), any(x)); break;
+                case Op:: gt_f32:
+                    if (zmm) { a->vcmpltps(A::k1, r(y), any(x)); a->vpmovm2d(dst(), A::k1); }
+                    else     { a->vcmpltps(dst(y), r(y), any(x)); }
+                               break;
+                case Op::gte_f32:
+                    if (zmm) { a->vcmpleps(A::k1, r(y), any(x)); a->vpmovm2d(dst(), A::k1); }
+                    else     { a->vcmpleps(dst(y), r(y), any(x)); }
+                               break;
 
                 // It's safe to alias dst(y) only when y != x.  Otherwise we'd overwrite x!
                 case Op::pack: a->vpslld(dst(y != x ? y : NA),  r(y), immz);
@@ -3785,9 +4109,13 @@ namespace skvm {
                     break;
 
                 case Op::from_half:
-                    a->vpackusdw(dst(x), r(x), r(x));  // f16 ymm -> f16 xmm
-                    a->vpermq   (dst(), dst(), 0xd8);  // swap middle two 64-bit lanes
-                    a->vcvtph2ps(dst(), dst());        // f16 xmm -> f32 ymm
+                    if (zmm) {
+                        a->vpmovdw  (dst(x), r(x));        // f16 zmm -> f16 ymm
+                    } else {
+                        a->vpackusdw(dst(x), r(x), r(x));  // f16 ymm -> f16 xmm
+                        a->vpermq   (dst(), dst(), 0xd8);  // swap middle two 64-bit lanes
+                    }
+                    a->vcvtph2ps(dst(), dst());            // f16 xmm -> f32 ymm
                     break;
 
             #elif defined(__aarch64__)
@@ -4037,7 +4365,21 @@ namespace skvm {
         Assembler a{nullptr};
         int stack_hint = -1;
         uint32_t registers_used = 0xffff'ffff;  // Start conservatively with all.
-        if (!this->jit(instructions, &stack_hint, &registers_used, &a)) {
+
+        // Prefer 16-lane zmm code when we can, falling back to 8-lane ymm if any op can't.
+        bool zmm = false;
+    #if defined(__x86_64__) || defined(_M_X64)
+        if (gSkVMAllowAVX512 && SkCpu::Supports(SkCpu::SKX)) {
+            a.use_zmm(zmm = true);
+            if (!this->jit(instructions, &stack_hint, &registers_used, &a)) {
+                a = Assembler{nullptr};
+                stack_hint = -1;
+                registers_used = 0xffff'ffff;
+                zmm = false;
+            }
+        }
+    #endif
+        if (!zmm && !this->jit(instructions, &stack_hint, &registers_used, &a)) {
             return;
         }
 
@@ -4047,6 +4389,7 @@ namespace skvm {
 
         // Assemble the program for real with stack_hint/registers_used as feedback from first call.
         a = Assembler{jit_entry};
+        a.use_zmm(zmm);
         SkAssertResult(this->jit(instructions, &stack_hint, &registers_used, &a));
         SkASSERT(a.size() <= fImpl->jit_size);
 
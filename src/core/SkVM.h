@@ -10,6 +10,7 @@
 
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkRefCnt.h"
 #include "include/private/SkMacros.h"
 #include "include/private/SkTArray.h"
 #include "include/private/SkTHash.h"
@@ -17,6 +18,7 @@
 #include "src/core/SkVM_fwd.h"
 #include <vector>      // std::vector
 
+class SkData;
 class SkWStream;
 
 #if defined(SKVM_JIT_WHEN_POSSIBLE)
@@ -65,6 +67,9 @@ namespace skvm {
             ymm0, ymm1, ymm2 , ymm3 , ymm4 , ymm5 , ymm6 , ymm7 ,
             ymm8, ymm9, ymm10, ymm11, ymm12, ymm13, ymm14, ymm15,
         };
+        enum Opmask {
+            k0, k1, k2, k3, k4, k5, k6, k7,
+        };
 
         // X and V values match 5-bit encoding for each (nothing tricky).
         enum X {
@@ -94,6 +99,13 @@ namespace skvm {
 
         void align(int mod);
 
+        // AVX-512: while use_zmm(true), vector instructions taking Ymm registers are EVEX-encoded
+        // to operate on all 512 bits of the zmm register with the same number, 16 32-bit lanes.
+        // The instructions marked AVX-512 below require this; vptest, vpblendvb, vperm2f128,
+        // vextracti128 and vgatherdps have no EVEX form and must be used without it.
+        void use_zmm(bool);
+        bool using_zmm() const { return fZmm; }
+
         void int3();
         void vzeroupper();
         void ret();
@@ -227,6 +239,33 @@ namespace skvm {
         // mask = 0;
         void vgatherdps(Ymm dst, Scale scale, Ymm ix, GP64 base, Ymm mask);
 
+        // AVX-512 comparisons write a bit per lane to an Opmask rather than a vector.
+        void vpcmpeqd(Opmask dst, Ymm x, Operand y);
+        void vpcmpgtd(Opmask dst, Ymm x, Operand y);
+
+        void vcmpps   (Opmask dst, Ymm x, Operand y, int imm);
+        void vcmpeqps (Opmask dst, Ymm x, Operand y) { this->vcmpps(dst,x,y,0); }
+        void vcmpltps (Opmask dst, Ymm x, Operand y) { this->vcmpps(dst,x,y,1); }
+        void vcmpleps (Opmask dst, Ymm x, Operand y) { this->vcmpps(dst,x,y,2); }
+        void vcmpneqps(Opmask dst, Ymm x, Operand y) { this->vcmpps(dst,x,y,4); }
+
+        void vpmovm2d(Ymm dst, Opmask src);               // dst[i] = src[i] ? ~0 : 0, AVX-512
+        void kxnorw  (Opmask dst, Opmask x, Opmask y);    // dst = ~(x^y), 16-bit
+        void kortestw(Opmask x, Opmask y);                // CF = (x|y) == 0xffff, ZF = (x|y) == 0
+
+        // dst = imm(dst,x,y), where imm is the truth table of a bitwise function, AVX-512.
+        void vpternlogd(Ymm dst, Ymm x, Operand y, int imm);
+
+        void vpmovdw(Operand dst, Ymm src);  // dst = src, truncating int -> uint16_t, AVX-512
+        void vpmovdb(Operand dst, Ymm src);  // dst = src, truncating int ->  uint8_t, AVX-512
+
+        // if (mask[i]) {
+        //     dst[i] = base[scale*ix[i]];
+        // }
+        // mask = 0;
+        // AVX-512.
+        void vpgatherdd(Ymm dst, Scale scale, Ymm ix, GP64 base, Opmask mask);
+
 
         void label(Label*);
 
@@ -343,15 +382,20 @@ namespace skvm {
         uint8_t* fCode;
         uint8_t* fCurr;
         size_t   fSize;
+        bool     fZmm = false;
 
         // x86-64
-        enum W { W0, W1 };      // Are the lanes 64-bit (W1) or default (W0)?  Intel Vol 2A 2.3.5.5
-        enum L { L128, L256 };  // Is this a 128- or 256-bit operation?        Intel Vol 2A 2.3.6.2
+        enum W { W0, W1 };            // Are the lanes 64-bit (W1) or default (W0)?  Vol 2A 2.3.5.5
+        enum L { L128, L256, L512 };  // Is this a 128-, 256-, or 512-bit operation?  Vol 2A 2.3.6.2
 
-        // Helpers for vector instructions.
-        void op(int prefix, int map, int opcode, int dst, int x, Operand y, W,L);
-        void op(int p, int m, int o, Ymm d, Ymm x, Operand y, W w=W0) { op(p,m,o, d,x,y,w,L256); }
-        void op(int p, int m, int o, Ymm d,        Operand y, W w=W0) { op(p,m,o, d,0,y,w,L256); }
+        // Helpers for vector instructions.  L512 operations are EVEX-encoded, the rest VEX.
+        void op(int prefix, int map, int opcode, int dst, int x, Operand y, W,L, Opmask=k0);
+        void op(int p, int m, int o, Ymm d, Ymm x, Operand y, W w=W0) {
+            op(p,m,o, d,x,y,w, fZmm ? L512 : L256);
+        }
+        void op(int p, int m, int o, Ymm d,        Operand y, W w=W0) {
+            op(p,m,o, d,0,y,w, fZmm ? L512 : L256);
+        }
         void op(int p, int m, int o, Xmm d, Xmm x, Operand y, W w=W0) { op(p,m,o, d,x,y,w,L128); }
         void op(int p, int m, int o, Xmm d,        Operand y, W w=W0) { op(p,m,o, d,0,y,w,L128); }
 
@@ -566,6 +610,10 @@ namespace skvm {
 
         Program done(const char* debug_name = nullptr) const;
 
+        // Like done(), also serializing the optimized program into *serialized so that
+        // Program::MakeFromData() can rebuild it later without running optimize() again.
+        Program done(const char* debug_name, sk_sp<SkData>* serialized) const;
+
         // Mostly for debugging, tests, etc.
         std::vector<Instruction> program() const { return fProgram; }
         std::vector<OptimizedInstruction> optimize() const;
@@ -863,6 +911,12 @@ namespace skvm {
         Program(const Program&) = delete;
         Program& operator=(const Program&) = delete;
 
+        // Rebuild a Program from data serialized by Builder::done().  Only the optimized
+        // instructions are serialized; the JIT (if any) runs again here.  Returns an empty
+        // Program if the data is malformed or was written by an incompatible version of SkVM.
+        static Program MakeFromData(const void* data, size_t length,
+                                    const char* debug_name = nullptr);
+
         void eval(int n, void* args[]) const;
 
         template <typename... T>
@@ -879,6 +933,8 @@ namespace skvm {
         int  loop () const;
         bool empty() const;
 
+        size_t approxBytesUsed() const;  // Including any JIT'd code.
+
         bool hasJIT() const;  // Has this Program been JITted?
         void dropJIT();       // If hasJIT(), drop it, forcing interpreter fallback.
 
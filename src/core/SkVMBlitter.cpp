@@ -5,6 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkData.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkTime.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkMacros.h"
 #include "src/core/SkArenaAlloc.h"
@@ -13,15 +16,19 @@
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkColorSpaceXformSteps.h"
 #include "src/core/SkCoreBlitters.h"
-#include "src/core/SkLRUCache.h"
 #include "src/core/SkMatrixProvider.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkPaintPriv.h"
 #include "src/core/SkVM.h"
+#include "src/core/SkVMProgramCache.h"
 #include "src/shaders/SkColorFilterShader.h"
 
+#include <atomic>
 #include <cinttypes>
 
+// Set by SkGraphics::SetPersistentCache().
+std::atomic<SkGraphics::PersistentCache*> gSkVMPersistentCache{nullptr};
+
 namespace {
 
     // Uniforms set by the Blitter itself,
@@ -96,19 +103,18 @@ namespace {
             key.coverage);
     }
 
-    static SkLRUCache<Key, skvm::Program>* try_acquire_program_cache() {
-    #if 1 && defined(SKVM_JIT)
-        thread_local static SkLRUCache<Key, skvm::Program> cache{64};
-        return &cache;
-    #else
-        // iOS in particular does not support thread_local until iOS 9.0.
-        // On the other hand, we'll never be able to JIT there anyway.
-        // It's probably fine to not cache any interpreted programs, anywhere.
-        return nullptr;
-    #endif
+    // The process-global cache of Programs, exposed through SkGraphics.
+    using ProgramCache = SkVMProgramCache<Key>;
+    static ProgramCache* program_cache() {
+        static ProgramCache* cache = new ProgramCache;
+        return cache;
     }
 
-    static void release_program_cache() { }
+    // Keys in the persistent cache are a Key's bytes, which are stable across processes:
+    // the shader and clip hashes come from the instructions those effects emit, not pointers.
+    static sk_sp<SkData> persistent_cache_key(const Key& key) {
+        return SkData::MakeWithCopy(&key, sizeof(key));
+    }
 
     // If build_program() can't build this program, cache_key() sets *ok to false.
     static Key cache_key(const Params& params,
@@ -550,25 +556,16 @@ namespace {
             }()) {}
 
         ~Blitter() override {
-            if (SkLRUCache<Key, skvm::Program>* cache = try_acquire_program_cache()) {
-                auto cache_program = [&](skvm::Program&& program, Coverage coverage) {
-                    if (!program.empty()) {
-                        Key key = fKey.withCoverage(coverage);
-                        if (skvm::Program* found = cache->find(key)) {
-                            *found = std::move(program);
-                        } else {
-                            cache->insert(key, std::move(program));
-                        }
-                    }
-                };
-                cache_program(std::move(fBlitH),         Coverage::Full);
-                cache_program(std::move(fBlitAntiH),     Coverage::UniformA8);
-                cache_program(std::move(fBlitMaskA8),    Coverage::MaskA8);
-                cache_program(std::move(fBlitMask3D),    Coverage::Mask3D);
-                cache_program(std::move(fBlitMaskLCD16), Coverage::MaskLCD16);
-
-                release_program_cache();
-            }
+            auto cache_program = [&](skvm::Program&& program, Coverage coverage) {
+                if (!program.empty()) {
+                    program_cache()->put(fKey.withCoverage(coverage), std::move(program));
+                }
+            };
+            cache_program(std::move(fBlitH),         Coverage::Full);
+            cache_program(std::move(fBlitAntiH),     Coverage::UniformA8);
+            cache_program(std::move(fBlitMaskA8),    Coverage::MaskA8);
+            cache_program(std::move(fBlitMask3D),    Coverage::Mask3D);
+            cache_program(std::move(fBlitMaskLCD16), Coverage::MaskLCD16);
         }
 
     private:
@@ -588,18 +585,21 @@ namespace {
 
         skvm::Program buildProgram(Coverage coverage) {
             Key key = fKey.withCoverage(coverage);
-            {
-                skvm::Program p;
-                if (SkLRUCache<Key, skvm::Program>* cache = try_acquire_program_cache()) {
-                    if (skvm::Program* found = cache->find(key)) {
-                        p = std::move(*found);
+            if (skvm::Program p = program_cache()->take(key); !p.empty()) {
+                return p;
+            }
+            SkGraphics::PersistentCache* persistentCache = gSkVMPersistentCache.load();
+            if (persistentCache) {
+                if (sk_sp<SkData> data = persistentCache->load(*persistent_cache_key(key))) {
+                    skvm::Program p = skvm::Program::MakeFromData(data->data(), data->size(),
+                                                                  debug_name(key).c_str());
+                    if (!p.empty()) {
+                        return p;
                     }
-                    release_program_cache();
-                }
-                if (!p.empty()) {
-                    return p;
                 }
             }
+            const double buildStart = SkTime::GetMSecs();
+
             // We don't really _need_ to rebuild fUniforms here.
             // It's just more natural to have effects unconditionally emit them,
             // and more natural to rebuild fUniforms than to emit them into a dummy buffer.
@@ -611,7 +611,13 @@ namespace {
             SkASSERTF(fUniforms.buf.size() == prev,
                       "%zu, prev was %zu", fUniforms.buf.size(), prev);
 
-            skvm::Program program = builder.done(debug_name(key).c_str());
+            sk_sp<SkData> serialized;
+            skvm::Program program = builder.done(debug_name(key).c_str(),
+                                                 persistentCache ? &serialized : nullptr);
+            program_cache()->recordBuildTime(SkTime::GetMSecs() - buildStart);
+            if (serialized) {
+                persistentCache->store(*persistent_cache_key(key), *serialized);
+            }
             if (false) {
                 static std::atomic<int> missed{0},
                                          total{0};
@@ -771,3 +777,27 @@ SkBlitter* SkCreateSkVMSpriteBlitter(const SkPixmap& device,
                                         SkSimpleMatrixProvider{SkMatrix{}}, std::move(clip), &ok);
     return ok ? blitter : nullptr;
 }
+
+int SkGraphics::GetProgramCacheCountLimit() {
+    return program_cache()->countLimit();
+}
+
+int SkGraphics::SetProgramCacheCountLimit(int count) {
+    return program_cache()->setCountLimit(count);
+}
+
+size_t SkGraphics::GetProgramCacheByteLimit() {
+    return program_cache()->byteLimit();
+}
+
+size_t SkGraphics::SetProgramCacheByteLimit(size_t bytes) {
+    return program_cache()->setByteLimit(bytes);
+}
+
+void SkGraphics::PurgeProgramCache() {
+    program_cache()->purge();
+}
+
+SkGraphics::ProgramCacheStats SkGraphics::GetProgramCacheStats() {
+    return program_cache()->stats();
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkVMProgramCache_DEFINED
+#define SkVMProgramCache_DEFINED
+
+#include "include/core/SkGraphics.h"
+#include "include/private/SkMutex.h"
+#include "src/core/SkLRUCache.h"
+#include "src/core/SkVM.h"
+
+#include <algorithm>
+
+// A cache of Programs, bounded by both count and bytes, evicting the least recently used first.
+// Users take Programs out of the cache while they use them, and put them back when done.
+//
+// SkVMBlitter keeps one process-global instance, which SkGraphics exposes.
+template <typename Key>
+class SkVMProgramCache {
+public:
+    // We enforce the limits ourselves in purgeTo(), so fLRU is effectively unbounded.
+    SkVMProgramCache() : fLRU(SK_MaxS32) {}
+
+    skvm::Program take(const Key& key) {
+        SkAutoMutexExclusive lock(fMutex);
+        skvm::Program program;
+        if (skvm::Program* found = fLRU.find(key)) {
+            program = std::move(*found);
+            fLRU.remove(key);
+            fBytes -= program.approxBytesUsed();
+            fHits++;
+        } else {
+            fMisses++;
+        }
+        return program;
+    }
+
+    void put(const Key& key, skvm::Program&& program) {
+        SkAutoMutexExclusive lock(fMutex);
+        // Another user may have built and returned the same Program while we held ours.
+        if (skvm::Program* found = fLRU.find(key)) {
+            fBytes -= found->approxBytesUsed();
+            fLRU.remove(key);
+        }
+        const size_t bytes = program.approxBytesUsed();
+        if (fCountLimit < 1 || bytes > fByteLimit) {
+            return;
+        }
+        this->purgeTo(fCountLimit - 1, fByteLimit - bytes);
+        fLRU.insert(key, std::move(program));
+        fBytes += bytes;
+    }
+
+    void recordBuildTime(double ms) {
+        int bucket = 0;
+        for (double us = ms * 1000; us >= 1 && bucket < kBuckets - 1; us *= 0.5) {
+            bucket++;
+        }
+        SkAutoMutexExclusive lock(fMutex);
+        fBuildTimes[bucket]++;
+    }
+
+    int setCountLimit(int count) {
+        SkAutoMutexExclusive lock(fMutex);
+        int prev = fCountLimit;
+        fCountLimit = std::max(count, 0);
+        this->purgeTo(fCountLimit, fByteLimit);
+        return prev;
+    }
+
+    size_t setByteLimit(size_t bytes) {
+        SkAutoMutexExclusive lock(fMutex);
+        size_t prev = fByteLimit;
+        fByteLimit = bytes;
+        this->purgeTo(fCountLimit, fByteLimit);
+        return prev;
+    }
+
+    int    countLimit() { SkAutoMutexExclusive lock(fMutex); return fCountLimit; }
+    size_t  byteLimit() { SkAutoMutexExclusive lock(fMutex); return fByteLimit;  }
+
+    void purge() {
+        SkAutoMutexExclusive lock(fMutex);
+        this->purgeTo(0, 0);
+    }
+
+    SkGraphics::ProgramCacheStats stats() {
+        SkAutoMutexExclusive lock(fMutex);
+        SkGraphics::ProgramCacheStats stats;
+        stats.fCount  = fLRU.count();
+        stats.fBytes  = fBytes;
+        stats.fHits   = fHits;
+        stats.fMisses = fMisses;
+        std::copy(fBuildTimes, fBuildTimes + kBuckets, stats.fBuildTimes);
+        return stats;
+    }
+
+private:
+    static constexpr int kBuckets = SkGraphics::ProgramCacheStats::kBuildTimeBuckets;
+
+    void purgeTo(int count, size_t bytes) {
+        skvm::Program evicted;
+        while (fLRU.count() > count || fBytes > bytes) {
+            SkAssertResult(fLRU.removeLRU(&evicted));
+            fBytes -= evicted.approxBytesUsed();
+        }
+    }
+
+    SkMutex                        fMutex;
+    SkLRUCache<Key, skvm::Program> fLRU;
+    int                            fCountLimit = 256;
+    size_t                         fByteLimit  = 16 * 1024 * 1024;
+    size_t                         fBytes      = 0;
+    uint64_t                       fHits       = 0,
+                                   fMisses     = 0,
+                                   fBuildTimes[kBuckets] = {};
+};
+
+#endif  // SkVMProgramCache_DEFINED
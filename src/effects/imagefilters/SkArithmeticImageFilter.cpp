@@ -44,6 +44,7 @@ protected:
 
     SkIRect onFilterBounds(const SkIRect&, const SkMatrix& ctm,
                            MapDirection, const SkIRect* inputRect) const override;
+    bool onCanFilterImageTiled() const override { return true; }
 
 #if SK_SUPPORT_GPU
     sk_sp<SkSpecialImage> filterImageGPU(const Context& ctx,
@@ -188,11 +189,16 @@ static bool intersect(SkPixmap* dst, SkPixmap* src, int srcDx, int srcDy) {
 
 sk_sp<SkSpecialImage> ArithmeticImageFilterImpl::onFilterImage(const Context& ctx,
                                                                SkIPoint* offset) const {
-    SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, ctx, &backgroundOffset));
+    SkASSERT(this->countInputs() == 2);
+    sk_sp<SkSpecialImage> images[2];
+    SkIPoint offsets[2];
+    this->filterInputs(ctx, images, offsets);
 
-    SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, ctx, &foregroundOffset));
+    const SkIPoint& backgroundOffset = offsets[0];
+    sk_sp<SkSpecialImage> background(std::move(images[0]));
+
+    const SkIPoint& foregroundOffset = offsets[1];
+    sk_sp<SkSpecialImage> foreground(std::move(images[1]));
 
     SkIRect foregroundBounds = SkIRect::MakeEmpty();
     if (foreground) {
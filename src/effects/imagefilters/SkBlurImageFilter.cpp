@@ -45,6 +45,7 @@ protected:
     sk_sp<SkSpecialImage> onFilterImage(const Context&, SkIPoint* offset) const override;
     SkIRect onFilterNodeBounds(const SkIRect& src, const SkMatrix& ctm,
                                MapDirection, const SkIRect* inputRect) const override;
+    bool onCanFilterImageTiled() const override { return fTileMode == SkTileMode::kDecal; }
 
 private:
     friend void SkBlurImageFilter::RegisterFlattenables();
@@ -51,6 +51,8 @@ public:
 protected:
     sk_sp<SkSpecialImage> onFilterImage(const Context&, SkIPoint* offset) const override;
 
+    bool onCanFilterImageTiled() const override { return true; }
+
     void flatten(SkWriteBuffer&) const override;
 
 private:
@@ -276,8 +278,9 @@ sk_sp<SkSpecialImage> SkDisplacementMapEffectImpl::onFilterImage(const Context&
     // With a more complex DAG attached to this input, it's not clear that working in ANY specific
     // color space makes sense, so we ignore color spaces (and gamma) entirely. This may not be
     // ideal, but it's at least consistent and predictable.
-    Context displContext(ctx.mapping(), ctx.desiredOutput(), ctx.cache(),
-                         kN32_SkColorType, nullptr, ctx.source());
+    Context displContext = Context(ctx.mapping(), ctx.desiredOutput(), ctx.cache(),
+                                   kN32_SkColorType, nullptr, ctx.source())
+                                   .withExecutor(ctx.executor());
     sk_sp<SkSpecialImage> displ(this->filterInput(0, displContext, &displOffset));
     if (!displ) {
         return nullptr;
@@ -28,6 +28,7 @@ public:
 protected:
     sk_sp<SkSpecialImage> onFilterImage(const Context&, SkIPoint* offset) const override;
     bool onCanHandleComplexCTM() const override { return true; }
+    bool onCanFilterImageTiled() const override { return true; }
 
 private:
     friend void SkMergeImageFilter::RegisterFlattenables();
@@ -73,9 +74,8 @@ sk_sp<SkSpecialImage> SkMergeImageFilterImpl::onFilterImage(const Context& ctx,
     std::unique_ptr<SkIPoint[]> offsets(new SkIPoint[inputCount]);
 
     // Filter all of the inputs.
+    this->filterInputs(ctx, inputs.get(), offsets.get());
     for (int i = 0; i < inputCount; ++i) {
-        offsets[i] = { 0, 0 };
-        inputs[i] = this->filterInput(i, ctx, &offsets[i]);
         if (!inputs[i]) {
             continue;
         }
@@ -71,6 +71,7 @@ protected:
       radiusVector.setAbs(radiusVector);
       return SkSize::Make(radiusVector.x(), radiusVector.y());
     }
+    bool onCanFilterImageTiled() const override { return true; }
 
 private:
     friend void SkDilateImageFilter::RegisterFlattenables();
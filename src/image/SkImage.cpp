@@ -350,7 +350,8 @@ sk_sp<SkImage> SkImage::MakeFromPicture(sk_sp<SkPicture> picture, const SkISize&
 
 sk_sp<SkImage> SkImage::makeWithFilter(GrRecordingContext* rContext, const SkImageFilter* filter,
                                        const SkIRect& subset, const SkIRect& clipBounds,
-                                       SkIRect* outSubset, SkIPoint* offset) const {
+                                       SkIRect* outSubset, SkIPoint* offset,
+                                       SkExecutor* executor) const {
 
     if (!filter || !outSubset || !offset || !this->bounds().contains(subset)) {
         return nullptr;
@@ -378,12 +379,15 @@ sk_sp<SkImage> SkImage::makeWithFilter(GrRecordingContext* rContext, const SkIma
     // subset's top left corner. But the clip bounds and any crop rects on the filters are in the
     // original coordinate system, so configure the CTM to correct crop rects and explicitly adjust
     // the clip bounds (since it is assumed to already be in image space).
-    SkImageFilter_Base::Context context(SkMatrix::Translate(-subset.x(), -subset.y()),
+    SkImageFilter_Base::Context context =
+            SkImageFilter_Base::Context(SkMatrix::Translate(-subset.x(), -subset.y()),
                                         clipBounds.makeOffset(-subset.topLeft()),
                                         cache.get(), fInfo.colorType(), fInfo.colorSpace(),
-                                        srcSpecialImage.get());
+                                        srcSpecialImage.get())
+                    .withExecutor(executor);
 
-    sk_sp<SkSpecialImage> result = as_IFB(filter)->filterImage(context).imageAndOffset(offset);
+    sk_sp<SkSpecialImage> result =
+            as_IFB(filter)->filterImageTiled(context).imageAndOffset(offset);
     if (!result) {
         return nullptr;
     }
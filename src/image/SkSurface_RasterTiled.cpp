@@ -0,0 +1,614 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkCanvasVirtualEnforcer.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkM44.h"
+#include "include/core/SkMallocPixelRef.h"
+#include "include/core/SkRegion.h"
+#include "include/private/SkTDArray.h"
+#include "include/private/SkTemplates.h"
+#include "src/core/SkBitmapDevice.h"
+#include "src/core/SkCanvasPriv.h"
+#include "src/core/SkImagePriv.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecorder.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/image/SkSurface_Base.h"
+
+#include <vector>
+
+// SkSurface_RasterTiled owns a normal raster backing store, but its canvas records draws into an
+// SkRecord instead of rasterizing them immediately.  Whenever the pixels are needed (snapshots,
+// reads, writes, flushes) the pending ops are replayed once per tile, with the tiles spread
+// across an SkExecutor.  Each tile draws through its own SkCanvas wrapping the full-size bitmap,
+// so all device-space math is unchanged, and each draw is clipped to the tile so tiles never
+// share pixels.  Draws that a tile would rasterize differently (those crossing its edges) and
+// layers are replayed serially into the whole bitmap instead, in order with the tiled ones.
+class SkSurface_RasterTiled : public SkSurface_Base {
+public:
+    SkSurface_RasterTiled(const SkImageInfo&, sk_sp<SkPixelRef>, SkExecutor*, int tileSize,
+                          const SkSurfaceProps*);
+
+    SkCanvas* onNewCanvas() override;
+    sk_sp<SkSurface> onNewSurface(const SkImageInfo&) override;
+    sk_sp<SkImage> onNewImageSnapshot(const SkIRect* subset) override;
+    void onWritePixels(const SkPixmap&, int x, int y) override;
+    void onDraw(SkCanvas*, SkScalar x, SkScalar y, const SkPaint*) override;
+    void onCopyOnWrite(ContentChangeMode) override;
+    void onRestoreBackingMutability() override;
+    GrSemaphoresSubmitted onFlush(BackendSurfaceAccess, const GrFlushInfo&,
+                                  const GrBackendSurfaceMutableState*) override;
+
+    SkCanvas* recorder() const { return fRecorder.get(); }
+    int recordedOpCount() const { return fRecord->count(); }
+
+    // Rasterize every pending op that a direct raster canvas would have already drawn.
+    void flushPendingDraws();
+
+private:
+    void resetRecording();
+
+    SkBitmap                    fBitmap;
+    SkExecutor*                 fExecutor;
+    int                         fTileSize;
+    sk_sp<SkRecord>             fRecord;
+    std::unique_ptr<SkRecorder> fRecorder;
+    int                         fFlushedOps = 0;   // ops [0, fFlushedOps) have reached fBitmap
+    SkBaseDevice*               fDevice = nullptr; // owned by our cached canvas
+
+    typedef SkSurface_Base INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// The base device of the recording canvas holds the real pixels.  Draws never reach it (the
+// canvas forwards them to the recorder), but pixel access does, so we flush before any of it.
+class TiledRecordingDevice final : public SkBitmapDevice {
+public:
+    TiledRecordingDevice(const SkBitmap& bitmap, const SkSurfaceProps& props,
+                         SkSurface_RasterTiled* surface)
+        : INHERITED(bitmap, props, nullptr, nullptr)
+        , fSurface(surface) {}
+
+protected:
+    bool onReadPixels(const SkPixmap& pm, int x, int y) override {
+        fSurface->flushPendingDraws();
+        return this->INHERITED::onReadPixels(pm, x, y);
+    }
+    bool onWritePixels(const SkPixmap& pm, int x, int y) override {
+        fSurface->flushPendingDraws();
+        return this->INHERITED::onWritePixels(pm, x, y);
+    }
+    bool onPeekPixels(SkPixmap* pm) override {
+        fSurface->flushPendingDraws();
+        return this->INHERITED::onPeekPixels(pm);
+    }
+    bool onAccessPixels(SkPixmap* pm) override {
+        fSurface->flushPendingDraws();
+        return this->INHERITED::onAccessPixels(pm);
+    }
+
+private:
+    SkSurface_RasterTiled* fSurface;
+
+    typedef SkBitmapDevice INHERITED;
+};
+
+// Tracks matrix and clip like any raster canvas (so quickReject() and friends still work), but
+// sends every save, clip and draw to the surface's recorder rather than to its device.
+class TiledRecordingCanvas final : public SkCanvasVirtualEnforcer<SkCanvas> {
+public:
+    TiledRecordingCanvas(sk_sp<SkBaseDevice> device, SkSurface_RasterTiled* surface)
+        : INHERITED(std::move(device))
+        , fSurface(surface) {}
+
+    // Returns the index of the SaveLayer op for the outermost layer not yet restored, or -1.
+    int firstOpenLayerOp() const {
+        for (int op : fSaveOps) {
+            if (op >= 0) {
+                return op;
+            }
+        }
+        return -1;
+    }
+
+protected:
+    void willSave() override {
+        fSaveOps.push_back(-1);
+        fSurface->recorder()->save();
+    }
+
+    SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+        fSaveOps.push_back(fSurface->recordedOpCount());
+        fSurface->recorder()->saveLayer(rec);
+        // The layer lives in the recording; we only need a save to track matrix and clip.
+        return kNoLayer_SaveLayerStrategy;
+    }
+
+    bool onDoSaveBehind(const SkRect* bounds) override {
+        fSaveOps.push_back(fSurface->recordedOpCount());
+        SkCanvasPriv::SaveBehind(fSurface->recorder(), bounds);
+        return false;
+    }
+
+    void willRestore() override {
+        if (fSaveOps.back() >= 0) {
+            this->willDraw();  // Restoring a layer composites it.
+        }
+        fSaveOps.pop_back();
+        fSurface->recorder()->restore();
+    }
+
+    void onMarkCTM(const char* name) override {
+        fSurface->recorder()->markCTM(name);
+        this->INHERITED::onMarkCTM(name);
+    }
+    void didConcat44(const SkM44& m) override { fSurface->recorder()->concat(m); }
+    void didConcat(const SkMatrix& m) override { fSurface->recorder()->concat(m); }
+    void didSetMatrix(const SkMatrix& m) override { fSurface->recorder()->setMatrix(m); }
+    void didTranslate(SkScalar x, SkScalar y) override { fSurface->recorder()->translate(x, y); }
+    void didScale(SkScalar x, SkScalar y) override { fSurface->recorder()->scale(x, y); }
+
+    void onClipRect(const SkRect& rect, SkClipOp op, ClipEdgeStyle edgeStyle) override {
+        fSurface->recorder()->clipRect(rect, op, kSoft_ClipEdgeStyle == edgeStyle);
+        this->INHERITED::onClipRect(rect, op, edgeStyle);
+    }
+    void onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle edgeStyle) override {
+        fSurface->recorder()->clipRRect(rrect, op, kSoft_ClipEdgeStyle == edgeStyle);
+        this->INHERITED::onClipRRect(rrect, op, edgeStyle);
+    }
+    void onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeStyle) override {
+        fSurface->recorder()->clipPath(path, op, kSoft_ClipEdgeStyle == edgeStyle);
+        this->INHERITED::onClipPath(path, op, edgeStyle);
+    }
+    void onClipShader(sk_sp<SkShader> sh, SkClipOp op) override {
+        fSurface->recorder()->clipShader(sh, op);
+        this->INHERITED::onClipShader(std::move(sh), op);
+    }
+    void onClipRegion(const SkRegion& deviceRgn, SkClipOp op) override {
+        fSurface->recorder()->clipRegion(deviceRgn, op);
+        this->INHERITED::onClipRegion(deviceRgn, op);
+    }
+
+    void onDrawPaint(const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawPaint(paint);
+    }
+    void onDrawBehind(const SkPaint& paint) override {
+        this->willDraw();
+        SkCanvasPriv::DrawBehind(fSurface->recorder(), paint);
+    }
+    void onDrawPoints(PointMode mode, size_t count, const SkPoint pts[],
+                      const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawPoints(mode, count, pts, paint);
+    }
+    void onDrawRect(const SkRect& rect, const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawRect(rect, paint);
+    }
+    void onDrawRegion(const SkRegion& region, const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawRegion(region, paint);
+    }
+    void onDrawOval(const SkRect& rect, const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawOval(rect, paint);
+    }
+    void onDrawArc(const SkRect& rect, SkScalar startAngle, SkScalar sweepAngle, bool useCenter,
+                   const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawArc(rect, startAngle, sweepAngle, useCenter, paint);
+    }
+    void onDrawRRect(const SkRRect& rrect, const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawRRect(rrect, paint);
+    }
+    void onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawDRRect(outer, inner, paint);
+    }
+    void onDrawPath(const SkPath& path, const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawPath(path, paint);
+    }
+    void onDrawImage(const SkImage* image, SkScalar left, SkScalar top,
+                     const SkPaint* paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawImage(image, left, top, paint);
+    }
+    void onDrawImageRect(const SkImage* image, const SkRect* src, const SkRect& dst,
+                         const SkPaint* paint, SrcRectConstraint constraint) override {
+        this->willDraw();
+        fSurface->recorder()->legacy_drawImageRect(image, src, dst, paint, constraint);
+    }
+    void onDrawImageNine(const SkImage* image, const SkIRect& center, const SkRect& dst,
+                         const SkPaint* paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawImageNine(image, center, dst, paint);
+    }
+    void onDrawImageLattice(const SkImage* image, const Lattice& lattice, const SkRect& dst,
+                            const SkPaint* paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawImageLattice(image, lattice, dst, paint);
+    }
+    void onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
+                        const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawTextBlob(blob, x, y, paint);
+    }
+    void onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
+                       const SkPaint* paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawPicture(picture, matrix, paint);
+    }
+    void onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) override {
+        this->willDraw();
+        fSurface->recorder()->drawDrawable(drawable, matrix);
+    }
+    void onDrawVerticesObject(const SkVertices* vertices, SkBlendMode mode,
+                              const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawVertices(vertices, mode, paint);
+    }
+    void onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
+                     const SkPoint texCoords[4], SkBlendMode mode,
+                     const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawPatch(cubics, colors, texCoords, mode, paint);
+    }
+    void onDrawAtlas(const SkImage* image, const SkRSXform xform[], const SkRect tex[],
+                     const SkColor colors[], int count, SkBlendMode mode, const SkRect* cull,
+                     const SkPaint* paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawAtlas(image, xform, tex, colors, count, mode, cull, paint);
+    }
+    void onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) override {
+        this->willDraw();
+        fSurface->recorder()->private_draw_shadow_rec(path, rec);
+    }
+    void onDrawAnnotation(const SkRect& rect, const char key[], SkData* data) override {
+        fSurface->recorder()->drawAnnotation(rect, key, data);
+    }
+    void onDrawEdgeAAQuad(const SkRect& rect, const SkPoint clip[4], QuadAAFlags aa,
+                          const SkColor4f& color, SkBlendMode mode) override {
+        this->willDraw();
+        fSurface->recorder()->experimental_DrawEdgeAAQuad(rect, clip, aa, color, mode);
+    }
+    void onDrawEdgeAAImageSet(const ImageSetEntry set[], int count, const SkPoint dstClips[],
+                              const SkMatrix preViewMatrices[], const SkPaint* paint,
+                              SrcRectConstraint constraint) override {
+        this->willDraw();
+        fSurface->recorder()->experimental_DrawEdgeAAImageSet(set, count, dstClips,
+                                                              preViewMatrices, paint, constraint);
+    }
+
+    void onFlush() override {
+        fSurface->flushPendingDraws();
+    }
+
+private:
+    // We bypass SkCanvas' own draw entry points, so we must do its copy-on-write bookkeeping.
+    void willDraw() {
+        fSurface->notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+    }
+
+    SkSurface_RasterTiled* fSurface;
+    // One entry per open save(): the SaveLayer/SaveBehind op index for layers, -1 otherwise.
+    std::vector<int>       fSaveOps;
+
+    typedef SkCanvasVirtualEnforcer<SkCanvas> INHERITED;
+};
+
+// Replays ops [0, stop) into a tile canvas, drawing only the draws in [drawFrom, stop).  Earlier
+// draws have already been rasterized, so we only rebuild their matrix/clip/save state; any layers
+// among them were restored before the last flush, so they become plain saves rather than being
+// composited a second time.
+//
+// When given a tile, the canvas is not clipped to it up front: clips are computed against the
+// whole surface, exactly as a direct raster canvas would, and only each draw is clipped to the
+// tile.  That only restricts which pixels are written, as long as the draw doesn't cross the tile
+// edges (see flushPendingDraws()).
+class TileReplayer {
+public:
+    TileReplayer(SkCanvas* canvas, int drawFrom, const SkIRect* tile)
+        : fDraw(canvas, nullptr, nullptr, 0)
+        , fCanvas(canvas)
+        , fDrawFrom(drawFrom) {
+        if (tile) {
+            fTile.setRect(*tile);
+        }
+    }
+
+    void replay(const SkRecord& record, int stop) {
+        for (fIndex = 0; fIndex < stop; fIndex++) {
+            record.visit(fIndex, *this);
+        }
+    }
+
+    template <typename T> void operator()(const T& op) {
+        if (!(T::kTags & SkRecords::kDraw_Tag)) {
+            fDraw(op);
+        } else if (fIndex >= fDrawFrom) {
+            if (fTile.isEmpty()) {
+                fDraw(op);
+            } else {
+                fCanvas->save();
+                fCanvas->clipRegion(fTile);
+                fDraw(op);
+                fCanvas->restore();
+            }
+        }
+    }
+    void operator()(const SkRecords::SaveLayer& op)  { this->layer(op); }
+    void operator()(const SkRecords::SaveBehind& op) { this->layer(op); }
+
+private:
+    template <typename T> void layer(const T& op) {
+        // Layers are never split across tiles, so any still open here are replayed untiled.
+        SkASSERT(fIndex < fDrawFrom || fTile.isEmpty());
+        if (fIndex < fDrawFrom) {
+            fCanvas->save();
+        } else {
+            fDraw(op);
+        }
+    }
+
+    SkRecords::Draw fDraw;
+    SkCanvas*       fCanvas;
+    SkRegion        fTile;
+    int             fDrawFrom;
+    int             fIndex = 0;
+};
+
+// How flushPendingDraws() groups ops into draws that can be tiled or not.
+struct OpKind {
+    enum Kind { kState, kDraw, kDrawPaint, kSave, kLayer, kRestore };
+
+    template <typename T> Kind operator()(const T&) {
+        return (T::kTags & SkRecords::kDraw_Tag) ? kDraw : kState;
+    }
+    Kind operator()(const SkRecords::DrawPaint& op) {
+        // An image filter draws through a layer the size of the clip.
+        return op.paint.getImageFilter() ? kDraw : kDrawPaint;
+    }
+    Kind operator()(const SkRecords::Save&)       { return kSave; }
+    Kind operator()(const SkRecords::SaveLayer&)  { return kLayer; }
+    Kind operator()(const SkRecords::SaveBehind&) { return kLayer; }
+    Kind operator()(const SkRecords::Restore&)    { return kRestore; }
+};
+
+}  // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkSurface_RasterTiled::SkSurface_RasterTiled(const SkImageInfo& info, sk_sp<SkPixelRef> pr,
+                                             SkExecutor* executor, int tileSize,
+                                             const SkSurfaceProps* props)
+    : INHERITED(pr->width(), pr->height(), props)
+    , fExecutor(executor)
+    , fTileSize(tileSize)
+{
+    fBitmap.setInfo(info, pr->rowBytes());
+    fBitmap.setPixelRef(std::move(pr), 0, 0);
+    this->resetRecording();
+}
+
+void SkSurface_RasterTiled::resetRecording() {
+    fRecord = sk_make_sp<SkRecord>();
+    const SkRect bounds = SkRect::MakeIWH(fBitmap.width(), fBitmap.height());
+    if (!fRecorder) {
+        fRecorder = std::make_unique<SkRecorder>(fRecord.get(), bounds);
+    }
+    // Pictures and drawables are played back as they're drawn, just like on a raster canvas.
+    fRecorder->reset(fRecord.get(), bounds, SkRecorder::Playback_DrawPictureMode);
+    fFlushedOps = 0;
+}
+
+SkCanvas* SkSurface_RasterTiled::onNewCanvas() {
+    auto device = sk_make_sp<TiledRecordingDevice>(fBitmap, this->props(), this);
+    fDevice = device.get();
+    return new TiledRecordingCanvas(std::move(device), this);
+}
+
+sk_sp<SkSurface> SkSurface_RasterTiled::onNewSurface(const SkImageInfo& info) {
+    return SkSurface::MakeRasterTiled(info, fExecutor, fTileSize, &this->props());
+}
+
+void SkSurface_RasterTiled::flushPendingDraws() {
+    auto canvas = static_cast<TiledRecordingCanvas*>(this->getCachedCanvas());
+
+    // A raster canvas doesn't composite a layer until it's restored, so neither do we.
+    int stop = canvas->firstOpenLayerOp();
+    if (stop < 0) {
+        stop = fRecord->count();
+    }
+    if (stop <= fFlushedOps) {
+        return;
+    }
+
+    const SkRecord& record = *fRecord;
+    const SkIRect surfaceBounds = fBitmap.bounds();
+    const int tilesX = (fBitmap.width()  + fTileSize - 1) / fTileSize,
+              tilesY = (fBitmap.height() + fTileSize - 1) / fTileSize;
+    auto tileBounds = [&](int i) {
+        SkIRect tile = SkIRect::MakeXYWH((i % tilesX) * fTileSize, (i / tilesX) * fTileSize,
+                                         fTileSize, fTileSize);
+        SkAssertResult(tile.intersect(surfaceBounds));
+        return tile;
+    };
+
+    // A draw is only rasterized the same way in a tile if it doesn't cross the tile's edges:
+    // clipping AA geometry, text drawn as paths, etc. to a tile changes their edges slightly.
+    // drawPaint() just fills the clip, so it can cover any number of tiles.  Layers (including
+    // backdrop filters and SaveBehind, which read pixels across tile edges) are never split.
+    SkAutoTMalloc<SkRect> bounds(record.count());
+    SkAutoTMalloc<SkBBoxHierarchy::Metadata> meta(record.count());
+    SkRecordFillBounds(SkRect::Make(surfaceBounds), record, bounds.get(), meta.get());
+    auto staysInOneTile = [&](int op) {
+        SkIRect b = bounds[op].roundOut().makeOutset(1, 1);
+        if (!b.intersect(surfaceBounds)) {
+            return true;
+        }
+        return b.fLeft / fTileSize == (b.fRight  - 1) / fTileSize &&
+               b.fTop  / fTileSize == (b.fBottom - 1) / fTileSize;
+    };
+
+    // Split the pending ops into runs of draws that can all be tiled, and runs that can't.
+    struct Run { int start; bool tiled; };
+    std::vector<Run> runs;
+    std::vector<bool> saveIsLayer;
+    int openLayers = 0;
+    for (int i = 0; i < stop; i++) {
+        const OpKind::Kind kind = record.visit(i, OpKind());
+        bool tiled;
+        switch (kind) {
+            case OpKind::kState:
+                continue;
+            case OpKind::kSave:
+                saveIsLayer.push_back(false);
+                continue;
+            case OpKind::kLayer:
+                saveIsLayer.push_back(true);
+                if (openLayers++ > 0) {
+                    continue;
+                }
+                tiled = false;
+                break;
+            case OpKind::kRestore:
+                openLayers -= saveIsLayer.back();
+                saveIsLayer.pop_back();
+                continue;
+            case OpKind::kDraw:
+            case OpKind::kDrawPaint:
+                if (openLayers > 0) {
+                    continue;
+                }
+                tiled = kind == OpKind::kDrawPaint || staysInOneTile(i);
+                break;
+        }
+        if (i >= fFlushedOps && (runs.empty() || runs.back().tiled != tiled)) {
+            runs.push_back({i, tiled});
+        }
+    }
+
+    for (size_t r = 0; r < runs.size(); r++) {
+        const int drawFrom = r == 0 ? fFlushedOps : runs[r].start,
+                  drawTo   = r + 1 == runs.size() ? stop : runs[r + 1].start;
+        if (!runs[r].tiled) {
+            SkCanvas canvas(fBitmap, this->props());
+            TileReplayer(&canvas, drawFrom, nullptr).replay(record, drawTo);
+            continue;
+        }
+        SkTaskGroup tg(*fExecutor);
+        tg.batch(tilesX * tilesY, [&](int i) {
+            const SkIRect tile = tileBounds(i);
+            SkCanvas tileCanvas(fBitmap, this->props());
+            TileReplayer(&tileCanvas, drawFrom, &tile).replay(record, drawTo);
+        });
+        tg.wait();
+    }
+
+    fFlushedOps = stop;
+
+    // If the canvas is back in its initial state, we can forget everything recorded so far.
+    if (stop == fRecord->count() &&
+        canvas->getSaveCount() == 1 &&
+        canvas->getLocalToDevice() == SkM44() &&
+        canvas->isClipRect() &&
+        canvas->getDeviceClipBounds() == fBitmap.bounds()) {
+        this->resetRecording();
+    }
+}
+
+void SkSurface_RasterTiled::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
+                                   const SkPaint* paint) {
+    this->flushPendingDraws();
+    canvas->drawBitmap(fBitmap, x, y, paint);
+}
+
+sk_sp<SkImage> SkSurface_RasterTiled::onNewImageSnapshot(const SkIRect* subset) {
+    this->flushPendingDraws();
+
+    if (subset) {
+        SkASSERT(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()).contains(*subset));
+        SkBitmap dst;
+        dst.allocPixels(fBitmap.info().makeDimensions(subset->size()));
+        SkAssertResult(fBitmap.readPixels(dst.pixmap(), subset->left(), subset->top()));
+        dst.setImmutable(); // key, so MakeFromBitmap doesn't make a copy of the buffer
+        return SkImage::MakeFromBitmap(dst);
+    }
+
+    // SkImage_raster requires these pixels are immutable for its full lifetime.
+    // We'll undo this via onRestoreBackingMutability() if we can avoid the COW.
+    if (SkPixelRef* pr = fBitmap.pixelRef()) {
+        pr->setTemporarilyImmutable();
+    }
+    return SkMakeImageFromRasterBitmap(fBitmap, kIfMutable_SkCopyPixelsMode);
+}
+
+void SkSurface_RasterTiled::onWritePixels(const SkPixmap& src, int x, int y) {
+    this->flushPendingDraws();
+    fBitmap.writePixels(src, x, y);
+}
+
+void SkSurface_RasterTiled::onRestoreBackingMutability() {
+    SkASSERT(!this->hasCachedImage());  // Shouldn't be any snapshots out there.
+    if (SkPixelRef* pr = fBitmap.pixelRef()) {
+        pr->restoreMutability();
+    }
+}
+
+void SkSurface_RasterTiled::onCopyOnWrite(ContentChangeMode mode) {
+    // Snapshots always flush first, so any ops still pending belong after the snapshot.
+    sk_sp<SkImage> cached(this->refCachedImage());
+    SkASSERT(cached);
+    if (SkBitmapImageGetPixelRef(cached.get()) == fBitmap.pixelRef()) {
+        if (kDiscard_ContentChangeMode == mode) {
+            fBitmap.allocPixels();
+        } else {
+            SkBitmap prev(fBitmap);
+            fBitmap.allocPixels();
+            SkASSERT(prev.info() == fBitmap.info());
+            SkASSERT(prev.rowBytes() == fBitmap.rowBytes());
+            memcpy(fBitmap.getPixels(), prev.getPixels(), fBitmap.computeByteSize());
+        }
+
+        // Point our canvas' device at the new pixels, making sure the canvas exists first.
+        SkAssertResult(this->getCachedCanvas());
+        fDevice->replaceBitmapBackendForRasterSurface(fBitmap);
+    }
+}
+
+GrSemaphoresSubmitted SkSurface_RasterTiled::onFlush(BackendSurfaceAccess, const GrFlushInfo&,
+                                                     const GrBackendSurfaceMutableState*) {
+    this->flushPendingDraws();
+    return GrSemaphoresSubmitted::kNo;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkSurface> SkSurface::MakeRasterTiled(const SkImageInfo& info, SkExecutor* executor,
+                                            int tileSize, const SkSurfaceProps* props) {
+    if (!SkSurfaceValidateRasterInfo(info) || tileSize <= 0) {
+        return nullptr;
+    }
+
+    sk_sp<SkPixelRef> pr = SkMallocPixelRef::MakeAllocate(info, 0);
+    if (!pr) {
+        return nullptr;
+    }
+    if (!executor) {
+        executor = &SkExecutor::GetDefault();
+    }
+    return sk_make_sp<SkSurface_RasterTiled>(info, std::move(pr), executor, tileSize, props);
+}
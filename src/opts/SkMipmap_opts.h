@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipmap_opts_DEFINED
+#define SkMipmap_opts_DEFINED
+
+#include "include/private/SkVx.h"
+
+namespace SK_OPTS_NS {
+
+    // Averages each 2x2 block of 8888 pixels, matching SkMipmap's generic downsample_2_2 bit for
+    // bit. Each 64-bit lane holds a pair of horizontally adjacent source pixels; we spread their
+    // channels into 16-bit fields so the four samples can be summed without overflow, then fold
+    // the odd pixel onto the even one.
+    template <int N>
+    static inline skvx::Vec<N,uint32_t> box_2x2_8888(const skvx::Vec<N,uint64_t>& r0,
+                                                     const skvx::Vec<N,uint64_t>& r1) {
+        const uint64_t mask = 0x00ff00ff00ff00ff;
+        skvx::Vec<N,uint64_t> rb = (r0 & mask) + (r1 & mask),
+                              ga = ((r0 >> 8) & mask) + ((r1 >> 8) & mask);
+        rb = rb + (rb >> 32);
+        ga = ga + (ga >> 32);
+        return skvx::cast<uint32_t>( ((rb >> 2) & 0x00ff00ff) |
+                                    (((ga >> 2) & 0x00ff00ff) << 8) );
+    }
+
+    /*not static*/ inline void downsample_2_2_8888(void* dst, const void* src, size_t srcRB,
+                                                   int count) {
+    #if defined(SK_CPU_SSE_LEVEL) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        static const int N = 8;
+    #else
+        static const int N = 4;
+    #endif
+        auto p0 = static_cast<const char*>(src);
+        auto p1 = p0 + srcRB;
+        auto d  = static_cast<uint32_t*>(dst);
+
+        while (count >= N) {
+            using V = skvx::Vec<N,uint64_t>;
+            box_2x2_8888(V::Load(p0), V::Load(p1)).store(d);
+            p0    += N * sizeof(uint64_t);
+            p1    += N * sizeof(uint64_t);
+            d     += N;
+            count -= N;
+        }
+        while (count --> 0) {
+            using V = skvx::Vec<1,uint64_t>;
+            box_2x2_8888(V::Load(p0), V::Load(p1)).store(d);
+            p0 += sizeof(uint64_t);
+            p1 += sizeof(uint64_t);
+            d  += 1;
+        }
+    }
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkMipmap_opts_DEFINED
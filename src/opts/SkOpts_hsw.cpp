@@ -11,6 +11,7 @@
 #include "src/core/SkCubicSolver.h"
 #include "src/opts/SkBitmapProcState_opts.h"
 #include "src/opts/SkBlitRow_opts.h"
+#include "src/opts/SkMipmap_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
 #include "src/opts/SkUtils_opts.h"
@@ -23,6 +24,8 @@ namespace SkOpts {
 
         S32_alpha_D32_filter_DX  = hsw::S32_alpha_D32_filter_DX;
 
+        downsample_2_2_8888 = SK_OPTS_NS::downsample_2_2_8888;
+
         cubic_solver = SK_OPTS_NS::cubic_solver;
 
         RGBA_to_BGRA          = SK_OPTS_NS::RGBA_to_BGRA;
@@ -11,12 +11,21 @@
 #include "include/core/SkString.h"
 #include "include/private/SkMalloc.h"
 #include "include/utils/SkParse.h"
+#include "src/core/SkMathPriv.h"
 #include "src/utils/SkUTF.h"
 
 #include <cmath>
 #include <tuple>
 #include <vector>
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+    #define SK_JSON_BLOCK_SCAN
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+    #define SK_JSON_BLOCK_SCAN
+#endif
+
 namespace skjson {
 
 // #define SK_JSON_REPORT_ERRORS
@@ -264,11 +273,80 @@ static inline bool is_digit(char c)    { return g_token_flags[static_cast<uint8_
 static inline bool is_numeric(char c)  { return g_token_flags[static_cast<uint8_t>(c)] & 0x10; }
 static inline bool is_eoscope(char c)  { return g_token_flags[static_cast<uint8_t>(c)] & 0x20; }
 
-static inline const char* skip_ws(const char* p) {
-    while (is_ws(*p)) ++p;
-    return p;
+#if defined(SK_JSON_BLOCK_SCAN)
+
+// Block scanners, looking at kScanBlock chars at once: they return the index of the first
+// string terminator (is_eostring) or non-whitespace (!is_ws) char, or kScanBlock if none.
+static constexpr int kScanBlock = 16;
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+static inline int first_eostring(const char* p) {
+    const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+    // Control chars (unsigned c <= 0x1f), and " \\ ] }.
+    auto m = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1f)), v);
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(']')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('}')));
+
+    return SkCTZ(SkToU32(_mm_movemask_epi8(m)) | (1u << kScanBlock));
 }
 
+static inline int first_non_ws(const char* p) {
+    const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+    auto m = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+
+    return SkCTZ(~SkToU32(_mm_movemask_epi8(m)));
+}
+
+#else
+
+// NEON has no movemask: narrow each 8-bit lane mask to a nibble, and look for the first one.
+static inline int first_set(uint8x16_t m) {
+    const uint64_t bits =
+            vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+    const auto lo = static_cast<uint32_t>(bits),
+               hi = static_cast<uint32_t>(bits >> 32);
+
+    return lo ? SkCTZ(lo) / 4
+              : hi ? (32 + SkCTZ(hi)) / 4
+                   : kScanBlock;
+}
+
+static inline int first_eostring(const char* p) {
+    const auto v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+
+    // Control chars (c <= 0x1f), and " \\ ] }.
+    auto m = vcleq_u8(v, vdupq_n_u8(0x1f));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('"')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('\\')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8(']')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('}')));
+
+    return first_set(m);
+}
+
+static inline int first_non_ws(const char* p) {
+    const auto v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+
+    auto m = vceqq_u8(v, vdupq_n_u8(' '));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('\t')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('\n')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('\r')));
+
+    return first_set(vmvnq_u8(m));
+}
+
+#endif
+
+#endif // SK_JSON_BLOCK_SCAN
+
 static inline float pow10(int32_t exp) {
     static constexpr float g_pow10_table[63] =
     {
@@ -291,19 +369,234 @@ static inline float pow10(int32_t exp) {
                                   : std::pow(10.0f, static_cast<float>(exp));
 }
 
-class DOMParser {
+// Builds the DOM bottom-up: values are pushed onto a stack as they are matched, and each closed
+// scope is collapsed into a single array/object value.
+class DOMSink {
 public:
-    explicit DOMParser(SkArenaAlloc& alloc)
+    explicit DOMSink(SkArenaAlloc& alloc)
         : fAlloc(alloc) {
         fValueStack.reserve(kValueStackReserve);
+    }
+
+    const Value& root() const {
+        SkASSERT(fValueStack.size() == 1);
+        return fValueStack.front();
+    }
+
+    bool inTopLevelScope() const { return fScopeIndex == 0; }
+    bool inObjectScope()   const { return fScopeIndex >  0; }
+    bool inArrayScope()    const { return fScopeIndex <  0; }
+
+    bool pushObjectScope() {
+        // Save a scope index now, and then later we'll overwrite this value as the Object itself.
+        fValueStack.push_back(RawValue<intptr_t>(fScopeIndex));
+
+        // New object scope.
+        fScopeIndex = SkTo<intptr_t>(fValueStack.size());
+        return true;
+    }
+
+    bool popObjectScope() {
+        SkASSERT(this->inObjectScope());
+        this->popScopeAsVec<ObjectValue>(SkTo<size_t>(fScopeIndex));
+
+        SkDEBUGCODE(
+            const auto& obj = fValueStack.back().as<ObjectValue>();
+            SkASSERT(obj.is<ObjectValue>());
+            for (const auto& member : obj) {
+                SkASSERT(member.fKey.is<StringValue>());
+            }
+        )
+        return true;
+    }
+
+    bool pushArrayScope() {
+        // Save a scope index now, and then later we'll overwrite this value as the Array itself.
+        fValueStack.push_back(RawValue<intptr_t>(fScopeIndex));
+
+        // New array scope.
+        fScopeIndex = -SkTo<intptr_t>(fValueStack.size());
+        return true;
+    }
+
+    bool popArrayScope() {
+        SkASSERT(this->inArrayScope());
+        this->popScopeAsVec<ArrayValue>(SkTo<size_t>(-fScopeIndex));
+
+        SkDEBUGCODE(
+            const auto& arr = fValueStack.back().as<ArrayValue>();
+            SkASSERT(arr.is<ArrayValue>());
+        )
+        return true;
+    }
+
+    bool pushObjectKey(const char* key, size_t size, const char* eos) {
+        SkASSERT(this->inObjectScope());
+        SkASSERT(fValueStack.size() >= SkTo<size_t>(fScopeIndex));
+        SkASSERT(!((fValueStack.size() - SkTo<size_t>(fScopeIndex)) & 1));
+        return this->pushString(key, size, eos);
+    }
+
+    bool pushTrue() {
+        fValueStack.push_back(BoolValue(true));
+        return true;
+    }
+
+    bool pushFalse() {
+        fValueStack.push_back(BoolValue(false));
+        return true;
+    }
+
+    bool pushNull() {
+        fValueStack.push_back(NullValue());
+        return true;
+    }
+
+    bool pushString(const char* s, size_t size, const char* eos) {
+        fValueStack.push_back(FastString(s, size, eos, fAlloc));
+        return true;
+    }
+
+    bool pushInt32(int32_t i) {
+        fValueStack.push_back(NumberValue(i));
+        return true;
+    }
+
+    bool pushFloat(float f) {
+        fValueStack.push_back(NumberValue(f));
+        return true;
+    }
+
+private:
+    SkArenaAlloc&         fAlloc;
+
+    // Pending values stack.
+    static constexpr size_t kValueStackReserve = 256;
+    std::vector<Value>    fValueStack;
+
+    // Tracks the current object/array scope, as an index into fStack:
+    //
+    //   - for objects: fScopeIndex =  (index of first value in scope)
+    //   - for arrays : fScopeIndex = -(index of first value in scope)
+    //
+    // fScopeIndex == 0 IFF we are at the top level (no current/active scope).
+    intptr_t              fScopeIndex = 0;
+
+    // Helper for masquerading raw primitive types as Values (bypassing tagging, etc).
+    template <typename T>
+    class RawValue final : public Value {
+    public:
+        explicit RawValue(T v) {
+            static_assert(sizeof(T) <= sizeof(Value), "");
+            *this->cast<T>() = v;
+        }
+
+        T operator *() const { return *this->cast<T>(); }
+    };
+
+    template <typename VectorT>
+    void popScopeAsVec(size_t scope_start) {
+        SkASSERT(scope_start > 0);
+        SkASSERT(scope_start <= fValueStack.size());
+
+        using T = typename VectorT::ValueT;
+        static_assert( sizeof(T) >=  sizeof(Value), "");
+        static_assert( sizeof(T)  %  sizeof(Value) == 0, "");
+        static_assert(alignof(T) == alignof(Value), "");
+
+        const auto scope_count = fValueStack.size() - scope_start,
+                         count = scope_count / (sizeof(T) / sizeof(Value));
+        SkASSERT(scope_count % (sizeof(T) / sizeof(Value)) == 0);
+
+        const auto* begin = reinterpret_cast<const T*>(fValueStack.data() + scope_start);
+
+        // Restore the previous scope index from saved placeholder value,
+        // and instantiate as a vector of values in scope.
+        auto& placeholder = fValueStack[scope_start - 1];
+        fScopeIndex = *static_cast<RawValue<intptr_t>&>(placeholder);
+        placeholder = VectorT(begin, count, fAlloc);
+
+        // Drop the (consumed) values in scope.
+        fValueStack.resize(scope_start);
+    }
+};
+
+// Forwards values to a Handler as soon as they are matched, only keeping track of the kind of
+// each open scope.
+class HandlerSink {
+public:
+    explicit HandlerSink(Handler* handler)
+        : fHandler(handler) {
+        fScopes.reserve(kScopeReserve);
+    }
+
+    bool inTopLevelScope() const { return fScopes.empty(); }
+    bool inObjectScope()   const { return !fScopes.empty() &&  fScopes.back(); }
+    bool inArrayScope()    const { return !fScopes.empty() && !fScopes.back(); }
+
+    bool pushObjectScope() {
+        fScopes.push_back(true);
+        return fHandler->onBeginObject();
+    }
+
+    bool popObjectScope() {
+        SkASSERT(this->inObjectScope());
+        fScopes.pop_back();
+        return fHandler->onEndObject();
+    }
+
+    bool pushArrayScope() {
+        fScopes.push_back(false);
+        return fHandler->onBeginArray();
+    }
+
+    bool popArrayScope() {
+        SkASSERT(this->inArrayScope());
+        fScopes.pop_back();
+        return fHandler->onEndArray();
+    }
+
+    bool pushObjectKey(const char* key, size_t size, const char*) {
+        SkASSERT(this->inObjectScope());
+        return fHandler->onKey(key, size);
+    }
+
+    bool pushTrue()  { return fHandler->onBool(true);  }
+    bool pushFalse() { return fHandler->onBool(false); }
+    bool pushNull()  { return fHandler->onNull();      }
+
+    bool pushString(const char* s, size_t size, const char*) {
+        return fHandler->onString(s, size);
+    }
+
+    bool pushInt32(int32_t i) { return fHandler->onInt(i);   }
+    bool pushFloat(float f)   { return fHandler->onFloat(f); }
+
+private:
+    Handler*              fHandler;
+
+    // Open scopes, innermost last: true for objects, false for arrays.
+    static constexpr size_t kScopeReserve = 64;
+    std::vector<bool>     fScopes;
+};
+
+// The lexer, shared by DOM and Parse(): it validates the input and reports each value to a Sink
+// as soon as it is matched. Sinks track the open object/array scopes, and return false from
+// any push/pop to stop parsing.
+template <typename Sink>
+class Parser {
+public:
+    explicit Parser(Sink& sink)
+        : fSink(sink) {
         fUnescapeBuffer.reserve(kUnescapeBufferReserve);
     }
 
-    Value parse(const char* p, size_t size) {
+    bool parse(const char* p, size_t size) {
         if (!size) {
-            return this->error(NullValue(), p, "invalid empty input");
+            return this->error(false, p, "invalid empty input");
         }
 
+        fEnd = p + size;
         const char* p_stop = p + size - 1;
 
         // We're only checking for end-of-stream on object/array close('}',']'),
@@ -312,10 +605,10 @@ public:
 
         SkASSERT(p_stop >= p && p_stop < p + size);
         if (!is_eoscope(*p_stop)) {
-            return this->error(NullValue(), p_stop, "invalid top-level value");
+            return this->error(false, p_stop, "invalid top-level value");
         }
 
-        p = skip_ws(p);
+        p = this->skipWS(p);
 
         switch (*p) {
         case '{':
@@ -323,42 +616,42 @@ public:
         case '[':
             goto match_array;
         default:
-            return this->error(NullValue(), p, "invalid top-level value");
+            return this->error(false, p, "invalid top-level value");
         }
 
     match_object:
         SkASSERT(*p == '{');
-        p = skip_ws(p + 1);
+        p = this->skipWS(p + 1);
 
-        this->pushObjectScope();
+        if (!fSink.pushObjectScope()) return this->stopped(p);
 
         if (*p == '}') goto pop_object;
 
         // goto match_object_key;
     match_object_key:
-        p = skip_ws(p);
-        if (*p != '"') return this->error(NullValue(), p, "expected object key");
+        p = this->skipWS(p);
+        if (*p != '"') return this->error(false, p, "expected object key");
 
         p = this->matchString(p, p_stop, [this](const char* key, size_t size, const char* eos) {
-            this->pushObjectKey(key, size, eos);
+            return fSink.pushObjectKey(key, size, eos);
         });
-        if (!p) return NullValue();
+        if (!p) return false;
 
-        p = skip_ws(p);
-        if (*p != ':') return this->error(NullValue(), p, "expected ':' separator");
+        p = this->skipWS(p);
+        if (*p != ':') return this->error(false, p, "expected ':' separator");
 
         ++p;
 
         // goto match_value;
     match_value:
-        p = skip_ws(p);
+        p = this->skipWS(p);
 
         switch (*p) {
         case '\0':
-            return this->error(NullValue(), p, "unexpected input end");
+            return this->error(false, p, "unexpected input end");
         case '"':
             p = this->matchString(p, p_stop, [this](const char* str, size_t size, const char* eos) {
-                this->pushString(str, size, eos);
+                return fSink.pushString(str, size, eos);
             });
             break;
         case '[':
@@ -379,20 +672,20 @@ public:
             break;
         }
 
-        if (!p) return NullValue();
+        if (!p) return false;
 
         // goto match_post_value;
     match_post_value:
-        SkASSERT(!this->inTopLevelScope());
+        SkASSERT(!fSink.inTopLevelScope());
 
-        p = skip_ws(p);
+        p = this->skipWS(p);
         switch (*p) {
         case ',':
             ++p;
-            if (this->inObjectScope()) {
+            if (fSink.inObjectScope()) {
                 goto match_object_key;
             } else {
-                SkASSERT(this->inArrayScope());
+                SkASSERT(fSink.inArrayScope());
                 goto match_value;
             }
         case ']':
@@ -400,7 +693,7 @@ public:
         case '}':
             goto pop_object;
         default:
-            return this->error(NullValue(), p - 1, "unexpected value-trailing token");
+            return this->error(false, p - 1, "unexpected value-trailing token");
         }
 
         // unreachable
@@ -409,27 +702,24 @@ public:
     pop_object:
         SkASSERT(*p == '}');
 
-        if (this->inArrayScope()) {
-            return this->error(NullValue(), p, "unexpected object terminator");
+        if (fSink.inArrayScope()) {
+            return this->error(false, p, "unexpected object terminator");
         }
 
-        this->popObjectScope();
+        if (!fSink.popObjectScope()) return this->stopped(p);
 
         // goto pop_common
     pop_common:
         SkASSERT(is_eoscope(*p));
 
-        if (this->inTopLevelScope()) {
-            SkASSERT(fValueStack.size() == 1);
-
+        if (fSink.inTopLevelScope()) {
             // Success condition: parsed the top level element and reached the stop token.
             return p == p_stop
-                ? fValueStack.front()
-                : this->error(NullValue(), p + 1, "trailing root garbage");
+                || this->error(false, p + 1, "trailing root garbage");
         }
 
         if (p == p_stop) {
-            return this->error(NullValue(), p, "unexpected end-of-input");
+            return this->error(false, p, "unexpected end-of-input");
         }
 
         ++p;
@@ -438,9 +728,9 @@ public:
 
     match_array:
         SkASSERT(*p == '[');
-        p = skip_ws(p + 1);
+        p = this->skipWS(p + 1);
 
-        this->pushArrayScope();
+        if (!fSink.pushArrayScope()) return this->stopped(p);
 
         if (*p != ']') goto match_value;
 
@@ -448,16 +738,16 @@ public:
     pop_array:
         SkASSERT(*p == ']');
 
-        if (this->inObjectScope()) {
-            return this->error(NullValue(), p, "unexpected array terminator");
+        if (fSink.inObjectScope()) {
+            return this->error(false, p, "unexpected array terminator");
         }
 
-        this->popArrayScope();
+        if (!fSink.popArrayScope()) return this->stopped(p);
 
         goto pop_common;
 
         SkASSERT(false);
-        return NullValue();
+        return false;
     }
 
     std::tuple<const char*, const SkString> getError() const {
@@ -465,155 +755,84 @@ public:
     }
 
 private:
-    SkArenaAlloc&         fAlloc;
+    Sink&                 fSink;
 
-    // Pending values stack.
-    static constexpr size_t kValueStackReserve = 256;
-    std::vector<Value>    fValueStack;
+    // End of the input, bounding block scans.
+    const char*           fEnd = nullptr;
 
     // String unescape buffer.
     static constexpr size_t kUnescapeBufferReserve = 512;
     std::vector<char>     fUnescapeBuffer;
 
-    // Tracks the current object/array scope, as an index into fStack:
-    //
-    //   - for objects: fScopeIndex =  (index of first value in scope)
-    //   - for arrays : fScopeIndex = -(index of first value in scope)
-    //
-    // fScopeIndex == 0 IFF we are at the top level (no current/active scope).
-    intptr_t              fScopeIndex = 0;
-
     // Error reporting.
     const char*           fErrorToken = nullptr;
     SkString              fErrorMessage;
 
-    bool inTopLevelScope() const { return fScopeIndex == 0; }
-    bool inObjectScope()   const { return fScopeIndex >  0; }
-    bool inArrayScope()    const { return fScopeIndex <  0; }
+    // Set when the sink stops parsing, as opposed to a lexing failure.
+    bool                  fStopped = false;
 
-    // Helper for masquerading raw primitive types as Values (bypassing tagging, etc).
     template <typename T>
-    class RawValue final : public Value {
-    public:
-        explicit RawValue(T v) {
-            static_assert(sizeof(T) <= sizeof(Value), "");
-            *this->cast<T>() = v;
-        }
-
-        T operator *() const { return *this->cast<T>(); }
-    };
-
-    template <typename VectorT>
-    void popScopeAsVec(size_t scope_start) {
-        SkASSERT(scope_start > 0);
-        SkASSERT(scope_start <= fValueStack.size());
-
-        using T = typename VectorT::ValueT;
-        static_assert( sizeof(T) >=  sizeof(Value), "");
-        static_assert( sizeof(T)  %  sizeof(Value) == 0, "");
-        static_assert(alignof(T) == alignof(Value), "");
-
-        const auto scope_count = fValueStack.size() - scope_start,
-                         count = scope_count / (sizeof(T) / sizeof(Value));
-        SkASSERT(scope_count % (sizeof(T) / sizeof(Value)) == 0);
-
-        const auto* begin = reinterpret_cast<const T*>(fValueStack.data() + scope_start);
-
-        // Restore the previous scope index from saved placeholder value,
-        // and instantiate as a vector of values in scope.
-        auto& placeholder = fValueStack[scope_start - 1];
-        fScopeIndex = *static_cast<RawValue<intptr_t>&>(placeholder);
-        placeholder = VectorT(begin, count, fAlloc);
-
-        // Drop the (consumed) values in scope.
-        fValueStack.resize(scope_start);
-    }
-
-    void pushObjectScope() {
-        // Save a scope index now, and then later we'll overwrite this value as the Object itself.
-        fValueStack.push_back(RawValue<intptr_t>(fScopeIndex));
-
-        // New object scope.
-        fScopeIndex = SkTo<intptr_t>(fValueStack.size());
-    }
-
-    void popObjectScope() {
-        SkASSERT(this->inObjectScope());
-        this->popScopeAsVec<ObjectValue>(SkTo<size_t>(fScopeIndex));
-
-        SkDEBUGCODE(
-            const auto& obj = fValueStack.back().as<ObjectValue>();
-            SkASSERT(obj.is<ObjectValue>());
-            for (const auto& member : obj) {
-                SkASSERT(member.fKey.is<StringValue>());
-            }
-        )
-    }
-
-    void pushArrayScope() {
-        // Save a scope index now, and then later we'll overwrite this value as the Array itself.
-        fValueStack.push_back(RawValue<intptr_t>(fScopeIndex));
-
-        // New array scope.
-        fScopeIndex = -SkTo<intptr_t>(fValueStack.size());
-    }
-
-    void popArrayScope() {
-        SkASSERT(this->inArrayScope());
-        this->popScopeAsVec<ArrayValue>(SkTo<size_t>(-fScopeIndex));
-
-        SkDEBUGCODE(
-            const auto& arr = fValueStack.back().as<ArrayValue>();
-            SkASSERT(arr.is<ArrayValue>());
-        )
-    }
-
-    void pushObjectKey(const char* key, size_t size, const char* eos) {
-        SkASSERT(this->inObjectScope());
-        SkASSERT(fValueStack.size() >= SkTo<size_t>(fScopeIndex));
-        SkASSERT(!((fValueStack.size() - SkTo<size_t>(fScopeIndex)) & 1));
-        this->pushString(key, size, eos);
-    }
-
-    void pushTrue() {
-        fValueStack.push_back(BoolValue(true));
-    }
-
-    void pushFalse() {
-        fValueStack.push_back(BoolValue(false));
+    T error(T&& ret_val, const char* p, const char* msg) {
+#if defined(SK_JSON_REPORT_ERRORS)
+        fErrorToken = p;
+        fErrorMessage.set(msg);
+#endif
+        return ret_val;
     }
 
-    void pushNull() {
-        fValueStack.push_back(NullValue());
+    template <typename T>
+    T stopped(T&& ret_val, const char* p) {
+        fStopped = true;
+        return this->error(std::forward<T>(ret_val), p, "stopped by sink");
     }
 
-    void pushString(const char* s, size_t size, const char* eos) {
-        fValueStack.push_back(FastString(s, size, eos, fAlloc));
+    bool stopped(const char* p) {
+        return this->stopped(false, p);
     }
 
-    void pushInt32(int32_t i) {
-        fValueStack.push_back(NumberValue(i));
+    // Returns p if the sink accepted the matched value, or stops parsing.
+    const char* accept(bool accepted, const char* p) {
+        return accepted ? p : this->stopped(nullptr, p);
     }
 
-    void pushFloat(float f) {
-        fValueStack.push_back(NumberValue(f));
+    const char* skipWS(const char* p) const {
+        // Compact JSON rarely has more than one whitespace char in a row, so only look at whole
+        // blocks for longer runs (indentation).
+        if (!is_ws(*p) || !is_ws(*++p)) {
+            return p;
+        }
+#if defined(SK_JSON_BLOCK_SCAN)
+        while (fEnd - p >= kScanBlock) {
+            const auto i = first_non_ws(p);
+            if (i < kScanBlock) {
+                return p + i;
+            }
+            p += kScanBlock;
+        }
+#endif
+        while (is_ws(*p)) ++p;
+        return p;
     }
 
-    template <typename T>
-    T error(T&& ret_val, const char* p, const char* msg) {
-#if defined(SK_JSON_REPORT_ERRORS)
-        fErrorToken = p;
-        fErrorMessage.set(msg);
+    const char* scanString(const char* p) const {
+#if defined(SK_JSON_BLOCK_SCAN)
+        while (fEnd - p >= kScanBlock) {
+            const auto i = first_eostring(p);
+            if (i < kScanBlock) {
+                return p + i;
+            }
+            p += kScanBlock;
+        }
 #endif
-        return ret_val;
+        while (!is_eostring(*p)) ++p;
+        return p;
     }
 
     const char* matchTrue(const char* p) {
         SkASSERT(p[0] == 't');
 
         if (p[1] == 'r' && p[2] == 'u' && p[3] == 'e') {
-            this->pushTrue();
-            return p + 4;
+            return this->accept(fSink.pushTrue(), p + 4);
         }
 
         return this->error(nullptr, p, "invalid token");
@@ -623,8 +842,7 @@ private:
         SkASSERT(p[0] == 'f');
 
         if (p[1] == 'a' && p[2] == 'l' && p[3] == 's' && p[4] == 'e') {
-            this->pushFalse();
-            return p + 5;
+            return this->accept(fSink.pushFalse(), p + 5);
         }
 
         return this->error(nullptr, p, "invalid token");
@@ -634,8 +852,7 @@ private:
         SkASSERT(p[0] == 'n');
 
         if (p[1] == 'u' && p[2] == 'l' && p[3] == 'l') {
-            this->pushNull();
-            return p + 4;
+            return this->accept(fSink.pushNull(), p + 4);
         }
 
         return this->error(nullptr, p, "invalid token");
@@ -696,12 +913,13 @@ private:
         do {
             // Consume string chars.
             // This is the fast path, and hopefully we only hit it once then quick-exit below.
-            for (p = p + 1; !is_eostring(*p); ++p);
+            p = this->scanString(p + 1);
 
             if (*p == '"') {
                 // Valid string found.
+                bool accepted;
                 if (!requires_unescape) {
-                    func(s_begin, p - s_begin, p_stop);
+                    accepted = func(s_begin, p - s_begin, p_stop);
                 } else {
                     // Slow unescape.  We could avoid this extra copy with some effort,
                     // but in practice escaped strings should be rare.
@@ -711,9 +929,9 @@ private:
                     }
 
                     SkASSERT(!buf->empty());
-                    func(buf->data(), buf->size(), buf->data() + buf->size() - 1);
+                    accepted = func(buf->data(), buf->size(), buf->data() + buf->size() - 1);
                 }
-                return p + 1;
+                return this->accept(accepted, p + 1);
             }
 
             if (*p == '\\') {
@@ -755,9 +973,7 @@ private:
             return nullptr;
         }
 
-        this->pushFloat(sign * f * decimal_scale);
-
-        return p;
+        return this->accept(fSink.pushFloat(sign * f * decimal_scale), p);
     }
 
     const char* matchFastFloatPart(const char* p, int sign, float f) {
@@ -770,8 +986,7 @@ private:
 
         if (!is_numeric(*p)) {
             // Matched (integral) float.
-            this->pushFloat(sign * f);
-            return p;
+            return this->accept(fSink.pushFloat(sign * f), p);
         }
 
         return (*p == '.') ? this->matchFastFloatDecimalPart(p + 1, sign, f, 0)
@@ -804,8 +1019,7 @@ private:
         if (!is_numeric(*p)) {
             // Did we actually match any digits?
             if (p > digits_start) {
-                this->pushInt32(sign * n32);
-                return p;
+                return this->accept(fSink.pushInt32(sign * n32), p);
             }
             return nullptr;
         }
@@ -825,8 +1039,7 @@ private:
             if (!is_numeric(*p)) {
                 // Did we actually match any digits?
                 if (p > decimals_start) {
-                    this->pushFloat(sign * n32 * pow10(exp));
-                    return p;
+                    return this->accept(fSink.pushFloat(sign * n32 * pow10(exp)), p);
                 }
                 return nullptr;
             }
@@ -842,13 +1055,13 @@ private:
 
     const char* matchNumber(const char* p) {
         if (const auto* fast = this->matchFast32OrFloat(p)) return fast;
+        if (fStopped) return nullptr;
 
         // slow fallback
         char* matched;
         float f = strtof(p, &matched);
         if (matched > p) {
-            this->pushFloat(f);
-            return matched;
+            return this->accept(fSink.pushFloat(f), matched);
         }
         return this->error(nullptr, p, "invalid numeric token");
     }
@@ -899,6 +1112,238 @@ void Write(const Value& v, SkWStream* stream) {
     }
 }
 
+// Binary snapshots.
+//
+// A snapshot is a header followed by a copy of the DOM's external records (long strings,
+// arrays and objects), laid out contiguously in breadth-first order, with their pointers
+// replaced by payload offsets:
+//
+//   [magic] [version] [pointer size] [payload size] [root value] [payload]
+//
+// Loading copies the payload into the arena in one go, then walks the records in the same
+// order, validating offsets and sizes and turning offsets back into pointers.
+//
+// The magic starts with a \0, which cannot start valid JSON text.
+static constexpr char     kSnapshotMagic[4] = { '\0', 's', 'k', 'j' };
+static constexpr uint32_t kSnapshotVersion  = 1;
+
+struct SnapshotHeader {
+    char     fMagic[4];
+    uint32_t fVersion;
+    uint32_t fPointerSize;
+    uint32_t fReserved;
+    uint64_t fPayloadSize;
+    Value    fRoot;
+};
+
+// Helper for relocating external records.
+class SnapshotValue final : public Value {
+public:
+    bool isExternal() const {
+        const auto tag = this->getTag();
+        return tag == Tag::kString || tag == Tag::kArray || tag == Tag::kObject;
+    }
+
+    // Inline values must not lead readers astray.
+    bool isValidInline() const {
+        switch (this->getTag()) {
+        case Tag::kShortString:
+            // Must be \0-terminated within the record.
+            return memchr(this->cast<char>(), '\0', sizeof(Value) - 1) != nullptr;
+        case Tag::kBool:
+            return *this->cast<uint8_t>() <= 1;
+        default:
+            return true;
+        }
+    }
+
+    size_t elementSize() const {
+        switch (this->getTag()) {
+        case Tag::kString: return sizeof(char);
+        case Tag::kArray:  return sizeof(Value);
+        case Tag::kObject: return sizeof(Member);
+        default:           SkUNREACHABLE;
+        }
+    }
+
+    // Long strings store a \0 terminator past their elements.
+    size_t trailingSize() const { return this->getTag() == Tag::kString ? 1 : 0; }
+
+    size_t count() const { return *this->ptr<size_t>(); }
+
+    const void* elements() const { return this->ptr<size_t>() + 1; }
+
+    size_t recordSize() const {
+        static_assert(kRecAlign == 8, "");
+        return SkAlign8(sizeof(size_t) + this->count() * this->elementSize()
+                                       + this->trailingSize());
+    }
+
+    uint64_t offset() const { return reinterpret_cast<uintptr_t>(this->ptr<void>()); }
+
+    void setOffset(uint64_t offset) {
+        SkASSERT(SkIsAlign8(offset));
+        this->init_tagged_pointer(this->getTag(), reinterpret_cast<void*>(SkTo<uintptr_t>(offset)));
+    }
+
+    void setRecord(void* rec) { this->init_tagged_pointer(this->getTag(), rec); }
+};
+
+void WriteBinary(const Value& root, SkWStream* stream) {
+    SkDynamicMemoryWStream payload;
+    uint64_t payload_size = 0;
+
+    // Records pending serialization, in payload order.
+    std::vector<const SnapshotValue*> pending;
+
+    // Returns a copy of |v|, with its record pointer (if any) replaced by the payload offset
+    // where the record will be written.
+    auto relocate = [&](const Value& v) -> Value {
+        const auto& sv = static_cast<const SnapshotValue&>(v);
+        if (!sv.isExternal()) {
+            return v;
+        }
+
+        SnapshotValue reloc = sv;
+        reloc.setOffset(payload_size);
+
+        pending.push_back(&sv);
+        payload_size += sv.recordSize();
+
+        return reloc;
+    };
+
+    SnapshotHeader header;
+    memcpy(header.fMagic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.fVersion     = kSnapshotVersion;
+    header.fPointerSize = sizeof(void*);
+    header.fReserved    = 0;
+    header.fRoot        = relocate(root);
+
+    for (size_t i = 0; i < pending.size(); ++i) {
+        const auto& rec = *pending[i];
+        const auto count = rec.count();
+        const auto start = payload.bytesWritten();
+
+        payload.write(&count, sizeof(count));
+
+        switch (rec.getType()) {
+        case Value::Type::kString:
+            payload.write(rec.elements(), count + 1);
+            break;
+        case Value::Type::kArray:
+            for (const auto& v : rec.as<ArrayValue>()) {
+                const auto reloc = relocate(v);
+                payload.write(&reloc, sizeof(reloc));
+            }
+            break;
+        case Value::Type::kObject:
+            for (const auto& m : rec.as<ObjectValue>()) {
+                const Value reloc[] = { relocate(m.fKey), relocate(m.fValue) };
+                payload.write(reloc, sizeof(reloc));
+            }
+            break;
+        default:
+            SkUNREACHABLE;
+        }
+
+        static constexpr char kPadding[kRecAlign] = {};
+        payload.write(kPadding, rec.recordSize() - (payload.bytesWritten() - start));
+    }
+    SkASSERT(payload.bytesWritten() == payload_size);
+
+    header.fPayloadSize = payload_size;
+    stream->write(&header, sizeof(header));
+    payload.writeToStream(stream);
+}
+
+Value ReadBinary(const char* data, size_t size, SkArenaAlloc& alloc) {
+    SnapshotHeader header;
+    if (size < sizeof(header)) {
+        return NullValue();
+    }
+    memcpy(&header, data, sizeof(header));
+
+    // Records are padded to kRecAlign, so a well-formed payload is too.
+    const auto payload_size = size - sizeof(header);
+    if (memcmp(header.fMagic, kSnapshotMagic, sizeof(kSnapshotMagic)) ||
+        header.fVersion != kSnapshotVersion || header.fPointerSize != sizeof(void*) ||
+        header.fPayloadSize != payload_size || !SkTFitsIn<uint32_t>(payload_size) ||
+        payload_size % kRecAlign) {
+        return NullValue();
+    }
+
+    auto* payload = static_cast<char*>(alloc.makeBytesAlignedTo(payload_size, kRecAlign));
+    sk_careful_memcpy(payload, data + sizeof(header), payload_size);
+
+    // Records pending relocation, in payload order.
+    std::vector<SnapshotValue*> pending;
+    auto resolve = [&](Value& v) {
+        auto& sv = static_cast<SnapshotValue&>(v);
+        if (sv.isExternal()) {
+            pending.push_back(&sv);
+            return true;
+        }
+        return sv.isValidInline();
+    };
+
+    Value root = header.fRoot;
+    if (!resolve(root)) {
+        return NullValue();
+    }
+
+    size_t cursor = 0;
+    for (size_t i = 0; i < pending.size(); ++i) {
+        auto& rec = *pending[i];
+
+        // Each record must start right where the previous one ended, and fit in the payload.
+        if (rec.offset() != cursor ||
+            payload_size - cursor < sizeof(size_t) + rec.trailingSize()) {
+            return NullValue();
+        }
+        const auto count = *reinterpret_cast<const size_t*>(payload + cursor);
+        if (count > (payload_size - cursor - sizeof(size_t) - rec.trailingSize())
+                        / rec.elementSize()) {
+            return NullValue();
+        }
+
+        rec.setRecord(payload + cursor);
+        const auto rec_size = rec.recordSize();
+        if (rec_size > payload_size - cursor) {
+            return NullValue();
+        }
+        cursor += rec_size;
+
+        switch (rec.getType()) {
+        case Value::Type::kString:
+            if (static_cast<const char*>(rec.elements())[count] != '\0') {
+                return NullValue();
+            }
+            break;
+        case Value::Type::kArray:
+            for (auto& v : rec.as<ArrayValue>()) {
+                if (!resolve(const_cast<Value&>(v))) {
+                    return NullValue();
+                }
+            }
+            break;
+        case Value::Type::kObject:
+            for (auto& m : rec.as<ObjectValue>()) {
+                if (!m.fKey.is<StringValue>() ||
+                    !resolve(const_cast<StringValue&>(m.fKey)) ||
+                    !resolve(const_cast<Value&>(m.fValue))) {
+                    return NullValue();
+                }
+            }
+            break;
+        default:
+            SkUNREACHABLE;
+        }
+    }
+
+    return cursor == payload_size ? root : NullValue();
+}
+
 } // namespace
 
 SkString Value::toString() const {
@@ -911,15 +1356,44 @@ SkString Value::toString() const {
 
 static constexpr size_t kMinChunkSize = 4096;
 
+DOM::DOM()
+    : fAlloc(kMinChunkSize) {}
+
 DOM::DOM(const char* data, size_t size)
     : fAlloc(kMinChunkSize) {
-    DOMParser parser(fAlloc);
+    DOMSink sink(fAlloc);
+    Parser<DOMSink> parser(sink);
+
+    fRoot = parser.parse(data, size) ? sink.root() : NullValue();
+}
+
+std::unique_ptr<DOM> DOM::MakeFromSnapshot(const char* data, size_t size) {
+    std::unique_ptr<DOM> dom(new DOM());
+    dom->fRoot = ReadBinary(data, size, dom->fAlloc);
+
+    return dom;
+}
 
-    fRoot = parser.parse(data, size);
+bool DOM::IsSnapshot(const char* data, size_t size) {
+    return size >= sizeof(kSnapshotMagic) &&
+           !memcmp(data, kSnapshotMagic, sizeof(kSnapshotMagic));
 }
 
 void DOM::write(SkWStream* stream) const {
     Write(fRoot, stream);
 }
 
+void DOM::writeBinary(SkWStream* stream) const {
+    WriteBinary(fRoot, stream);
+}
+
+bool Parse(const char* data, size_t size, Handler* handler) {
+    SkASSERT(handler);
+
+    HandlerSink sink(handler);
+    Parser<HandlerSink> parser(sink);
+
+    return parser.parse(data, size);
+}
+
 } // namespace skjson
@@ -14,6 +14,7 @@
 #include "src/core/SkArenaAlloc.h"
 
 #include <cstring>
+#include <memory>
 
 class SkString;
 class SkWStream;
@@ -334,17 +335,80 @@ public:
 
 class DOM final : public SkNoncopyable {
 public:
+    /**
+     *  Parses JSON text.
+     *
+     *  On failure, root() is a NullValue.
+     */
     DOM(const char*, size_t);
 
+    /**
+     *  Loads a binary snapshot produced by writeBinary().  The records are copied into the
+     *  DOM (their pointers are rebased in place), so the data does not need to outlive it.
+     *
+     *  On failure (including JSON text input), root() is a NullValue.
+     */
+    static std::unique_ptr<DOM> MakeFromSnapshot(const char*, size_t);
+
+    /**
+     *  Returns true if the data starts like a binary snapshot (it may still fail to load).
+     */
+    static bool IsSnapshot(const char*, size_t);
+
     const Value& root() const { return fRoot; }
 
     void write(SkWStream*) const;
 
+    /**
+     *  Writes a binary snapshot of the DOM: a relocatable image of the parsed records, which
+     *  loads with a single copy and a pointer fix-up pass (no lexing or number parsing).
+     *  It replaces parsing only: users still walk the loaded DOM like a parsed one.
+     *
+     *  Snapshots are only portable between builds with the same pointer size.
+     */
+    void writeBinary(SkWStream*) const;
+
 private:
+    DOM();
+
     SkArenaAlloc fAlloc;
     Value        fRoot;
 };
 
+/**
+ *  Streaming alternative to DOM: reports values to a Handler as they are lexed, in document
+ *  order, without building a tree. Memory use is bounded by the nesting depth and the longest
+ *  escaped string, rather than by the size of the document.
+ *
+ *  String and key pointers are only valid for the duration of the callback, and are not
+ *  \0-terminated. Each callback returns false to stop parsing.
+ */
+class Handler {
+public:
+    virtual ~Handler() = default;
+
+    virtual bool onNull()                      { return true; }
+    virtual bool onBool(bool)                  { return true; }
+    virtual bool onInt(int32_t)                { return true; }
+    virtual bool onFloat(float)                { return true; }
+    virtual bool onString(const char*, size_t) { return true; }
+
+    virtual bool onBeginObject()               { return true; }
+    virtual bool onKey(const char*, size_t)    { return true; }
+    virtual bool onEndObject()                 { return true; }
+
+    virtual bool onBeginArray()                { return true; }
+    virtual bool onEndArray()                  { return true; }
+};
+
+/**
+ *  Parses JSON text, accepting the same inputs as DOM.
+ *
+ *  Returns true if the whole input was parsed. On failure (malformed input, or a Handler
+ *  callback returning false) some events may already have been delivered.
+ */
+bool Parse(const char*, size_t, Handler*);
+
 inline Value::Type Value::getType() const {
     switch (this->getTag()) {
     case Tag::kNull:        return Type::kNull;
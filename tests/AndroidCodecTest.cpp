@@ -12,6 +12,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
@@ -20,9 +21,11 @@
 #include "include/core/SkTypes.h"
 #include "include/third_party/skcms/skcms.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/codec/SkScanlineResizer.h"
 #include "src/core/SkPixmapPriv.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
+#include "tools/ToolUtils.h"
 
 #include <string.h>
 #include <initializer_list>
@@ -299,3 +302,103 @@ DEF_TEST(AndroidCodec_sampledOrientation, r) {
         ERRORF(r, "got result \"%s\"\n", SkCodec::ResultToString(result));
     }
 }
+
+// Resized decodes stream rows into an SkScanlineResizer as the codec produces them. Whatever
+// order the codec produces them in, the result should match resizing the fully decoded image.
+DEF_TEST(AndroidCodec_resize, r) {
+    using Filter = SkAndroidCodec::ResizeFilter;
+    for (const char* name : { "images/mandrill_512.png",        // incremental, row sink
+                              "images/plane_interlaced.png",    // full decode
+                              "images/mandrill_512_q075.jpg",   // native scale, then scanlines
+                              "images/randPixels.bmp",          // bottom-up scanlines
+                              "images/mandrill.wbmp",
+                              "images/color_wheel.gif" }) {
+        sk_sp<SkData> data = GetResourceAsData(name);
+        if (!data) {
+            continue;
+        }
+        auto codec = SkAndroidCodec::MakeFromCodec(SkCodec::MakeFromData(data));
+        if (!codec) {
+            ERRORF(r, "Failed to create codec for %s", name);
+            continue;
+        }
+        const SkISize size = codec->getInfo().dimensions();
+
+        for (Filter filter : { Filter::kMitchell, Filter::kLanczos3 }) {
+            for (SkISize dstSize : { times(size, 1/3.0f), SkISize{ 1, 1 }, plus(size, 3) }) {
+                if (invalid(dstSize)) {
+                    continue;
+                }
+                SkImageInfo info = codec->getInfo().makeDimensions(dstSize)
+                                                   .makeColorType(kN32_SkColorType);
+                if (info.alphaType() == kUnpremul_SkAlphaType) {
+                    info = info.makeAlphaType(kPremul_SkAlphaType);
+                }
+                SkBitmap actual;
+                actual.allocPixels(info);
+                SkAndroidCodec::AndroidOptions options;
+                options.fResizeFilter = filter;
+                auto result = codec->getAndroidPixels(info, actual.getPixels(), actual.rowBytes(),
+                                                      &options);
+                if (result != SkCodec::kSuccess) {
+                    ERRORF(r, "Failed to resize %s: %s", name, SkCodec::ResultToString(result));
+                    continue;
+                }
+
+                // Decode the way resizedDecode() would, first at the size libjpeg-turbo can
+                // scale to natively, then resize all of it at once.
+                SkISize nativeSize = size;
+                if (codec->getEncodedFormat() == SkEncodedImageFormat::kJPEG) {
+                    for (int sampleSize : { 8, 4, 2 }) {
+                        SkISize s = codec->codec()->getScaledDimensions(1.0f / sampleSize);
+                        if (s.width() >= dstSize.width() && s.height() >= dstSize.height()) {
+                            nativeSize = s;
+                            break;
+                        }
+                    }
+                }
+                SkBitmap full;
+                full.allocPixels(info.makeDimensions(nativeSize));
+                result = codec->codec()->getPixels(full.pixmap());
+                REPORTER_ASSERT(r, result == SkCodec::kSuccess, "%s", name);
+
+                SkBitmap expected;
+                expected.allocPixels(info);
+                SkScanlineResizer resizer(full.info(), expected.pixmap(), filter, false);
+                for (int y = 0; y < full.height(); y++) {
+                    resizer.addRow(full.getAddr(0, y));
+                }
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual), "%s %dx%d",
+                                name, dstSize.width(), dstSize.height());
+            }
+        }
+    }
+}
+
+DEF_TEST(AndroidCodec_resizeSolid, r) {
+    // Both filters sum to one and clamp their ringing, so a solid image stays solid.
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeN32Premul(97, 61));
+    bm.eraseColor(SkColorSetARGB(0xC0, 0x40, 0x80, 0xFF));
+    sk_sp<SkData> png = SkEncodeBitmap(bm, SkEncodedImageFormat::kPNG, 100);
+    REPORTER_ASSERT(r, png);
+
+    auto codec = SkAndroidCodec::MakeFromData(png);
+    for (auto filter : { SkAndroidCodec::ResizeFilter::kMitchell,
+                         SkAndroidCodec::ResizeFilter::kLanczos3 }) {
+        for (SkISize dstSize : { SkISize{ 10, 7 }, SkISize{ 96, 20 }, SkISize{ 200, 130 } }) {
+            SkBitmap dst;
+            dst.allocPixels(bm.info().makeDimensions(dstSize));
+            SkAndroidCodec::AndroidOptions options;
+            options.fResizeFilter = filter;
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(
+                    dst.info(), dst.getPixels(), dst.rowBytes(), &options));
+            for (int y = 0; y < dst.height(); y++) {
+                for (int x = 0; x < dst.width(); x++) {
+                    REPORTER_ASSERT(r, *dst.getAddr32(x, y) == *bm.getAddr32(0, 0),
+                                    "%08x at (%d, %d)", *dst.getAddr32(x, y), x, y);
+                }
+            }
+        }
+    }
+}
@@ -12,6 +12,7 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkDrawLooper.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkMath.h"
@@ -32,9 +33,11 @@
 #include "include/effects/SkPerlinNoiseShader.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/private/SkFloatBits.h"
+#include "include/utils/SkRandom.h"
 #include "src/core/SkBlurMask.h"
 #include "src/core/SkBlurPriv.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkMaskBlurFilter.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMathPriv.h"
 #include "src/effects/SkEmbossMaskFilter.h"
@@ -743,3 +746,58 @@ DEF_TEST(zero_blur, reporter) {
     bitmap.extractAlpha(&alpha, &paint, nullptr, &offset);
 }
 
+
+// Blurring several rows at once in SIMD lanes, and in bands on a thread pool, must produce
+// exactly what blurring one row at a time does.
+DEF_TEST(BlurMaskFilter_LanesMatchScalar, reporter) {
+    const SkMask::Format formats[] = {
+        SkMask::kBW_Format, SkMask::kA8_Format, SkMask::kARGB32_Format, SkMask::kLCD16_Format,
+    };
+    const SkISize sizes[] = {{5, 3}, {37, 29}, {300, 517}, {1024, 1024}};
+    const double sigmas[] = {2.5, 11, 27.3, 80};
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkRandom rand;
+    for (SkMask::Format format : formats) {
+        for (SkISize size : sizes) {
+            SkMask src;
+            src.fBounds = SkIRect::MakeSize(size);
+            src.fFormat = format;
+            switch (format) {
+                case SkMask::kBW_Format:      src.fRowBytes = (size.width() + 7) / 8; break;
+                case SkMask::kA8_Format:      src.fRowBytes = size.width();           break;
+                case SkMask::kARGB32_Format:  src.fRowBytes = size.width() * 4;       break;
+                default:                      src.fRowBytes = size.width() * 2;       break;
+            }
+            src.fRowBytes += 8;  // Pad the rows a bit.
+            src.fImage = SkMask::AllocImage(src.computeImageSize());
+            SkAutoMaskFreeImage srcImage(src.fImage);
+            for (size_t i = 0; i < src.computeImageSize(); i++) {
+                src.fImage[i] = rand.nextU();
+            }
+
+            for (double sigma : sigmas) {
+                SkMaskBlurFilter filter(sigma, sigma);
+                SkMask expected, lanes, threaded;
+
+                filter.setUseLanesForTesting(false);
+                filter.blur(src, &expected);
+                filter.setUseLanesForTesting(true);
+                filter.blur(src, &lanes);
+                filter.blur(src, &threaded, executor.get());
+
+                SkAutoMaskFreeImage expectedImage(expected.fImage),
+                                    lanesImage(lanes.fImage),
+                                    threadedImage(threaded.fImage);
+                size_t bytes = expected.computeImageSize();
+                REPORTER_ASSERT(reporter, bytes == lanes.computeImageSize());
+                REPORTER_ASSERT(reporter, bytes == threaded.computeImageSize());
+                if (memcmp(expected.fImage, lanes.fImage, bytes) ||
+                    memcmp(expected.fImage, threaded.fImage, bytes)) {
+                    ERRORF(reporter, "format %d, %dx%d, sigma %g: blurs differ",
+                           format, size.width(), size.height(), sigma);
+                }
+            }
+        }
+    }
+}
@@ -19,6 +19,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageGenerator.h"
@@ -52,6 +53,7 @@
 #include "png.h"
 
 #include <setjmp.h>
+#include <atomic>
 #include <cstring>
 #include <initializer_list>
 #include <memory>
@@ -1836,3 +1838,133 @@ DEF_TEST(Codec_noConversion, r) {
         REPORTER_ASSERT(r, bm.getColor(0, 0) == rec.color);
     }
 }
+
+// Decoding with Options::fExecutor must produce exactly the same pixels and results as without.
+static void check_executor_decodes(skiatest::Reporter* r,
+                                   std::initializer_list<const char*> names) {
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    auto decode = [](sk_sp<SkData> data, const SkImageInfo& info, SkExecutor* exec,
+                     SkBitmap* bm) {
+        auto codec = SkCodec::MakeFromData(std::move(data));
+        if (!codec) {
+            // The header may not fit in a truncated image.
+            return SkCodec::kInvalidInput;
+        }
+        bm->allocPixels(info);
+        SkCodec::Options options;
+        options.fExecutor = exec;
+        return codec->getPixels(info, bm->getPixels(), bm->rowBytes(), &options);
+    };
+
+    for (const char* name : names) {
+        sk_sp<SkData> data = GetResourceAsData(name);
+        if (!data) {
+            continue;
+        }
+        const SkImageInfo baseInfo = SkCodec::MakeFromData(data)->getInfo();
+        for (SkColorType ct : { kN32_SkColorType, kRGBA_F16_SkColorType, kRGB_565_SkColorType }) {
+            SkImageInfo info = baseInfo.makeColorType(ct);
+            if (ct == kRGB_565_SkColorType) {
+                info = info.makeAlphaType(kOpaque_SkAlphaType);
+            } else if (ct == kRGBA_F16_SkColorType) {
+                info = info.makeColorSpace(SkColorSpace::MakeSRGBLinear());
+            }
+
+            for (size_t size : { data->size(), data->size() * 2 / 3 }) {
+                sk_sp<SkData> subset = SkData::MakeSubset(data.get(), 0, size);
+                // A truncated image is still filled in below the last row we could decode.
+                SkBitmap expected, actual;
+                auto expectedResult = decode(subset, info, nullptr, &expected);
+                auto actualResult = decode(subset, info, executor.get(), &actual);
+                REPORTER_ASSERT(r, expectedResult == actualResult, "%s", name);
+                if (expectedResult != SkCodec::kSuccess &&
+                    expectedResult != SkCodec::kIncompleteInput) {
+                    continue;
+                }
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual), "%s ct %d size %zu",
+                                name, ct, size);
+            }
+        }
+    }
+}
+
+DEF_TEST(Codec_pngExecutor, r) {
+    check_executor_decodes(r, { "images/mandrill_512.png", "images/yellow_rose.png",
+                                "images/color_wheel_with_profile.png", "images/index8.png",
+                                "images/grayscale.png", "images/plane_interlaced.png" });
+}
+
+// Counts the tasks handed to an executor.  SkJpegCodec only uses the executor to decode restart
+// intervals in bands, so this tells us which images took that path.
+class CountingExecutor final : public SkExecutor {
+public:
+    explicit CountingExecutor(SkExecutor* executor) : fExecutor(executor) {}
+
+    void add(std::function<void(void)> work) override {
+        fTasks++;
+        fExecutor->add(std::move(work));
+    }
+    void borrow() override { fExecutor->borrow(); }
+
+    int tasks() const { return fTasks.load(); }
+
+private:
+    SkExecutor*      fExecutor;
+    std::atomic<int> fTasks{0};
+};
+
+DEF_TEST(Codec_jpegExecutor, r) {
+    // icc-v2-gbr.jpg has a restart marker every MCU row, 4:2:0 chroma and an ICC profile.
+    // mandrill_h2v1_restart20.jpg has one every 20 MCUs, which is not a whole number of MCU rows.
+    // mandrill_cmyk.jpg is CMYK with an ICC profile, so the color xform handles the conversion.
+    // The others have restart markers we do not use (too short to split), or none.
+    const struct {
+        const char* name;
+        bool        decodesRestartIntervals;
+    } recs[] = {
+        { "images/icc-v2-gbr.jpg",                    true  },
+        { "images/mandrill_h2v1_restart20.jpg",       true  },
+        { "images/mandrill_cmyk.jpg",                 true  },
+        { "images/cmyk_yellow_224_224_32.jpg",        false },
+        { "images/wide_gamut_yellow_224_224_64.jpeg", false },
+        { "images/mandrill_512_q075.jpg",             false },
+        { "images/mandrill_h1v1.jpg",                 false },
+        { "images/grayscale.jpg",                     false },
+    };
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const auto& rec : recs) {
+        check_executor_decodes(r, { rec.name });
+
+        // Make sure the images we expect to split at restart markers actually were.
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(GetResourceAsData(rec.name));
+        if (!codec) {
+            continue;
+        }
+        SkBitmap bm;
+        bm.allocPixels(codec->getInfo());
+        CountingExecutor counter(executor.get());
+        SkCodec::Options options;
+        options.fExecutor = &counter;
+        REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                           codec->getPixels(bm.info(), bm.getPixels(), bm.rowBytes(), &options));
+        REPORTER_ASSERT(r, (counter.tasks() > 0) == rec.decodesRestartIntervals, "%s", rec.name);
+    }
+
+    // Adding restart markers does not change the pixels, with or without an executor.
+    std::unique_ptr<SkCodec> plain = SkCodec::MakeFromData(
+                                         GetResourceAsData("images/mandrill_h2v1.jpg")),
+                             restart = SkCodec::MakeFromData(
+                                         GetResourceAsData("images/mandrill_h2v1_restart20.jpg"));
+    if (plain && restart) {
+        SkBitmap expected, actual;
+        expected.allocPixels(plain->getInfo());
+        actual.allocPixels(restart->getInfo());
+        SkCodec::Options options;
+        options.fExecutor = executor.get();
+        REPORTER_ASSERT(r, SkCodec::kSuccess == plain->getPixels(expected.pixmap()));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == restart->getPixels(actual.pixmap(), &options));
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual));
+    }
+}
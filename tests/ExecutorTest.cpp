@@ -0,0 +1,38 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "src/core/SkTaskGroup.h"
+#include "tests/Test.h"
+
+#include <atomic>
+
+DEF_TEST(Executor_WorkStealing, r) {
+    for (int threads : {1, 2, 4}) {
+        std::unique_ptr<SkExecutor> executor = SkExecutor::MakeWorkStealingThreadPool(threads);
+
+        // Nested batches add work from the pool's own threads, then wait by borrowing.
+        std::atomic<int> count{0};
+        SkTaskGroup outer(*executor);
+        outer.batch(16, [&](int) {
+            SkTaskGroup inner(*executor);
+            inner.batch(16, [&](int) { count++; });
+        });
+        outer.wait();
+        REPORTER_ASSERT(r, count == 16 * 16);
+    }
+
+    // Work still queued when the pool is destroyed is run before its threads shut down.
+    std::atomic<int> count{0};
+    {
+        std::unique_ptr<SkExecutor> executor = SkExecutor::MakeWorkStealingThreadPool(2);
+        for (int i = 0; i < 100; i++) {
+            executor->add([&] { count++; });
+        }
+    }
+    REPORTER_ASSERT(r, count == 100);
+}
@@ -12,10 +12,14 @@
 #include "include/core/SkImage.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/effects/SkImageFilters.h"
 #include "src/core/SkImageFilterCache.h"
 #include "src/core/SkSpecialImage.h"
 
+#include <map>
+#include <string>
+
 SK_USE_FLUENT_IMAGE_FILTER_TYPES
 
 static const int kSmallerSize = 10;
@@ -117,6 +121,94 @@ static void test_internal_purge(skiatest::Reporter* reporter, const sk_sp<SkSpec
     REPORTER_ASSERT(reporter, !cache->get(key1, &foundImage));
 }
 
+// Test that purging prefers results that are cheap to recompute over older, expensive ones
+static void test_cost_aware_purge(skiatest::Reporter* reporter,
+                                  const sk_sp<SkSpecialImage>& image) {
+    SkASSERT(image->getSize());
+    const size_t kCacheSize = 2 * image->getSize() + 10;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+
+    SkIRect clip = SkIRect::MakeWH(100, 100);
+    SkImageFilterCacheKey key1(0, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    SkImageFilterCacheKey key2(1, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    SkImageFilterCacheKey key3(2, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+
+    SkIPoint offset = SkIPoint::Make(3, 4);
+    skif::FilterResult<For::kOutput> result(image, skif::LayerSpace<SkIPoint>(offset));
+    auto filter = make_filter();
+    cache->set(key1, filter.get(), result, /*computeMs=*/100);
+    cache->set(key2, filter.get(), result, /*computeMs=*/0.01);
+
+    // key2 is the most recently used, but much cheaper to recompute than key1
+    cache->set(key3, filter.get(), result, /*computeMs=*/1);
+
+    skif::FilterResult<For::kOutput> foundImage;
+    REPORTER_ASSERT(reporter, cache->get(key1, &foundImage));
+    REPORTER_ASSERT(reporter, !cache->get(key2, &foundImage));
+    REPORTER_ASSERT(reporter, cache->get(key3, &foundImage));
+
+    // Entries age as others are evicted, so a stream of results costing as much as key3 will
+    // eventually push out key1 once it's no longer used.
+    for (uint32_t id = 10; id < 1000; ++id) {
+        SkImageFilterCacheKey key(id, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+        cache->set(key, filter.get(), result, /*computeMs=*/1);
+    }
+    REPORTER_ASSERT(reporter, !cache->get(key1, &foundImage));
+}
+
+// Records every numeric value dumped, by dump and value name
+class StatsTraceMemoryDump : public SkTraceMemoryDump {
+public:
+    void dumpNumericValue(const char* dumpName, const char* valueName, const char* units,
+                          uint64_t value) override {
+        fValues[std::string(dumpName) + "." + valueName] = value;
+    }
+    void setMemoryBacking(const char* dumpName, const char* backingType,
+                          const char* backingObjectId) override { }
+    void setDiscardableMemoryBacking(
+        const char* dumpName,
+        const SkDiscardableMemory& discardableMemoryObject) override { }
+    LevelOfDetail getRequestedDetails() const override {
+        return SkTraceMemoryDump::kObjectsBreakdowns_LevelOfDetail;
+    }
+
+    std::map<std::string, uint64_t> fValues;
+};
+
+// Test the per filter type hit and miss statistics
+static void test_statistics(skiatest::Reporter* reporter, const sk_sp<SkSpecialImage>& image) {
+    static const size_t kCacheSize = 1000000;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+
+    SkIRect clip = SkIRect::MakeWH(100, 100);
+    SkImageFilterCacheKey key1(0, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    SkImageFilterCacheKey key2(1, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+
+    SkIPoint offset = SkIPoint::Make(3, 4);
+    skif::FilterResult<For::kOutput> result(image, skif::LayerSpace<SkIPoint>(offset));
+    auto filter = make_filter();
+    cache->set(key1, filter.get(), result, /*computeMs=*/2);
+    cache->set(key2, filter.get(), result, /*computeMs=*/3);
+
+    skif::FilterResult<For::kOutput> foundImage;
+    for (int i = 0; i < 3; ++i) {
+        REPORTER_ASSERT(reporter, cache->get(key2, &foundImage));
+    }
+
+    StatsTraceMemoryDump dump;
+    cache->dumpMemoryStatistics(&dump);
+    std::string name = std::string("skia/sk_image_filter_cache/") + filter->getTypeName();
+    REPORTER_ASSERT(reporter, dump.fValues["skia/sk_image_filter_cache.size"] ==
+                              2 * image->getSize());
+    REPORTER_ASSERT(reporter, dump.fValues["skia/sk_image_filter_cache.budget_size"] ==
+                              kCacheSize);
+    REPORTER_ASSERT(reporter, dump.fValues["skia/sk_image_filter_cache.entry_count"] == 2);
+    REPORTER_ASSERT(reporter, dump.fValues[name + ".hits"] == 3);
+    REPORTER_ASSERT(reporter, dump.fValues[name + ".misses"] == 2);
+    REPORTER_ASSERT(reporter, dump.fValues[name + ".compute_time"] == 5000);
+    REPORTER_ASSERT(reporter, dump.fValues[name + ".saved_time"] == 9000);
+}
+
 // Exercise the purgeByKey and purge methods
 static void test_explicit_purging(skiatest::Reporter* reporter,
                                   const sk_sp<SkSpecialImage>& image,
@@ -168,7 +260,9 @@ DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     test_find_existing(reporter, fullImg, subsetImg);
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
+    test_cost_aware_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_statistics(reporter, fullImg);
 }
 
 
@@ -187,7 +281,9 @@ static void test_image_backed(skiatest::Reporter* reporter,
     test_find_existing(reporter, fullImg, subsetImg);
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
+    test_cost_aware_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_statistics(reporter, fullImg);
 }
 
 DEF_TEST(ImageFilterCache_ImageBackedRaster, reporter) {
@@ -281,5 +377,7 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ImageFilterCache_GPUBacked, reporter, ctxInfo
     test_find_existing(reporter, fullImg, subsetImg);
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
+    test_cost_aware_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_statistics(reporter, fullImg);
 }
@@ -7,6 +7,7 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
@@ -1733,6 +1734,83 @@ DEF_TEST(ImageFilterMakeWithFilter, reporter) {
     test_make_with_filter(reporter, nullptr);
 }
 
+DEF_TEST(ImageFilterMakeWithFilter_Executor, reporter) {
+    // Big enough that the clip below is split into several tiles, some of them partial.
+    sk_sp<SkSurface> surface(SkSurface::MakeRaster(SkImageInfo::MakeN32Premul(600, 560)));
+    SkCanvas* canvas = surface->getCanvas();
+    SkPoint pts[] = {{0, 0}, {600, 560}};
+    SkColor colors[] = {SK_ColorRED, SK_ColorTRANSPARENT, SK_ColorBLUE};
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 3, SkTileMode::kClamp));
+    canvas->drawPaint(paint);
+    paint.setShader(nullptr);
+    paint.setColor(SK_ColorGREEN);
+    for (int i = 0; i < 12; ++i) {
+        canvas->drawCircle(50.0f * i + 20, 45.0f * i + 15, 30, paint);
+    }
+    sk_sp<SkImage> image = surface->makeImageSnapshot();
+
+    sk_sp<SkImageFilter> blur = SkImageFilters::Blur(4, 4, nullptr);
+    sk_sp<SkImageFilter> offset = SkImageFilters::Offset(7, -5, blur);
+    sk_sp<SkImageFilter> gray = make_grayscale(nullptr, nullptr);
+    sk_sp<SkImageFilter> filters[] = {
+        SkImageFilters::Merge(offset, SkImageFilters::Dilate(3, 2, gray)),
+        SkImageFilters::Arithmetic(0.25f, 0.5f, 0.5f, 0, true, offset, gray),
+        SkImageFilters::Xfermode(SkBlendMode::kMultiply, blur,
+                                 SkImageFilters::Compose(offset, gray)),
+        SkImageFilters::DisplacementMap(SkColorChannel::kR, SkColorChannel::kG, 12, gray, blur),
+        // These depend on the edges of their bounds, so they must not be tiled.
+        SkImageFilters::DistantLitDiffuse(SkPoint3::Make(1, -1, 1), SK_ColorWHITE, 2, 1, blur),
+        SkImageFilters::PointLitSpecular(SkPoint3::Make(300, 280, 50), SK_ColorCYAN, 1, 1, 8,
+                                         offset),
+        SkImageFilters::Magnifier(SkRect::MakeXYWH(150, 140, 300, 280), 40, nullptr),
+        SkImageFilters::Merge(offset, SkImageFilters::Magnifier(
+                SkRect::MakeXYWH(200, 200, 100, 100), 10, gray)),
+    };
+    SkIRect clips[] = {
+        SkIRect::MakeXYWH(-20, 37, 600, 520),
+        SkIRect::MakeXYWH(100, 100, 300, 300),
+        // Leaves a 1px remainder tile in both directions.
+        SkIRect::MakeXYWH(10, 20, 513, 513),
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const sk_sp<SkImageFilter>& filter : filters) {
+        for (const SkIRect& clip : clips) {
+            SkIRect expectedSubset, actualSubset;
+            SkIPoint expectedOffset, actualOffset;
+            sk_sp<SkImage> expected = image->makeWithFilter(nullptr, filter.get(), image->bounds(),
+                                                            clip, &expectedSubset,
+                                                            &expectedOffset),
+                           actual   = image->makeWithFilter(nullptr, filter.get(), image->bounds(),
+                                                            clip, &actualSubset, &actualOffset,
+                                                            executor.get());
+            REPORTER_ASSERT(reporter, expected && actual);
+            if (!expected || !actual) {
+                continue;
+            }
+            REPORTER_ASSERT(reporter, expectedSubset == actualSubset,
+                            "subset %d,%d %dx%d != %d,%d %dx%d",
+                            expectedSubset.x(), expectedSubset.y(),
+                            expectedSubset.width(), expectedSubset.height(),
+                            actualSubset.x(), actualSubset.y(),
+                            actualSubset.width(), actualSubset.height());
+            REPORTER_ASSERT(reporter, expectedOffset == actualOffset,
+                            "offset %d,%d != %d,%d", expectedOffset.x(), expectedOffset.y(),
+                            actualOffset.x(), actualOffset.y());
+            if (expectedSubset != actualSubset || expectedOffset != actualOffset) {
+                continue;
+            }
+            sk_sp<SkImage> expectedPixels = expected->makeSubset(expectedSubset),
+                           actualPixels   = actual->makeSubset(actualSubset);
+            if (!ToolUtils::equal_pixels(expectedPixels.get(), actualPixels.get())) {
+                ERRORF(reporter, "filtering on an executor changed the result, clip %d,%d %dx%d",
+                       clip.x(), clip.y(), clip.width(), clip.height());
+            }
+        }
+    }
+}
+
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ImageFilterMakeWithFilter_Gpu, reporter, ctxInfo) {
     test_make_with_filter(reporter, ctxInfo.directContext());
 }
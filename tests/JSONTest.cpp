@@ -12,6 +12,9 @@
 #include "src/core/SkArenaAlloc.h"
 #include "src/utils/SkJSON.h"
 
+#include <cstring>
+#include <vector>
+
 using namespace skjson;
 
 DEF_TEST(JSON_Parse, reporter) {
@@ -454,3 +457,215 @@ DEF_TEST(JSON_ParseNumber, reporter) {
         REPORTER_ASSERT(reporter, SkScalarNearlyEqual(**jnumber, test.value, test.tolerance));
     }
 }
+
+DEF_TEST(JSON_Binary, reporter) {
+    static constexpr char json[] = R"({
+        "k1": null,
+        "k2": [ true, false, 0, -1, 42.75, "", "short", "a longer string", [], {} ],
+        "a somewhat longer key": {
+            "k3": [ [ [ "deep" ] ], { "k4": { "k5": "deeper still" } } ],
+            "k6": "é\t"
+        },
+        "k7": [ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17 ]
+    })";
+
+    const DOM dom(json, strlen(json));
+    REPORTER_ASSERT(reporter, dom.root().is<ObjectValue>());
+
+    SkDynamicMemoryWStream wstream;
+    dom.writeBinary(&wstream);
+    const auto snapshot = wstream.detachAsData();
+    const auto* data = static_cast<const char*>(snapshot->data());
+
+    // Snapshots round-trip.
+    REPORTER_ASSERT(reporter, DOM::IsSnapshot(data, snapshot->size()));
+    const auto binary_dom = DOM::MakeFromSnapshot(data, snapshot->size());
+    REPORTER_ASSERT(reporter, binary_dom->root().is<ObjectValue>());
+    REPORTER_ASSERT(reporter, binary_dom->root().toString() == dom.root().toString());
+
+    // Snapshots are not JSON, and JSON is not a snapshot.
+    REPORTER_ASSERT(reporter, DOM(data, snapshot->size()).root().is<NullValue>());
+    REPORTER_ASSERT(reporter, !DOM::IsSnapshot(json, strlen(json)));
+    REPORTER_ASSERT(reporter, DOM::MakeFromSnapshot(json, strlen(json))->root().is<NullValue>());
+
+    const auto& root = binary_dom->root().as<ObjectValue>();
+    const StringValue* deep = root["a somewhat longer key"].as<ObjectValue>()["k3"]
+                                  .as<ArrayValue>()[1].as<ObjectValue>()["k4"]
+                                  .as<ObjectValue>()["k5"];
+    REPORTER_ASSERT(reporter, deep && !strcmp(deep->begin(), "deeper still"));
+
+    // Truncated snapshots are rejected.
+    for (size_t i = 0; i < snapshot->size(); ++i) {
+        REPORTER_ASSERT(reporter, DOM::MakeFromSnapshot(data, i)->root().is<NullValue>());
+    }
+
+    // ... including when the header's payload size is patched to match, so the last record
+    // (or its padding) runs past the end of the payload.
+    static constexpr size_t kPayloadSizeOffset = 16,
+                            kHeaderSize        = kPayloadSizeOffset + 2 * sizeof(uint64_t);
+    for (size_t i = kHeaderSize; i < snapshot->size(); ++i) {
+        std::vector<char> truncated(data, data + i);
+        const uint64_t payload_size = i - kHeaderSize;
+        memcpy(truncated.data() + kPayloadSizeOffset, &payload_size, sizeof(payload_size));
+        REPORTER_ASSERT(reporter, DOM::MakeFromSnapshot(truncated.data(), truncated.size())
+                                      ->root().is<NullValue>(), "%zu", i);
+    }
+
+    // Corrupt snapshots are either rejected, or yield a well-formed DOM.
+    std::vector<char> corrupt(data, data + snapshot->size());
+    for (size_t i = 0; i < corrupt.size(); ++i) {
+        for (char c : { '\x00', '\x01', '\x07', '\x08', '\xff' }) {
+            const auto saved = corrupt[i];
+            corrupt[i] = c;
+            DOM::MakeFromSnapshot(corrupt.data(), corrupt.size())->root().toString();
+            corrupt[i] = saved;
+        }
+    }
+
+    // Empty containers still get a (count-only) record.
+    const DOM array_dom("[]", 2);
+    SkDynamicMemoryWStream array_stream;
+    array_dom.writeBinary(&array_stream);
+    const auto array_snapshot = array_stream.detachAsData();
+    const auto binary_array_dom =
+            DOM::MakeFromSnapshot(static_cast<const char*>(array_snapshot->data()),
+                                  array_snapshot->size());
+    REPORTER_ASSERT(reporter, binary_array_dom->root().is<ArrayValue>());
+    REPORTER_ASSERT(reporter, binary_array_dom->root().as<ArrayValue>().size() == 0);
+}
+
+namespace {
+
+// Rebuilds the compact JSON text DOM::write() would produce, from parse events.
+class TextHandler final : public Handler {
+public:
+    const SkString& text() const { return fText; }
+
+    bool onNull()                             override { return this->value("null"); }
+    bool onBool(bool b)                       override { return this->value(b ? "true"
+                                                                              : "false"); }
+    bool onInt(int32_t i)                     override { return this->number(i); }
+    bool onFloat(float f)                     override { return this->number(f); }
+    bool onString(const char* s, size_t size) override { return this->string(s, size); }
+
+    bool onBeginObject() override { return this->value("{"); }
+    bool onKey(const char* key, size_t size) override {
+        return this->string(key, size) && this->append(":");
+    }
+    bool onEndObject()   override { return this->append("}"); }
+
+    bool onBeginArray()  override { return this->value("["); }
+    bool onEndArray()    override { return this->append("]"); }
+
+private:
+    bool append(const char* s) {
+        fText.append(s);
+        return true;
+    }
+
+    bool value(const char* s) {
+        if (!fText.isEmpty() && !strchr("[{:", fText[fText.size() - 1])) {
+            fText.append(",");
+        }
+        return this->append(s);
+    }
+
+    bool number(SkScalar n) {
+        SkString str;
+        str.appendScalar(n);
+        return this->value(str.c_str());
+    }
+
+    bool string(const char* s, size_t size) {
+        this->value("\"");
+        fText.append(s, size);
+        return this->append("\"");
+    }
+
+    SkString fText;
+};
+
+// Stops after a given number of events.
+class StoppingHandler final : public Handler {
+public:
+    explicit StoppingHandler(int budget) : fBudget(budget) {}
+
+    int events() const { return fEvents; }
+
+    bool onInt(int32_t)   override { return this->event(); }
+    bool onBeginObject()  override { return this->event(); }
+    bool onKey(const char*, size_t) override { return this->event(); }
+    bool onEndObject()    override { return this->event(); }
+    bool onBeginArray()   override { return this->event(); }
+    bool onEndArray()     override { return this->event(); }
+
+private:
+    bool event() {
+        return ++fEvents < fBudget;
+    }
+
+    const int fBudget;
+    int       fEvents = 0;
+};
+
+void check_stream(skiatest::Reporter* reporter, const char* json, size_t size) {
+    const DOM dom(json, size);
+    TextHandler handler;
+    const auto success = Parse(json, size, &handler);
+
+    REPORTER_ASSERT(reporter, success == !dom.root().is<NullValue>(), "%s", json);
+    if (success) {
+        REPORTER_ASSERT(reporter, handler.text() == dom.root().toString(),
+                        "%s\n%s", handler.text().c_str(), dom.root().toString().c_str());
+    }
+}
+
+} // namespace
+
+DEF_TEST(JSON_Stream, reporter) {
+    static constexpr const char* g_docs[] = {
+        "", "[", "{}}", "[1,,2]", "[ \"foo", "{ \"k\" : null \"k\" : 1 }", R"zzz(["\u00"])zzz",
+        "[]", "{}", " \n\r\t [ \n\r\t ] \n\r\t ", "[ null , true, false,0,12.8, -3, 1e2 ]",
+        R"({ "k1" : null, "k2" : [ true, { "kk1" : "foo{bar}baz", "kk2" : [ 42, [] ] } ] })",
+        R"(["foo\"bar", "\\", "ሴ", "x\ty"])",
+    };
+
+    for (const auto* json : g_docs) {
+        check_stream(reporter, json, strlen(json));
+    }
+
+    // Strings and whitespace runs of all lengths around the block scan size, with escapes,
+    // and scope terminators at all offsets.
+    for (int len = 0; len < 40; ++len) {
+        for (int escape = -1; escape < len; ++escape) {
+            SkString str;
+            for (int i = 0; i < len; ++i) {
+                str.append(i == escape ? "\\n" : i % 7 == 3 ? "}" : "a");
+            }
+            SkString ws;
+            for (int i = 0; i < len; ++i) {
+                ws.append(i % 5 == 4 ? "\n" : " ");
+            }
+
+            const auto json = SkStringPrintf("[\"%s\",%s{%s\"%s\"%s:%s1}%s]%s",
+                                             str.c_str(), ws.c_str(), ws.c_str(), str.c_str(),
+                                             ws.c_str(), ws.c_str(), ws.c_str(), ws.c_str());
+            check_stream(reporter, json.c_str(), json.size());
+
+            // Unterminated strings must not scan past the input.
+            const auto partial = SkStringPrintf("[\"%s", str.c_str());
+            check_stream(reporter, partial.c_str(), partial.size());
+        }
+    }
+
+    // Handlers can stop parsing.
+    static constexpr char json[] = "[ 1, { \"k\": [ 2, 3 ] }, 4 ]";
+    for (int budget = 1; budget <= 10; ++budget) {
+        StoppingHandler handler(budget);
+        REPORTER_ASSERT(reporter, !Parse(json, strlen(json), &handler));
+        REPORTER_ASSERT(reporter, handler.events() == budget, "%d %d", budget, handler.events());
+    }
+    StoppingHandler handler(12);
+    REPORTER_ASSERT(reporter, Parse(json, strlen(json), &handler));
+    REPORTER_ASSERT(reporter, handler.events() == 11);
+}
@@ -70,3 +70,28 @@ DEF_TEST(LRUCacheRandom, r) {
     }
     REPORTER_ASSERT(r, 0 == instances);
 }
+
+DEF_TEST(LRUCacheRemove, r) {
+    int instances = 0;
+    {
+        SkLRUCache<int, std::unique_ptr<Value>> test(10);
+        for (int i = 0; i < 5; i++) {
+            test.insert(i, std::make_unique<Value>(i, &instances));
+        }
+        test.find(0);  // Makes 1 the least recently used.
+
+        test.remove(3);
+        REPORTER_ASSERT(r, 4 == instances);
+        REPORTER_ASSERT(r, !test.find(3));
+
+        std::unique_ptr<Value> evicted;
+        REPORTER_ASSERT(r, test.removeLRU(&evicted));
+        REPORTER_ASSERT(r, evicted && 1 == evicted->fValue);
+        REPORTER_ASSERT(r, 3 == test.count());
+        evicted.reset();
+
+        while (test.removeLRU()) {}
+        REPORTER_ASSERT(r, 0 == test.count());
+    }
+    REPORTER_ASSERT(r, 0 == instances);
+}
@@ -6,6 +6,7 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkMipmap.h"
 #include "tests/Test.h"
@@ -211,6 +212,68 @@ DEF_TEST(MipMap_F16, reporter) {
     sk_sp<SkMipmap> mipmap(SkMipmap::Build(bmp, nullptr));
 }
 
+DEF_TEST(MipMap_Executor, reporter) {
+    const SkColorType colorTypes[] = {
+        kRGBA_8888_SkColorType, kRGB_565_SkColorType, kAlpha_8_SkColorType,
+        kRGBA_F16_SkColorType, kR16G16_unorm_SkColorType, kRGBA_1010102_SkColorType,
+    };
+    const SkISize sizes[] = {{1024, 1024}, {1027, 769}, {600, 1101}, {3, 2000}, {2000, 1}};
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkRandom rand;
+    for (SkColorType ct : colorTypes) {
+        for (SkISize size : sizes) {
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::Make(size, ct, kPremul_SkAlphaType));
+            // Fill with random bytes, but keep F16 finite.
+            for (int y = 0; y < bm.height(); y++) {
+                auto row = (uint8_t*)bm.getAddr(0, y);
+                for (size_t i = 0; i < bm.info().minRowBytes(); i++) {
+                    row[i] = ct == kRGBA_F16_SkColorType && (i & 1) ? rand.nextU() & 0x3b
+                                                                    : rand.nextU();
+                }
+            }
+
+            sk_sp<SkMipmap> serial(SkMipmap::Build(bm.pixmap(), nullptr, true, nullptr)),
+                          parallel(SkMipmap::Build(bm.pixmap(), nullptr, true, executor.get()));
+            REPORTER_ASSERT(reporter, serial && parallel);
+            REPORTER_ASSERT(reporter, serial->countLevels() == parallel->countLevels());
+
+            for (int i = 0; i < serial->countLevels(); i++) {
+                SkMipmap::Level a, b;
+                serial->getLevel(i, &a);
+                parallel->getLevel(i, &b);
+                for (int y = 0; y < a.fPixmap.height(); y++) {
+                    if (memcmp(a.fPixmap.addr(0, y), b.fPixmap.addr(0, y),
+                               a.fPixmap.info().minRowBytes())) {
+                        ERRORF(reporter, "color type %d, %dx%d: level %d differs at row %d",
+                               ct, size.width(), size.height(), i, y);
+                        break;
+                    }
+                }
+            }
+
+            // The optimized 8888 box filter must match a plain per-channel average.
+            if (ct == kRGBA_8888_SkColorType && size == SkISize{1024, 1024}) {
+                SkMipmap::Level level;
+                serial->getLevel(0, &level);
+                bool match = true;
+                for (int y = 0; y < level.fPixmap.height() && match; y++) {
+                    for (int x = 0; x < level.fPixmap.width() && match; x++) {
+                        auto p0 = (const uint8_t*)bm.getAddr32(2*x, 2*y),
+                             p1 = (const uint8_t*)bm.getAddr32(2*x, 2*y + 1),
+                             d  = (const uint8_t*)level.fPixmap.addr32(x, y);
+                        for (int c = 0; c < 4; c++) {
+                            match &= d[c] == ((p0[c] + p0[c+4] + p1[c] + p1[c+4]) >> 2);
+                        }
+                    }
+                }
+                REPORTER_ASSERT(reporter, match);
+            }
+        }
+    }
+}
+
 #include "include/core/SkCanvas.h"
 #include "include/core/SkSurface.h"
 
@@ -231,3 +231,33 @@ DEF_TEST(pathbuilder_addPolygon, reporter) {
         }
     }
 }
+
+DEF_TEST(pathbuilder_computeBounds, r) {
+    SkPathBuilder builder;
+    REPORTER_ASSERT(r, builder.computeBounds().isEmpty());
+
+    builder.moveTo(10, 20);
+    REPORTER_ASSERT(r, builder.computeBounds() == SkRect::MakeLTRB(10, 20, 10, 20));
+    builder.lineTo(-5, 40);
+    REPORTER_ASSERT(r, builder.computeBounds() == SkRect::MakeLTRB(-5, 20, 10, 40));
+    builder.cubicTo(0, 0, 30, 50, 1, 1);
+    REPORTER_ASSERT(r, builder.computeBounds() == SkRect::MakeLTRB(-5, 0, 30, 50));
+
+    // The bounds computed so far are handed to the path.
+    SkPath path = builder.snapshot();
+    REPORTER_ASSERT(r, path.getBounds() == SkRect::MakeLTRB(-5, 0, 30, 50));
+
+    builder.lineTo(SK_ScalarNaN, 0);
+    REPORTER_ASSERT(r, builder.computeBounds().isEmpty());
+    builder.lineTo(100, 100);
+    REPORTER_ASSERT(r, builder.computeBounds().isEmpty());
+    path = builder.detach();
+    REPORTER_ASSERT(r, !path.isFinite());
+    REPORTER_ASSERT(r, builder.computeBounds().isEmpty());
+
+    builder.moveTo(1, 1).arcTo({0, 0, 4, 4}, 0, 90, false).lineTo(-1, 3);
+    path = builder.snapshot();
+    SkRect bounds;
+    bounds.setBounds(SkPathPriv::PointData(path), path.countPoints());
+    REPORTER_ASSERT(r, builder.computeBounds() == bounds);
+}
@@ -5663,3 +5663,107 @@ DEF_TEST(pathedger, r) {
 
     test_edger(r, { M, L, L, M, L, L }, { L, L, L,   L, L, L });
 }
+
+namespace {
+struct PathOp {
+    SkPath::Verb fVerb;
+    SkPoint      fPts[3];
+};
+
+void apply(const PathOp& op, SkPath* path) {
+    switch (op.fVerb) {
+        case SkPath::kMove_Verb:  path->moveTo(op.fPts[0]); break;
+        case SkPath::kLine_Verb:  path->lineTo(op.fPts[0]); break;
+        case SkPath::kQuad_Verb:  path->quadTo(op.fPts[0], op.fPts[1]); break;
+        case SkPath::kConic_Verb: path->conicTo(op.fPts[0], op.fPts[1], 0.7f); break;
+        case SkPath::kCubic_Verb: path->cubicTo(op.fPts[0], op.fPts[1], op.fPts[2]); break;
+        case SkPath::kClose_Verb: path->close(); break;
+        default: break;
+    }
+}
+}  // namespace
+
+// Bounds, convexity and the content hash pick up where they left off as a path grows. Check them
+// after every step against a path that was built in one go.
+DEF_TEST(Path_incremental, r) {
+    SkRandom rand;
+    for (int trial = 0; trial < 100; ++trial) {
+        // Mostly walk around a circle, so that many of the paths are convex.
+        const SkPoint center = {rand.nextRangeF(-100, 100), rand.nextRangeF(-100, 100)};
+        const float radius = rand.nextRangeF(1, 50);
+        float angle = 0;
+        auto nextPt = [&]() {
+            if (rand.nextULessThan(100) == 0) {
+                return SkPoint{SK_ScalarInfinity, 0};
+            }
+            angle += rand.nextULessThan(8) == 0 ? -rand.nextF() : rand.nextF() * 0.5f;
+            return center + SkPoint{radius * std::cos(angle), radius * std::sin(angle)};
+        };
+
+        std::vector<PathOp> ops;
+        SkPath path;
+        SkPath copy;
+        for (int step = 0; step < 30; ++step) {
+            PathOp op;
+            uint32_t choice = rand.nextULessThan(20);
+            op.fVerb = step == 0 || choice == 0 ? SkPath::kMove_Verb
+                     : choice == 1              ? SkPath::kClose_Verb
+                     : (SkPath::Verb)(SkPath::kLine_Verb + choice % 4);
+            for (SkPoint& pt : op.fPts) {
+                pt = nextPt();
+            }
+            ops.push_back(op);
+            apply(op, &path);
+            if (rand.nextBool()) {
+                // Sharing the path ref makes the next edit copy it, and what's been computed so far.
+                copy = path;
+            }
+
+            SkPath fresh;
+            for (const PathOp& o : ops) {
+                apply(o, &fresh);
+            }
+            // close() leaves a cached convexity alone, so ask a copy that hasn't cached one.
+            SkPath probe = path;
+            probe.setConvexityType(SkPathConvexityType::kUnknown);
+            REPORTER_ASSERT(r, probe.getBounds() == fresh.getBounds());
+            REPORTER_ASSERT(r, probe.isFinite() == fresh.isFinite());
+            REPORTER_ASSERT(r, probe.getConvexityType() == fresh.getConvexityType());
+            REPORTER_ASSERT(r, SkPathPriv::ContentHash(probe) == SkPathPriv::ContentHash(fresh));
+
+            SkPathPriv::FirstDirection dir, freshDir;
+            REPORTER_ASSERT(r, SkPathPriv::CheapComputeFirstDirection(probe, &dir) ==
+                               SkPathPriv::CheapComputeFirstDirection(fresh, &freshDir));
+            REPORTER_ASSERT(r, dir == freshDir);
+        }
+    }
+
+    // Changing points that have already been looked at starts over.
+    SkPath square;
+    square.moveTo(0, 0);
+    for (SkPoint pt : {SkPoint{10, 0}, SkPoint{10, 10}, SkPoint{0, 10}}) {
+        square.lineTo(pt);
+        (void)square.getBounds();
+        (void)square.getConvexityType();
+    }
+    REPORTER_ASSERT(r, square.isConvex());
+    square.setLastPt(5, 2);
+    square.setConvexityType(SkPathConvexityType::kUnknown);
+    REPORTER_ASSERT(r, square.getConvexityType() == SkPathConvexityType::kConcave);
+    square.setLastPt(20, 5);
+    REPORTER_ASSERT(r, square.getBounds() == SkRect::MakeLTRB(0, 0, 20, 10));
+
+    // Equal contents hash the same however they were made; different contents shouldn't.
+    SkPath a, b;
+    a.moveTo(1, 2).lineTo(3, 4).quadTo(5, 6, 7, 8);
+    (void)SkPathPriv::ContentHash(a);
+    a.close();
+    b = SkPathBuilder().moveTo(1, 2).lineTo(3, 4).quadTo(5, 6, 7, 8).close().detach();
+    REPORTER_ASSERT(r, SkPathPriv::ContentHash(a) == SkPathPriv::ContentHash(b));
+    b.setLastPt(7, 9);
+    REPORTER_ASSERT(r, SkPathPriv::ContentHash(a) != SkPathPriv::ContentHash(b));
+    b.setLastPt(7, 8);
+    REPORTER_ASSERT(r, SkPathPriv::ContentHash(a) == SkPathPriv::ContentHash(b));
+    b.setFillType(SkPathFillType::kEvenOdd);
+    REPORTER_ASSERT(r, SkPathPriv::ContentHash(a) != SkPathPriv::ContentHash(b));
+}
@@ -11,20 +11,28 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPixelRef.h"
+#include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkTextBlob.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
+#include "include/core/SkVertices.h"
+#include "include/effects/SkImageFilters.h"
+#include "include/utils/SkPaintFilterCanvas.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkClipOpPriv.h"
@@ -999,3 +1007,184 @@ DEF_TEST(Picture_nested_op_count, r) {
     check(make_pic(10, leaf1),  10,  10);
     check(make_pic(10, leaf10), 10, 100);
 }
+
+DEF_TEST(Picture_playbackParallel, r) {
+    SkRTreeFactory factory;
+    SkPictureRecorder rec;
+    SkCanvas* c = rec.beginRecording({0,0, 200,300}, &factory);
+    SkRandom rand;
+    for (int i = 0; i < 200; i++) {
+        SkPaint paint;
+        paint.setColor(rand.nextU() | 0xff000000);
+        c->drawRect(SkRect::MakeXYWH(rand.nextRangeScalar(0, 200), rand.nextRangeScalar(0, 300),
+                                     rand.nextRangeScalar(0, 50),  rand.nextRangeScalar(0, 50)),
+                    paint);
+    }
+    sk_sp<SkPicture> pic = rec.finishRecordingAsPicture();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (int bands : {0, 1, 7, 1000}) {
+        SkBitmap serial, parallel;
+        serial.allocN32Pixels(200, 300);
+        parallel.allocN32Pixels(200, 300);
+        serial.eraseColor(SK_ColorWHITE);
+        parallel.eraseColor(SK_ColorWHITE);
+
+        // Exercise the destination's matrix and clip, too.
+        SkCanvas serialCanvas(serial), parallelCanvas(parallel);
+        for (SkCanvas* canvas : {&serialCanvas, &parallelCanvas}) {
+            canvas->clipRect({10, 20, 190, 280});
+            canvas->translate(5, -3);
+        }
+        pic->playback(&serialCanvas);
+        pic->playbackParallel(&parallelCanvas, executor.get(), bands);
+
+        REPORTER_ASSERT(r, 0 == memcmp(serial.getPixels(), parallel.getPixels(),
+                                       serial.computeByteSize()));
+    }
+
+    // Each of these must give exactly the same pixels as playback():
+    //   - a backdrop blur, which reads rows across band edges;
+    //   - an anti-aliased clip with fractional edges;
+    //   - a wrapper canvas that changes every paint.
+    c = rec.beginRecording({0,0, 200,300}, &factory);
+    c->drawPicture(pic);
+    const SkRect layerBounds = {20, 40, 180, 260};
+    auto blur = SkImageFilters::Blur(6, 6, nullptr);
+    c->saveLayer(SkCanvas::SaveLayerRec(&layerBounds, nullptr, blur.get(), 0));
+    c->restore();
+    sk_sp<SkPicture> backdropPic = rec.finishRecordingAsPicture();
+    REPORTER_ASSERT(r, !SkPicturePriv::ReadsBackdrop(pic.get()));
+    REPORTER_ASSERT(r, SkPicturePriv::ReadsBackdrop(backdropPic.get()));
+
+    class GreenFilterCanvas final : public SkPaintFilterCanvas {
+    public:
+        using SkPaintFilterCanvas::SkPaintFilterCanvas;
+        bool onFilter(SkPaint& paint) const override {
+            paint.setColor(SK_ColorGREEN);
+            return true;
+        }
+    };
+
+    enum class Variant { kBackdrop, kAAClip, kWrapper };
+    for (Variant variant : {Variant::kBackdrop, Variant::kAAClip, Variant::kWrapper}) {
+        SkBitmap serial, parallel;
+        serial.allocN32Pixels(200, 300);
+        parallel.allocN32Pixels(200, 300);
+        serial.eraseColor(SK_ColorWHITE);
+        parallel.eraseColor(SK_ColorWHITE);
+
+        SkCanvas serialCanvas(serial), parallelCanvas(parallel);
+        GreenFilterCanvas serialFilter(&serialCanvas), parallelFilter(&parallelCanvas);
+        SkCanvas* serialDst   = variant == Variant::kWrapper ? &serialFilter   : &serialCanvas;
+        SkCanvas* parallelDst = variant == Variant::kWrapper ? &parallelFilter : &parallelCanvas;
+        if (variant == Variant::kAAClip) {
+            serialDst->clipRect({10.5f, 20.25f, 190.5f, 280.75f}, true);
+            parallelDst->clipRect({10.5f, 20.25f, 190.5f, 280.75f}, true);
+        }
+
+        const SkPicture* p = variant == Variant::kBackdrop ? backdropPic.get() : pic.get();
+        p->playback(serialDst);
+        p->playbackParallel(parallelDst, executor.get(), 7);
+
+        REPORTER_ASSERT(r, 0 == memcmp(serial.getPixels(), parallel.getPixels(),
+                                       serial.computeByteSize()), "variant %d", (int)variant);
+    }
+}
+
+DEF_TEST(Picture_MakeFromMappedData, r) {
+    auto draw_paths = [](SkCanvas* c, SkRandom* rand, int count) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < count; i++) {
+            SkPath path;
+            if (i % 3 == 0) {
+                path.addRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(rand->nextRangeScalar(0, 150),
+                                                                   rand->nextRangeScalar(0, 250),
+                                                                   40, 30), 5, 7));
+            } else {
+                path.moveTo(rand->nextRangeScalar(0, 200), rand->nextRangeScalar(0, 300));
+                path.conicTo(rand->nextRangeScalar(0, 200), rand->nextRangeScalar(0, 300),
+                             rand->nextRangeScalar(0, 200), rand->nextRangeScalar(0, 300), 0.7f);
+                path.cubicTo(rand->nextRangeScalar(0, 200), rand->nextRangeScalar(0, 300),
+                             rand->nextRangeScalar(0, 200), rand->nextRangeScalar(0, 300),
+                             rand->nextRangeScalar(0, 200), rand->nextRangeScalar(0, 300));
+            }
+            paint.setColor(rand->nextU() | 0xff000000);
+            c->drawPath(path, paint);
+        }
+    };
+
+    SkRandom rand;
+    SkPictureRecorder rec;
+    draw_paths(rec.beginRecording({0,0, 200,300}), &rand, 20);
+    sk_sp<SkPicture> child = rec.finishRecordingAsPicture();
+
+    SkCanvas* c = rec.beginRecording({0,0, 200,300});
+    draw_paths(c, &rand, 50);
+    c->save();
+        c->translate(20, 10);
+        c->drawPicture(child);
+    c->restore();
+    c->clipPath(SkPath().addCircle(100, 150, 90), true);
+    draw_paths(c, &rand, 50);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    bitmap.eraseColor(SK_ColorGREEN);
+    c->drawImage(SkImage::MakeFromBitmap(bitmap), 150, 10);
+    c->drawTextBlob(SkTextBlob::MakeFromString("mapped", SkFont(nullptr, 20)), 10, 280, SkPaint());
+    const SkPoint pts[] = {{10, 10}, {100, 20}, {50, 90}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+    c->drawVertices(SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, 3, pts, nullptr,
+                                         colors),
+                    SkBlendMode::kModulate, SkPaint());
+    sk_sp<SkData> skp = rec.finishRecordingAsPicture()->serialize();
+
+    // Also try a copy that starts at an odd address, so nothing can be referenced in place.
+    sk_sp<SkData> storage = SkData::MakeUninitialized(skp->size() + 1);
+    memcpy((char*)storage->writable_data() + 1, skp->data(), skp->size());
+    sk_sp<SkData> misaligned = SkData::MakeSubset(storage.get(), 1, skp->size());
+
+    sk_sp<SkPicture> expected = SkPicture::MakeFromData(skp.get());
+    REPORTER_ASSERT(r, expected);
+
+    auto render = [](const SkPicture* pic, SkExecutor* executor) {
+        SkBitmap bm;
+        bm.allocN32Pixels(200, 300);
+        bm.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bm);
+        if (executor) {
+            pic->playbackParallel(&canvas, executor, 8);
+        } else {
+            pic->playback(&canvas);
+        }
+        return bm;
+    };
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const sk_sp<SkData>& data : {skp, misaligned}) {
+        // Keep everything, evict after every op, and evict occasionally.
+        for (size_t budget : {0, 1, 4096}) {
+            sk_sp<SkPicture> mapped = SkPicture::MakeFromMappedData(data, nullptr, budget);
+            REPORTER_ASSERT(r, mapped);
+            REPORTER_ASSERT(r, mapped->cullRect() == expected->cullRect());
+            REPORTER_ASSERT(r, mapped->approximateOpCount(true) >
+                               mapped->approximateOpCount(false));
+
+            // Decode the objects on several threads at once first, then again on this one.
+            for (SkExecutor* exec : {executor.get(), (SkExecutor*)nullptr}) {
+                SkBitmap want = render(expected.get(), exec),
+                         got  = render(mapped.get(), exec);
+                REPORTER_ASSERT(r, 0 == memcmp(want.getPixels(), got.getPixels(),
+                                               want.computeByteSize()));
+            }
+
+            // A mapped picture should serialize back to the same bytes.
+            sk_sp<SkData> reserialized = mapped->serialize();
+            REPORTER_ASSERT(r, reserialized->equals(skp.get()));
+        }
+    }
+
+    REPORTER_ASSERT(r, !SkPicture::MakeFromMappedData(nullptr));
+    REPORTER_ASSERT(r, !SkPicture::MakeFromMappedData(SkData::MakeSubset(skp.get(), 0, 40)));
+}
@@ -7,10 +7,14 @@
 
 #include "include/private/SkHalf.h"
 #include "include/private/SkTo.h"
+#include "include/utils/SkRandom.h"
 #include "src/core/SkRasterPipeline.h"
 #include "src/gpu/GrSwizzle.h"
 #include "tests/Test.h"
 
+#include <algorithm>
+#include <vector>
+
 DEF_TEST(SkRasterPipeline, r) {
     // Build and run a simple pipeline to exercise SkRasterPipeline,
     // drawing 50% transparent blue over opaque red in half-floats.
@@ -566,3 +570,106 @@ DEF_TEST(SkRasterPipeline_lowp_clamp01, r) {
     p.append(SkRasterPipeline::store_8888, &ptr);
     p.run(0,0,1,1);
 }
+
+DEF_TEST(SkRasterPipeline_allTails, r) {
+    // Copy every run length up to a few times the widest stride (16 lowp lanes with AVX2)
+    // through each load/store pair, both lowp (when available) and highp.  The copy must be
+    // exact, and must not touch memory past the run.
+    static constexpr int kMaxN = 70;
+
+    struct Format {
+        SkRasterPipeline::StockStage load, store;
+        size_t                       bpp;
+        // Fills one pixel with random, opaque (so unpremul is a no-op) data.
+        void (*fill)(SkRandom*, void*);
+    };
+
+    static const Format kFormats[] = {
+        { SkRasterPipeline::load_a8, SkRasterPipeline::store_a8, 1,
+          [](SkRandom* rand, void* px) { *(uint8_t*)px = SkTo<uint8_t>(rand->nextU() >> 24); } },
+        { SkRasterPipeline::load_565, SkRasterPipeline::store_565, 2,
+          [](SkRandom* rand, void* px) { *(uint16_t*)px = SkTo<uint16_t>(rand->nextU() >> 16); } },
+        { SkRasterPipeline::load_4444, SkRasterPipeline::store_4444, 2,
+          [](SkRandom* rand, void* px) {
+              *(uint16_t*)px = SkTo<uint16_t>(rand->nextU() >> 16) | 0x000f;
+          } },
+        { SkRasterPipeline::load_rg88, SkRasterPipeline::store_rg88, 2,
+          [](SkRandom* rand, void* px) { *(uint16_t*)px = SkTo<uint16_t>(rand->nextU() >> 16); } },
+        { SkRasterPipeline::load_8888, SkRasterPipeline::store_8888, 4,
+          [](SkRandom* rand, void* px) { *(uint32_t*)px = rand->nextU() | 0xff000000; } },
+        { SkRasterPipeline::load_1010102, SkRasterPipeline::store_1010102, 4,
+          [](SkRandom* rand, void* px) { *(uint32_t*)px = rand->nextU() | 0xc0000000; } },
+        { SkRasterPipeline::load_a16, SkRasterPipeline::store_a16, 2,
+          [](SkRandom* rand, void* px) { *(uint16_t*)px = SkTo<uint16_t>(rand->nextU() >> 16); } },
+        { SkRasterPipeline::load_rg1616, SkRasterPipeline::store_rg1616, 4,
+          [](SkRandom* rand, void* px) { *(uint32_t*)px = rand->nextU(); } },
+        { SkRasterPipeline::load_16161616, SkRasterPipeline::store_16161616, 8,
+          [](SkRandom* rand, void* px) {
+              uint16_t rgba[] = { SkTo<uint16_t>(rand->nextU() >> 16),
+                                  SkTo<uint16_t>(rand->nextU() >> 16),
+                                  SkTo<uint16_t>(rand->nextU() >> 16),
+                                  0xffff };
+              memcpy(px, rgba, sizeof(rgba));
+          } },
+        { SkRasterPipeline::load_f16, SkRasterPipeline::store_f16, 8,
+          [](SkRandom* rand, void* px) {
+              uint16_t rgba[] = { h(rand->nextF()), h(rand->nextF()), h(rand->nextF()), h(1) };
+              memcpy(px, rgba, sizeof(rgba));
+          } },
+        { SkRasterPipeline::load_rgf16, SkRasterPipeline::store_rgf16, 4,
+          [](SkRandom* rand, void* px) {
+              uint16_t rg[] = { h(rand->nextF()), h(rand->nextF()) };
+              memcpy(px, rg, sizeof(rg));
+          } },
+        { SkRasterPipeline::load_f32, SkRasterPipeline::store_f32, 16,
+          [](SkRandom* rand, void* px) {
+              float rgba[] = { rand->nextF(), rand->nextF(), rand->nextF(), 1 };
+              memcpy(px, rgba, sizeof(rgba));
+          } },
+        { SkRasterPipeline::load_rgf32, SkRasterPipeline::store_rgf32, 8,
+          [](SkRandom* rand, void* px) {
+              float rg[] = { rand->nextF(), rand->nextF() };
+              memcpy(px, rg, sizeof(rg));
+          } },
+    };
+
+    static constexpr uint8_t kGuard = 0xab;
+
+    SkRandom rand;
+    for (const auto& fmt : kFormats) {
+        std::vector<uint8_t> src(kMaxN * fmt.bpp),
+                             dst(kMaxN * fmt.bpp);
+        for (int i = 0; i < kMaxN; i++) {
+            fmt.fill(&rand, src.data() + i * fmt.bpp);
+        }
+
+        SkRasterPipeline_MemoryCtx src_ctx = { src.data(), 0 },
+                                   dst_ctx = { dst.data(), 0 };
+
+        // unpremul has no lowp implementation, so it forces the highp pipeline.
+        for (bool highp : { false, true }) {
+            SkRasterPipeline_<256> p;
+            p.append(fmt.load, &src_ctx);
+            if (highp) {
+                p.append(SkRasterPipeline::unpremul);
+            }
+            p.append(fmt.store, &dst_ctx);
+
+            for (int n = 1; n <= kMaxN; n++) {
+                std::fill(dst.begin(), dst.end(), kGuard);
+                p.run(0,0, n,1);
+
+                const size_t len = n * fmt.bpp;
+                if (memcmp(dst.data(), src.data(), len)) {
+                    ERRORF(r, "stage %d, highp %d, n %d: mismatched pixels\n",
+                           fmt.store, highp, n);
+                }
+                if (std::any_of(dst.begin() + len, dst.end(),
+                                [](uint8_t b) { return b != kGuard; })) {
+                    ERRORF(r, "stage %d, highp %d, n %d: wrote past the run\n",
+                           fmt.store, highp, n);
+                }
+            }
+        }
+    }
+}
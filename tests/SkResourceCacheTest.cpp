@@ -292,3 +292,51 @@ DEF_TEST(ResourceCache_purge, reporter) {
         }
     }
 }
+
+static bool test_rec_visitor(const SkResourceCache::Rec& baseRec, void* context) {
+    *(int32_t*)context = static_cast<const TestRec&>(baseRec).fKey.fData;
+    return true;
+}
+
+/*
+ *  The global cache keeps working, and keeps its entries, as it is split into shards and back.
+ */
+DEF_TEST(ResourceCache_shards, reporter) {
+    const size_t prevLimit = SkResourceCache::SetTotalByteLimit(1000 * 1024 + 7);
+    const int prevCount = SkResourceCache::SetShardCount(1);
+    SkResourceCache::PurgeAll();
+
+    constexpr int kRecs = 200;
+    int flags[kRecs] = {};
+    for (int i = 0; i < kRecs; ++i) {
+        auto rec = new TestRec(0, i, &flags[i]);
+        rec->fCanBePurged = true;
+        SkResourceCache::Add(rec);
+    }
+    REPORTER_ASSERT(reporter, SkResourceCache::GetTotalBytesUsed() == kRecs * 1024);
+
+    for (int shards : { 8, 64, 3, 1 }) {
+        SkResourceCache::SetShardCount(shards);
+        REPORTER_ASSERT(reporter, SkResourceCache::GetShardCount() == shards);
+        REPORTER_ASSERT(reporter, SkResourceCache::GetTotalByteLimit() == 1000 * 1024 + 7);
+        REPORTER_ASSERT(reporter, SkResourceCache::GetTotalBytesUsed() == kRecs * 1024);
+        for (int i = 0; i < kRecs; ++i) {
+            int32_t found = -1;
+            REPORTER_ASSERT(reporter, SkResourceCache::Find(TestKey(0, i), test_rec_visitor,
+                                                            &found));
+            REPORTER_ASSERT(reporter, found == i);
+        }
+    }
+
+    // Each shard only gets its share of the budget, and purges within it.
+    SkResourceCache::SetShardCount(4);
+    SkResourceCache::SetTotalByteLimit(4 * 10 * 1024);
+    REPORTER_ASSERT(reporter, SkResourceCache::GetTotalBytesUsed() <= 4 * 10 * 1024);
+    REPORTER_ASSERT(reporter,
+                    SkResourceCache::GetEffectiveSingleAllocationByteLimit() == 10 * 1024);
+
+    SkResourceCache::PurgeAll();
+    REPORTER_ASSERT(reporter, SkResourceCache::GetTotalBytesUsed() == 0);
+    SkResourceCache::SetShardCount(prevCount);
+    SkResourceCache::SetTotalByteLimit(prevLimit);
+}
@@ -5,8 +5,10 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/core/SkTaskGroup.h"
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
 
@@ -48,6 +50,47 @@ DEF_TEST(SkStrikeCache_CachePurge, Reporter) {
         REPORTER_ASSERT(Reporter, cache.getTotalMemoryUsed() == 0);
     }
     REPORTER_ASSERT(Reporter, cache.getTotalMemoryUsed() == 0);
+}
+
+// Many threads finding strikes while the cache is small enough that they keep getting purged.
+DEF_TEST(SkStrikeCache_MultiThreadFind, Reporter) {
+    SkStrikeCache cache;
+    cache.setCacheCountLimit(8);
 
+    SkFont font;
+    font.setTypeface(ToolUtils::create_portable_typeface("serif", SkFontStyle::Italic()));
+    SkPaint defaultPaint;
 
+    static constexpr int kSizes = 24;
+    std::vector<SkStrikeSpec> specs;
+    for (int i = 0; i < kSizes; i++) {
+        font.setSize(8 + i);
+        specs.push_back(SkStrikeSpec::MakeMask(
+                font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                SkScalerContextFlags::kNone, SkMatrix::I()));
+    }
+
+    static constexpr int kThreadCount = 8;
+    auto executor = SkExecutor::MakeFIFOThreadPool(kThreadCount);
+    std::atomic<int> mismatches{0};
+    SkTaskGroup(*executor).batch(kThreadCount, [&](int thread) {
+        for (int i = 0; i < 2000; i++) {
+            // Mostly a few hot strikes, with the occasional cold one to force purging.
+            int index = (i % 16 == 0) ? (i / 16 + thread) % kSizes : thread % 4;
+            sk_sp<SkStrike> strike = specs[index].findOrCreateStrike(&cache);
+            if (strike->getDescriptor() != specs[index].descriptor()) {
+                mismatches++;
+            }
+        }
+    });
+    REPORTER_ASSERT(Reporter, mismatches == 0);
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() <= 8);
+
+    // A strike we just made can be found again, and is gone once purged.
+    sk_sp<SkStrike> strike = specs[0].findOrCreateStrike(&cache);
+    REPORTER_ASSERT(Reporter, cache.findStrike(specs[0].descriptor()) == strike);
+    strike.reset();
+    cache.purgeAll();
+    REPORTER_ASSERT(Reporter, cache.findStrike(specs[0].descriptor()) == nullptr);
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() == 0);
 }
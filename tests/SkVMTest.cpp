@@ -6,14 +6,19 @@
  */
 
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkData.h"
+#include "include/core/SkGraphics.h"
 #include "include/private/SkColorData.h"
 #include "src/core/SkCpu.h"
 #include "src/core/SkMSAN.h"
 #include "src/core/SkVM.h"
+#include "src/core/SkVMProgramCache.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
 #include "tools/SkVMBuilders.h"
 
+extern bool gSkVMAllowJIT;
+
 using Fmt = SrcoverBuilder_F32::Fmt;
 const char* fmt_name(Fmt fmt) {
     switch (fmt) {
@@ -1614,6 +1619,62 @@ DEF_TEST(SkVM_Assembler, r) {
         0xc4,0xe2,0x1d,0x92,0x04,0xd0,
     });
 
+    // AVX-512: with use_zmm(true), the same Ymm calls assemble EVEX-encoded zmm instructions.
+    test_asm(r, [&](A& a) {
+        a.use_zmm(true);
+        a.vaddps (A::ymm1, A::ymm2, A::ymm3);
+        a.vaddps (A::ymm9, A::ymm12, A::Mem{A::rsp, 64});
+        a.vmovups(A::Mem{A::rdi, 4, A::r9, A::FOUR}, A::ymm14);
+        a.vpslld (A::ymm1, A::ymm10, 3);
+        a.vpxor  (A::ymm2, A::ymm3, A::ymm4);
+        a.vroundps (A::ymm1, A::ymm2, A::FLOOR);
+        a.vcvtps2ph(A::ymm3, A::ymm2, A::CURRENT);
+        a.vcvtph2ps(A::ymm2, A::ymm3);
+    },{
+        0x62,0xf1,0x6c,0x48,0x58,0xcb,
+        0x62,0x71,0x1c,0x48,0x58,0x8c,0x24,0x40,0x00,0x00,0x00,
+        0x62,0x31,0x7c,0x48,0x11,0xb4,0x8f,0x04,0x00,0x00,0x00,
+        0x62,0xd1,0x75,0x48,0x72,0xf2,0x03,
+        0x62,0xf1,0x65,0x48,0xef,0xd4,
+        0x62,0xf3,0x7d,0x48,0x08,0xca,0x01,
+        0x62,0xf3,0x7d,0x48,0x1d,0xd3,0x04,
+        0x62,0xf2,0x7d,0x48,0x13,0xd3,
+    });
+
+    test_asm(r, [&](A& a) {
+        a.use_zmm(true);
+        a.vpcmpeqd(A::k1, A::ymm2, A::ymm11);
+        a.vpcmpgtd(A::k2, A::ymm8, A::Mem{A::rax});
+        a.vcmpltps(A::k1, A::ymm3, A::ymm4);
+        a.vpmovm2d(A::ymm12, A::k1);
+        a.kxnorw  (A::k1, A::k1, A::k1);
+        a.kortestw(A::k1, A::k2);
+        a.vpternlogd(A::ymm1, A::ymm2, A::ymm13, 0xca);
+    },{
+        0x62,0xd1,0x6d,0x48,0x76,0xcb,
+        0x62,0xf1,0x3d,0x48,0x66,0x10,
+        0x62,0xf1,0x64,0x48,0xc2,0xcc,0x01,
+        0x62,0x72,0x7e,0x48,0x38,0xe1,
+        0xc5,0xf4,0x46,0xc9,
+        0xc5,0xf8,0x98,0xca,
+        0x62,0xd3,0x6d,0x48,0x25,0xcd,0xca,
+    });
+
+    test_asm(r, [&](A& a) {
+        a.use_zmm(true);
+        a.vpmovdb(A::Mem{A::rdi}, A::ymm1);
+        a.vpmovdw(A::Mem{A::r8 }, A::ymm9);
+        a.vpmovdw(A::ymm3, A::ymm1);
+        a.vpgatherdd(A::ymm1 , A::FOUR, A::ymm0 , A::rax, A::k1);
+        a.vpgatherdd(A::ymm10, A::ONE , A::ymm12, A::r9 , A::k2);
+    },{
+        0x62,0xf2,0x7e,0x48,0x31,0x0f,
+        0x62,0x52,0x7e,0x48,0x33,0x08,
+        0x62,0xf2,0x7e,0x48,0x33,0xcb,
+        0x62,0xf2,0x7d,0x49,0x90,0x0c,0x80,
+        0x62,0x12,0x7d,0x4a,0x90,0x14,0x21,
+    });
+
     test_asm(r, [&](A& a) {
         a.mov(A::rax, A::Mem{A::rdi,   0});
         a.mov(A::rax, A::Mem{A::rdi,   1});
@@ -2287,6 +2348,77 @@ DEF_TEST(SkVM_64bit, r) {
     }
 }
 
+DEF_TEST(SkVM_zmm_fallback, r) {
+    // load64, load128, store64, store128, gather8 and gather16 have no zmm implementations, so on
+    // SKX machines setupJIT() assembles programs using them with ymm.  Those programs must still
+    // be JITted, and must still get every tail length right.
+    skvm::Builder b;
+    {
+        skvm::Arg uniforms = b.uniform(),
+                  wide     = b.varying<uint64_t>(),
+                  src      = b.arg(16),
+                  dst      = b.arg(16),
+                  bytes    = b.varying<int>(),
+                  halfs    = b.varying<int>();
+        skvm::I32 lo = b.load64(wide, 0),
+                  hi = b.load64(wide, 1);
+        b.store64(wide, hi, lo);
+        b.store128(dst, lo, hi, 0);
+        b.store128(dst, b.load128(src, 3), b.load128(src, 0), 1);
+        b.store32(bytes, b.gather8 (uniforms,0, b.bit_and(lo, b.splat(63))));
+        b.store32(halfs, b.gather16(uniforms,0, b.bit_and(hi, b.splat(31))));
+    }
+    skvm::Program program = b.done();
+#if defined(SKVM_JIT) && (defined(__x86_64__) || defined(_M_X64))
+    REPORTER_ASSERT(r, !gSkVMAllowJIT || !SkCpu::Supports(SkCpu::HSW) || program.hasJIT());
+#endif
+
+    test_jit_and_interpreter(std::move(program), [&](const skvm::Program& program) {
+        uint8_t img[64];
+        for (int i = 0; i < 64; i++) {
+            img[i] = 3*i + 1;
+        }
+        struct Uniforms {
+            const uint8_t* img;
+        } uniforms{img};
+
+        constexpr int kMaxN = 40;
+        for (int N = 1; N <= kMaxN; N++) {
+            uint64_t wide[kMaxN+1];
+            uint32_t src[kMaxN+1][4],
+                     dst[kMaxN+1][4];
+            int      bytes[kMaxN+1],
+                     halfs[kMaxN+1];
+            for (int i = 0; i <= kMaxN; i++) {
+                wide[i] = (uint64_t)(2*i+1) << 32 | (uint64_t)(2*i);
+                for (int j = 0; j < 4; j++) {
+                    src[i][j] = 4*i + j;
+                    dst[i][j] = 0xaaaaaaaa;
+                }
+                bytes[i] = halfs[i] = -1;
+            }
+
+            program.eval(N, &uniforms, wide, src, dst, bytes, halfs);
+
+            for (int i = 0; i < N; i++) {
+                uint32_t lo = 2*i,
+                         hi = 2*i+1;
+                REPORTER_ASSERT(r, wide[i] == ((uint64_t)lo << 32 | hi));
+                REPORTER_ASSERT(r, dst[i][0] == lo        && dst[i][1] == hi &&
+                                   dst[i][2] == src[i][3] && dst[i][3] == src[i][0]);
+                REPORTER_ASSERT(r, bytes[i] == img[lo & 63]);
+                uint16_t half;
+                memcpy(&half, img + 2*(hi & 31), 2);
+                REPORTER_ASSERT(r, halfs[i] == half);
+            }
+            // Nothing past the N'th value is touched.
+            REPORTER_ASSERT(r, wide[N] == ((uint64_t)(2*N+1) << 32 | (uint64_t)(2*N)));
+            REPORTER_ASSERT(r, dst[N][0] == 0xaaaaaaaa && dst[N][3] == 0xaaaaaaaa);
+            REPORTER_ASSERT(r, bytes[N] == -1 && halfs[N] == -1);
+        }
+    });
+}
+
 DEF_TEST(SkVM_is_NaN_is_finite, r) {
     skvm::Builder b;
     {
@@ -2339,3 +2471,141 @@ DEF_TEST(SkVM_args, r) {
         }
     });
 }
+
+DEF_TEST(SkVM_serialize, r) {
+    skvm::Builder b;
+    {
+        skvm::Arg buf = b.varying<int>(),
+                  uni = b.uniform();
+        skvm::I32 x = b.load32(buf);
+        x = b.select( b.gt(x, b.splat(4)), x, b.uniform32(uni, 0) );
+        b.store32(buf, x);
+    }
+
+    sk_sp<SkData> data;
+    skvm::Program original = b.done("original", &data);
+    REPORTER_ASSERT(r, data);
+
+    skvm::Program loaded = skvm::Program::MakeFromData(data->data(), data->size());
+    REPORTER_ASSERT(r, !loaded.empty());
+    REPORTER_ASSERT(r, loaded.nargs() == original.nargs());
+    REPORTER_ASSERT(r, loaded.nregs() == original.nregs());
+    REPORTER_ASSERT(r, loaded.loop () == original.loop ());
+    REPORTER_ASSERT(r, loaded.instructions().size() == original.instructions().size());
+
+    test_jit_and_interpreter(std::move(loaded), [&](const skvm::Program& program) {
+        int buf[] = { 0,1,2,3,4,5,6,7,8 };
+        struct { int fallback; } uniforms = { 42 };
+        program.eval(SK_ARRAY_COUNT(buf), buf, &uniforms);
+        for (int i = 0; i < (int)SK_ARRAY_COUNT(buf); i++) {
+            REPORTER_ASSERT(r, buf[i] == (i > 4 ? i : 42));
+        }
+    });
+
+    // Truncated or corrupted data should be rejected, not loaded.
+    REPORTER_ASSERT(r, skvm::Program::MakeFromData(nullptr, 0).empty());
+    REPORTER_ASSERT(r, skvm::Program::MakeFromData(data->data(), data->size() - 1).empty());
+
+    sk_sp<SkData> corrupt = SkData::MakeWithCopy(data->data(), data->size());
+    ((uint8_t*)corrupt->writable_data())[corrupt->size() - 1] ^= 0xff;
+    REPORTER_ASSERT(r, skvm::Program::MakeFromData(corrupt->data(), corrupt->size()).empty());
+}
+
+DEF_TEST(SkVM_ProgramCacheLimits, r) {
+    // The global cache is shared with every other test running, so only check the plumbing,
+    // without changing its limits or expecting anything of its contents.
+    const int    count = SkGraphics::GetProgramCacheCountLimit();
+    const size_t bytes = SkGraphics::GetProgramCacheByteLimit();
+    REPORTER_ASSERT(r, count == SkGraphics::SetProgramCacheCountLimit(count));
+    REPORTER_ASSERT(r, bytes == SkGraphics::SetProgramCacheByteLimit(bytes));
+
+    // Everything else is tested on a private cache.
+    SkVMProgramCache<int> cache;
+    cache.setCountLimit(2);
+
+    // Program n adds 1..n to each int, so bigger keys use more bytes.
+    auto make = [](int key) {
+        skvm::Builder b;
+        {
+            skvm::Arg ptr = b.varying<int>();
+            skvm::I32 x = b.load32(ptr);
+            for (int i = 1; i <= key; i++) {
+                x = b.add(x, b.splat(i));
+            }
+            b.store32(ptr, x);
+        }
+        return b.done();
+    };
+    size_t programBytes[5] = {};
+    for (int key = 1; key < 5; key++) {
+        programBytes[key] = make(key).approxBytesUsed();
+    }
+    REPORTER_ASSERT(r, programBytes[2] < programBytes[4]);
+
+    auto put = [&](int key) { cache.put(key, make(key)); };
+    // Taking a Program and putting it back makes it the most recently used.
+    auto hit = [&](int key) {
+        skvm::Program program = cache.take(key);
+        if (program.empty()) {
+            return false;
+        }
+        cache.put(key, std::move(program));
+        return true;
+    };
+    auto count_is = [&](int n) { return n == cache.stats().fCount; };
+    auto bytes_are = [&](std::initializer_list<int> keys) {
+        size_t sum = 0;
+        for (int key : keys) {
+            sum += programBytes[key];
+        }
+        return sum == cache.stats().fBytes;
+    };
+
+    put(1);
+    put(2);
+    REPORTER_ASSERT(r, count_is(2) && bytes_are({1,2}));
+
+    // Using 1 makes 2 the least recently used, so 3 evicts 2.
+    REPORTER_ASSERT(r, hit(1));
+    put(3);
+    REPORTER_ASSERT(r, count_is(2) && bytes_are({1,3}));
+    REPORTER_ASSERT(r, !hit(2));
+
+    // Now 1 is the least recently used, so 2 evicts it.
+    REPORTER_ASSERT(r, hit(3));
+    put(2);
+    REPORTER_ASSERT(r, count_is(2) && bytes_are({2,3}));
+    REPORTER_ASSERT(r, !hit(1));
+
+    SkGraphics::ProgramCacheStats stats = cache.stats();
+    REPORTER_ASSERT(r, stats.fHits == 2 && stats.fMisses == 2);
+
+    // Putting back a Program that is already cached replaces it, without counting it twice.
+    put(2);
+    REPORTER_ASSERT(r, count_is(2) && bytes_are({2,3}));
+
+    // Lowering the byte limit evicts the least recently used (3) until the rest fits.
+    cache.setByteLimit(programBytes[2] + programBytes[3] - 1);
+    REPORTER_ASSERT(r, count_is(1) && bytes_are({2}));
+    REPORTER_ASSERT(r, hit(2));
+
+    // A Program bigger than the byte limit is not cached at all.
+    cache.setByteLimit(programBytes[4] - 1);
+    put(4);
+    REPORTER_ASSERT(r, count_is(1) && bytes_are({2}));
+
+    // Lowering the count limit evicts too, and a limit of zero caches nothing.
+    cache.setByteLimit(SIZE_MAX);
+    put(1);
+    cache.setCountLimit(1);
+    REPORTER_ASSERT(r, count_is(1) && bytes_are({1}));
+    cache.setCountLimit(0);
+    put(3);
+    REPORTER_ASSERT(r, count_is(0) && bytes_are({}));
+
+    cache.setCountLimit(2);
+    put(1);
+    put(2);
+    cache.purge();
+    REPORTER_ASSERT(r, count_is(0) && bytes_are({}));
+}
@@ -7,14 +7,19 @@
 
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkOverdrawCanvas.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkRRect.h"
 #include "include/core/SkRegion.h"
 #include "include/core/SkSurface.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/effects/SkImageFilters.h"
 #include "include/gpu/GrBackendSurface.h"
 #include "include/gpu/GrDirectContext.h"
 #include "src/core/SkAutoPixmapStorage.h"
+#include "src/core/SkCanvasPriv.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkUtils.h"
 #include "src/gpu/GrContextPriv.h"
@@ -1215,3 +1220,148 @@ DEF_TEST(surface_image_unity, reporter) {
         }
     }
 }
+
+static bool pixmaps_equal(const SkPixmap& a, const SkPixmap& b) {
+    if (a.info() != b.info()) {
+        return false;
+    }
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.addr(0, y), b.addr(0, y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void draw_tiled_scene(SkCanvas* canvas) {
+    SkPoint pts[] = {{0, 0}, {300, 200}};
+    SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kClamp));
+    canvas->drawPaint(paint);
+
+    paint.reset();
+    paint.setAntiAlias(true);
+    paint.setColor(0x8000ff00);
+    canvas->save();
+    canvas->translate(10, 20);
+    canvas->clipRect({0, 0, 250, 150});
+    canvas->drawCircle(100, 70, 90, paint);
+    canvas->saveLayerAlpha(nullptr, 0x80);
+    canvas->drawRect({40, 40, 200, 120}, paint);
+    canvas->restore();
+    canvas->restore();
+
+    // AA geometry and text crossing tile edges, and some within a single tile.
+    SkPath path;
+    path.moveTo(30, 180);
+    path.cubicTo(90, 10, 160, 230, 290, 40);
+    path.lineTo(250, 190);
+    path.close();
+    paint.setColor(0xc0ff8000);
+    canvas->drawPath(path, paint);
+    for (int i = 0; i < 4; ++i) {
+        canvas->drawCircle(64 * i + 32.3f, 31.7f, 20, paint);
+    }
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawString("Tiles", 40, 110, SkFont(ToolUtils::create_portable_typeface(), 40),
+                       paint);
+    canvas->drawString("Tg", 100, 190, SkFont(ToolUtils::create_portable_typeface(), 150),
+                       paint);
+}
+
+DEF_TEST(SurfaceRasterTiled, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(300, 200);
+    std::unique_ptr<SkExecutor> one  = SkExecutor::MakeFIFOThreadPool(1),
+                                four = SkExecutor::MakeFIFOThreadPool(4);
+
+    auto serial   = SkSurface::MakeRasterTiled(info, one.get(), 64),
+         parallel = SkSurface::MakeRasterTiled(info, four.get(), 64);
+    REPORTER_ASSERT(reporter, serial && parallel);
+    REPORTER_ASSERT(reporter, !SkSurface::MakeRasterTiled(info, one.get(), 0));
+
+    draw_tiled_scene(serial->getCanvas());
+    draw_tiled_scene(parallel->getCanvas());
+
+    // The tile grid doesn't depend on the thread count, so neither do the results.
+    SkPixmap a, b;
+    REPORTER_ASSERT(reporter, serial->peekPixels(&a) && parallel->peekPixels(&b));
+    REPORTER_ASSERT(reporter, pixmaps_equal(a, b));
+
+    // Tiling doesn't change the results of a direct surface either.
+    auto direct = SkSurface::MakeRaster(info);
+    draw_tiled_scene(direct->getCanvas());
+    REPORTER_ASSERT(reporter, direct->peekPixels(&b));
+    REPORTER_ASSERT(reporter, pixmaps_equal(a, b));
+
+    // Neither does an AA clip crossing tile edges.
+    direct = SkSurface::MakeRaster(info);
+    auto tiled = SkSurface::MakeRasterTiled(info, four.get(), 64);
+    for (SkCanvas* canvas : {direct->getCanvas(), tiled->getCanvas()}) {
+        canvas->clipRRect(SkRRect::MakeOval({20.5f, 10.5f, 280.5f, 190.5f}), true);
+        draw_tiled_scene(canvas);
+    }
+    REPORTER_ASSERT(reporter, direct->peekPixels(&a) && tiled->peekPixels(&b));
+    REPORTER_ASSERT(reporter, pixmaps_equal(a, b));
+
+    // Backdrop filters read pixels across tile edges, and SaveBehind restores them, so these
+    // are replayed untiled and match a direct surface exactly.
+    direct = SkSurface::MakeRaster(info);
+    tiled = SkSurface::MakeRasterTiled(info, four.get(), 64);
+    for (SkCanvas* canvas : {direct->getCanvas(), tiled->getCanvas()}) {
+        draw_tiled_scene(canvas);
+
+        auto blur = SkImageFilters::Blur(8, 8, nullptr);
+        const SkRect bounds = {30, 30, 270, 170};
+        canvas->saveLayer(SkCanvas::SaveLayerRec(&bounds, nullptr, blur.get(), 0));
+        canvas->restore();
+
+        SkCanvasPriv::SaveBehind(canvas, &bounds);
+        SkPaint paint;
+        paint.setColor(0x80ffff00);
+        canvas->drawCircle(150, 100, 60, paint);
+        canvas->restore();
+    }
+    REPORTER_ASSERT(reporter, direct->peekPixels(&a) && tiled->peekPixels(&b));
+    REPORTER_ASSERT(reporter, pixmaps_equal(a, b));
+}
+
+DEF_TEST(SurfaceRasterTiled_Flush, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 100);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    auto surface = SkSurface::MakeRasterTiled(info, executor.get(), 32);
+    SkCanvas* canvas = surface->getCanvas();
+
+    auto pixel = [&] {
+        uint32_t px = 0;
+        SkAssertResult(surface->readPixels(info.makeWH(1, 1), &px, 4, 50, 50));
+        return px;
+    };
+
+    // Snapshots see everything drawn before them, and nothing after.
+    canvas->clear(SK_ColorRED);
+    sk_sp<SkImage> red = surface->makeImageSnapshot();
+    canvas->clear(SK_ColorBLUE);
+    REPORTER_ASSERT(reporter, pixel() == SkPreMultiplyColor(SK_ColorBLUE));
+    uint32_t px = 0;
+    REPORTER_ASSERT(reporter, red->readPixels(info.makeWH(1, 1), &px, 4, 50, 50));
+    REPORTER_ASSERT(reporter, px == SkPreMultiplyColor(SK_ColorRED));
+
+    // A layer isn't visible until it's restored, and is only composited once.
+    canvas->saveLayerAlpha(nullptr, 0x80);
+    canvas->clear(SK_ColorGREEN);
+    REPORTER_ASSERT(reporter, pixel() == SkPreMultiplyColor(SK_ColorBLUE));
+    canvas->restore();
+    const uint32_t blended = pixel();
+    REPORTER_ASSERT(reporter, blended != SkPreMultiplyColor(SK_ColorBLUE));
+    canvas->drawRect({0, 0, 1, 1}, SkPaint());
+    REPORTER_ASSERT(reporter, pixel() == blended);
+
+    // State set before a flush still applies to draws recorded after it.
+    canvas->save();
+    canvas->clipRect({0, 0, 10, 10});
+    surface->flushAndSubmit();
+    canvas->clear(SK_ColorRED);
+    canvas->restore();
+    REPORTER_ASSERT(reporter, pixel() == blended);
+}
@@ -12,6 +12,7 @@
 #include "include/core/SkSurface.h"
 #include "include/core/SkTime.h"
 #include "modules/skottie/include/Skottie.h"
+#include "modules/skottie/utils/SkottieUtils.h"
 #include "modules/skresources/include/SkResources.h"
 #include "src/utils/SkOSPath.h"
 
@@ -28,6 +29,7 @@ static DEFINE_bool2(verbose, v, false, "verbose mode");
 static DEFINE_bool2(loop, l, false, "loop mode for profiling");
 static DEFINE_int(set_dst_width, 0, "set destination width (height will be computed)");
 static DEFINE_bool2(gpu, g, false, "use GPU for rendering");
+static DEFINE_int_2(threads, t, 1, "number of threads to render with (CPU rendering only)");
 
 static void produce_frame(SkSurface* surf, skottie::Animation* anim, double frame) {
     anim->seekFrame(frame);
@@ -63,7 +65,10 @@ int main(int argc, char** argv) {
     }
     SkDebugf("assetPath %s\n", assetPath.c_str());
 
-    auto animation = skottie::Animation::Builder()
+    const int threads = FLAGS_gpu ? 1 : std::max(FLAGS_threads, 1);
+    const uint32_t flags = threads > 1 ? skottie::Animation::Builder::kAllowClones : 0;
+
+    auto animation = skottie::Animation::Builder(flags)
         .setResourceProvider(skresources::FileResourceProvider::Make(assetPath))
         .makeFromFile(FLAGS_input[0]);
     if (!animation) {
@@ -105,52 +110,68 @@ int main(int argc, char** argv) {
             return -1;
         }
 
-        // lazily allocate the surfaces
-        if (!surf) {
-            if (FLAGS_gpu) {
-                context = factory.getContextInfo(contextType).directContext();
-                surf = SkSurface::MakeRenderTarget(context,
-                                                   SkBudgeted::kNo,
-                                                   info,
-                                                   0,
-                                                   GrSurfaceOrigin::kTopLeft_GrSurfaceOrigin,
-                                                   nullptr);
-                if (!surf) {
-                    context = nullptr;
-                }
+        if (threads > 1) {
+            std::vector<double> frame_list(frames + 1);
+            for (int i = 0; i <= frames; ++i) {
+                frame_list[i] = i * fps_scale;
             }
+            skottie_utils::RenderFrames(animation, frame_list, info, SK_ColorWHITE, threads,
+                                        [&](size_t index, const SkPixmap& pm) {
+                if (FLAGS_verbose) {
+                    SkDebugf("rendered frame %g\n", frame_list[index]);
+                }
+                encoder.addFrame(pm);
+            });
+        } else {
+            // lazily allocate the surfaces
             if (!surf) {
-                surf = SkSurface::MakeRaster(info);
-            }
-            surf->getCanvas()->scale(scale, scale);
-        }
-
-        for (int i = 0; i <= frames; ++i) {
-            const double frame = i * fps_scale;
-            if (FLAGS_verbose) {
-                SkDebugf("rendering frame %g\n", frame);
+                if (FLAGS_gpu) {
+                    context = factory.getContextInfo(contextType).directContext();
+                    surf = SkSurface::MakeRenderTarget(context,
+                                                       SkBudgeted::kNo,
+                                                       info,
+                                                       0,
+                                                       GrSurfaceOrigin::kTopLeft_GrSurfaceOrigin,
+                                                       nullptr);
+                    if (!surf) {
+                        context = nullptr;
+                    }
+                }
+                if (!surf) {
+                    surf = SkSurface::MakeRaster(info);
+                }
+                surf->getCanvas()->scale(scale, scale);
             }
 
-            produce_frame(surf.get(), animation.get(), frame);
+            for (int i = 0; i <= frames; ++i) {
+                const double frame = i * fps_scale;
+                if (FLAGS_verbose) {
+                    SkDebugf("rendering frame %g\n", frame);
+                }
 
-            AsyncRec asyncRec = { info, &encoder };
-            if (context) {
-                auto read_pixels_cb = [](SkSurface::ReadPixelsContext ctx,
-                                         std::unique_ptr<const SkSurface::AsyncReadResult> result) {
-                    if (result && result->count() == 1) {
-                        AsyncRec* rec = reinterpret_cast<AsyncRec*>(ctx);
-                        rec->encoder->addFrame({rec->info, result->data(0), result->rowBytes(0)});
-                    }
-                };
-                surf->asyncRescaleAndReadPixels(info, {0, 0, info.width(), info.height()},
-                                                SkSurface::RescaleGamma::kSrc,
-                                                kNone_SkFilterQuality,
-                                                read_pixels_cb, &asyncRec);
-                surf->getContext()->submit();
-            } else {
-                SkPixmap pm;
-                SkAssertResult(surf->peekPixels(&pm));
-                encoder.addFrame(pm);
+                produce_frame(surf.get(), animation.get(), frame);
+
+                AsyncRec asyncRec = { info, &encoder };
+                if (context) {
+                    auto read_pixels_cb =
+                            [](SkSurface::ReadPixelsContext ctx,
+                               std::unique_ptr<const SkSurface::AsyncReadResult> result) {
+                        if (result && result->count() == 1) {
+                            AsyncRec* rec = reinterpret_cast<AsyncRec*>(ctx);
+                            rec->encoder->addFrame({rec->info, result->data(0),
+                                                    result->rowBytes(0)});
+                        }
+                    };
+                    surf->asyncRescaleAndReadPixels(info, {0, 0, info.width(), info.height()},
+                                                    SkSurface::RescaleGamma::kSrc,
+                                                    kNone_SkFilterQuality,
+                                                    read_pixels_cb, &asyncRec);
+                    surf->getContext()->submit();
+                } else {
+                    SkPixmap pm;
+                    SkAssertResult(surf->peekPixels(&pm));
+                    encoder.addFrame(pm);
+                }
             }
         }
         data = encoder.endRecording();